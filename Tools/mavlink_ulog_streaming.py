@@ -26,7 +26,8 @@ from argparse import ArgumentParser
 class MavlinkLogStreaming():
     '''Streams log data via MAVLink.
        Assumptions:
-       - the sender only sends one acked message at a time
+       - acked messages are retransmitted individually and can arrive out of
+         order (the sender keeps a window of them), they are reordered here
        - the data is in the ULog format '''
     def __init__(self, portname, baudrate, output_filename, debug=0):
         self.baudrate = 0
@@ -44,6 +45,7 @@ class MavlinkLogStreaming():
         self.file = open(output_filename,'wb')
         self.start_time = timer()
         self.last_sequence = -1
+        self.acked_pending = {} # acked messages received ahead of a gap
         self.logging_started = False
         self.num_dropouts = 0
         self.target_component = 1
@@ -104,6 +106,12 @@ class MavlinkLogStreaming():
     def read_message(self):
         ''' read a single mavlink message, handle ACK & return a tuple of (data, first
         message start, num dropouts) '''
+        next_sequence = (self.last_sequence + 1) % (1 << 16)
+        if next_sequence in self.acked_pending:
+            m = self.acked_pending.pop(next_sequence)
+            self.last_sequence = m.sequence
+            return m.data[:m.length], m.first_message_offset, 0
+
         m = self.mav.recv_match(type=['LOGGING_DATA_ACKED',
                             'LOGGING_DATA', 'COMMAND_ACK'], blocking=True,
                             timeout=0.05)
@@ -130,6 +138,11 @@ class MavlinkLogStreaming():
                         self.target_component, m.sequence)
 
             if is_newer:
+                if m.get_type() == 'LOGGING_DATA_ACKED' and num_drops > 0:
+                    # overtook a retransmission: hold it back until the gap is filled
+                    self.acked_pending[m.sequence] = m
+                    return None, 0, 0
+
                 if num_drops > 0:
                     self.num_dropouts += num_drops
 
@@ -150,8 +163,8 @@ class MavlinkLogStreaming():
     def check_sequence(self, seq):
         ''' check if a sequence is newer than the previously received one & if
         there were dropped messages between the last and this '''
-        if self.last_sequence == -1:
-            return True, 0
+        if self.last_sequence == -1: # the logger starts with sequence 0
+            return True, seq
         if seq == self.last_sequence: # duplicate
             return False, 0
         if seq > self.last_sequence:
@@ -27,6 +27,7 @@ set(config_module_list
 	#
 	# System commands
 	#
+	systemcmds/affinity
 	systemcmds/param
 	systemcmds/mixer
 	systemcmds/ver
@@ -29,6 +29,7 @@ set(config_module_list
 	#
 	# System commands
 	#
+	systemcmds/affinity
 	#systemcmds/bl_update
 	#systemcmds/config
 	#systemcmds/dumpfile
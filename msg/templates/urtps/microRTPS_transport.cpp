@@ -35,11 +35,17 @@
 #include <stdio.h>
 #include <errno.h>
 #include <sys/socket.h>
+#include <sys/time.h>
 
 #include "microRTPS_transport.h"
 
+#if defined(__PX4_NUTTX) || defined(__PX4_POSIX)
+#include <systemlib/crc.h>
+#endif
+
 #define DEFAULT_UART "/dev/ttyACM0"
 
+#if !defined(__PX4_NUTTX) && !defined(__PX4_POSIX)
 /** CRC table for the CRC-16. The poly is 0x8005 (x^16 + x^15 + x^2 + 1) */
 uint16_t const crc16_table[256] = {
 	0x0000, 0xC0C1, 0xC181, 0x0140, 0xC301, 0x03C0, 0x0280, 0xC241,
@@ -75,8 +81,10 @@ uint16_t const crc16_table[256] = {
 	0x4400, 0x84C1, 0x8581, 0x4540, 0x8701, 0x47C0, 0x4680, 0x8641,
 	0x8201, 0x42C0, 0x4380, 0x8341, 0x4100, 0x81C1, 0x8081, 0x4040
 };
+#endif
 
-Transport_node::Transport_node(): rx_buff_pos(0)
+Transport_node::Transport_node(): rx_buff_start(0), rx_buff_pos(0), rx_batch_pos(0), rx_batch_end(0),
+	tx_buff_pos(0), tx_batch_start(0), tx_batching(false), tx_seq(0)
 {
 }
 
@@ -86,11 +94,19 @@ Transport_node::~Transport_node()
 
 uint16_t Transport_node::crc16_byte(uint16_t crc, const uint8_t data)
 {
+#if defined(__PX4_NUTTX) || defined(__PX4_POSIX)
+	return crc16_arc_signature(crc, 1, &data);
+#else
 	return (crc >> 8) ^ crc16_table[(crc ^ data) & 0xff];
+#endif
 }
 
 uint16_t Transport_node::crc16(uint8_t const *buffer, size_t len)
 {
+#if defined(__PX4_NUTTX) || defined(__PX4_POSIX)
+	// on the PX4 side use the shared CRC engine (slice-by-8 on POSIX)
+	return crc16_arc_signature(0, len, buffer);
+#else
 	uint16_t crc = 0;
 
 	while (len--) {
@@ -98,17 +114,66 @@ uint16_t Transport_node::crc16(uint8_t const *buffer, size_t len)
 	}
 
 	return crc;
+#endif
 }
 
 ssize_t Transport_node::read(uint8_t *topic_ID, char out_buffer[], size_t buffer_len)
 {
-	if (nullptr == out_buffer || nullptr == topic_ID || !fds_OK()) {
+	if (nullptr == out_buffer) {
+		return -1;
+	}
+
+	char *payload = nullptr;
+	size_t payload_len = 0;
+	ssize_t len = read(topic_ID, &payload, &payload_len);
+
+	if (len <= 0) {
+		return len;
+	}
+
+	// The message won't fit the buffer. It has already been consumed, so drop it.
+	if (buffer_len < sizeof(struct Header) + payload_len) {
+		*topic_ID = 255;
+		return -EMSGSIZE;
+	}
+
+	memcpy(out_buffer, payload, payload_len);
+
+	return len;
+}
+
+ssize_t Transport_node::read(uint8_t *topic_ID, char **payload, size_t *payload_len)
+{
+	if (nullptr == topic_ID || nullptr == payload || nullptr == payload_len || !fds_OK()) {
 		return -1;
 	}
 
 	*topic_ID = 255;
 
-	ssize_t len = node_read((void *)(rx_buffer + rx_buff_pos), sizeof(rx_buffer) - rx_buff_pos);
+	// Unpack the rest of a batch frame first, it still sits in the receive buffer
+	if (rx_batch_pos < rx_batch_end) {
+		return next_batched(topic_ID, payload, payload_len);
+	}
+
+	// A previous read may have brought in several messages, hand those out first
+	ssize_t len = parse(topic_ID, payload, payload_len);
+
+	if (len != 0) {
+		return len;
+	}
+
+	if (rx_buff_start == rx_buff_pos) {
+		// Nothing pending, start over at the beginning of the buffer
+		rx_buff_start = rx_buff_pos = 0;
+
+	} else if (sizeof(rx_buffer) - rx_buff_pos < RX_MIN_FREE) {
+		// Only the (partial) message being assembled is moved, at most once per read
+		memmove(rx_buffer, rx_buffer + rx_buff_start, rx_buff_pos - rx_buff_start);
+		rx_buff_pos -= rx_buff_start;
+		rx_buff_start = 0;
+	}
+
+	len = node_read((void *)(rx_buffer + rx_buff_pos), sizeof(rx_buffer) - rx_buff_pos);
 
 	if (len <= 0) {
 		int errsv = errno;
@@ -122,125 +187,253 @@ ssize_t Transport_node::read(uint8_t *topic_ID, char out_buffer[], size_t buffer
 
 	rx_buff_pos += len;
 
-	// We read some
-	size_t header_size = sizeof(struct Header);
+	return parse(topic_ID, payload, payload_len);
+}
+
+ssize_t Transport_node::parse(uint8_t *topic_ID, char **payload, size_t *payload_len)
+{
+	const size_t header_size = sizeof(struct Header);
 
-	// but not enough
-	if (rx_buff_pos < header_size) {
+	// Not enough for a header
+	if (rx_buff_pos - rx_buff_start < header_size) {
 		return 0;
 	}
 
-	uint32_t msg_start_pos = 0;
+	// Look for the start marker: the last possible header start is header_size bytes before the end
+	char *begin = rx_buffer + rx_buff_start;
+	char *last = rx_buffer + rx_buff_pos - header_size;
+	char *msg_start = begin;
+
+	while (msg_start <= last) {
+		msg_start = (char *)memchr(msg_start, '>', last - msg_start + 1);
 
-	for (msg_start_pos = 0; msg_start_pos <= rx_buff_pos - header_size; ++msg_start_pos) {
-		if ('>' == rx_buffer[msg_start_pos] && memcmp(rx_buffer + msg_start_pos, ">>>", 3) == 0) {
+		if (nullptr == msg_start || ('>' == msg_start[1] && '>' == msg_start[2])) {
 			break;
 		}
+
+		++msg_start;
 	}
 
 	// Start not found
-	if (msg_start_pos > rx_buff_pos - header_size) {
-		printf("                                 (↓↓ %u)\n", msg_start_pos);
-		// All we've checked so far is garbage, drop it - but save unchecked bytes
-		memmove(rx_buffer, rx_buffer + msg_start_pos, rx_buff_pos - msg_start_pos);
-		rx_buff_pos = rx_buff_pos - msg_start_pos;
+	if (nullptr == msg_start || msg_start > last) {
+		uint32_t dropped = last - begin + 1;
+		printf("                                 (↓↓ %u)\n", dropped);
+		// All we've checked so far is garbage, drop it - but keep unchecked bytes
+		rx_buff_start += dropped;
 		return -1;
 	}
 
+	// If there's garbage at the beginning, drop it
+	if (msg_start > begin) {
+		printf("                                 (↓ %u)\n", (uint32_t)(msg_start - begin));
+		rx_buff_start = msg_start - rx_buffer;
+	}
+
 	/*
 	 * [>,>,>,topic_ID,seq,payload_length_H,payload_length_L,CRCHigh,CRCLow,payloadStart, ... ,payloadEnd]
 	 */
 
-	struct Header *header = (struct Header *)&rx_buffer[msg_start_pos];
-	uint32_t payload_len = ((uint32_t)header->payload_len_h << 8) | header->payload_len_l;
+	struct Header *header = (struct Header *)msg_start;
+	uint32_t payload_size = ((uint32_t)header->payload_len_h << 8) | header->payload_len_l;
 
-	// The message won't fit the buffer.
-	if (buffer_len < header_size + payload_len) {
-		return -EMSGSIZE;
+	// A message this large can never be assembled, the marker must be garbage
+	if (header_size + payload_size > sizeof(rx_buffer) - RX_MIN_FREE) {
+		printf("                                 (↓ 3)\n");
+		rx_buff_start += sizeof(header->marker);
+		return -1;
 	}
 
 	// We do not have a complete message yet
-	if (msg_start_pos + header_size + payload_len > rx_buff_pos) {
-		// If there's garbage at the beginning, drop it
-		if (msg_start_pos > 0) {
-			printf("                                 (↓ %u)\n", msg_start_pos);
-			memmove(rx_buffer, rx_buffer + msg_start_pos, rx_buff_pos - msg_start_pos);
-			rx_buff_pos -= msg_start_pos;
-		}
-
+	if (rx_buff_start + header_size + payload_size > rx_buff_pos) {
 		return 0;
 	}
 
+	// Discard the message from rx_buffer, the payload stays in place until the next read
+	rx_buff_start += header_size + payload_size;
+
 	uint16_t read_crc = ((uint16_t)header->crc_h << 8) | header->crc_l;
-	uint16_t calc_crc = crc16((uint8_t *)rx_buffer + msg_start_pos + header_size, payload_len);
+	uint16_t calc_crc = crc16((uint8_t *)msg_start + header_size, payload_size);
 
 	if (read_crc != calc_crc) {
 		printf("BAD CRC %u != %u\n", read_crc, calc_crc);
-		printf("                                 (↓ %lu)\n", (unsigned long)(header_size + payload_len));
-		len = -1;
+		printf("                                 (↓ %lu)\n", (unsigned long)(header_size + payload_size));
+		return -1;
+	}
 
-	} else {
-		// copy message to outbuffer and set other return values
-		memmove(out_buffer, rx_buffer + msg_start_pos + header_size, payload_len);
-		*topic_ID = header->topic_ID;
-		len = payload_len + header_size;
+	if (BATCH_TOPIC_ID == header->topic_ID) {
+		rx_batch_pos = msg_start + header_size - rx_buffer;
+		rx_batch_end = rx_batch_pos + payload_size;
+		return next_batched(topic_ID, payload, payload_len);
 	}
 
-	// discard message from rx_buffer
-	rx_buff_pos -= header_size + payload_len;
-	memmove(rx_buffer, rx_buffer + msg_start_pos + header_size + payload_len, rx_buff_pos);
+	*topic_ID = header->topic_ID;
+	*payload = msg_start + header_size;
+	*payload_len = payload_size;
 
-	return len;
+	return payload_size + header_size;
+}
+
+ssize_t Transport_node::next_batched(uint8_t *topic_ID, char **payload, size_t *payload_len)
+{
+	const size_t header_size = sizeof(struct BatchHeader);
+	struct BatchHeader *header = (struct BatchHeader *)(rx_buffer + rx_batch_pos);
+	uint32_t payload_size = ((uint32_t)header->payload_len_h << 8) | header->payload_len_l;
+
+	// The CRC matched, so this can only come from a broken sender
+	if (rx_batch_pos + header_size > rx_batch_end || rx_batch_pos + header_size + payload_size > rx_batch_end) {
+		printf("BAD BATCH (↓ %u)\n", rx_batch_end - rx_batch_pos);
+		rx_batch_pos = rx_batch_end = 0;
+		return -1;
+	}
+
+	*topic_ID = header->topic_ID;
+	*payload = rx_buffer + rx_batch_pos + header_size;
+	*payload_len = payload_size;
+	rx_batch_pos += header_size + payload_size;
+
+	if (rx_batch_pos >= rx_batch_end) {
+		rx_batch_pos = rx_batch_end = 0;
+	}
+
+	return payload_size + header_size;
 }
 
 ssize_t Transport_node::write(const uint8_t topic_ID, char buffer[], size_t length)
+{
+	// Keep the stream in order with respect to anything queued before
+	ssize_t len = queue(topic_ID, buffer, length);
+
+	if (len < 0) {
+		return len;
+	}
+
+	if (0 > flush()) {
+		return -1;
+	}
+
+	return len;
+}
+
+ssize_t Transport_node::queue(const uint8_t topic_ID, char buffer[], size_t length)
 {
 	if (!fds_OK()) {
 		return -1;
 	}
 
-	static struct Header header = {
-		.marker = {'>', '>', '>'},
-		.topic_ID = 0u,
-		.seq = 0u,
-		.payload_len_h = 0u,
-		.payload_len_l = 0u,
-		.crc_h = 0u,
-		.crc_l = 0u
+	if (tx_batching) {
+		const size_t msg_len = sizeof(struct BatchHeader) + length;
+
+		if (sizeof(struct Header) + msg_len > sizeof(tx_buffer)) {
+			return -EMSGSIZE;
+		}
+
+		size_t needed = msg_len + (tx_batch_start == tx_buff_pos ? sizeof(struct Header) : 0);
+
+		if (tx_buff_pos + needed > sizeof(tx_buffer) && 0 > flush()) {
+			return -1;
+		}
+
+		// Open a new batch frame, its header is filled in when the batch is complete
+		if (tx_batch_start == tx_buff_pos) {
+			tx_buff_pos += sizeof(struct Header);
+		}
+
+		struct BatchHeader header;
+		header.topic_ID = topic_ID;
+		header.payload_len_h = (length >> 8) & 0xff;
+		header.payload_len_l = length & 0xff;
+
+		memcpy(tx_buffer + tx_buff_pos, &header, sizeof(header));
+		memcpy(tx_buffer + tx_buff_pos + sizeof(header), buffer, length);
+		tx_buff_pos += msg_len;
+
+		return msg_len;
+	}
+
+	const size_t frame_len = sizeof(struct Header) + length;
 
-	};
+	if (frame_len > sizeof(tx_buffer)) {
+		return -EMSGSIZE;
+	}
 
-	static uint8_t seq = 0;
+	if (tx_buff_pos + frame_len > sizeof(tx_buffer) && 0 > flush()) {
+		return -1;
+	}
 
 	// [>,>,>,topic_ID,seq,payload_length,CRCHigh,CRCLow,payload_start, ... ,payload_end]
 
 	uint16_t crc = crc16((uint8_t *)buffer, length);
 
+	struct Header header;
+	header.marker[0] = header.marker[1] = header.marker[2] = '>';
 	header.topic_ID = topic_ID;
-	header.seq = seq++;
+	header.seq = tx_seq++;
 	header.payload_len_h = (length >> 8) & 0xff;
 	header.payload_len_l = length & 0xff;
 	header.crc_h = (crc >> 8) & 0xff;
 	header.crc_l = crc & 0xff;
 
-	ssize_t len = node_write(&header, sizeof(header));
+	memcpy(tx_buffer + tx_buff_pos, &header, sizeof(header));
+	memcpy(tx_buffer + tx_buff_pos + sizeof(header), buffer, length);
+	tx_buff_pos += frame_len;
+	tx_batch_start = tx_buff_pos;
+
+	return frame_len;
+}
 
-	if (len != sizeof(header)) {
-		goto err;
+void Transport_node::finish_batch()
+{
+	if (tx_batch_start == tx_buff_pos) {
+		return;
 	}
 
-	len = node_write(buffer, length);
+	char *payload = tx_buffer + tx_batch_start + sizeof(struct Header);
+	size_t length = tx_buff_pos - tx_batch_start - sizeof(struct Header);
+	uint16_t crc = crc16((uint8_t *)payload, length);
 
-	if (len != ssize_t(length)) {
-		goto err;
+	struct Header header;
+	header.marker[0] = header.marker[1] = header.marker[2] = '>';
+	header.topic_ID = BATCH_TOPIC_ID;
+	header.seq = tx_seq++;
+	header.payload_len_h = (length >> 8) & 0xff;
+	header.payload_len_l = length & 0xff;
+	header.crc_h = (crc >> 8) & 0xff;
+	header.crc_l = crc & 0xff;
+
+	memcpy(tx_buffer + tx_batch_start, &header, sizeof(header));
+	tx_batch_start = tx_buff_pos;
+}
+
+void Transport_node::set_frame_batching(bool enable)
+{
+	if (enable != tx_batching) {
+		finish_batch();
+		tx_batching = enable;
+	}
+}
+
+ssize_t Transport_node::flush()
+{
+	finish_batch();
+
+	if (0 == tx_buff_pos) {
+		return 0;
 	}
 
-	return len + sizeof(header);
+	// All queued frames go out in a single write (one datagram for UDP). On failure
+	// the batch is dropped, the receiver resynchronizes on the next marker.
+	size_t length = tx_buff_pos;
+	tx_buff_pos = 0;
+	tx_batch_start = 0;
 
-err:
-	//int errsv = errno;
-	//if (len == -1 ) printf("                               => Writing error '%d'\n", errsv);
-	//else            printf("                               => Wrote '%ld' != length(%lu) error '%d'\n", (long)len, (unsigned long)length, errsv);
+	ssize_t len = node_write(tx_buffer, length);
+
+	if (len != ssize_t(length)) {
+		//int errsv = errno;
+		//if (len == -1 ) printf("                               => Writing error '%d'\n", errsv);
+		//else            printf("                               => Wrote '%ld' != length(%lu) error '%d'\n", (long)len, (unsigned long)length, errsv);
+		return -1;
+	}
 
 	return len;
 }
@@ -451,6 +644,23 @@ int UDP_node::init_sender(uint16_t udp_port)
 	return 0;
 }
 
+int UDP_node::set_read_timeout(uint32_t timeout_ms)
+{
+#ifndef __PX4_NUTTX
+	struct timeval tv;
+	tv.tv_sec = timeout_ms / 1000;
+	tv.tv_usec = (timeout_ms % 1000) * 1000;
+
+	if (0 > setsockopt(receiver_fd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv))) {
+		printf("set receive timeout failed (%d)\n", errno);
+		return -1;
+	}
+
+#endif /* __PX4_NUTTX */
+
+	return 0;
+}
+
 uint8_t UDP_node::close()
 {
 #ifndef __PX4_NUTTX
@@ -481,7 +691,7 @@ ssize_t UDP_node::node_read(void *buffer, size_t len)
 
 	int ret = 0;
 #ifndef __PX4_NUTTX
-	// Blocking call
+	// Blocking call, unless bounded by set_read_timeout()
 	static socklen_t addrlen = sizeof(receiver_outaddr);
 	ret = recvfrom(receiver_fd, buffer, len, 0, (struct sockaddr *) &receiver_outaddr, &addrlen);
 #endif /* __PX4_NUTTX */
@@ -46,8 +46,40 @@ public:
 	virtual int init() {return 0;}
 	virtual uint8_t close() {return 0;}
 	ssize_t read(uint8_t *topic_ID, char out_buffer[], size_t buffer_len);
+
+	/**
+	 * Read the next message without copying it.
+	 * @param payload set to the payload inside the receive buffer, valid until the next read
+	 * @param payload_len set to the payload length
+	 * @return message length (header included), 0 if no complete message is available, < 0 on error
+	 */
+	ssize_t read(uint8_t *topic_ID, char **payload, size_t *payload_len);
+
 	ssize_t write(const uint8_t topic_ID, char buffer[], size_t length);
 
+	/**
+	 * Append a message to the transmit batch. The batch is written out by flush(),
+	 * or automatically when the next message does not fit.
+	 * @return message length (header included), < 0 on error
+	 */
+	ssize_t queue(const uint8_t topic_ID, char buffer[], size_t length);
+
+	/**
+	 * Write all queued messages with a single node_write.
+	 * @return number of bytes written, < 0 on error
+	 */
+	ssize_t flush();
+
+	/**
+	 * In batch frame mode all messages queued until the next flush() are packed into a single
+	 * frame, with a 3 byte sub-header [topic_ID,length_H,length_L] per message instead of a
+	 * full frame header. The receiving side unpacks them transparently in read().
+	 */
+	void set_frame_batching(bool enable);
+
+	/** Topic ID reserved for batch frames */
+	static const uint8_t BATCH_TOPIC_ID = 254;
+
 protected:
 	virtual ssize_t node_read(void *buffer, size_t len) = 0;
 	virtual ssize_t node_write(void *buffer, size_t len) = 0;
@@ -55,9 +87,26 @@ protected:
 	uint16_t crc16_byte(uint16_t crc, const uint8_t data);
 	uint16_t crc16(uint8_t const *buffer, size_t len);
 
+	ssize_t parse(uint8_t *topic_ID, char **payload, size_t *payload_len);
+	ssize_t next_batched(uint8_t *topic_ID, char **payload, size_t *payload_len);
+	void finish_batch();
+
 protected:
-	uint32_t rx_buff_pos;
-	char rx_buffer[1024] = {};
+	// Free space guaranteed for each node_read, large enough for a whole batch datagram
+	static const size_t RX_MIN_FREE = 1024;
+
+	uint32_t rx_buff_start;	///< first byte not consumed yet
+	uint32_t rx_buff_pos;	///< end of the received data
+	char rx_buffer[2 * RX_MIN_FREE] = {};
+
+	uint32_t rx_batch_pos;	///< next message of the batch frame being unpacked
+	uint32_t rx_batch_end;
+
+	uint32_t tx_buff_pos;
+	uint32_t tx_batch_start;	///< header position of the open batch frame, tx_buff_pos if none
+	bool tx_batching;
+	uint8_t tx_seq;
+	char tx_buffer[RX_MIN_FREE] = {};
 
 private:
 	struct __attribute__((packed)) Header {
@@ -69,6 +118,12 @@ private:
 		uint8_t crc_h;
 		uint8_t crc_l;
 	};
+
+	struct __attribute__((packed)) BatchHeader {
+		uint8_t topic_ID;
+		uint8_t payload_len_h;
+		uint8_t payload_len_l;
+	};
 };
 
 class UART_node: public Transport_node
@@ -101,6 +156,13 @@ public:
 	int init();
 	uint8_t close();
 
+	/**
+	 * Bound the time a read waits for a datagram, by default it blocks until one arrives.
+	 * @param timeout_ms receive timeout, 0 to block again
+	 * @return 0 on success, < 0 on error
+	 */
+	int set_read_timeout(uint32_t timeout_ms);
+
 protected:
 	int init_receiver(uint16_t udp_port);
 	int init_sender(uint16_t udp_port);
@@ -40,6 +40,7 @@
 #include "px4_posix.h"
 #include "vdev.h"
 #include "drivers/drv_device.h"
+#include "drivers/drv_hrt.h"
 
 #include <stdlib.h>
 #include <stdio.h>
@@ -57,7 +58,10 @@ namespace device
 
 int px4_errno;
 
-static map<string, void *> devmap;
+/* devices are registered per namespace: the same path can refer to a
+ * different device in each of them (see px4_get_namespace()) */
+typedef pair<int, string> devkey_t;
+static map<devkey_t, void *> devmap;
 pthread_mutex_t devmutex = PTHREAD_MUTEX_INITIALIZER;
 
 
@@ -70,6 +74,7 @@ CDev::CDev(const char *name,
 	_pub_blocked(false),
 	// private
 	_devname(devname),
+	_namespace(px4_get_namespace()),
 	_registered(false),
 	_max_pollwaiters(0),
 	_open_count(0),
@@ -133,14 +138,15 @@ CDev::register_driver(const char *name, void *data)
 	pthread_mutex_lock(&devmutex);
 
 	// Make sure the device does not already exist
-	auto item = devmap.find(name);
+	const devkey_t key(_namespace, name);
+	auto item = devmap.find(key);
 
 	if (item != devmap.end()) {
 		pthread_mutex_unlock(&devmutex);
 		return -EEXIST;
 	}
 
-	devmap[name] = (void *)data;
+	devmap[key] = (void *)data;
 	DEVICE_DEBUG("Registered DEV %s", name);
 
 	pthread_mutex_unlock(&devmutex);
@@ -160,7 +166,7 @@ CDev::unregister_driver(const char *name)
 
 	pthread_mutex_lock(&devmutex);
 
-	if (devmap.erase(name) > 0) {
+	if (devmap.erase(devkey_t(_namespace, name)) > 0) {
 		DEVICE_DEBUG("Unregistered DEV %s", name);
 		ret = 0;
 	}
@@ -181,7 +187,7 @@ CDev::unregister_class_devname(const char *class_devname, unsigned class_instanc
 	PX4_WARN("unregistering class %s", name);
 	pthread_mutex_lock(&devmutex);
 
-	if (devmap.erase(name) > 0) {
+	if (devmap.erase(devkey_t(_namespace, name)) > 0) {
 		DEVICE_DEBUG("Unregistered class DEV %s", name);
 		ret = 0;
 	}
@@ -375,7 +381,7 @@ CDev::poll(file_t *filep, px4_pollfd_struct_t *fds, bool setup)
 
 			/* yes? post the notification */
 			if (fds->revents != 0) {
-				px4_sem_post(fds->sem);
+				hrt_lockstep_post(fds->sem);
 			}
 
 		} else {
@@ -426,7 +432,7 @@ CDev::poll_notify_one(px4_pollfd_struct_t *fds, pollevent_t events)
 	/* if the state is now interesting, wake the waiter if it's still asleep */
 	/* XXX semcount check here is a vile hack; counting semphores should not be abused as cvars */
 	if ((fds->revents != 0) && (value <= 0)) {
-		px4_sem_post(fds->sem);
+		hrt_lockstep_post(fds->sem);
 	}
 }
 
@@ -505,7 +511,7 @@ CDev *CDev::getDev(const char *path)
 
 	pthread_mutex_lock(&devmutex);
 
-	auto item = devmap.find(path);
+	auto item = devmap.find(devkey_t(px4_get_namespace(), path));
 
 	if (item != devmap.end()) {
 		pthread_mutex_unlock(&devmutex);
@@ -525,8 +531,8 @@ void CDev::showDevices()
 	pthread_mutex_lock(&devmutex);
 
 	for (const auto &dev : devmap) {
-		if (strncmp(dev.first.c_str(), "/dev/", 5) == 0) {
-			PX4_INFO("   %s", dev.first.c_str());
+		if (dev.first.first == px4_get_namespace() && strncmp(dev.first.second.c_str(), "/dev/", 5) == 0) {
+			PX4_INFO("   %s", dev.first.second.c_str());
 		}
 	}
 
@@ -554,8 +560,8 @@ void CDev::showTopics()
 	pthread_mutex_lock(&devmutex);
 
 	for (const auto &dev : devmap) {
-		if (strncmp(dev.first.c_str(), "/obj/", 5) == 0) {
-			PX4_INFO("   %s", dev.first.c_str());
+		if (dev.first.first == px4_get_namespace() && strncmp(dev.first.second.c_str(), "/obj/", 5) == 0) {
+			PX4_INFO("   %s", dev.first.second.c_str());
 		}
 	}
 
@@ -569,9 +575,10 @@ void CDev::showFiles()
 	pthread_mutex_lock(&devmutex);
 
 	for (const auto &dev : devmap) {
-		if (strncmp(dev.first.c_str(), "/obj/", 5) != 0 &&
-		    strncmp(dev.first.c_str(), "/dev/", 5) != 0) {
-			PX4_INFO("   %s", dev.first.c_str());
+		if (dev.first.first == px4_get_namespace() &&
+		    strncmp(dev.first.second.c_str(), "/obj/", 5) != 0 &&
+		    strncmp(dev.first.second.c_str(), "/dev/", 5) != 0) {
+			PX4_INFO("   %s", dev.first.second.c_str());
 		}
 	}
 
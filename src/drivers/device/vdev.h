@@ -424,6 +424,7 @@ protected:
 
 private:
 	const char	*_devname;		/**< device node name */
+	int		_namespace;		/**< namespace the device is registered in (the creator's) */
 	bool		_registered;		/**< true if device name was registered */
 	uint8_t		_max_pollwaiters; /**< size of the _pollset array */
 	unsigned	_open_count;		/**< number of successful opens */
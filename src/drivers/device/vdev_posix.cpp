@@ -44,6 +44,7 @@
 #include "vfile.h"
 
 #include <hrt_work.h>
+#include <drivers/drv_hrt.h>
 #include <stdlib.h>
 #include <stdio.h>
 #include <string.h>
@@ -53,13 +54,12 @@
 using namespace device;
 
 pthread_mutex_t filemutex = PTHREAD_MUTEX_INITIALIZER;
-px4_sem_t lockstep_sem;
-bool sim_lockstep = false;
 volatile bool sim_delay = false;
 
 extern "C" {
 
-#define PX4_MAX_FD 350
+// file descriptors are shared by all namespaces
+#define PX4_MAX_FD 4096
 	static device::file_t *filemap[PX4_MAX_FD] = {};
 
 	int px4_errno;
@@ -319,39 +319,17 @@ extern "C" {
 		// If any FD can be polled, lock the semaphore and
 		// check for new data
 		if (fd_pollable) {
-			if (timeout > 0) {
-
-				// Get the current time
-				struct timespec ts;
-				// FIXME: check if QURT should probably be using CLOCK_MONOTONIC
-				px4_clock_gettime(CLOCK_REALTIME, &ts);
-
-				// Calculate an absolute time in the future
-				const unsigned billion = (1000 * 1000 * 1000);
-				unsigned tdiff = timeout;
-				uint64_t nsecs = ts.tv_nsec + (tdiff * 1000 * 1000);
-				ts.tv_sec += nsecs / billion;
-				nsecs -= (nsecs / billion) * billion;
-				ts.tv_nsec = nsecs;
-
-				// Execute a blocking wait for that time in the future
-				errno = 0;
-				ret = px4_sem_timedwait(&sem, &ts);
-#ifndef __PX4_DARWIN
-				ret = errno;
-#endif
+			if (timeout != 0) {
+				// Block until the sem is posted or until the timeout has
+				// elapsed in hrt time, which is virtual time in lockstep mode
+				const hrt_abstime deadline = (timeout > 0) ?
+							     hrt_absolute_time() + (hrt_abstime)timeout * 1000 : HRT_ABSTIME_MAX;
 
-				// Ensure ret is negative on failure
-				if (ret > 0) {
-					ret = -ret;
-				}
+				ret = hrt_lockstep_wait(&sem, deadline);
 
 				if (ret && ret != -ETIMEDOUT) {
 					PX4_WARN("%s: px4_poll() sem error", thread_name);
 				}
-
-			} else if (timeout < 0) {
-				px4_sem_wait(&sem);
 			}
 
 			// We have waited now (or not, depending on timeout),
@@ -415,15 +393,27 @@ extern "C" {
 		CDev::showFiles();
 	}
 
-	void px4_enable_sim_lockstep()
+	int px4_usleep(useconds_t usec)
 	{
-		px4_sem_init(&lockstep_sem, 0, 0);
+		if (!hrt_lockstep_enabled()) {
+			return usleep(usec);
+		}
+
+		// sleep in virtual time, until the simulation gets there
+		px4_sem_t sem;
+		px4_sem_init(&sem, 0, 0);
+		px4_sem_setprotocol(&sem, SEM_PRIO_NONE);
 
-		// lockstep_sem use case is a signal
+		hrt_lockstep_wait(&sem, hrt_absolute_time() + usec);
 
-		px4_sem_setprotocol(&lockstep_sem, SEM_PRIO_NONE);
+		px4_sem_destroy(&sem);
+		return 0;
+	}
 
-		sim_lockstep = true;
+	void px4_enable_sim_lockstep()
+	{
+		// time is driven by the simulator from now on
+		hrt_lockstep_enable();
 		sim_delay = false;
 	}
 
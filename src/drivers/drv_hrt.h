@@ -46,6 +46,10 @@
 #include <px4_time.h>
 #include <queue.h>
 
+#ifdef __PX4_POSIX
+#include <px4_sem.h>
+#endif
+
 __BEGIN_DECLS
 
 /**
@@ -75,6 +79,10 @@ typedef struct hrt_call {
 	hrt_abstime		period;
 	hrt_callout		callout;
 	void			*arg;
+#ifdef __PX4_POSIX
+	int			ns;	/**< namespace of the caller, the callout runs in it */
+	unsigned		heap_index;	/**< slot in the callout heap while queued */
+#endif
 } *hrt_call_t;
 
 /**
@@ -191,6 +199,58 @@ __EXPORT extern void	hrt_stop_delay(void);
  */
 __EXPORT extern void	hrt_stop_delay_delta(hrt_abstime delta);
 
+/**
+ * Deadline for hrt_lockstep_wait() that is never reached.
+ */
+#define HRT_ABSTIME_MAX UINT64_MAX
+
+/**
+ * Switch the HRT to lockstep mode.
+ *
+ * From then on hrt_absolute_time() no longer follows the system clock, it only
+ * advances through hrt_lockstep_set_time().
+ */
+__EXPORT extern void	hrt_lockstep_enable(void);
+
+/**
+ * Return true if the HRT is in lockstep mode.
+ */
+__EXPORT extern bool	hrt_lockstep_enabled(void);
+
+/**
+ * Advance the lockstep clock to time.
+ *
+ * Blocks until every task woken in the previous step is waiting in
+ * hrt_lockstep_wait() again, then wakes all waits whose deadline is reached.
+ * The clock never goes back: a time that is not in the future only waits for
+ * the running tasks. Does nothing if lockstep is not enabled.
+ */
+__EXPORT extern void	hrt_lockstep_set_time(hrt_abstime time);
+
+/**
+ * Wait on a semaphore until it is posted or the HRT reaches deadline.
+ *
+ * In lockstep mode the deadline is in virtual time, otherwise this is a timed
+ * wait on the system clock.
+ *
+ * @return 0 if the semaphore was posted, -ETIMEDOUT if the deadline was reached
+ */
+__EXPORT extern int	hrt_lockstep_wait(px4_sem_t *sem, hrt_abstime deadline);
+
+/**
+ * Post a semaphore a task may be blocked on in hrt_lockstep_wait().
+ *
+ * In lockstep mode the woken task counts as part of the current step until it
+ * waits again.
+ */
+__EXPORT extern int	hrt_lockstep_post(px4_sem_t *sem);
+
+/**
+ * Print the lockstep clock and the number of steps that advanced before all
+ * tasks completed (stalls, also in the hrt_lockstep_stall perf counter).
+ */
+__EXPORT extern void	hrt_lockstep_print_status(void);
+
 #endif
 
 __END_DECLS
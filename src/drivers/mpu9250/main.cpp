@@ -130,11 +130,12 @@ struct mpu9250_bus_option {
 #define NUM_BUS_OPTIONS (sizeof(bus_options)/sizeof(bus_options[0]))
 
 
-void	start(enum MPU9250_BUS busid, enum Rotation rotation, bool external_bus);
-bool	start_bus(struct mpu9250_bus_option &bus, enum Rotation rotation, bool external_bus);
+void	start(enum MPU9250_BUS busid, enum Rotation rotation, bool external_bus, bool fifo);
+bool	start_bus(struct mpu9250_bus_option &bus, enum Rotation rotation, bool external_bus, bool fifo);
 struct mpu9250_bus_option &find_bus(enum MPU9250_BUS busid);
 void	stop(enum MPU9250_BUS busid);
 void	test(enum MPU9250_BUS busid);
+void	fifotest(enum MPU9250_BUS busid);
 void	reset(enum MPU9250_BUS busid);
 void	info(enum MPU9250_BUS busid);
 void	regdump(enum MPU9250_BUS busid);
@@ -160,7 +161,7 @@ struct mpu9250_bus_option &find_bus(enum MPU9250_BUS busid)
  * start driver for a specific bus option
  */
 bool
-start_bus(struct mpu9250_bus_option &bus, enum Rotation rotation, bool external)
+start_bus(struct mpu9250_bus_option &bus, enum Rotation rotation, bool external, bool fifo)
 {
 	int fd = -1;
 
@@ -201,6 +202,10 @@ start_bus(struct mpu9250_bus_option &bus, enum Rotation rotation, bool external)
 		return false;
 	}
 
+	if (fifo) {
+		bus.dev->enable_fifo();
+	}
+
 	if (OK != bus.dev->init()) {
 		goto fail;
 	}
@@ -242,7 +247,7 @@ fail:
  * or failed to detect the sensor.
  */
 void
-start(enum MPU9250_BUS busid, enum Rotation rotation, bool external)
+start(enum MPU9250_BUS busid, enum Rotation rotation, bool external, bool fifo)
 {
 
 	bool started = false;
@@ -258,7 +263,7 @@ start(enum MPU9250_BUS busid, enum Rotation rotation, bool external)
 			continue;
 		}
 
-		started |= start_bus(bus_options[i], rotation, external);
+		started |= start_bus(bus_options[i], rotation, external, fifo);
 	}
 
 	exit(started ? 0 : 1);
@@ -394,6 +399,61 @@ test(enum MPU9250_BUS busid)
 	errx(0, "PASS");
 }
 
+/**
+ * Check the report rate and the FIFO sample rate of a driver started
+ * with -f over a few seconds.
+ */
+void
+fifotest(enum MPU9250_BUS busid)
+{
+	struct mpu9250_bus_option &bus = find_bus(busid);
+
+	if (!bus.dev->fifo_enabled()) {
+		errx(1, "FIFO mode not enabled (start with -f)");
+	}
+
+	int fd = open(bus.gyropath, O_RDONLY);
+
+	if (fd < 0) {
+		err(1, "%s open failed", bus.gyropath);
+	}
+
+	int rate = ioctl(fd, SENSORIOCGPOLLRATE, 0);
+	close(fd);
+
+	if (rate <= 0) {
+		errx(1, "not polling");
+	}
+
+	uint32_t reports_start, samples_start;
+	uint32_t reports_end, samples_end;
+	const unsigned duration_s = 5;
+
+	bus.dev->get_fifo_counts(reports_start, samples_start);
+	const hrt_abstime start = hrt_absolute_time();
+	sleep(duration_s);
+	const float elapsed = hrt_elapsed_time(&start) * 1e-6f;
+	bus.dev->get_fifo_counts(reports_end, samples_end);
+
+	const float report_rate = (reports_end - reports_start) / elapsed;
+	const float sample_rate = (samples_end - samples_start) / elapsed;
+
+	warnx("reports: %.1f Hz (expected %d Hz)", (double)report_rate, rate);
+	warnx("FIFO samples: %.1f Hz (expected %d Hz), %.2f per report", (double)sample_rate, MPU9250_FIFO_SAMPLE_RATE,
+	      (double)((report_rate > 0.0f) ? sample_rate / report_rate : 0.0f));
+
+	/* the timer runs slightly faster than the poll rate, duplicates are dropped */
+	if (report_rate < 0.95f * rate || report_rate > 1.05f * rate) {
+		errx(1, "FAIL: report rate");
+	}
+
+	if (sample_rate < 0.95f * MPU9250_FIFO_SAMPLE_RATE || sample_rate > 1.05f * MPU9250_FIFO_SAMPLE_RATE) {
+		errx(1, "FAIL: FIFO sample rate");
+	}
+
+	errx(0, "PASS");
+}
+
 /**
  * Reset the driver.
  */
@@ -479,10 +539,12 @@ testerror(enum MPU9250_BUS busid)
 void
 usage()
 {
-	warnx("missing command: try 'start', 'info', 'test', 'stop',\n'reset', 'regdump', 'testerror'");
+	warnx("missing command: try 'start', 'info', 'test', 'fifotest', 'stop',\n'reset', 'regdump', 'testerror'");
 	warnx("options:");
 	warnx("    -X    (external bus)");
 	warnx("    -R rotation");
+	warnx("    -f    (FIFO mode: publish all samples on sensor_gyro_fifo/sensor_accel_fifo, SPI only)");
+	warnx("          (on-chip DLPF off, sensor_gyro/sensor_accel report the average of the FIFO samples)");
 }
 
 } // namespace
@@ -494,9 +556,10 @@ mpu9250_main(int argc, char *argv[])
 	int ch;
 	bool external = false;
 	enum Rotation rotation = ROTATION_NONE;
+	bool fifo = false;
 
 	/* jump over start/off/etc and look at options first */
-	while ((ch = getopt(argc, argv, "XISsR:")) != EOF) {
+	while ((ch = getopt(argc, argv, "XISsR:f")) != EOF) {
 		switch (ch) {
 		case 'X':
 			busid = MPU9250_BUS_I2C_EXTERNAL;
@@ -518,6 +581,10 @@ mpu9250_main(int argc, char *argv[])
 			rotation = (enum Rotation)atoi(optarg);
 			break;
 
+		case 'f':
+			fifo = true;
+			break;
+
 		default:
 			mpu9250::usage();
 			exit(0);
@@ -533,7 +600,7 @@ mpu9250_main(int argc, char *argv[])
 
 	 */
 	if (!strcmp(verb, "start")) {
-		mpu9250::start(busid, rotation, external);
+		mpu9250::start(busid, rotation, external, fifo);
 	}
 
 	if (!strcmp(verb, "stop")) {
@@ -547,6 +614,13 @@ mpu9250_main(int argc, char *argv[])
 		mpu9250::test(busid);
 	}
 
+	/*
+	 * Check the rates in FIFO mode.
+	 */
+	if (!strcmp(verb, "fifotest")) {
+		mpu9250::fifotest(busid);
+	}
+
 	/*
 	 * Reset the driver.
 	 */
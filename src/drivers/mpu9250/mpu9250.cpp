@@ -106,7 +106,8 @@ const uint8_t MPU9250::_checked_registers[MPU9250_NUM_CHECKED_REGISTERS] = { MPU
 									     MPUREG_ACCEL_CONFIG,
 									     MPUREG_ACCEL_CONFIG2,
 									     MPUREG_INT_ENABLE,
-									     MPUREG_INT_PIN_CFG
+									     MPUREG_INT_PIN_CFG,
+									     MPUREG_FIFO_EN
 									   };
 
 
@@ -138,6 +139,14 @@ MPU9250::MPU9250(device::Device *interface, device::Device *mag_interface, const
 	_gyro_range_scale(0.0f),
 	_gyro_range_rad_s(0.0f),
 	_dlpf_freq(MPU9250_DEFAULT_ONCHIP_FILTER_FREQ),
+	_fifo_enabled(false),
+	_fifo_buffer(nullptr),
+	_report_count(0),
+	_fifo_sample_count(0),
+	_accel_fifo{},
+	_gyro_fifo{},
+	_accel_fifo_topic(nullptr),
+	_gyro_fifo_topic(nullptr),
 	_sample_rate(1000),
 	_accel_reads(perf_alloc(PC_COUNT, "mpu9250_acc_read")),
 	_gyro_reads(perf_alloc(PC_COUNT, "mpu9250_gyro_read")),
@@ -147,6 +156,7 @@ MPU9250::MPU9250(device::Device *interface, device::Device *mag_interface, const
 	_good_transfers(perf_alloc(PC_COUNT, "mpu9250_good_trans")),
 	_reset_retries(perf_alloc(PC_COUNT, "mpu9250_reset")),
 	_duplicates(perf_alloc(PC_COUNT, "mpu9250_dupe")),
+	_fifo_overflows(perf_alloc(PC_COUNT, "mpu9250_fifo_ovf")),
 	_controller_latency_perf(perf_alloc_once(PC_ELAPSED, "ctrl_latency")),
 	_register_wait(0),
 	_reset_wait(0),
@@ -220,6 +230,8 @@ MPU9250::~MPU9250()
 
 	orb_unadvertise(_accel_topic);
 	orb_unadvertise(_gyro->_gyro_topic);
+	orb_unadvertise(_accel_fifo_topic);
+	orb_unadvertise(_gyro_fifo_topic);
 
 	/* delete the gyro subdriver */
 	delete _gyro;
@@ -236,6 +248,10 @@ MPU9250::~MPU9250()
 		delete _gyro_reports;
 	}
 
+	if (_fifo_buffer != nullptr) {
+		delete _fifo_buffer;
+	}
+
 	if (_accel_class_instance != -1) {
 		unregister_class_devname(ACCEL_BASE_DEVICE_PATH, _accel_class_instance);
 	}
@@ -249,6 +265,7 @@ MPU9250::~MPU9250()
 	perf_free(_good_transfers);
 	perf_free(_reset_retries);
 	perf_free(_duplicates);
+	perf_free(_fifo_overflows);
 }
 
 int
@@ -291,6 +308,20 @@ MPU9250::init()
 		return ret;
 	}
 
+	if (_fifo_enabled && is_i2c()) {
+		/* the I2C bus is too slow for the sample rate in FIFO mode */
+		PX4_WARN("FIFO mode needs SPI, disabled");
+		_fifo_enabled = false;
+	}
+
+	if (_fifo_enabled) {
+		_fifo_buffer = new MPUFIFOBuffer;
+
+		if (_fifo_buffer == nullptr) {
+			return ret;
+		}
+	}
+
 	if (reset_mpu() != OK) {
 		PX4_ERR("Exiting! Device failed to take initialization");
 		return ret;
@@ -408,6 +439,23 @@ MPU9250::init()
 		return ret;
 	}
 
+	if (_fifo_enabled) {
+		/* sample blocks, queued so that the sensors module gets all of them */
+		int instance;
+		_accel_fifo.device_id = _device_id.devid;
+		_accel_fifo_topic = orb_advertise_multi_queue(ORB_ID(sensor_accel_fifo), &_accel_fifo, &instance,
+				    (is_external()) ? ORB_PRIO_MAX - 1 : ORB_PRIO_HIGH - 1, sensor_imu_fifo_s::ORB_QUEUE_LENGTH);
+
+		_gyro_fifo.device_id = _gyro->_device_id.devid;
+		_gyro_fifo_topic = orb_advertise_multi_queue(ORB_ID(sensor_gyro_fifo), &_gyro_fifo, &instance,
+				   (is_external()) ? ORB_PRIO_MAX - 1 : ORB_PRIO_HIGH - 1, sensor_imu_fifo_s::ORB_QUEUE_LENGTH);
+
+		if (_accel_fifo_topic == nullptr || _gyro_fifo_topic == nullptr) {
+			PX4_ERR("ADVERT FAIL");
+			return ret;
+		}
+	}
+
 	return ret;
 }
 
@@ -456,7 +504,7 @@ int MPU9250::reset_mpu()
 
 	// Enable I2C bus or Disable I2C bus (recommended on data sheet)
 
-	write_checked_reg(MPUREG_USER_CTRL, is_i2c() ? 0 : BIT_I2C_IF_DIS);
+	write_checked_reg(MPUREG_USER_CTRL, (is_i2c() ? 0 : BIT_I2C_IF_DIS) | (_fifo_enabled ? BIT_I2C_FIFO_EN : 0));
 
 	// SAMPLE RATE
 	_set_sample_rate(_sample_rate);
@@ -464,7 +512,9 @@ int MPU9250::reset_mpu()
 	// FS & DLPF   FS=2000 deg/s, DLPF = 20Hz (low pass filter)
 	// was 90 Hz, but this ruins quality and does not improve the
 	// system response
-	_set_dlpf_filter(MPU9250_DEFAULT_ONCHIP_FILTER_FREQ);
+	// In FIFO mode the DLPF is off (8 kHz gyro sampling) and all samples
+	// are passed on, so that filtering happens downstream without aliasing.
+	_set_dlpf_filter(_fifo_enabled ? 0 : MPU9250_DEFAULT_ONCHIP_FILTER_FREQ);
 
 	// Gyro scale 2000 deg/s ()
 	write_checked_reg(MPUREG_GYRO_CONFIG, BITS_FS_2000DPS);
@@ -499,7 +549,15 @@ int MPU9250::reset_mpu()
 
 	write_checked_reg(MPUREG_INT_PIN_CFG, BIT_INT_ANYRD_2CLEAR | (bypass ? BIT_INT_BYPASS_EN : 0));
 
-	write_checked_reg(MPUREG_ACCEL_CONFIG2, BITS_ACCEL_CONFIG2_41HZ);
+	write_checked_reg(MPUREG_ACCEL_CONFIG2, _fifo_enabled ? BITS_ACCEL_CONFIG2_1130HZ : BITS_ACCEL_CONFIG2_41HZ);
+
+	// FIFO mode: queue accel & gyro samples
+	write_checked_reg(MPUREG_FIFO_EN, _fifo_enabled ?
+			  (BIT_FIFO_EN_GYRO_X | BIT_FIFO_EN_GYRO_Y | BIT_FIFO_EN_GYRO_Z | BIT_FIFO_EN_ACCEL) : 0);
+
+	if (_fifo_enabled) {
+		reset_fifo();
+	}
 
 	uint8_t retries = 3;
 	bool all_ok = false;
@@ -565,6 +623,13 @@ MPU9250::_set_sample_rate(unsigned desired_sample_rate_hz)
 	_sample_rate = 1000 / div;
 }
 
+unsigned
+MPU9250::timer_interval() const
+{
+	/* in FIFO mode every cycle reads all queued samples, there are no duplicates to reject */
+	return _fifo_enabled ? _call_interval : _call_interval - MPU9250_TIMER_REDUCTION;
+}
+
 /*
   set the DLPF filter frequency. This affects both accel and gyro.
  */
@@ -573,6 +638,14 @@ MPU9250::_set_dlpf_filter(uint16_t frequency_hz)
 {
 	uint8_t filter;
 
+	/*
+	   in FIFO mode the DLPF stays off, the FIFO has to run at the
+	   8 kHz gyro rate whatever the sensor ioctls ask for
+	 */
+	if (_fifo_enabled) {
+		frequency_hz = 0;
+	}
+
 	/*
 	   choose next highest filter frequency available
 	 */
@@ -851,7 +924,7 @@ MPU9250::ioctl(struct file *filp, int cmd, unsigned long arg)
 					  them. This prevents aliasing due to a beat between the
 					  stm32 clock and the mpu9250 clock
 					 */
-					_call.period = _call_interval - MPU9250_TIMER_REDUCTION;
+					_call.period = timer_interval();
 
 					/* if we need to start the poll state machine, do it */
 					if (want_start) {
@@ -1159,7 +1232,7 @@ MPU9250::start()
 		/* start polling at the specified rate */
 		hrt_call_every(&_call,
 			       1000,
-			       _call_interval - MPU9250_TIMER_REDUCTION,
+			       timer_interval(),
 			       (hrt_callout)&MPU9250::measure_trampoline, this);
 
 	} else {
@@ -1214,7 +1287,7 @@ MPU9250::cycle()
 			   &_work,
 			   (worker_t)&MPU9250::cycle_trampoline,
 			   this,
-			   USEC2TICK(_call_interval - MPU9250_TIMER_REDUCTION));
+			   USEC2TICK(timer_interval()));
 	}
 }
 #endif
@@ -1405,6 +1478,28 @@ MPU9250::measure()
 		return;
 	}
 
+	if (_fifo_enabled) {
+		/*
+		 * The on-chip DLPF is off, so the registers hold a snapshot of the
+		 * 8 kHz samples which would alias into the reports. Report the
+		 * average of the FIFO samples since the last cycle instead.
+		 */
+		int16_t accel_avg[3];
+		int16_t gyro_avg[3];
+
+		if (measure_fifo(accel_avg, gyro_avg) == 0) {
+			perf_end(_sample_perf);
+			return;
+		}
+
+		report.accel_x = accel_avg[0];
+		report.accel_y = accel_avg[1];
+		report.accel_z = accel_avg[2];
+		report.gyro_x = gyro_avg[0];
+		report.gyro_y = gyro_avg[1];
+		report.gyro_z = gyro_avg[2];
+	}
+
 	/*
 	 * Swap axes and negate y
 	 */
@@ -1530,8 +1625,20 @@ MPU9250::measure()
 	/* return device ID */
 	grb.device_id = _gyro->_device_id.devid;
 
+	/* publish the sample blocks before the reports they belong to */
+	if (_fifo_enabled) {
+		if (accel_notify) {
+			publish_fifo(_accel_fifo, ORB_ID(sensor_accel_fifo), _accel_fifo_topic);
+		}
+
+		if (gyro_notify) {
+			publish_fifo(_gyro_fifo, ORB_ID(sensor_gyro_fifo), _gyro_fifo_topic);
+		}
+	}
+
 	_accel_reports->force(&arb);
 	_gyro_reports->force(&grb);
+	_report_count++;
 
 	/* notify anyone waiting for data */
 	if (accel_notify) {
@@ -1558,6 +1665,134 @@ MPU9250::measure()
 	perf_end(_sample_perf);
 }
 
+unsigned
+MPU9250::measure_fifo(int16_t accel_avg[3], int16_t gyro_avg[3])
+{
+	uint8_t count[2];
+
+	if (OK != _interface->read(MPU9250_SET_SPEED(MPUREG_FIFO_COUNTH, MPU9250_HIGH_BUS_SPEED), count, sizeof(count))) {
+		return 0;
+	}
+
+	unsigned fifo_bytes = ((count[0] & 0x1f) << 8) | count[1];
+
+	if (fifo_bytes > MPU9250_FIFO_SIZE - MPU9250_FIFO_SAMPLE_SIZE) {
+		// the FIFO overflowed (or is about to), and the oldest sample was
+		// partially overwritten: start again at a sample boundary
+		perf_count(_fifo_overflows);
+		reset_fifo();
+		fifo_bytes = 0;
+	}
+
+	unsigned samples = fifo_bytes / MPU9250_FIFO_SAMPLE_SIZE;
+
+	int ret = OK;
+
+	if (samples >= MPU9250_FIFO_MIN_SAMPLES) {
+		/* large enough to be transferred in place, command byte included */
+		ret = _interface->read(MPU9250_SET_SPEED(MPUREG_FIFO_R_W, MPU9250_HIGH_BUS_SPEED), (uint8_t *)_fifo_buffer,
+				       1 + samples * MPU9250_FIFO_SAMPLE_SIZE);
+
+	} else if (samples > 0) {
+		/* shorter than an MPUReport: the interface pads it through its scratch buffer */
+		ret = _interface->read(MPU9250_SET_SPEED(MPUREG_FIFO_R_W, MPU9250_HIGH_BUS_SPEED), _fifo_buffer->data,
+				       samples * MPU9250_FIFO_SAMPLE_SIZE);
+	}
+
+	if (ret != OK) {
+		samples = 0;
+	}
+
+	_fifo_sample_count += samples;
+
+	const hrt_abstime timestamp = hrt_absolute_time();
+	int32_t accel_sum[3] = {};
+	int32_t gyro_sum[3] = {};
+
+	// without DLPF the FIFO runs at the gyro rate, otherwise at the sample rate
+	const float dt = (_dlpf_freq == 0) ? 1e6f / MPU9250_FIFO_SAMPLE_RATE : 1e6f / _sample_rate;
+
+	for (unsigned i = 0; i < samples; i++) {
+		uint8_t *sample = &_fifo_buffer->data[i * MPU9250_FIFO_SAMPLE_SIZE];
+		const hrt_abstime timestamp_sample = timestamp - (hrt_abstime)((samples - 1 - i) * dt);
+
+		for (unsigned axis = 0; axis < 3; axis++) {
+			accel_sum[axis] += int16_t_from_bytes(&sample[axis * 2]);
+			gyro_sum[axis] += int16_t_from_bytes(&sample[6 + axis * 2]);
+		}
+
+		/*
+		 * Swap axes and negate y, apply the rotation and the calibration
+		 * like for the reports in measure().
+		 */
+		float xraw_f = int16_t_from_bytes(&sample[2]);
+		float yraw_f = -int16_t_from_bytes(&sample[0]);
+		float zraw_f = int16_t_from_bytes(&sample[4]);
+
+		rotate_3f(_rotation, xraw_f, yraw_f, zraw_f);
+
+		unsigned n = _accel_fifo.samples++;
+		_accel_fifo.x[n] = ((xraw_f * _accel_range_scale) - _accel_scale.x_offset) * _accel_scale.x_scale;
+		_accel_fifo.y[n] = ((yraw_f * _accel_range_scale) - _accel_scale.y_offset) * _accel_scale.y_scale;
+		_accel_fifo.z[n] = ((zraw_f * _accel_range_scale) - _accel_scale.z_offset) * _accel_scale.z_scale;
+		_accel_fifo.timestamp_sample = timestamp_sample;
+		_accel_fifo.dt = dt;
+
+		xraw_f = int16_t_from_bytes(&sample[8]);
+		yraw_f = -int16_t_from_bytes(&sample[6]);
+		zraw_f = int16_t_from_bytes(&sample[10]);
+
+		rotate_3f(_rotation, xraw_f, yraw_f, zraw_f);
+
+		n = _gyro_fifo.samples++;
+		_gyro_fifo.x[n] = ((xraw_f * _gyro_range_scale) - _gyro_scale.x_offset) * _gyro_scale.x_scale;
+		_gyro_fifo.y[n] = ((yraw_f * _gyro_range_scale) - _gyro_scale.y_offset) * _gyro_scale.y_scale;
+		_gyro_fifo.z[n] = ((zraw_f * _gyro_range_scale) - _gyro_scale.z_offset) * _gyro_scale.z_scale;
+		_gyro_fifo.timestamp_sample = timestamp_sample;
+		_gyro_fifo.dt = dt;
+
+		if (_accel_fifo.samples == sensor_imu_fifo_s::SAMPLES_MAX) {
+			publish_fifo(_accel_fifo, ORB_ID(sensor_accel_fifo), _accel_fifo_topic);
+		}
+
+		if (_gyro_fifo.samples == sensor_imu_fifo_s::SAMPLES_MAX) {
+			publish_fifo(_gyro_fifo, ORB_ID(sensor_gyro_fifo), _gyro_fifo_topic);
+		}
+	}
+
+	if (samples > 0) {
+		// rounded average, still in sensor axes like the registers
+		for (unsigned axis = 0; axis < 3; axis++) {
+			accel_avg[axis] = (int16_t)lroundf((float)accel_sum[axis] / samples);
+			gyro_avg[axis] = (int16_t)lroundf((float)gyro_sum[axis] / samples);
+		}
+	}
+
+	return samples;
+}
+
+void
+MPU9250::publish_fifo(sensor_imu_fifo_s &block, const struct orb_metadata *meta, orb_advert_t &topic)
+{
+	if (block.samples == 0) {
+		return;
+	}
+
+	if (!(_pub_blocked)) {
+		block.timestamp = hrt_absolute_time();
+		orb_publish(meta, topic, &block);
+	}
+
+	block.samples = 0;
+}
+
+void
+MPU9250::reset_fifo()
+{
+	// self-clearing
+	modify_reg(MPUREG_USER_CTRL, 0, BIT_FIFO_RST);
+}
+
 void
 MPU9250::print_info()
 {
@@ -1569,6 +1804,11 @@ MPU9250::print_info()
 	perf_print_counter(_good_transfers);
 	perf_print_counter(_reset_retries);
 	perf_print_counter(_duplicates);
+
+	if (_fifo_enabled) {
+		perf_print_counter(_fifo_overflows);
+	}
+
 	_accel_reports->print_info("accel queue");
 	_gyro_reports->print_info("gyro queue");
 	_mag->_mag_reports->print_info("mag queue");
@@ -49,6 +49,8 @@
 #include <mathlib/math/filter/LowPassFilter2p.hpp>
 #include <lib/conversion/rotation.h>
 
+#include <uORB/topics/sensor_imu_fifo.h>
+
 #include "mag.h"
 #include "gyro.h"
 
@@ -145,6 +147,7 @@
 #define BITS_DLPF_CFG_MASK		0x07
 
 #define BITS_ACCEL_CONFIG2_41HZ		0x03
+#define BITS_ACCEL_CONFIG2_1130HZ	0x08
 
 #define BIT_RAW_RDY_EN			0x01
 #define BIT_INT_ANYRD_2CLEAR		0x10
@@ -177,6 +180,12 @@
 #define BIT_I2C_SLV2_DLY_EN         0x04
 #define BIT_I2C_SLV3_DLY_EN         0x08
 
+#define BIT_FIFO_EN_TEMP            0x80
+#define BIT_FIFO_EN_GYRO_X          0x40
+#define BIT_FIFO_EN_GYRO_Y          0x20
+#define BIT_FIFO_EN_GYRO_Z          0x10
+#define BIT_FIFO_EN_ACCEL           0x08
+
 #define MPU_WHOAMI_9250			0x71
 #define MPU_WHOAMI_6500			0x70
 
@@ -192,6 +201,11 @@
 
 #define MPU9250_ONE_G					9.80665f
 
+/* FIFO mode: accel & gyro (12 bytes per sample) at the gyro rate without DLPF */
+#define MPU9250_FIFO_SIZE				512
+#define MPU9250_FIFO_SAMPLE_SIZE			12
+#define MPU9250_FIFO_SAMPLE_RATE			8000
+
 #define MPUIOCGIS_I2C	(unsigned)(DEVIOCGDEVICEID+100)
 
 
@@ -214,6 +228,19 @@ struct MPUReport {
 };
 #pragma pack(pop)
 
+/**
+ * FIFO transfer. Like MPUReport, the first byte is the command. Transfers
+ * shorter than an MPUReport go to data only, the interface then adds the
+ * command byte in its own scratch buffer.
+ */
+struct MPUFIFOBuffer {
+	uint8_t		cmd;
+	uint8_t		data[MPU9250_FIFO_SIZE / MPU9250_FIFO_SAMPLE_SIZE * MPU9250_FIFO_SAMPLE_SIZE];
+};
+
+/* smallest number of FIFO samples that is transferred in place */
+#define MPU9250_FIFO_MIN_SAMPLES ((sizeof(MPUReport) + MPU9250_FIFO_SAMPLE_SIZE - 1) / MPU9250_FIFO_SAMPLE_SIZE)
+
 #define MPU_MAX_WRITE_BUFFER_SIZE (2)
 
 
@@ -268,6 +295,28 @@ public:
 	// deliberately cause a sensor error
 	void 			test_error();
 
+	/**
+	 * Read all samples from the sensor FIFO and publish them in blocks on
+	 * sensor_gyro_fifo and sensor_accel_fifo. This disables the on-chip
+	 * low pass filter (8 kHz gyro sampling). Must be called before init(),
+	 * SPI only.
+	 *
+	 * sensor_accel and sensor_gyro are then built from the average of the
+	 * FIFO samples read in each cycle (~8 samples at 1 kHz) instead of the
+	 * DLPF output, followed by the usual driver low pass filter. This has
+	 * less delay than the 41 Hz DLPF but lets more noise between 41 Hz and
+	 * the driver filter cutoff through to consumers like mc_att_control.
+	 */
+	void			enable_fifo() { _fifo_enabled = true; }
+
+	bool			fifo_enabled() const { return _fifo_enabled; }
+
+	/**
+	 * Number of reports built and FIFO samples read since the start, to
+	 * check the rates of the FIFO mode.
+	 */
+	void			get_fifo_counts(uint32_t &reports, uint32_t &samples) const { reports = _report_count; samples = _fifo_sample_count; }
+
 protected:
 	Device			*_interface;
 
@@ -313,6 +362,15 @@ private:
 
 	unsigned		_dlpf_freq;
 
+	bool			_fifo_enabled;
+	MPUFIFOBuffer		*_fifo_buffer;
+	uint32_t		_report_count;
+	uint32_t		_fifo_sample_count;
+	sensor_imu_fifo_s	_accel_fifo;
+	sensor_imu_fifo_s	_gyro_fifo;
+	orb_advert_t		_accel_fifo_topic;
+	orb_advert_t		_gyro_fifo_topic;
+
 	unsigned		_sample_rate;
 	perf_counter_t		_accel_reads;
 	perf_counter_t		_gyro_reads;
@@ -322,6 +380,7 @@ private:
 	perf_counter_t		_good_transfers;
 	perf_counter_t		_reset_retries;
 	perf_counter_t		_duplicates;
+	perf_counter_t		_fifo_overflows;
 	perf_counter_t		_controller_latency_perf;
 
 	uint8_t			_register_wait;
@@ -342,7 +401,7 @@ private:
 	// this is used to support runtime checking of key
 	// configuration registers to detect SPI bus errors and sensor
 	// reset
-#define MPU9250_NUM_CHECKED_REGISTERS 11
+#define MPU9250_NUM_CHECKED_REGISTERS 12
 	static const uint8_t	_checked_registers[MPU9250_NUM_CHECKED_REGISTERS];
 	uint8_t			_checked_values[MPU9250_NUM_CHECKED_REGISTERS];
 	uint8_t			_checked_bad[MPU9250_NUM_CHECKED_REGISTERS];
@@ -431,6 +490,27 @@ private:
 	 */
 	void			measure();
 
+	/**
+	 * Read the samples queued in the sensor FIFO into the sample blocks and
+	 * publish the blocks that are full. The caller publishes the partial
+	 * blocks together with the reports.
+	 *
+	 * @param accel_avg	Average of the accel samples read, raw sensor axes.
+	 * @param gyro_avg	Average of the gyro samples read, raw sensor axes.
+	 * @return		Number of samples read, the averages are only set if > 0.
+	 */
+	unsigned		measure_fifo(int16_t accel_avg[3], int16_t gyro_avg[3]);
+
+	/**
+	 * Discard the content of the sensor FIFO.
+	 */
+	void			reset_fifo();
+
+	/**
+	 * Publish a sample block (if not empty) and start a new one.
+	 */
+	void			publish_fifo(sensor_imu_fifo_s &block, const struct orb_metadata *meta, orb_advert_t &topic);
+
 	/**
 	 * Read a register from the mpu
 	 *
@@ -528,6 +608,11 @@ private:
 	 */
 	void _set_dlpf_filter(uint16_t frequency_hz);
 
+	/*
+	  period of the measurement timer, see MPU9250_TIMER_REDUCTION
+	 */
+	unsigned timer_interval() const;
+
 	/*
 	  set sample rate (approximate) - 1kHz to 5Hz
 	*/
@@ -224,11 +224,11 @@ int
 MPU9250_SPI::read(unsigned reg_speed, void *data, unsigned count)
 {
 	/* We want to avoid copying the data of MPUReport: So if the caller
-	 * supplies a buffer not MPUReport in size, it is assume to be a reg or reg 16 read
-	 * and we need to provied the buffer large enough for the callers data
-	 * and our command.
+	 * supplies a buffer not MPUReport in size, it is assume to be a reg, reg 16
+	 * or short FIFO read and we need to provied the buffer large enough for the
+	 * callers data and our command.
 	 */
-	uint8_t cmd[3] = {0, 0, 0};
+	uint8_t cmd[sizeof(MPUReport)] = {};
 
 	uint8_t *pbuff  =  count < sizeof(MPUReport) ? cmd : (uint8_t *) data ;
 
@@ -42,6 +42,7 @@
 #include <px4_config.h>
 #include <px4_posix.h>
 #include <px4_tasks.h>
+#include <px4_module.h>
 #include <unistd.h>
 #include <stdlib.h>
 #include <stdio.h>
@@ -682,6 +683,8 @@ void AttitudeEstimatorQ::update_mag_declination(float new_declination)
 	}
 }
 
+PX4_MODULE_DEPENDENCIES(attitude_estimator_q, "sensors");
+
 int attitude_estimator_q_main(int argc, char *argv[])
 {
 	if (argc < 2) {
@@ -527,6 +527,261 @@ int run_lm_ellipsoid_fit(const float x[], const float y[], const float z[], floa
 	}
 }
 
+void ellipsoid_fit_stats_reset(struct ellipsoid_fit_stats_s *stats)
+{
+	memset(stats, 0, sizeof(*stats));
+}
+
+void ellipsoid_fit_stats_add(struct ellipsoid_fit_stats_s *stats, float x, float y, float z)
+{
+	if (stats->count == 0) {
+		// the first sample is on the ellipsoid surface, so all shifted samples stay within its diameter
+		stats->ref[0] = x;
+		stats->ref[1] = y;
+		stats->ref[2] = z;
+	}
+
+	x -= stats->ref[0];
+	y -= stats->ref[1];
+	z -= stats->ref[2];
+
+	const float xx = x * x;
+	const float yy = y * y;
+	const float zz = z * z;
+	const float d = xx + yy + zz;
+
+	const float D[ellipsoid_fit_stats_dim] = {
+		xx + yy - 2.0f * zz,
+		xx - 2.0f * yy + zz,
+		2.0f * x * y,
+		2.0f * x * z,
+		2.0f * y * z,
+		2.0f * x,
+		2.0f * y,
+		2.0f * z,
+		1.0f
+	};
+
+	unsigned k = 0;
+
+	for (unsigned i = 0; i < ellipsoid_fit_stats_dim; i++) {
+		for (unsigned j = i; j < ellipsoid_fit_stats_dim; j++) {
+			stats->DTD[k++] += D[i] * D[j];
+		}
+
+		stats->DTd[i] += D[i] * d;
+	}
+
+	stats->dTd += d * d;
+	stats->count++;
+}
+
+/// Copy the rows and columns [first, first + n) of D'D into a full n x n matrix
+static void ellipsoid_fit_stats_unpack(const struct ellipsoid_fit_stats_s *stats, unsigned first, unsigned n,
+				       float *A)
+{
+	unsigned k = 0;
+
+	for (unsigned i = 0; i < ellipsoid_fit_stats_dim; i++) {
+		for (unsigned j = i; j < ellipsoid_fit_stats_dim; j++, k++) {
+			if (i >= first && j >= first && i < first + n && j < first + n) {
+				A[(i - first) * n + (j - first)] = stats->DTD[k];
+				A[(j - first) * n + (i - first)] = stats->DTD[k];
+			}
+		}
+	}
+}
+
+/// Relative RMS fit error from the algebraic residual |p|^2 - D(p) * u,
+/// which is about 2 * r * (distance of p to the surface) near the surface.
+static float ellipsoid_fit_stats_error(const struct ellipsoid_fit_stats_s *stats, unsigned first, unsigned n,
+				       const float *A, const float *u, float radius_sq)
+{
+	float ssr = stats->dTd;
+
+	for (unsigned i = 0; i < n; i++) {
+		float Au = 0.0f;
+
+		for (unsigned j = 0; j < n; j++) {
+			Au += A[i * n + j] * u[j];
+		}
+
+		ssr += u[i] * (Au - 2.0f * stats->DTd[first + i]);
+	}
+
+	// cancellation can make the sum slightly negative for near perfect fits
+	ssr = (ssr > 0.0f) ? ssr : 0.0f;
+
+	return sqrtf(ssr / stats->count) / (2.0f * radius_sq);
+}
+
+static bool inverse3x3(const float m[9], float inv[9])
+{
+	inv[0] = m[4] * m[8] - m[5] * m[7];
+	inv[1] = m[2] * m[7] - m[1] * m[8];
+	inv[2] = m[1] * m[5] - m[2] * m[4];
+	inv[3] = m[5] * m[6] - m[3] * m[8];
+	inv[4] = m[0] * m[8] - m[2] * m[6];
+	inv[5] = m[2] * m[3] - m[0] * m[5];
+	inv[6] = m[3] * m[7] - m[4] * m[6];
+	inv[7] = m[1] * m[6] - m[0] * m[7];
+	inv[8] = m[0] * m[4] - m[1] * m[3];
+
+	const float det = m[0] * inv[0] + m[1] * inv[3] + m[2] * inv[6];
+
+	if (fabsf(det) < FLT_EPSILON) {
+		return false;
+	}
+
+	for (unsigned i = 0; i < 9; i++) {
+		inv[i] /= det;
+	}
+
+	return true;
+}
+
+int ellipsoid_fit_stats_solve_sphere(const struct ellipsoid_fit_stats_s *stats, float *offset_x, float *offset_y,
+				     float *offset_z, float *sphere_radius, float *fit_error)
+{
+	// the sphere only uses the regressors [2x, 2y, 2z, 1]
+	const unsigned first = ellipsoid_fit_stats_dim - 4;
+	float A[16];
+	float A_inv[16];
+
+	if (stats->count < 4) {
+		return 1;
+	}
+
+	ellipsoid_fit_stats_unpack(stats, first, 4, A);
+
+	if (!inverse4x4(A, A_inv)) {
+		return 1;
+	}
+
+	float u[4] = {};
+
+	for (unsigned i = 0; i < 4; i++) {
+		for (unsigned j = 0; j < 4; j++) {
+			u[i] += A_inv[i * 4 + j] * stats->DTd[first + j];
+		}
+	}
+
+	const float radius_sq = u[3] + u[0] * u[0] + u[1] * u[1] + u[2] * u[2];
+
+	if (!PX4_ISFINITE(radius_sq) || radius_sq <= 0.0f) {
+		return 1;
+	}
+
+	*offset_x = stats->ref[0] + u[0];
+	*offset_y = stats->ref[1] + u[1];
+	*offset_z = stats->ref[2] + u[2];
+	*sphere_radius = sqrtf(radius_sq);
+	*fit_error = ellipsoid_fit_stats_error(stats, first, 4, A, u, radius_sq);
+
+	return 0;
+}
+
+int ellipsoid_fit_stats_solve(const struct ellipsoid_fit_stats_s *stats, float *offset_x, float *offset_y,
+			      float *offset_z, float *sphere_radius, float *diag_x, float *diag_y, float *diag_z,
+			      float *offdiag_x, float *offdiag_y, float *offdiag_z, float *fit_error)
+{
+	const unsigned n = ellipsoid_fit_stats_dim;
+	float A[n * n];
+	float A_inv[n * n];
+
+	if (stats->count < n) {
+		return 1;
+	}
+
+	ellipsoid_fit_stats_unpack(stats, 0, n, A);
+
+	if (!mat_inverse(A, A_inv, n)) {
+		return 1;
+	}
+
+	float u[n] = {};
+
+	for (unsigned i = 0; i < n; i++) {
+		for (unsigned j = 0; j < n; j++) {
+			u[i] += A_inv[i * n + j] * stats->DTd[j];
+		}
+	}
+
+	// ellipsoid (p - c)' * M * (p - c) = radius^2 with trace(M) = 3
+	const float M[9] = {
+		1.0f - u[0] - u[1], -u[2], -u[3],
+		-u[2], 1.0f - u[0] + 2.0f * u[1], -u[4],
+		-u[3], -u[4], 1.0f + 2.0f * u[0] - u[1]
+	};
+
+	const float det_M = M[0] * (M[4] * M[8] - M[5] * M[7]) - M[1] * (M[3] * M[8] - M[5] * M[6])
+			    + M[2] * (M[3] * M[7] - M[4] * M[6]);
+
+	// M must be positive definite (Sylvester's criterion), otherwise the quadric is no ellipsoid
+	if (!(M[0] > 0.0f && M[0] * M[4] - M[1] * M[3] > 0.0f && det_M > 0.0f)) {
+		return 1;
+	}
+
+	float M_inv[9];
+
+	if (!inverse3x3(M, M_inv)) {
+		return 1;
+	}
+
+	float c[3] = {};
+
+	for (unsigned i = 0; i < 3; i++) {
+		for (unsigned j = 0; j < 3; j++) {
+			c[i] += M_inv[i * 3 + j] * u[5 + j];
+		}
+	}
+
+	const float radius_sq = u[8] + c[0] * u[5] + c[1] * u[6] + c[2] * u[7];
+
+	if (!PX4_ISFINITE(radius_sq) || radius_sq <= 0.0f) {
+		return 1;
+	}
+
+	// T = sqrt(M) using the Denman-Beavers iteration, M is close to identity for any real mag
+	float Y[9];
+	float Z[9] = {1.0f, 0.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 0.0f, 1.0f};
+	memcpy(Y, M, sizeof(Y));
+
+	for (unsigned iter = 0; iter < 10; iter++) {
+		float Y_inv[9];
+		float Z_inv[9];
+
+		if (!inverse3x3(Y, Y_inv) || !inverse3x3(Z, Z_inv)) {
+			return 1;
+		}
+
+		for (unsigned i = 0; i < 9; i++) {
+			Y[i] = 0.5f * (Y[i] + Z_inv[i]);
+			Z[i] = 0.5f * (Z[i] + Y_inv[i]);
+		}
+	}
+
+	for (unsigned i = 0; i < 9; i++) {
+		if (!PX4_ISFINITE(Y[i])) {
+			return 1;
+		}
+	}
+
+	*offset_x = stats->ref[0] + c[0];
+	*offset_y = stats->ref[1] + c[1];
+	*offset_z = stats->ref[2] + c[2];
+	*sphere_radius = sqrtf(radius_sq);
+	*diag_x = Y[0];
+	*diag_y = Y[4];
+	*diag_z = Y[8];
+	*offdiag_x = 0.5f * (Y[1] + Y[3]);
+	*offdiag_y = 0.5f * (Y[2] + Y[6]);
+	*offdiag_z = 0.5f * (Y[5] + Y[7]);
+	*fit_error = ellipsoid_fit_stats_error(stats, 0, n, A, u, radius_sq);
+
+	return 0;
+}
+
 enum detect_orientation_return detect_orientation(orb_advert_t *mavlink_log_pub, int cancel_sub, int accel_sub,
 		bool lenient_still_position)
 {
@@ -72,6 +72,62 @@ int run_lm_ellipsoid_fit(const float x[], const float y[], const float z[], floa
 bool inverse4x4(float m[], float invOut[]);
 bool mat_inverse(float* A, float* inv, uint8_t n);
 
+/// Number of regressors of the streaming ellipsoid fit
+static const unsigned ellipsoid_fit_stats_dim = 9;
+
+/// Sufficient statistics of a streaming linear least-squares ellipsoid fit.
+///
+/// Every sample p is fitted to |p|^2 = D(p) * u, where the regressor D(p) =
+/// [x^2+y^2-2z^2, x^2-2y^2+z^2, 2xy, 2xz, 2yz, 2x, 2y, 2z, 1] describes a general
+/// ellipsoid with the trace of its shape matrix fixed to 3. Only D'D, D'|p|^2 and
+/// the sum of |p|^4 are kept, so memory is constant and adding a sample is O(1).
+/// The last four regressors on their own describe a sphere, so the same
+/// statistics also yield a sphere fit.
+struct ellipsoid_fit_stats_s {
+	float ref[3];		///< reference sample subtracted from all samples for numerical conditioning
+	float DTD[ellipsoid_fit_stats_dim * (ellipsoid_fit_stats_dim + 1) / 2];	///< upper triangle of D'D, row major
+	float DTd[ellipsoid_fit_stats_dim];	///< D'|p|^2
+	float dTd;		///< sum of |p|^4
+	unsigned count;		///< number of samples
+};
+
+/// Clear all statistics
+void ellipsoid_fit_stats_reset(struct ellipsoid_fit_stats_s *stats);
+
+/// Add a sample to the statistics, O(1) in time and memory
+void ellipsoid_fit_stats_add(struct ellipsoid_fit_stats_s *stats, float x, float y, float z);
+
+/**
+ * Sphere fit from streaming statistics.
+ *
+ * @param stats accumulated statistics, at least 4 samples
+ * @param offset_x coordinate of the sphere center on the X axis
+ * @param offset_y coordinate of the sphere center on the Y axis
+ * @param offset_z coordinate of the sphere center on the Z axis
+ * @param sphere_radius sphere radius
+ * @param fit_error RMS distance of the samples to the sphere relative to the radius
+ *
+ * @return 0 on success, 1 on failure
+ */
+int ellipsoid_fit_stats_solve_sphere(const struct ellipsoid_fit_stats_s *stats, float *offset_x, float *offset_y,
+				     float *offset_z, float *sphere_radius, float *fit_error);
+
+/**
+ * Ellipsoid fit from streaming statistics.
+ *
+ * The result uses the same model as ellipsoid_fit_least_squares():
+ * |T * (p - offset)| = sphere_radius with the symmetric matrix
+ * T = [diag_x offdiag_x offdiag_y; offdiag_x diag_y offdiag_z; offdiag_y offdiag_z diag_z].
+ *
+ * @param stats accumulated statistics, at least 9 samples spanning more than one plane
+ * @param fit_error RMS distance of the samples to the ellipsoid relative to the radius
+ *
+ * @return 0 on success, 1 on failure
+ */
+int ellipsoid_fit_stats_solve(const struct ellipsoid_fit_stats_s *stats, float *offset_x, float *offset_y,
+			      float *offset_z, float *sphere_radius, float *diag_x, float *diag_y, float *diag_z,
+			      float *offdiag_x, float *offdiag_y, float *offdiag_z, float *fit_error);
+
 // FIXME: Change the name
 static const unsigned max_accel_sens = 3;
 
@@ -73,6 +73,7 @@
 #include <px4_shutdown.h>
 #include <px4_tasks.h>
 #include <px4_time.h>
+#include <px4_module.h>
 #include <systemlib/circuit_breaker.h>
 #include <systemlib/err.h>
 #include <systemlib/mavlink_log.h>
@@ -371,6 +372,8 @@ static int power_button_state_notification_cb(board_power_button_state_notificat
 	return ret;
 }
 
+PX4_MODULE_DEPENDENCIES(commander, "sensors");
+
 int commander_main(int argc, char *argv[])
 {
 	if (argc < 2) {
@@ -1779,7 +1782,7 @@ int commander_thread_main(int argc, char *argv[])
 	(void)pthread_attr_setschedparam(&commander_low_prio_attr, &param);
 #endif
 
-	pthread_create(&commander_low_prio_thread, &commander_low_prio_attr, commander_low_prio_loop, nullptr);
+	px4_pthread_create(&commander_low_prio_thread, &commander_low_prio_attr, commander_low_prio_loop, nullptr);
 	pthread_attr_destroy(&commander_low_prio_attr);
 
 	arm_auth_init(&mavlink_log_pub, &status.system_id);
@@ -3205,7 +3208,7 @@ int commander_thread_main(int argc, char *argv[])
 
 		arm_auth_update(now);
 
-		usleep(COMMANDER_MONITORING_INTERVAL);
+		px4_usleep(COMMANDER_MONITORING_INTERVAL);
 	}
 
 	/* wait for threads to complete */
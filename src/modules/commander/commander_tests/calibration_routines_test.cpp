@@ -0,0 +1,178 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2017 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/**
+ * @file calibration_routines_test.cpp
+ * Streaming sphere and ellipsoid fit unit test.
+ */
+
+#include "calibration_routines_test.h"
+
+#include <px4_defines.h>
+#include <math.h>
+#include <stdint.h>
+#include <uORB/uORB.h>
+#include <unit_test.h>
+
+#include "../calibration_routines.h"
+
+class CalibrationRoutinesTest : public UnitTest
+{
+public:
+	virtual bool run_tests();
+
+private:
+	bool sphereFitTest();
+	bool ellipsoidFitTest();
+
+	/**
+	 * Fill the statistics with samples covering the whole sphere, distorted by
+	 * the soft iron matrix and shifted by the offset (hard iron).
+	 */
+	void add_samples(ellipsoid_fit_stats_s &stats, const float soft_iron[9]);
+
+	static constexpr unsigned _elevations = 12;
+	static constexpr unsigned _azimuths = 24;
+	static constexpr float _radius = 0.45f;
+	const float _offset[3] = {0.35f, -0.8f, 0.12f};
+};
+
+constexpr float CalibrationRoutinesTest::_radius;
+
+void CalibrationRoutinesTest::add_samples(ellipsoid_fit_stats_s &stats, const float soft_iron[9])
+{
+	ellipsoid_fit_stats_reset(&stats);
+
+	for (unsigned e = 0; e < _elevations; e++) {
+		const float elevation = M_PI_F * ((e + 0.5f) / _elevations - 0.5f);
+
+		for (unsigned a = 0; a < _azimuths; a++) {
+			const float azimuth = 2.0f * M_PI_F * a / _azimuths;
+			const float v[3] = {
+				_radius * cosf(elevation) * cosf(azimuth),
+				_radius * cosf(elevation) * sinf(azimuth),
+				_radius * sinf(elevation)
+			};
+
+			float p[3];
+
+			for (unsigned i = 0; i < 3; i++) {
+				p[i] = _offset[i] + soft_iron[i * 3 + 0] * v[0] + soft_iron[i * 3 + 1] * v[1] + soft_iron[i * 3 + 2] * v[2];
+			}
+
+			ellipsoid_fit_stats_add(&stats, p[0], p[1], p[2]);
+		}
+	}
+}
+
+bool CalibrationRoutinesTest::sphereFitTest()
+{
+	const float identity[9] = {1.0f, 0.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 0.0f, 1.0f};
+	ellipsoid_fit_stats_s stats;
+	add_samples(stats, identity);
+
+	ut_compare("sample count", stats.count, _elevations * _azimuths);
+
+	float offset[3];
+	float radius;
+	float fit_error;
+	ut_assert_true(ellipsoid_fit_stats_solve_sphere(&stats, &offset[0], &offset[1], &offset[2], &radius, &fit_error) == 0);
+
+	for (unsigned i = 0; i < 3; i++) {
+		ut_assert("sphere offset", fabsf(offset[i] - _offset[i]) < 1e-3f);
+	}
+
+	ut_assert("sphere radius", fabsf(radius - _radius) < 1e-3f);
+	ut_assert("sphere fit error", fit_error < 1e-2f);
+
+	return true;
+}
+
+bool CalibrationRoutinesTest::ellipsoidFitTest()
+{
+	// raw = offset + soft_iron * field, so the calibration has to recover inverse(soft_iron)
+	const float soft_iron[9] = {
+		1.05f, 0.03f, -0.02f,
+		0.03f, 0.95f, 0.01f,
+		-0.02f, 0.01f, 1.0f
+	};
+
+	ellipsoid_fit_stats_s stats;
+	add_samples(stats, soft_iron);
+
+	float offset[3];
+	float radius;
+	float diag[3];
+	float offdiag[3];
+	float fit_error;
+	ut_assert_true(ellipsoid_fit_stats_solve(&stats, &offset[0], &offset[1], &offset[2], &radius,
+			&diag[0], &diag[1], &diag[2], &offdiag[0], &offdiag[1], &offdiag[2], &fit_error) == 0);
+
+	for (unsigned i = 0; i < 3; i++) {
+		ut_assert("ellipsoid offset", fabsf(offset[i] - _offset[i]) < 1e-3f);
+	}
+
+	ut_assert("ellipsoid fit error", fit_error < 1e-2f);
+
+	// the fit is only defined up to a common scale of T and radius: T * soft_iron * _radius / radius == I
+	const float T[9] = {
+		diag[0], offdiag[0], offdiag[1],
+		offdiag[0], diag[1], offdiag[2],
+		offdiag[1], offdiag[2], diag[2]
+	};
+
+	for (unsigned i = 0; i < 3; i++) {
+		for (unsigned j = 0; j < 3; j++) {
+			float product = 0.0f;
+
+			for (unsigned k = 0; k < 3; k++) {
+				product += T[i * 3 + k] * soft_iron[k * 3 + j];
+			}
+
+			product *= _radius / radius;
+			ut_assert("soft iron correction", fabsf(product - ((i == j) ? 1.0f : 0.0f)) < 2e-3f);
+		}
+	}
+
+	return true;
+}
+
+bool CalibrationRoutinesTest::run_tests()
+{
+	ut_run_test(sphereFitTest);
+	ut_run_test(ellipsoidFitTest);
+
+	return (_tests_failed == 0);
+}
+
+ut_declare_test(calibrationRoutinesTest, CalibrationRoutinesTest)
@@ -51,6 +51,7 @@
 #include <string.h>
 #include <poll.h>
 #include <cmath>
+#include <float.h>
 #include <fcntl.h>
 #include <drivers/drv_hrt.h>
 #include <drivers/drv_accel.h>
@@ -69,6 +70,10 @@ static unsigned int calibration_sides = 6;			///< The total number of sides
 static constexpr unsigned int calibration_total_points = 240;		///< The total points per magnetometer
 static constexpr unsigned int calibraton_duration_seconds = 42; 	///< The total duration the routine is allowed to take
 
+/// Sample directions are binned on a cube map with mag_bins_per_face^2 bins per face
+static constexpr unsigned mag_bins_per_face = 4;
+static constexpr unsigned mag_bin_count = 6 * mag_bins_per_face * mag_bins_per_face;
+
 static constexpr float MAG_MAX_OFFSET_LEN =
 	1.3f;	///< The maximum measurement range is ~1.9 Ga, the earth field is ~0.6 Ga, so an offset larger than ~1.3 Ga means the mag will saturate in some directions.
 
@@ -80,6 +85,18 @@ static unsigned _last_mag_progress = 0;
 
 calibrate_return mag_calibrate_all(orb_advert_t *mavlink_log_pub);
 
+/// Constant size fit state of a single mag, replaces storing all samples
+typedef struct {
+	struct ellipsoid_fit_stats_s	stats;		///< streaming fit statistics
+	float		last_sample[3];			///< last accepted sample
+	float		side_sum[3];			///< sum of the samples accepted on the current side
+	unsigned	side_count;			///< number of samples accepted on the current side
+	float		center[3];			///< fitted center, once available
+	bool		center_fitted;			///< false until enough sides are collected to fit a center
+	uint8_t		bin_count[mag_bin_count];	///< samples per direction bin on the current side
+	bool		bin_visited[mag_bin_count];	///< direction bins around the fitted center holding samples
+} mag_fit_state_t;
+
 /// Data passed to calibration worker routine
 typedef struct  {
 	orb_advert_t	*mavlink_log_pub;
@@ -88,11 +105,8 @@ typedef struct  {
 	unsigned int	calibration_points_perside;
 	unsigned int	calibration_interval_perside_seconds;
 	uint64_t	calibration_interval_perside_useconds;
-	unsigned int	calibration_counter_total[max_mags];
 	bool		side_data_collected[detect_orientation_side_count];
-	float		*x[max_mags];
-	float		*y[max_mags];
-	float		*z[max_mags];
+	mag_fit_state_t	*fit[max_mags];
 } mag_worker_data_t;
 
 
@@ -262,23 +276,167 @@ int do_mag_calibration(orb_advert_t *mavlink_log_pub)
 	return result;
 }
 
-static bool reject_sample(float sx, float sy, float sz, float x[], float y[], float z[], unsigned count,
-			  unsigned max_count)
+// Returns the cube map bin of a direction
+static unsigned direction_bin(float x, float y, float z)
+{
+	const float ax = fabsf(x);
+	const float ay = fabsf(y);
+	const float az = fabsf(z);
+	unsigned face;
+	float major, u, v;
+
+	if (ax >= ay && ax >= az) {
+		face = (x >= 0.0f) ? 0 : 1;
+		major = ax;
+		u = y;
+		v = z;
+
+	} else if (ay >= az) {
+		face = (y >= 0.0f) ? 2 : 3;
+		major = ay;
+		u = x;
+		v = z;
+
+	} else {
+		face = (z >= 0.0f) ? 4 : 5;
+		major = az;
+		u = x;
+		v = y;
+	}
+
+	if (major < FLT_EPSILON) {
+		return 0;
+	}
+
+	// u / major and v / major are within [-1, 1]
+	const float scale = 0.5f * mag_bins_per_face / major;
+	unsigned iu = (unsigned)((u + major) * scale);
+	unsigned iv = (unsigned)((v + major) * scale);
+	iu = (iu < mag_bins_per_face) ? iu : mag_bins_per_face - 1;
+	iv = (iv < mag_bins_per_face) ? iv : mag_bins_per_face - 1;
+
+	return (face * mag_bins_per_face + iu) * mag_bins_per_face + iv;
+}
+
+// Resets the per side sample binning
+static void start_side(mag_fit_state_t *fit)
+{
+	memset(fit->side_sum, 0, sizeof(fit->side_sum));
+	fit->side_count = 0;
+	memset(fit->bin_count, 0, sizeof(fit->bin_count));
+}
+
+// Samples are binned by their direction from the fitted center once enough sides are
+// collected. Before, the samples of a side lie on a circle and are binned around its
+// running mean, which spreads them over the bins around the circle from the first sample on.
+static bool sample_bin(const mag_fit_state_t *fit, const float sample[3], unsigned &bin)
 {
-	float min_sample_dist = fabsf(5.4f * mag_sphere_radius / sqrtf(max_count)) / 3.0f;
+	float center[3];
 
-	for (size_t i = 0; i < count; i++) {
-		float dx = sx - x[i];
-		float dy = sy - y[i];
-		float dz = sz - z[i];
-		float dist = sqrtf(dx * dx + dy * dy + dz * dz);
+	if (fit->center_fitted) {
+		memcpy(center, fit->center, sizeof(center));
 
-		if (dist < min_sample_dist) {
-			return true;
+	} else if (fit->side_count > 0) {
+		for (unsigned i = 0; i < 3; i++) {
+			center[i] = fit->side_sum[i] / fit->side_count;
 		}
+
+	} else {
+		return false;
 	}
 
-	return false;
+	bin = direction_bin(sample[0] - center[0], sample[1] - center[1], sample[2] - center[2]);
+	return true;
+}
+
+// Rejects samples too close to the previously accepted one (vehicle not rotating)
+// and samples in a direction which already holds its share of samples.
+// Constant time, in contrast to comparing against every stored sample.
+static bool reject_sample(const mag_fit_state_t *fit, const float sample[3], unsigned max_count)
+{
+	if (fit->stats.count == 0) {
+		return false;
+	}
+
+	const float min_sample_dist = fabsf(5.4f * mag_sphere_radius / sqrtf(max_count)) / 3.0f;
+	const float dx = sample[0] - fit->last_sample[0];
+	const float dy = sample[1] - fit->last_sample[1];
+	const float dz = sample[2] - fit->last_sample[2];
+
+	if (sqrtf(dx * dx + dy * dy + dz * dz) < min_sample_dist) {
+		return true;
+	}
+
+	const unsigned bin_max = 1 + 2 * max_count / mag_bin_count;
+	unsigned bin;
+
+	return sample_bin(fit, sample, bin) && fit->bin_count[bin] >= bin_max;
+}
+
+static void accept_sample(mag_fit_state_t *fit, const float sample[3])
+{
+	unsigned bin;
+
+	if (sample_bin(fit, sample, bin)) {
+		if (fit->bin_count[bin] < UINT8_MAX) {
+			fit->bin_count[bin]++;
+		}
+
+		fit->bin_visited[bin] = fit->bin_visited[bin] || fit->center_fitted;
+	}
+
+	for (unsigned i = 0; i < 3; i++) {
+		fit->side_sum[i] += sample[i];
+	}
+
+	fit->side_count++;
+
+	ellipsoid_fit_stats_add(&fit->stats, sample[0], sample[1], sample[2]);
+	memcpy(fit->last_sample, sample, sizeof(fit->last_sample));
+}
+
+// Updates the center estimate and reports the fit quality of the samples collected so far
+static void update_fit_feedback(mag_worker_data_t *worker_data)
+{
+	// samples of a single side lie on a circle, which does not determine the center
+	if (worker_data->done_count < 2) {
+		return;
+	}
+
+	for (unsigned cur_mag = 0; cur_mag < max_mags; cur_mag++) {
+		if (worker_data->sub_mag[cur_mag] < 0 || device_ids[cur_mag] == 0) {
+			continue;
+		}
+
+		mag_fit_state_t *fit = worker_data->fit[cur_mag];
+		float radius;
+		float fit_error;
+
+		if (ellipsoid_fit_stats_solve_sphere(&fit->stats, &fit->center[0], &fit->center[1], &fit->center[2],
+						     &radius, &fit_error) != 0) {
+			continue;
+		}
+
+		if (fit->center_fitted) {
+			// coverage of the sides collected since the first center fit
+			unsigned bins_used = 0;
+
+			for (unsigned bin = 0; bin < mag_bin_count; bin++) {
+				if (fit->bin_visited[bin]) {
+					bins_used++;
+				}
+			}
+
+			calibration_log_info(worker_data->mavlink_log_pub, "[cal] mag #%u fit error: %.1f%%, coverage: %u%%",
+					     cur_mag, (double)(100.0f * fit_error), 100 * bins_used / mag_bin_count);
+
+		} else {
+			calibration_log_info(worker_data->mavlink_log_pub, "[cal] mag #%u fit error: %.1f%%",
+					     cur_mag, (double)(100.0f * fit_error));
+		}
+
+		fit->center_fitted = true;
+	}
 }
 
 static unsigned progress_percentage(mag_worker_data_t *worker_data)
@@ -420,6 +578,10 @@ static calibrate_return mag_calibration_worker(detect_orientation_return orienta
 
 	calibration_counter_side = 0;
 
+	for (size_t cur_mag = 0; cur_mag < max_mags; cur_mag++) {
+		start_side(worker_data->fit[cur_mag]);
+	}
+
 	while (hrt_absolute_time() < calibration_deadline &&
 	       calibration_counter_side < worker_data->calibration_points_perside) {
 
@@ -444,39 +606,34 @@ static calibrate_return mag_calibration_worker(detect_orientation_return orienta
 
 		if (poll_ret > 0) {
 
-			int prev_count[max_mags];
+			float sample[max_mags][3];
 			bool rejected = false;
 
 			for (size_t cur_mag = 0; cur_mag < max_mags; cur_mag++) {
 
-				prev_count[cur_mag] = worker_data->calibration_counter_total[cur_mag];
-
 				if (worker_data->sub_mag[cur_mag] >= 0) {
 					struct mag_report mag;
 
 					orb_copy(ORB_ID(sensor_mag), worker_data->sub_mag[cur_mag], &mag);
 
+					sample[cur_mag][0] = mag.x;
+					sample[cur_mag][1] = mag.y;
+					sample[cur_mag][2] = mag.z;
+
 					// Check if this measurement is good to go in
-					rejected = rejected || reject_sample(mag.x, mag.y, mag.z,
-									     worker_data->x[cur_mag], worker_data->y[cur_mag], worker_data->z[cur_mag],
-									     worker_data->calibration_counter_total[cur_mag],
+					rejected = rejected || reject_sample(worker_data->fit[cur_mag], sample[cur_mag],
 									     calibration_sides * worker_data->calibration_points_perside);
-
-					worker_data->x[cur_mag][worker_data->calibration_counter_total[cur_mag]] = mag.x;
-					worker_data->y[cur_mag][worker_data->calibration_counter_total[cur_mag]] = mag.y;
-					worker_data->z[cur_mag][worker_data->calibration_counter_total[cur_mag]] = mag.z;
-					worker_data->calibration_counter_total[cur_mag]++;
 				}
 			}
 
-			// Keep calibration of all mags in lockstep
-			if (rejected) {
-				// Reset counts, since one of the mags rejected the measurement
+			// Keep calibration of all mags in lockstep, only add the measurement if no mag rejected it
+			if (!rejected) {
 				for (size_t cur_mag = 0; cur_mag < max_mags; cur_mag++) {
-					worker_data->calibration_counter_total[cur_mag] = prev_count[cur_mag];
+					if (worker_data->sub_mag[cur_mag] >= 0) {
+						accept_sample(worker_data->fit[cur_mag], sample[cur_mag]);
+					}
 				}
 
-			} else {
 				calibration_counter_side++;
 
 				unsigned new_progress = progress_percentage(worker_data) +
@@ -510,6 +667,7 @@ static calibrate_return mag_calibration_worker(detect_orientation_return orienta
 				     detect_orientation_str(orientation));
 
 		worker_data->done_count++;
+		update_fit_feedback(worker_data);
 		usleep(20000);
 		calibration_log_info(worker_data->mavlink_log_pub, CAL_QGC_PROGRESS_MSG, progress_percentage(worker_data));
 	}
@@ -559,24 +717,22 @@ calibrate_return mag_calibrate_all(orb_advert_t *mavlink_log_pub)
 		worker_data.sub_mag[cur_mag] = -1;
 
 		// Initialize to no memory allocated
-		worker_data.x[cur_mag] = nullptr;
-		worker_data.y[cur_mag] = nullptr;
-		worker_data.z[cur_mag] = nullptr;
-		worker_data.calibration_counter_total[cur_mag] = 0;
+		worker_data.fit[cur_mag] = nullptr;
 	}
 
-	const unsigned int calibration_points_maxcount = calibration_sides * worker_data.calibration_points_perside;
-
 	char str[30];
 
 	for (size_t cur_mag = 0; cur_mag < max_mags; cur_mag++) {
-		worker_data.x[cur_mag] = reinterpret_cast<float *>(malloc(sizeof(float) * calibration_points_maxcount));
-		worker_data.y[cur_mag] = reinterpret_cast<float *>(malloc(sizeof(float) * calibration_points_maxcount));
-		worker_data.z[cur_mag] = reinterpret_cast<float *>(malloc(sizeof(float) * calibration_points_maxcount));
+		worker_data.fit[cur_mag] = reinterpret_cast<mag_fit_state_t *>(malloc(sizeof(mag_fit_state_t)));
 
-		if (worker_data.x[cur_mag] == nullptr || worker_data.y[cur_mag] == nullptr || worker_data.z[cur_mag] == nullptr) {
+		if (worker_data.fit[cur_mag] == nullptr) {
 			calibration_log_critical(mavlink_log_pub, "[cal] ERROR: out of memory");
 			result = calibrate_return_error;
+
+		} else {
+			// No samples and no fitted center yet
+			memset(worker_data.fit[cur_mag], 0, sizeof(mag_fit_state_t));
+			ellipsoid_fit_stats_reset(&worker_data.fit[cur_mag]->stats);
 		}
 	}
 
@@ -714,13 +870,21 @@ calibrate_return mag_calibrate_all(orb_advert_t *mavlink_log_pub)
 			if (device_ids[cur_mag] != 0) {
 				// Mag in this slot is available and we should have values for it to calibrate
 
-				ellipsoid_fit_least_squares(worker_data.x[cur_mag], worker_data.y[cur_mag], worker_data.z[cur_mag],
-							    worker_data.calibration_counter_total[cur_mag],
-							    100, 0.0f,
-							    &sphere_x[cur_mag], &sphere_y[cur_mag], &sphere_z[cur_mag],
-							    &sphere_radius[cur_mag],
-							    &diag_x[cur_mag], &diag_y[cur_mag], &diag_z[cur_mag],
-							    &offdiag_x[cur_mag], &offdiag_y[cur_mag], &offdiag_z[cur_mag]);
+				float fit_error = NAN;
+
+				if (ellipsoid_fit_stats_solve(&worker_data.fit[cur_mag]->stats,
+							      &sphere_x[cur_mag], &sphere_y[cur_mag], &sphere_z[cur_mag],
+							      &sphere_radius[cur_mag],
+							      &diag_x[cur_mag], &diag_y[cur_mag], &diag_z[cur_mag],
+							      &offdiag_x[cur_mag], &offdiag_y[cur_mag], &offdiag_z[cur_mag],
+							      &fit_error) != 0) {
+					// no ellipsoid, let the check below report it
+					sphere_radius[cur_mag] = NAN;
+
+				} else {
+					calibration_log_info(mavlink_log_pub, "[cal] mag #%u %u samples, fit error: %.1f%%",
+							     cur_mag, worker_data.fit[cur_mag]->stats.count, (double)(100.0f * fit_error));
+				}
 
 				result = check_calibration_result(sphere_x[cur_mag], sphere_y[cur_mag], sphere_z[cur_mag],
 							    sphere_radius[cur_mag],
@@ -735,56 +899,9 @@ calibrate_return mag_calibrate_all(orb_advert_t *mavlink_log_pub)
 		}
 	}
 
-	// Print uncalibrated data points
-	if (result == calibrate_return_ok) {
-
-		// DO NOT REMOVE! Critical validation data!
-
-		// printf("RAW DATA:\n--------------------\n");
-		// for (size_t cur_mag = 0; cur_mag < max_mags; cur_mag++) {
-
-		// 	if (worker_data.calibration_counter_total[cur_mag] == 0) {
-		// 		continue;
-		// 	}
-
-		// 	printf("RAW: MAG %u with %u samples:\n", (unsigned)cur_mag, (unsigned)worker_data.calibration_counter_total[cur_mag]);
-
-		// 	for (size_t i = 0; i < worker_data.calibration_counter_total[cur_mag]; i++) {
-		// 		float x = worker_data.x[cur_mag][i];
-		// 		float y = worker_data.y[cur_mag][i];
-		// 		float z = worker_data.z[cur_mag][i];
-		// 		printf("%8.4f, %8.4f, %8.4f\n", (double)x, (double)y, (double)z);
-		// 	}
-
-		// 	printf(">>>>>>>\n");
-		// }
-
-		// printf("CALIBRATED DATA:\n--------------------\n");
-		// for (size_t cur_mag = 0; cur_mag < max_mags; cur_mag++) {
-
-		// 	if (worker_data.calibration_counter_total[cur_mag] == 0) {
-		// 		continue;
-		// 	}
-
-		// 	printf("Calibrated: MAG %u with %u samples:\n", (unsigned)cur_mag, (unsigned)worker_data.calibration_counter_total[cur_mag]);
-
-		// 	for (size_t i = 0; i < worker_data.calibration_counter_total[cur_mag]; i++) {
-		// 		float x = worker_data.x[cur_mag][i] - sphere_x[cur_mag];
-		// 		float y = worker_data.y[cur_mag][i] - sphere_y[cur_mag];
-		// 		float z = worker_data.z[cur_mag][i] - sphere_z[cur_mag];
-		// 		printf("%8.4f, %8.4f, %8.4f\n", (double)x, (double)y, (double)z);
-		// 	}
-
-		// 	printf("SPHERE RADIUS: %8.4f\n", (double)sphere_radius[cur_mag]);
-		// 	printf(">>>>>>>\n");
-		// }
-	}
-
-	// Data points are no longer needed
+	// Fit statistics are no longer needed
 	for (size_t cur_mag = 0; cur_mag < max_mags; cur_mag++) {
-		free(worker_data.x[cur_mag]);
-		free(worker_data.y[cur_mag]);
-		free(worker_data.z[cur_mag]);
+		free(worker_data.fit[cur_mag]);
 	}
 
 	if (result == calibrate_return_ok) {
@@ -146,9 +146,7 @@ static dm_operations_t dm_ram_flash_operations = {
 };
 #endif
 
-static dm_operations_t *g_dm_ops;
-
-static struct {
+typedef struct {
 	union {
 		struct {
 			int fd;
@@ -167,7 +165,7 @@ static struct {
 #endif
 	};
 	bool running;
-} dm_operations_data;
+} dm_operations_data_t;
 
 /** Types of function calls supported by the worker task */
 typedef enum {
@@ -210,9 +208,6 @@ typedef struct {
 
 const size_t k_work_item_allocation_chunk_size = 8;
 
-/* Usage statistics */
-static unsigned g_func_counts[dm_number_of_funcs];
-
 /* table of maximum number of instances for each item type */
 static const unsigned g_per_item_max_index[DM_KEY_NUM_KEYS] = {
 	DM_KEY_SAFE_POINTS_MAX,
@@ -240,24 +235,18 @@ static const unsigned g_per_item_size[DM_KEY_NUM_KEYS] = {
 /* Table of offset for index 0 of each item type */
 static unsigned int g_key_offsets[DM_KEY_NUM_KEYS];
 
-/* Item type lock mutexes */
-static px4_sem_t *g_item_locks[DM_KEY_NUM_KEYS];
-static px4_sem_t g_sys_state_mutex_mission;
-static px4_sem_t g_sys_state_mutex_fence;
-
-/* The data manager store file handle and file name */
+/* The data manager store file name */
 #if defined(__PX4_POSIX_EAGLE) || defined(__PX4_POSIX_EXCELSIOR)
 static const char *default_device_path = PX4_ROOTFSDIR"/dataman";
 #else
 static const char *default_device_path = PX4_ROOTFSDIR"/fs/microsd/dataman";
 #endif
-static char *k_data_manager_device_path = nullptr;
 
 #if defined(FLASH_BASED_DATAMAN)
 static const dm_sector_descriptor_t *k_dataman_flash_sector = nullptr;
 #endif
 
-static enum {
+typedef enum {
 	BACKEND_NONE = 0,
 	BACKEND_FILE,
 	BACKEND_RAM,
@@ -265,7 +254,7 @@ static enum {
 	BACKEND_RAM_FLASH,
 #endif
 	BACKEND_LAST
-} backend = BACKEND_NONE;
+} dm_backend_t;
 
 /* The data manager work queues */
 
@@ -276,13 +265,42 @@ typedef struct {
 	unsigned max_size;	/* Maximum queue size reached */
 } work_q_t;
 
-static work_q_t g_free_q;	/* queue of free work items. So that we don't always need to call malloc and free*/
-static work_q_t g_work_q;	/* pending work items. To be consumed by worker thread */
+/**
+ * Data manager state. Every namespace (see px4_get_namespace()) runs its own
+ * worker task on its own store, so that several vehicles in one process do not
+ * share missions and geofences. Clients and the worker task access the state
+ * of their namespace.
+ */
+typedef struct {
+	dm_operations_t *ops;
+	dm_operations_data_t operations_data;
+	dm_backend_t backend;
+	char *device_path;	/* The data manager store file name */
+
+	/* Usage statistics */
+	unsigned func_counts[dm_number_of_funcs];
 
-static px4_sem_t g_work_queued_sema;	/* To notify worker thread a work item has been queued */
-static px4_sem_t g_init_sema;
+	/* Item type lock mutexes */
+	px4_sem_t *item_locks[DM_KEY_NUM_KEYS];
+	px4_sem_t sys_state_mutex_mission;
+	px4_sem_t sys_state_mutex_fence;
 
-static bool g_task_should_exit;	/**< if true, dataman task should exit */
+	work_q_t free_q;	/* queue of free work items. So that we don't always need to call malloc and free*/
+	work_q_t work_q;	/* pending work items. To be consumed by worker thread */
+
+	px4_sem_t work_queued_sema;	/* To notify worker thread a work item has been queued */
+	px4_sem_t init_sema;
+
+	bool task_should_exit;	/**< if true, dataman task should exit */
+} dm_namespace_t;
+
+static dm_namespace_t g_dm_namespaces[PX4_MAX_NAMESPACES];
+
+static inline dm_namespace_t *
+dm_ns()
+{
+	return &g_dm_namespaces[px4_get_namespace()];
+}
 
 static void init_q(work_q_t *q)
 {
@@ -315,13 +333,13 @@ create_work_item()
 	work_q_item_t *item;
 
 	/* Try to reuse item from free item queue */
-	lock_queue(&g_free_q);
+	lock_queue(&dm_ns()->free_q);
 
-	if ((item = (work_q_item_t *)sq_remfirst(&(g_free_q.q)))) {
-		g_free_q.size--;
+	if ((item = (work_q_item_t *)sq_remfirst(&(dm_ns()->free_q.q)))) {
+		dm_ns()->free_q.size--;
 	}
 
-	unlock_queue(&g_free_q);
+	unlock_queue(&dm_ns()->free_q);
 
 	/* If we there weren't any free items then obtain memory for a new ones */
 	if (item == nullptr) {
@@ -329,21 +347,21 @@ create_work_item()
 
 		if (item) {
 			item->first = 1;
-			lock_queue(&g_free_q);
+			lock_queue(&dm_ns()->free_q);
 
 			for (size_t i = 1; i < k_work_item_allocation_chunk_size; i++) {
 				(item + i)->first = 0;
-				sq_addfirst(&(item + i)->link, &(g_free_q.q));
+				sq_addfirst(&(item + i)->link, &(dm_ns()->free_q.q));
 			}
 
 			/* Update the queue size and potentially the maximum queue size */
-			g_free_q.size += k_work_item_allocation_chunk_size - 1;
+			dm_ns()->free_q.size += k_work_item_allocation_chunk_size - 1;
 
-			if (g_free_q.size > g_free_q.max_size) {
-				g_free_q.max_size = g_free_q.size;
+			if (dm_ns()->free_q.size > dm_ns()->free_q.max_size) {
+				dm_ns()->free_q.max_size = dm_ns()->free_q.size;
 			}
 
-			unlock_queue(&g_free_q);
+			unlock_queue(&dm_ns()->free_q);
 		}
 	}
 
@@ -367,15 +385,15 @@ destroy_work_item(work_q_item_t *item)
 {
 	px4_sem_destroy(&item->wait_sem); /* Destroy the item lock */
 	/* Return the item to the free item queue for later reuse */
-	lock_queue(&g_free_q);
-	sq_addfirst(&item->link, &(g_free_q.q));
+	lock_queue(&dm_ns()->free_q);
+	sq_addfirst(&item->link, &(dm_ns()->free_q.q));
 
 	/* Update the queue size and potentially the maximum queue size */
-	if (++g_free_q.size > g_free_q.max_size) {
-		g_free_q.max_size = g_free_q.size;
+	if (++dm_ns()->free_q.size > dm_ns()->free_q.max_size) {
+		dm_ns()->free_q.max_size = dm_ns()->free_q.size;
 	}
 
-	unlock_queue(&g_free_q);
+	unlock_queue(&dm_ns()->free_q);
 }
 
 static inline work_q_item_t *
@@ -384,13 +402,13 @@ dequeue_work_item()
 	work_q_item_t *work;
 
 	/* retrieve the 1st item on the work queue */
-	lock_queue(&g_work_q);
+	lock_queue(&dm_ns()->work_q);
 
-	if ((work = (work_q_item_t *)sq_remfirst(&g_work_q.q))) {
-		g_work_q.size--;
+	if ((work = (work_q_item_t *)sq_remfirst(&dm_ns()->work_q.q))) {
+		dm_ns()->work_q.size--;
 	}
 
-	unlock_queue(&g_work_q);
+	unlock_queue(&dm_ns()->work_q);
 	return work;
 }
 
@@ -398,18 +416,18 @@ static int
 enqueue_work_item_and_wait_for_result(work_q_item_t *item)
 {
 	/* put the work item at the end of the work queue */
-	lock_queue(&g_work_q);
-	sq_addlast(&item->link, &(g_work_q.q));
+	lock_queue(&dm_ns()->work_q);
+	sq_addlast(&item->link, &(dm_ns()->work_q.q));
 
 	/* Adjust the queue size and potentially the maximum queue size */
-	if (++g_work_q.size > g_work_q.max_size) {
-		g_work_q.max_size = g_work_q.size;
+	if (++dm_ns()->work_q.size > dm_ns()->work_q.max_size) {
+		dm_ns()->work_q.max_size = dm_ns()->work_q.size;
 	}
 
-	unlock_queue(&g_work_q);
+	unlock_queue(&dm_ns()->work_q);
 
 	/* tell the work thread that work is available */
-	px4_sem_post(&g_work_queued_sema);
+	px4_sem_post(&dm_ns()->work_queued_sema);
 
 	/* wait for the result */
 	px4_sem_wait(&item->wait_sem);
@@ -423,7 +441,7 @@ enqueue_work_item_and_wait_for_result(work_q_item_t *item)
 
 static bool is_running()
 {
-	return dm_operations_data.running;
+	return dm_ns()->operations_data.running;
 }
 
 /* Calculate the offset in file of specific item */
@@ -474,9 +492,9 @@ static ssize_t _ram_write(dm_item_t item, unsigned index, dm_persitence_t persis
 		return -E2BIG;
 	}
 
-	uint8_t *buffer = &dm_operations_data.ram.data[offset];
+	uint8_t *buffer = &dm_ns()->operations_data.ram.data[offset];
 
-	if (buffer > dm_operations_data.ram.data_end) {
+	if (buffer > dm_ns()->operations_data.ram.data_end) {
 		return -1;
 	}
 
@@ -530,9 +548,9 @@ _file_write(dm_item_t item, unsigned index, dm_persitence_t persistence, const v
 	len = -1;
 
 	/* Seek to the right spot in the data manager file and write the data item */
-	if (lseek(dm_operations_data.file.fd, offset, SEEK_SET) == offset) {
-		if ((len = write(dm_operations_data.file.fd, buffer, count)) == count) {
-			fsync(dm_operations_data.file.fd);        /* Make sure data is written to physical media */
+	if (lseek(dm_ns()->operations_data.file.fd, offset, SEEK_SET) == offset) {
+		if ((len = write(dm_ns()->operations_data.file.fd, buffer, count)) == count) {
+			fsync(dm_ns()->operations_data.file.fd);        /* Make sure data is written to physical media */
 		}
 	}
 
@@ -549,7 +567,7 @@ _file_write(dm_item_t item, unsigned index, dm_persitence_t persistence, const v
 static void
 _ram_flash_update_flush_timeout()
 {
-	dm_operations_data.ram_flash.flush_timeout_usec = hrt_absolute_time() + RAM_FLASH_FLUSH_TIMEOUT_USEC;
+	dm_ns()->operations_data.ram_flash.flush_timeout_usec = hrt_absolute_time() + RAM_FLASH_FLUSH_TIMEOUT_USEC;
 }
 
 static ssize_t
@@ -587,9 +605,9 @@ static ssize_t _ram_read(dm_item_t item, unsigned index, void *buf, size_t count
 
 	/* Read the prefix and data */
 
-	uint8_t *buffer = &dm_operations_data.ram.data[offset];
+	uint8_t *buffer = &dm_ns()->operations_data.ram.data[offset];
 
-	if (buffer > dm_operations_data.ram.data_end) {
+	if (buffer > dm_ns()->operations_data.ram.data_end) {
 		return -1;
 	}
 
@@ -631,8 +649,8 @@ _file_read(dm_item_t item, unsigned index, void *buf, size_t count)
 	/* Read the prefix and data */
 	len = -1;
 
-	if (lseek(dm_operations_data.file.fd, offset, SEEK_SET) == offset) {
-		len = read(dm_operations_data.file.fd, buffer, count + DM_SECTOR_HDR_SIZE);
+	if (lseek(dm_ns()->operations_data.file.fd, offset, SEEK_SET) == offset) {
+		len = read(dm_ns()->operations_data.file.fd, buffer, count + DM_SECTOR_HDR_SIZE);
 	}
 
 	/* Check for read error */
@@ -683,9 +701,9 @@ static int  _ram_clear(dm_item_t item)
 
 	/* Clear all items of this type */
 	for (i = 0; (unsigned)i < g_per_item_max_index[item]; i++) {
-		uint8_t *buf = &dm_operations_data.ram.data[offset];
+		uint8_t *buf = &dm_ns()->operations_data.ram.data[offset];
 
-		if (buf > dm_operations_data.ram.data_end) {
+		if (buf > dm_ns()->operations_data.ram.data_end) {
 			result = -1;
 			break;
 		}
@@ -714,26 +732,26 @@ _file_clear(dm_item_t item)
 	for (i = 0; (unsigned)i < g_per_item_max_index[item]; i++) {
 		char buf[1];
 
-		if (lseek(dm_operations_data.file.fd, offset, SEEK_SET) != offset) {
+		if (lseek(dm_ns()->operations_data.file.fd, offset, SEEK_SET) != offset) {
 			result = -1;
 			break;
 		}
 
 		/* Avoid SD flash wear by only doing writes where necessary */
-		if (read(dm_operations_data.file.fd, buf, 1) < 1) {
+		if (read(dm_ns()->operations_data.file.fd, buf, 1) < 1) {
 			break;
 		}
 
 		/* If item has length greater than 0 it needs to be overwritten */
 		if (buf[0]) {
-			if (lseek(dm_operations_data.file.fd, offset, SEEK_SET) != offset) {
+			if (lseek(dm_ns()->operations_data.file.fd, offset, SEEK_SET) != offset) {
 				result = -1;
 				break;
 			}
 
 			buf[0] = 0;
 
-			if (write(dm_operations_data.file.fd, buf, 1) != 1) {
+			if (write(dm_ns()->operations_data.file.fd, buf, 1) != 1) {
 				result = -1;
 				break;
 			}
@@ -743,7 +761,7 @@ _file_clear(dm_item_t item)
 	}
 
 	/* Make sure data is actually written to physical media */
-	fsync(dm_operations_data.file.fd);
+	fsync(dm_ns()->operations_data.file.fd);
 	return result;
 }
 
@@ -765,7 +783,7 @@ _ram_flash_clear(dm_item_t item)
 /* Tell the data manager about the type of the last reset */
 static int  _ram_restart(dm_reset_reason reason)
 {
-	uint8_t *buffer = dm_operations_data.ram.data;
+	uint8_t *buffer = dm_ns()->operations_data.ram.data;
 
 	/* We need to scan the entire file and invalidate and data that should not persist after the last reset */
 
@@ -813,14 +831,14 @@ _file_restart(dm_reset_reason reason)
 	for (int item = (int)DM_KEY_SAFE_POINTS; item < (int)DM_KEY_NUM_KEYS; item++) {
 		for (unsigned i = 0; i < g_per_item_max_index[item]; i++) {
 			/* Get data segment at current offset */
-			if (lseek(dm_operations_data.file.fd, offset, SEEK_SET) != offset) {
+			if (lseek(dm_ns()->operations_data.file.fd, offset, SEEK_SET) != offset) {
 				result = -1;
 				item = DM_KEY_NUM_KEYS;
 				break;
 			}
 
 			uint8_t buffer[2];
-			ssize_t len = read(dm_operations_data.file.fd, buffer, sizeof(buffer));
+			ssize_t len = read(dm_ns()->operations_data.file.fd, buffer, sizeof(buffer));
 
 			if (len != sizeof(buffer)) {
 				result = -1;
@@ -846,7 +864,7 @@ _file_restart(dm_reset_reason reason)
 
 				/* Set segment to unused if data does not persist */
 				if (clear_entry) {
-					if (lseek(dm_operations_data.file.fd, offset, SEEK_SET) != offset) {
+					if (lseek(dm_ns()->operations_data.file.fd, offset, SEEK_SET) != offset) {
 						result = -1;
 						item = DM_KEY_NUM_KEYS;
 						break;
@@ -854,7 +872,7 @@ _file_restart(dm_reset_reason reason)
 
 					buffer[0] = 0;
 
-					len = write(dm_operations_data.file.fd, buffer, 1);
+					len = write(dm_ns()->operations_data.file.fd, buffer, 1);
 
 					if (len != 1) {
 						result = -1;
@@ -868,7 +886,7 @@ _file_restart(dm_reset_reason reason)
 		}
 	}
 
-	fsync(dm_operations_data.file.fd);
+	fsync(dm_ns()->operations_data.file.fd);
 
 	/* tell the caller how it went */
 	return result;
@@ -886,12 +904,12 @@ static int
 _file_initialize(unsigned max_offset)
 {
 	/* See if the data manage file exists and is a multiple of the sector size */
-	dm_operations_data.file.fd = open(k_data_manager_device_path, O_RDONLY | O_BINARY);
+	dm_ns()->operations_data.file.fd = open(dm_ns()->device_path, O_RDONLY | O_BINARY);
 
-	if (dm_operations_data.file.fd >= 0) {
+	if (dm_ns()->operations_data.file.fd >= 0) {
 		// Read the mission state and check the hash
 		struct dataman_compat_s compat_state;
-		int ret = g_dm_ops->read(DM_KEY_COMPAT, 0, &compat_state, sizeof(compat_state));
+		int ret = dm_ns()->ops->read(DM_KEY_COMPAT, 0, &compat_state, sizeof(compat_state));
 
 		bool incompat = true;
 
@@ -901,40 +919,40 @@ _file_initialize(unsigned max_offset)
 			}
 		}
 
-		close(dm_operations_data.file.fd);
+		close(dm_ns()->operations_data.file.fd);
 
 		if (incompat) {
-			unlink(k_data_manager_device_path);
+			unlink(dm_ns()->device_path);
 		}
 	}
 
 	/* Open or create the data manager file */
-	dm_operations_data.file.fd = open(k_data_manager_device_path, O_RDWR | O_CREAT | O_BINARY, PX4_O_MODE_666);
+	dm_ns()->operations_data.file.fd = open(dm_ns()->device_path, O_RDWR | O_CREAT | O_BINARY, PX4_O_MODE_666);
 
-	if (dm_operations_data.file.fd < 0) {
-		PX4_WARN("Could not open data manager file %s", k_data_manager_device_path);
-		px4_sem_post(&g_init_sema); /* Don't want to hang startup */
+	if (dm_ns()->operations_data.file.fd < 0) {
+		PX4_WARN("Could not open data manager file %s", dm_ns()->device_path);
+		px4_sem_post(&dm_ns()->init_sema); /* Don't want to hang startup */
 		return -1;
 	}
 
-	if ((unsigned)lseek(dm_operations_data.file.fd, max_offset, SEEK_SET) != max_offset) {
-		close(dm_operations_data.file.fd);
-		PX4_WARN("Could not seek data manager file %s", k_data_manager_device_path);
-		px4_sem_post(&g_init_sema); /* Don't want to hang startup */
+	if ((unsigned)lseek(dm_ns()->operations_data.file.fd, max_offset, SEEK_SET) != max_offset) {
+		close(dm_ns()->operations_data.file.fd);
+		PX4_WARN("Could not seek data manager file %s", dm_ns()->device_path);
+		px4_sem_post(&dm_ns()->init_sema); /* Don't want to hang startup */
 		return -1;
 	}
 
 	/* Write current compat info */
 	struct dataman_compat_s compat_state;
 	compat_state.key = DM_COMPAT_KEY;
-	int ret = g_dm_ops->write(DM_KEY_COMPAT, 0, DM_PERSIST_POWER_ON_RESET, &compat_state, sizeof(compat_state));
+	int ret = dm_ns()->ops->write(DM_KEY_COMPAT, 0, DM_PERSIST_POWER_ON_RESET, &compat_state, sizeof(compat_state));
 
 	if (ret != sizeof(compat_state)) {
 		PX4_ERR("Failed writing compat: %d", ret);
 	}
 
-	fsync(dm_operations_data.file.fd);
-	dm_operations_data.running = true;
+	fsync(dm_ns()->operations_data.file.fd);
+	dm_ns()->operations_data.running = true;
 
 	return 0;
 }
@@ -943,17 +961,17 @@ static int
 _ram_initialize(unsigned max_offset)
 {
 	/* In memory */
-	dm_operations_data.ram.data = (uint8_t *)malloc(max_offset);
+	dm_ns()->operations_data.ram.data = (uint8_t *)malloc(max_offset);
 
-	if (dm_operations_data.ram.data == nullptr) {
+	if (dm_ns()->operations_data.ram.data == nullptr) {
 		PX4_WARN("Could not allocate %d bytes of memory", max_offset);
-		px4_sem_post(&g_init_sema); /* Don't want to hang startup */
+		px4_sem_post(&dm_ns()->init_sema); /* Don't want to hang startup */
 		return -1;
 	}
 
-	memset(dm_operations_data.ram.data, 0, max_offset);
-	dm_operations_data.ram.data_end = &dm_operations_data.ram.data[max_offset - 1];
-	dm_operations_data.running = true;
+	memset(dm_ns()->operations_data.ram.data, 0, max_offset);
+	dm_ns()->operations_data.ram.data_end = &dm_ns()->operations_data.ram.data[max_offset - 1];
+	dm_ns()->operations_data.running = true;
 
 	return 0;
 }
@@ -979,17 +997,17 @@ _ram_flash_initialize(unsigned max_offset)
 	}
 
 	/* Copy flash to RAM */
-	memcpy(dm_operations_data.ram_flash.data, (void *)k_dataman_flash_sector->address, max_offset);
+	memcpy(dm_ns()->operations_data.ram_flash.data, (void *)k_dataman_flash_sector->address, max_offset);
 
 	struct dataman_compat_s compat_state;
-	ret = g_dm_ops->read(DM_KEY_COMPAT, 0, &compat_state, sizeof(compat_state));
+	ret = dm_ns()->ops->read(DM_KEY_COMPAT, 0, &compat_state, sizeof(compat_state));
 
 	if (ret != sizeof(compat_state) || compat_state.key != DM_COMPAT_KEY) {
 		/* Not compatible: clear RAM and write DM_KEY_COMPAT(it will flush flash) */
-		memset(dm_operations_data.ram_flash.data, 0, max_offset);
+		memset(dm_ns()->operations_data.ram_flash.data, 0, max_offset);
 
 		compat_state.key = DM_COMPAT_KEY;
-		ret = g_dm_ops->write(DM_KEY_COMPAT, 0, DM_PERSIST_POWER_ON_RESET, &compat_state, sizeof(compat_state));
+		ret = dm_ns()->ops->write(DM_KEY_COMPAT, 0, DM_PERSIST_POWER_ON_RESET, &compat_state, sizeof(compat_state));
 	}
 
 	return ret > 0 ? 0 : -1;
@@ -999,15 +1017,15 @@ _ram_flash_initialize(unsigned max_offset)
 static void
 _file_shutdown()
 {
-	close(dm_operations_data.file.fd);
-	dm_operations_data.running = false;
+	close(dm_ns()->operations_data.file.fd);
+	dm_ns()->operations_data.running = false;
 }
 
 static void
 _ram_shutdown()
 {
-	free(dm_operations_data.ram.data);
-	dm_operations_data.running = false;
+	free(dm_ns()->operations_data.ram.data);
+	dm_ns()->operations_data.running = false;
 }
 
 #if defined(FLASH_BASED_DATAMAN)
@@ -1018,7 +1036,7 @@ _ram_flash_flush()
 	 * reseting flush_timeout_usec even in errors cases to avoid looping
 	 * forever in case of flash failure.
 	 */
-	dm_operations_data.ram_flash.flush_timeout_usec = 0;
+	dm_ns()->operations_data.ram_flash.flush_timeout_usec = 0;
 
 	ssize_t ret = up_progmem_getpage(k_dataman_flash_sector->address);
 	ret = up_progmem_erasepage(ret);
@@ -1028,8 +1046,8 @@ _ram_flash_flush()
 		return;
 	}
 
-	const size_t len = (dm_operations_data.ram_flash.data_end - dm_operations_data.ram_flash.data) + 1;
-	ret = up_progmem_write(k_dataman_flash_sector->address, dm_operations_data.ram_flash.data, len);
+	const size_t len = (dm_ns()->operations_data.ram_flash.data_end - dm_ns()->operations_data.ram_flash.data) + 1;
+	ret = up_progmem_write(k_dataman_flash_sector->address, dm_ns()->operations_data.ram_flash.data, len);
 
 	if (ret < len) {
 		PX4_WARN("Error writing to flash sector %u, error: %i", k_dataman_flash_sector->page, ret);
@@ -1040,7 +1058,7 @@ _ram_flash_flush()
 static void
 _ram_flash_shutdown()
 {
-	if (dm_operations_data.ram_flash.flush_timeout_usec) {
+	if (dm_ns()->operations_data.ram_flash.flush_timeout_usec) {
 		_ram_flash_flush();
 	}
 
@@ -1050,26 +1068,26 @@ _ram_flash_shutdown()
 static int
 _ram_flash_wait(px4_sem_t *sem)
 {
-	if (!dm_operations_data.ram_flash.flush_timeout_usec) {
+	if (!dm_ns()->operations_data.ram_flash.flush_timeout_usec) {
 		px4_sem_wait(sem);
 		return 0;
 	}
 
 	const uint64_t now = hrt_absolute_time();
 
-	if (now >= dm_operations_data.ram_flash.flush_timeout_usec) {
+	if (now >= dm_ns()->operations_data.ram_flash.flush_timeout_usec) {
 		_ram_flash_flush();
 		return 0;
 	}
 
-	const uint64_t diff = dm_operations_data.ram_flash.flush_timeout_usec - now;
+	const uint64_t diff = dm_ns()->operations_data.ram_flash.flush_timeout_usec - now;
 	struct timespec abstime;
 	abstime.tv_sec = diff / USEC_PER_SEC;
 	abstime.tv_nsec = (diff % USEC_PER_SEC) * NSEC_PER_USEC;
 
 	px4_sem_timedwait(sem, &abstime);
 
-	if (hrt_absolute_time() < dm_operations_data.ram_flash.flush_timeout_usec) {
+	if (hrt_absolute_time() < dm_ns()->operations_data.ram_flash.flush_timeout_usec) {
 		/* a work was queued before timeout */
 		return 0;
 	}
@@ -1086,7 +1104,7 @@ dm_write(dm_item_t item, unsigned index, dm_persitence_t persistence, const void
 	work_q_item_t *work;
 
 	/* Make sure data manager has been started and is not shutting down */
-	if (!is_running() || g_task_should_exit) {
+	if (!is_running() || dm_ns()->task_should_exit) {
 		return -1;
 	}
 
@@ -1113,7 +1131,7 @@ dm_read(dm_item_t item, unsigned index, void *buf, size_t count)
 	work_q_item_t *work;
 
 	/* Make sure data manager has been started and is not shutting down */
-	if (!is_running() || g_task_should_exit) {
+	if (!is_running() || dm_ns()->task_should_exit) {
 		return -1;
 	}
 
@@ -1139,7 +1157,7 @@ dm_clear(dm_item_t item)
 	work_q_item_t *work;
 
 	/* Make sure data manager has been started and is not shutting down */
-	if (!is_running() || g_task_should_exit) {
+	if (!is_running() || dm_ns()->task_should_exit) {
 		return -1;
 	}
 
@@ -1159,7 +1177,7 @@ __EXPORT int
 dm_lock(dm_item_t item)
 {
 	/* Make sure data manager has been started and is not shutting down */
-	if (!is_running() || g_task_should_exit) {
+	if (!is_running() || dm_ns()->task_should_exit) {
 		errno = EINVAL;
 		return -1;
 	}
@@ -1169,8 +1187,8 @@ dm_lock(dm_item_t item)
 		return -1;
 	}
 
-	if (g_item_locks[item]) {
-		return px4_sem_wait(g_item_locks[item]);
+	if (dm_ns()->item_locks[item]) {
+		return px4_sem_wait(dm_ns()->item_locks[item]);
 	}
 
 	errno = EINVAL;
@@ -1181,7 +1199,7 @@ __EXPORT int
 dm_trylock(dm_item_t item)
 {
 	/* Make sure data manager has been started and is not shutting down */
-	if (!is_running() || g_task_should_exit) {
+	if (!is_running() || dm_ns()->task_should_exit) {
 		errno = EINVAL;
 		return -1;
 	}
@@ -1191,8 +1209,8 @@ dm_trylock(dm_item_t item)
 		return -1;
 	}
 
-	if (g_item_locks[item]) {
-		return px4_sem_trywait(g_item_locks[item]);
+	if (dm_ns()->item_locks[item]) {
+		return px4_sem_trywait(dm_ns()->item_locks[item]);
 	}
 
 	errno = EINVAL;
@@ -1204,7 +1222,7 @@ __EXPORT void
 dm_unlock(dm_item_t item)
 {
 	/* Make sure data manager has been started and is not shutting down */
-	if (!is_running() || g_task_should_exit) {
+	if (!is_running() || dm_ns()->task_should_exit) {
 		return;
 	}
 
@@ -1212,8 +1230,8 @@ dm_unlock(dm_item_t item)
 		return;
 	}
 
-	if (g_item_locks[item]) {
-		px4_sem_post(g_item_locks[item]);
+	if (dm_ns()->item_locks[item]) {
+		px4_sem_post(dm_ns()->item_locks[item]);
 	}
 }
 
@@ -1224,7 +1242,7 @@ dm_restart(dm_reset_reason reason)
 	work_q_item_t *work;
 
 	/* Make sure data manager has been started and is not shutting down */
-	if (!is_running() || g_task_should_exit) {
+	if (!is_running() || dm_ns()->task_should_exit) {
 		return -1;
 	}
 
@@ -1253,19 +1271,19 @@ static int
 task_main(int argc, char *argv[])
 {
 	/* Dataman can use disk or RAM */
-	switch (backend) {
+	switch (dm_ns()->backend) {
 	case BACKEND_FILE:
-		g_dm_ops = &dm_file_operations;
+		dm_ns()->ops = &dm_file_operations;
 		break;
 
 	case BACKEND_RAM:
-		g_dm_ops = &dm_ram_operations;
+		dm_ns()->ops = &dm_ram_operations;
 		break;
 
 #if defined(FLASH_BASED_DATAMAN)
 
 	case BACKEND_RAM_FLASH:
-		g_dm_ops = &dm_ram_flash_operations;
+		dm_ns()->ops = &dm_ram_flash_operations;
 		break;
 #endif
 
@@ -1287,59 +1305,59 @@ task_main(int argc, char *argv[])
 			      g_per_item_size[DM_KEY_NUM_KEYS - 1]);
 
 	for (unsigned i = 0; i < dm_number_of_funcs; i++) {
-		g_func_counts[i] = 0;
+		dm_ns()->func_counts[i] = 0;
 	}
 
 	/* Initialize the item type locks, for now only DM_KEY_MISSION_STATE & DM_KEY_FENCE_POINTS supports locking */
-	px4_sem_init(&g_sys_state_mutex_mission, 1, 1); /* Initially unlocked */
-	px4_sem_init(&g_sys_state_mutex_fence, 1, 1); /* Initially unlocked */
+	px4_sem_init(&dm_ns()->sys_state_mutex_mission, 1, 1); /* Initially unlocked */
+	px4_sem_init(&dm_ns()->sys_state_mutex_fence, 1, 1); /* Initially unlocked */
 
 	for (unsigned i = 0; i < DM_KEY_NUM_KEYS; i++) {
-		g_item_locks[i] = nullptr;
+		dm_ns()->item_locks[i] = nullptr;
 	}
 
-	g_item_locks[DM_KEY_MISSION_STATE] = &g_sys_state_mutex_mission;
-	g_item_locks[DM_KEY_FENCE_POINTS] = &g_sys_state_mutex_fence;
+	dm_ns()->item_locks[DM_KEY_MISSION_STATE] = &dm_ns()->sys_state_mutex_mission;
+	dm_ns()->item_locks[DM_KEY_FENCE_POINTS] = &dm_ns()->sys_state_mutex_fence;
 
-	g_task_should_exit = false;
+	dm_ns()->task_should_exit = false;
 
-	init_q(&g_work_q);
-	init_q(&g_free_q);
+	init_q(&dm_ns()->work_q);
+	init_q(&dm_ns()->free_q);
 
-	px4_sem_init(&g_work_queued_sema, 1, 0);
+	px4_sem_init(&dm_ns()->work_queued_sema, 1, 0);
 
-	/* g_work_queued_sema use case is a signal */
+	/* dm_ns()->work_queued_sema use case is a signal */
 
-	px4_sem_setprotocol(&g_work_queued_sema, SEM_PRIO_NONE);
+	px4_sem_setprotocol(&dm_ns()->work_queued_sema, SEM_PRIO_NONE);
 
 	/* see if we need to erase any items based on restart type */
 	int sys_restart_val;
 
 	const char *restart_type_str = "Unknown restart";
 
-	int ret = g_dm_ops->initialize(max_offset);
+	int ret = dm_ns()->ops->initialize(max_offset);
 
 	if (ret) {
-		g_task_should_exit = true;
+		dm_ns()->task_should_exit = true;
 		goto end;
 	}
 
 	if (param_get(param_find("SYS_RESTART_TYPE"), &sys_restart_val) == OK) {
 		if (sys_restart_val == DM_INIT_REASON_POWER_ON) {
 			restart_type_str = "Power on restart";
-			g_dm_ops->restart(DM_INIT_REASON_POWER_ON);
+			dm_ns()->ops->restart(DM_INIT_REASON_POWER_ON);
 
 		} else if (sys_restart_val == DM_INIT_REASON_IN_FLIGHT) {
 			restart_type_str = "In flight restart";
-			g_dm_ops->restart(DM_INIT_REASON_IN_FLIGHT);
+			dm_ns()->ops->restart(DM_INIT_REASON_IN_FLIGHT);
 		}
 	}
 
-	switch (backend) {
+	switch (dm_ns()->backend) {
 	case BACKEND_FILE:
 		if (sys_restart_val != DM_INIT_REASON_POWER_ON) {
 			PX4_INFO("%s, data manager file '%s' size is %d bytes",
-				 restart_type_str, k_data_manager_device_path, max_offset);
+				 restart_type_str, dm_ns()->device_path, max_offset);
 		}
 
 		break;
@@ -1362,15 +1380,15 @@ task_main(int argc, char *argv[])
 	}
 
 	/* Tell startup that the worker thread has completed its initialization */
-	px4_sem_post(&g_init_sema);
+	px4_sem_post(&dm_ns()->init_sema);
 
 	/* Start the endless loop, waiting for then processing work requests */
 	while (true) {
 
 		/* do we need to exit ??? */
-		if (!g_task_should_exit) {
+		if (!dm_ns()->task_should_exit) {
 			/* wait for work */
-			g_dm_ops->wait(&g_work_queued_sema);
+			dm_ns()->ops->wait(&dm_ns()->work_queued_sema);
 		}
 
 		/* Empty the work queue */
@@ -1379,27 +1397,27 @@ task_main(int argc, char *argv[])
 			/* handle each work item with the appropriate handler */
 			switch (work->func) {
 			case dm_write_func:
-				g_func_counts[dm_write_func]++;
+				dm_ns()->func_counts[dm_write_func]++;
 				work->result =
-					g_dm_ops->write(work->write_params.item, work->write_params.index, work->write_params.persistence,
+					dm_ns()->ops->write(work->write_params.item, work->write_params.index, work->write_params.persistence,
 							work->write_params.buf,
 							work->write_params.count);
 				break;
 
 			case dm_read_func:
-				g_func_counts[dm_read_func]++;
+				dm_ns()->func_counts[dm_read_func]++;
 				work->result =
-					g_dm_ops->read(work->read_params.item, work->read_params.index, work->read_params.buf, work->read_params.count);
+					dm_ns()->ops->read(work->read_params.item, work->read_params.index, work->read_params.buf, work->read_params.count);
 				break;
 
 			case dm_clear_func:
-				g_func_counts[dm_clear_func]++;
-				work->result = g_dm_ops->clear(work->clear_params.item);
+				dm_ns()->func_counts[dm_clear_func]++;
+				work->result = dm_ns()->ops->clear(work->clear_params.item);
 				break;
 
 			case dm_restart_func:
-				g_func_counts[dm_restart_func]++;
-				work->result = g_dm_ops->restart(work->restart_params.reason);
+				dm_ns()->func_counts[dm_restart_func]++;
+				work->result = dm_ns()->ops->restart(work->restart_params.reason);
 				break;
 
 			default: /* should never happen */
@@ -1412,16 +1430,16 @@ task_main(int argc, char *argv[])
 		}
 
 		/* time to go???? */
-		if (g_task_should_exit) {
+		if (dm_ns()->task_should_exit) {
 			break;
 		}
 	}
 
-	g_dm_ops->shutdown();
+	dm_ns()->ops->shutdown();
 
 	/* The work queue is now empty, empty the free queue */
 	for (;;) {
-		if ((work = (work_q_item_t *)sq_remfirst(&(g_free_q.q))) == nullptr) {
+		if ((work = (work_q_item_t *)sq_remfirst(&(dm_ns()->free_q.q))) == nullptr) {
 			break;
 		}
 
@@ -1431,12 +1449,12 @@ task_main(int argc, char *argv[])
 	}
 
 end:
-	backend = BACKEND_NONE;
-	destroy_q(&g_work_q);
-	destroy_q(&g_free_q);
-	px4_sem_destroy(&g_work_queued_sema);
-	px4_sem_destroy(&g_sys_state_mutex_mission);
-	px4_sem_destroy(&g_sys_state_mutex_fence);
+	dm_ns()->backend = BACKEND_NONE;
+	destroy_q(&dm_ns()->work_q);
+	destroy_q(&dm_ns()->free_q);
+	px4_sem_destroy(&dm_ns()->work_queued_sema);
+	px4_sem_destroy(&dm_ns()->sys_state_mutex_mission);
+	px4_sem_destroy(&dm_ns()->sys_state_mutex_fence);
 
 	return 0;
 }
@@ -1446,22 +1464,22 @@ start()
 {
 	int task;
 
-	px4_sem_init(&g_init_sema, 1, 0);
+	px4_sem_init(&dm_ns()->init_sema, 1, 0);
 
-	/* g_init_sema use case is a signal */
+	/* dm_ns()->init_sema use case is a signal */
 
-	px4_sem_setprotocol(&g_init_sema, SEM_PRIO_NONE);
+	px4_sem_setprotocol(&dm_ns()->init_sema, SEM_PRIO_NONE);
 
 	/* start the worker thread with low priority for disk IO */
 	if ((task = px4_task_spawn_cmd("dataman", SCHED_DEFAULT, SCHED_PRIORITY_DEFAULT - 10, 1200, task_main, nullptr)) < 0) {
-		px4_sem_destroy(&g_init_sema);
+		px4_sem_destroy(&dm_ns()->init_sema);
 		PX4_ERR("task start failed");
 		return -1;
 	}
 
 	/* wait for the thread to actually initialize */
-	px4_sem_wait(&g_init_sema);
-	px4_sem_destroy(&g_init_sema);
+	px4_sem_wait(&dm_ns()->init_sema);
+	px4_sem_destroy(&dm_ns()->init_sema);
 
 	return 0;
 }
@@ -1470,19 +1488,19 @@ static void
 status()
 {
 	/* display usage statistics */
-	PX4_INFO("Writes   %d", g_func_counts[dm_write_func]);
-	PX4_INFO("Reads    %d", g_func_counts[dm_read_func]);
-	PX4_INFO("Clears   %d", g_func_counts[dm_clear_func]);
-	PX4_INFO("Restarts %d", g_func_counts[dm_restart_func]);
-	PX4_INFO("Max Q lengths work %d, free %d", g_work_q.max_size, g_free_q.max_size);
+	PX4_INFO("Writes   %d", dm_ns()->func_counts[dm_write_func]);
+	PX4_INFO("Reads    %d", dm_ns()->func_counts[dm_read_func]);
+	PX4_INFO("Clears   %d", dm_ns()->func_counts[dm_clear_func]);
+	PX4_INFO("Restarts %d", dm_ns()->func_counts[dm_restart_func]);
+	PX4_INFO("Max Q lengths work %d, free %d", dm_ns()->work_q.max_size, dm_ns()->free_q.max_size);
 }
 
 static void
 stop()
 {
 	/* Tell the worker task to shut down */
-	g_task_should_exit = true;
-	px4_sem_post(&g_work_queued_sema);
+	dm_ns()->task_should_exit = true;
+	px4_sem_post(&dm_ns()->work_queued_sema);
 }
 
 static void
@@ -1518,6 +1536,7 @@ check for geofence violations.
 	PRINT_MODULE_USAGE_PARAM_FLAG('r', "Use RAM backend (NOT persistent)", true);
 	PRINT_MODULE_USAGE_PARAM_FLAG('i', "Use FLASH backend", true);
 	PRINT_MODULE_USAGE_PARAM_COMMENT("The options -f, -r and -i are mutually exclusive. If nothing is specified, a file 'dataman' is used");
+	PRINT_MODULE_USAGE_PARAM_COMMENT("dataman runs once per namespace, namespace <n> > 0 uses the file 'dataman_<n>' by default");
 
 	PRINT_MODULE_USAGE_COMMAND_DESCR("poweronrestart", "Restart dataman (on power on)");
 	PRINT_MODULE_USAGE_COMMAND_DESCR("inflightrestart", "Restart dataman (in flight)");
@@ -1526,7 +1545,7 @@ check for geofence violations.
 
 static int backend_check()
 {
-	if (backend != BACKEND_NONE) {
+	if (dm_ns()->backend != BACKEND_NONE) {
 		PX4_WARN("-f, -r and -i are mutually exclusive");
 		usage();
 		return -1;
@@ -1563,9 +1582,9 @@ dataman_main(int argc, char *argv[])
 					return -1;
 				}
 
-				backend = BACKEND_FILE;
-				k_data_manager_device_path = strdup(dmoptarg);
-				PX4_INFO("dataman file set to: %s", k_data_manager_device_path);
+				dm_ns()->backend = BACKEND_FILE;
+				dm_ns()->device_path = strdup(dmoptarg);
+				PX4_INFO("dataman file set to: %s", dm_ns()->device_path);
 				break;
 
 			case 'r':
@@ -1573,7 +1592,7 @@ dataman_main(int argc, char *argv[])
 					return -1;
 				}
 
-				backend = BACKEND_RAM;
+				dm_ns()->backend = BACKEND_RAM;
 				break;
 
 			case 'i':
@@ -1587,7 +1606,7 @@ dataman_main(int argc, char *argv[])
 					return -1;
 				}
 
-				backend = BACKEND_RAM_FLASH;
+				dm_ns()->backend = BACKEND_RAM_FLASH;
 				break;
 #else
 				PX4_WARN("RAM/Flash backend is not available");
@@ -1601,17 +1620,26 @@ dataman_main(int argc, char *argv[])
 			}
 		}
 
-		if (backend == BACKEND_NONE) {
-			backend = BACKEND_FILE;
-			k_data_manager_device_path = strdup(default_device_path);
+		if (dm_ns()->backend == BACKEND_NONE) {
+			dm_ns()->backend = BACKEND_FILE;
+
+			if (px4_get_namespace() == 0) {
+				dm_ns()->device_path = strdup(default_device_path);
+
+			} else {
+				/* every further namespace gets its own file, e.g. 'dataman_1' */
+				char path[64];
+				snprintf(path, sizeof(path), "%s_%i", default_device_path, px4_get_namespace());
+				dm_ns()->device_path = strdup(path);
+			}
 		}
 
 		start();
 
 		if (!is_running()) {
 			PX4_ERR("dataman start failed");
-			free(k_data_manager_device_path);
-			k_data_manager_device_path = nullptr;
+			free(dm_ns()->device_path);
+			dm_ns()->device_path = nullptr;
 			return -1;
 		}
 
@@ -1627,8 +1655,8 @@ dataman_main(int argc, char *argv[])
 
 	if (!strcmp(argv[1], "stop")) {
 		stop();
-		free(k_data_manager_device_path);
-		k_data_manager_device_path = nullptr;
+		free(dm_ns()->device_path);
+		dm_ns()->device_path = nullptr;
 
 	} else if (!strcmp(argv[1], "status")) {
 		status();
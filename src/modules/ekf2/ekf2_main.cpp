@@ -1400,6 +1400,8 @@ int Ekf2::task_spawn(int argc, char *argv[])
 	return 0;
 }
 
+PX4_MODULE_DEPENDENCIES(ekf2, "sensors");
+
 int ekf2_main(int argc, char *argv[])
 {
 	return Ekf2::main(argc, argv);
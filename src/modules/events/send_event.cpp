@@ -218,6 +218,8 @@ The tasks can be started via CLI or uORB topics (vehicle_command from MAVLink, e
 }
 
 
+PX4_MODULE_DEPENDENCIES(send_event, "");
+
 int send_event_main(int argc, char *argv[])
 {
 	return SendEvent::main(argc, argv);
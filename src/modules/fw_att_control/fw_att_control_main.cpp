@@ -45,6 +45,7 @@
 #include <px4_defines.h>
 #include <px4_tasks.h>
 #include <px4_posix.h>
+#include <px4_module.h>
 
 #include <drivers/drv_hrt.h>
 #include <ecl/attitude_fw/ecl_pitch_controller.h>
@@ -1270,6 +1271,8 @@ FixedwingAttitudeControl::start()
 	return PX4_OK;
 }
 
+PX4_MODULE_DEPENDENCIES(fw_att_control, "");
+
 int fw_att_control_main(int argc, char *argv[])
 {
 	if (argc < 2) {
@@ -33,6 +33,8 @@
 
 #include "FixedwingPositionControl.hpp"
 
+#include <px4_module.h>
+
 extern "C" __EXPORT int fw_pos_control_l1_main(int argc, char *argv[]);
 
 FixedwingPositionControl *l1_control::g_control;
@@ -1901,6 +1903,8 @@ FixedwingPositionControl::start()
 	return PX4_OK;
 }
 
+PX4_MODULE_DEPENDENCIES(fw_pos_control_l1, "");
+
 int fw_pos_control_l1_main(int argc, char *argv[])
 {
 	if (argc < 2) {
@@ -51,6 +51,7 @@ namespace land_detector
 {
 
 LandDetector::LandDetector() :
+	ModuleWorkItem(HPWORK),
 	_cycle_perf(perf_alloc(PC_ELAPSED, "land_detector_cycle"))
 {
 }
@@ -60,25 +61,11 @@ LandDetector::~LandDetector()
 	perf_free(_cycle_perf);
 }
 
-int LandDetector::start()
-{
-	/* schedule a cycle to start things */
-	return work_queue(HPWORK, &_work, (worker_t)&LandDetector::_cycle_trampoline, this, 0);
-}
-
-void
-LandDetector::_cycle_trampoline(void *arg)
-{
-	LandDetector *dev = reinterpret_cast<LandDetector *>(arg);
-
-	dev->_cycle();
-}
-
-void LandDetector::_cycle()
+void LandDetector::cycle()
 {
 	perf_begin(_cycle_perf);
 
-	if (_object == nullptr) { // not initialized yet
+	if (!_initialized) {
 		// Advertise the first land detected uORB.
 		_landDetected.timestamp = hrt_absolute_time();
 		_landDetected.freefall = false;
@@ -94,7 +81,7 @@ void LandDetector::_cycle()
 
 		_check_params(true);
 
-		_object = this;
+		_initialized = true;
 	}
 
 	_check_params(false);
@@ -144,16 +131,6 @@ void LandDetector::_cycle()
 	}
 
 	perf_end(_cycle_perf);
-
-	if (!should_exit()) {
-
-		// Schedule next cycle.
-		work_queue(HPWORK, &_work, (worker_t)&LandDetector::_cycle_trampoline, this,
-			   USEC2TICK(1000000 / LAND_DETECTOR_UPDATE_RATE_HZ));
-
-	} else {
-		exit_and_cleanup();
-	}
 }
 void LandDetector::_check_params(const bool force)
 {
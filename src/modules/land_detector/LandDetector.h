@@ -42,8 +42,7 @@
 
 #pragma once
 
-#include <px4_workqueue.h>
-#include <px4_module.h>
+#include <px4_module_work.h>
 #include <systemlib/hysteresis/hysteresis.h>
 #include <systemlib/param/param.h>
 #include <systemlib/perf_counter.h>
@@ -54,7 +53,7 @@ namespace land_detector
 {
 
 
-class LandDetector : public ModuleBase<LandDetector>
+class LandDetector : public ModuleWorkItem<LandDetector>
 {
 public:
 	enum class LandDetectionState {
@@ -68,7 +67,8 @@ public:
 	LandDetector();
 	virtual ~LandDetector();
 
-	static int task_spawn(int argc, char *argv[]);
+	/** @see ModuleWorkItem */
+	static LandDetector *instantiate(int argc, char *argv[]);
 
 	/** @see ModuleBase */
 	static int custom_command(int argc, char *argv[])
@@ -90,11 +90,6 @@ public:
 		return _state;
 	}
 
-	/**
-	 * Get the work queue going.
-	 */
-	int start();
-
 protected:
 	/**
 	 * Called once to initialize uORB topics.
@@ -159,9 +154,8 @@ protected:
 	systemlib::Hysteresis _ground_contact_hysteresis{true};
 
 private:
-	static void _cycle_trampoline(void *arg);
-
-	void _cycle();
+	/** @see ModuleWorkItem */
+	void cycle() override;
 
 	void _check_params(const bool force);
 
@@ -172,7 +166,7 @@ private:
 	uint64_t _total_flight_time{0}; ///< in microseconds
 	hrt_abstime _takeoff_time{0};
 
-	struct work_s	_work {};
+	bool _initialized{false};
 
 	perf_counter_t	_cycle_perf;
 };
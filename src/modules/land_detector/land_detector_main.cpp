@@ -59,11 +59,11 @@ extern "C" __EXPORT int land_detector_main(int argc, char *argv[]);
 
 static char _currentMode[12];
 
-int LandDetector::task_spawn(int argc, char *argv[])
+LandDetector *LandDetector::instantiate(int argc, char *argv[])
 {
 	if (argc < 2) {
 		print_usage();
-		return -1;
+		return nullptr;
 	}
 
 	LandDetector *obj;
@@ -82,28 +82,18 @@ int LandDetector::task_spawn(int argc, char *argv[])
 
 	} else {
 		print_usage("unknown mode");
-		return -1;
+		return nullptr;
 	}
 
-	if (obj == nullptr) {
-		PX4_ERR("alloc failed");
-		return -1;
-	}
-
-	int ret = obj->start();
+	if (obj != nullptr) {
+		obj->set_interval(1000000 / LAND_DETECTOR_UPDATE_RATE_HZ);
 
-	if (ret < 0) {
-		delete obj;
-		return ret;
+		// Remember current active mode
+		strncpy(_currentMode, argv[1], sizeof(_currentMode) - 1);
+		_currentMode[sizeof(_currentMode) - 1] = '\0';
 	}
 
-	// Remember current active mode
-	strncpy(_currentMode, argv[1], sizeof(_currentMode) - 1);
-	_currentMode[sizeof(_currentMode) - 1] = '\0';
-
-	wait_until_running(); // this will wait until _object is set from the cycle method
-	_task_id = task_id_is_work_queue;
-	return 0;
+	return obj;
 }
 
 int LandDetector::print_status()
@@ -172,6 +162,8 @@ The module runs periodically on the HP work queue.
 }
 
 
+PX4_MODULE_DEPENDENCIES(land_detector, "");
+
 int land_detector_main(int argc, char *argv[])
 {
 	return LandDetector::main(argc, argv);
@@ -45,8 +45,7 @@
 #include <unistd.h>
 
 #include <px4_config.h>
-#include <px4_module.h>
-#include <px4_workqueue.h>
+#include <px4_module_work.h>
 #include <px4_defines.h>
 
 #include <drivers/drv_hrt.h>
@@ -71,13 +70,14 @@ extern "C" __EXPORT int load_mon_main(int argc, char *argv[]);
 // Run it at 1 Hz.
 const unsigned LOAD_MON_INTERVAL_US = 1000000;
 
-class LoadMon : public ModuleBase<LoadMon>
+class LoadMon : public ModuleWorkItem<LoadMon>
 {
 public:
 	LoadMon();
 	~LoadMon();
 
-	static int task_spawn(int argc, char *argv[]);
+	/** @see ModuleWorkItem */
+	static LoadMon *instantiate(int argc, char *argv[]);
 
 	/** @see ModuleBase */
 	static int custom_command(int argc, char *argv[])
@@ -91,12 +91,9 @@ public:
 	/** @see ModuleBase::print_status() */
 	int print_status() override;
 
-	/** Trampoline for the work queue. */
-	static void cycle_trampoline(void *arg);
-
 private:
-	/** Do a compute and schedule the next cycle. */
-	void _cycle();
+	/** @see ModuleWorkItem */
+	void cycle() override;
 
 	/** Do a calculation of the CPU load and publish it. */
 	void _compute();
@@ -113,8 +110,6 @@ private:
 	orb_advert_t _task_stack_info_pub;
 #endif
 
-	struct work_s _work;
-
 	struct cpuload_s _cpuload;
 	orb_advert_t _cpuload_pub;
 	hrt_abstime _last_idle_time;
@@ -123,12 +118,12 @@ private:
 };
 
 LoadMon::LoadMon() :
+	ModuleWorkItem(LPWORK),
 #ifdef __PX4_NUTTX
 	_task_stack_info {},
 	_stack_task_index(0),
 	_task_stack_info_pub(nullptr),
 #endif
-	_work {},
 	_cpuload{},
 	_cpuload_pub(nullptr),
 	_last_idle_time(0),
@@ -155,47 +150,20 @@ LoadMon::~LoadMon()
 	perf_free(_stack_perf);
 }
 
-int LoadMon::task_spawn(int argc, char *argv[])
+LoadMon *LoadMon::instantiate(int argc, char *argv[])
 {
 	LoadMon *obj = new LoadMon();
 
-	if (!obj) {
-		PX4_ERR("alloc failed");
-		return -1;
+	if (obj != nullptr) {
+		obj->set_interval(LOAD_MON_INTERVAL_US);
 	}
 
-	/* Schedule a cycle to start things. */
-	int ret = work_queue(LPWORK, &obj->_work, (worker_t)&LoadMon::cycle_trampoline, obj, 0);
-
-	if (ret < 0) {
-		delete obj;
-		return ret;
-	}
-
-	_object = obj;
-	_task_id = task_id_is_work_queue;
-	return 0;
-}
-
-void
-LoadMon::cycle_trampoline(void *arg)
-{
-	LoadMon *dev = reinterpret_cast<LoadMon *>(arg);
-
-	dev->_cycle();
+	return obj;
 }
 
-void LoadMon::_cycle()
+void LoadMon::cycle()
 {
 	_compute();
-
-	if (!should_exit()) {
-		work_queue(LPWORK, &_work, (worker_t)&LoadMon::cycle_trampoline, this,
-			   USEC2TICK(LOAD_MON_INTERVAL_US));
-
-	} else {
-		exit_and_cleanup();
-	}
 }
 
 void LoadMon::_compute()
@@ -51,6 +51,7 @@
 #include <fcntl.h>
 #include <px4_posix.h>
 #include <px4_tasks.h>
+#include <px4_module.h>
 
 #include "BlockLocalPositionEstimator.hpp"
 
@@ -84,6 +85,8 @@ usage(const char *reason)
 	return 1;
 }
 
+PX4_MODULE_DEPENDENCIES(local_position_estimator, "sensors");
+
 /**
  * The deamon app only briefly exists to start
  * the background job. The stack size assigned in the
@@ -55,7 +55,7 @@ public:
 	static constexpr Backend BackendMavlink = 1 << 1;
 	static constexpr Backend BackendAll = BackendFile | BackendMavlink;
 
-	LogWriter(Backend configured_backend, size_t file_buffer_size, unsigned int queue_size);
+	LogWriter(Backend configured_backend, size_t file_buffer_size, unsigned int queue_size, unsigned int window_size);
 	~LogWriter();
 
 	bool init();
@@ -137,6 +137,13 @@ public:
 		return 0;
 	}
 
+	/* mavlink logging methods */
+
+	void print_statistics_mavlink() const
+	{
+		if (_log_writer_mavlink) { _log_writer_mavlink->print_statistics(); }
+	}
+
 
 	/**
 	 * Indicate to the underlying backend whether future write_message() calls need a reliable
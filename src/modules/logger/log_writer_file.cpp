@@ -175,7 +175,7 @@ int LogWriterFile::thread_start()
 
 	pthread_attr_setstacksize(&thr_attr, PX4_STACK_ADJUSTED(1072));
 
-	int ret = pthread_create(&_thread, &thr_attr, &LogWriterFile::run_helper, this);
+	int ret = px4_pthread_create(&_thread, &thr_attr, &LogWriterFile::run_helper, this);
 	pthread_attr_destroy(&thr_attr);
 
 	return ret;
@@ -45,8 +45,9 @@ namespace logger
 {
 
 
-LogWriterMavlink::LogWriterMavlink(unsigned int queue_size) :
-	_queue_size(queue_size)
+LogWriterMavlink::LogWriterMavlink(unsigned int queue_size, unsigned int window_size) :
+	_queue_size(queue_size),
+	_window_size(math::constrain(window_size, 1u, math::min(queue_size, (unsigned int)ulog_stream_ack_s::WINDOW_MAX)))
 {
 	_ulog_stream_data.length = 0;
 }
@@ -86,12 +87,24 @@ void LogWriterMavlink::start_log()
 	_ulog_stream_data.sequence = 0;
 	_ulog_stream_data.length = 0;
 	_ulog_stream_data.first_message_offset = 0;
+	_num_unacked = 0;
+	_unacked_first = 0;
+
+	_start_time = hrt_absolute_time();
+	_num_messages = 0;
+	_num_acked_messages = 0;
+	_bytes_sent = 0;
+	_ack_wait_time = 0;
+	_ack_latency_sum = 0;
+	_ack_latency_max = 0;
+
 	_is_started = true;
 }
 
 void LogWriterMavlink::stop_log()
 {
 	_ulog_stream_data.length = 0;
+	_num_unacked = 0;
 	_is_started = false;
 }
 
@@ -132,6 +145,11 @@ void LogWriterMavlink::set_need_reliable_transfer(bool need_reliable)
 			// make sure to send previous data using reliable transfer
 			publish_message();
 		}
+
+		// the receiver must have everything before unacked data follows
+		if (is_started()) {
+			wait_for_acks(0);
+		}
 	}
 
 	_need_reliable_transfer = need_reliable;
@@ -139,6 +157,14 @@ void LogWriterMavlink::set_need_reliable_transfer(bool need_reliable)
 
 int LogWriterMavlink::publish_message()
 {
+	if (_need_reliable_transfer) {
+		// make room in the window. Note that this blocks the main logger thread, so if a file logging
+		// is already running, it might miss samples.
+		if (wait_for_acks(_window_size - 1)) {
+			return -2;
+		}
+	}
+
 	_ulog_stream_data.timestamp = hrt_absolute_time();
 	_ulog_stream_data.flags = 0;
 
@@ -154,50 +180,106 @@ int LogWriterMavlink::publish_message()
 	}
 
 	if (_need_reliable_transfer) {
-		// we need to wait for an ack. Note that this blocks the main logger thread, so if a file logging
-		// is already running, it will miss samples.
-		px4_pollfd_struct_t fds[1];
-		fds[0].fd = _ulog_stream_ack_sub;
-		fds[0].events = POLLIN;
-		bool got_ack = false;
-		const int timeout_ms = ulog_stream_ack_s::ACK_TIMEOUT * ulog_stream_ack_s::ACK_MAX_TRIES;
+		unsigned int idx = (_unacked_first + _num_unacked) % ulog_stream_ack_s::WINDOW_MAX;
+		_unacked_sequence[idx] = _ulog_stream_data.sequence;
+		_unacked_time[idx] = _ulog_stream_data.timestamp;
+		++_num_unacked;
+		++_num_acked_messages;
+	}
 
-		hrt_abstime started = hrt_absolute_time();
+	++_num_messages;
+	_bytes_sent += _ulog_stream_data.length;
 
-		do {
-			int ret = px4_poll(fds, sizeof(fds) / sizeof(fds[0]), timeout_ms);
+	_ulog_stream_data.sequence++;
+	_ulog_stream_data.length = 0;
+	_ulog_stream_data.first_message_offset = 255;
+	return 0;
+}
 
-			if (ret <= 0) {
-				break;
-			}
+void LogWriterMavlink::handle_ack(uint16_t sequence)
+{
+	hrt_abstime now = hrt_absolute_time();
+
+	// the ack covers all messages up to sequence (wrap-around safe comparison)
+	while (_num_unacked > 0 && (int16_t)(_unacked_sequence[_unacked_first] - sequence) <= 0) {
+		hrt_abstime latency = now - _unacked_time[_unacked_first];
+		_ack_latency_sum += latency;
+
+		if (latency > _ack_latency_max) {
+			_ack_latency_max = latency;
+		}
+
+		_unacked_first = (_unacked_first + 1) % ulog_stream_ack_s::WINDOW_MAX;
+		--_num_unacked;
+	}
+}
+
+int LogWriterMavlink::wait_for_acks(unsigned int max_unacked)
+{
+	px4_pollfd_struct_t fds[1];
+	fds[0].fd = _ulog_stream_ack_sub;
+	fds[0].events = POLLIN;
+	const int timeout_ms = ulog_stream_ack_s::ACK_TIMEOUT * ulog_stream_ack_s::ACK_MAX_TRIES;
+
+	hrt_abstime started = hrt_absolute_time();
+	hrt_abstime last_progress = started;
 
-			if (fds[0].revents & POLLIN) {
-				ulog_stream_ack_s ack;
-				orb_copy(ORB_ID(ulog_stream_ack), _ulog_stream_ack_sub, &ack);
+	// consume pending acks without blocking first, then block while the window is full
+	bool updated = false;
+	orb_check(_ulog_stream_ack_sub, &updated);
 
-				if (ack.sequence == _ulog_stream_data.sequence) {
-					got_ack = true;
-				}
+	while (updated || _num_unacked > max_unacked) {
+		if (!updated) {
+			int ret = px4_poll(fds, sizeof(fds) / sizeof(fds[0]), timeout_ms);
 
-			} else {
+			if (ret <= 0 || !(fds[0].revents & POLLIN)) {
 				break;
 			}
-		} while (!got_ack && hrt_elapsed_time(&started) / 1000 < timeout_ms);
+		}
 
-		if (!got_ack) {
-			PX4_ERR("Ack timeout. Stopping mavlink log");
-			stop_log();
-			return -2;
+		ulog_stream_ack_s ack;
+		orb_copy(ORB_ID(ulog_stream_ack), _ulog_stream_ack_sub, &ack);
+		unsigned int num_unacked = _num_unacked;
+		handle_ack(ack.sequence);
+
+		if (_num_unacked < num_unacked) {
+			last_progress = hrt_absolute_time();
+
+		} else if (hrt_elapsed_time(&last_progress) / 1000 >= (hrt_abstime)timeout_ms) {
+			break;
 		}
 
-		PX4_DEBUG("got ack in %i ms", (int)(hrt_elapsed_time(&started) / 1000));
+		orb_check(_ulog_stream_ack_sub, &updated);
+	}
+
+	_ack_wait_time += hrt_elapsed_time(&started);
+
+	if (_num_unacked > max_unacked) {
+		PX4_ERR("Ack timeout. Stopping mavlink log");
+		stop_log();
+		return -2;
 	}
 
-	_ulog_stream_data.sequence++;
-	_ulog_stream_data.length = 0;
-	_ulog_stream_data.first_message_offset = 255;
 	return 0;
 }
 
+void LogWriterMavlink::print_statistics() const
+{
+	float seconds = hrt_elapsed_time(&_start_time) / 1e6f;
+	float kibibytes = _bytes_sent / 1024.0f;
+
+	PX4_INFO("Sent %u messages, %4.2f KiB (avg %5.2f KiB/s)", (unsigned)_num_messages, (double)kibibytes,
+		 (double)(seconds > 0.f ? kibibytes / seconds : 0.f));
+	PX4_INFO("Reliable: %u messages, window %u (%u in flight), waited %.3f s for acks",
+		 (unsigned)_num_acked_messages, _window_size, _num_unacked, (double)(_ack_wait_time / 1e6f));
+
+	unsigned int num_completed = _num_acked_messages - _num_unacked;
+
+	if (num_completed > 0) {
+		PX4_INFO("Ack latency: avg %.1f ms, max %.1f ms", (double)(_ack_latency_sum / num_completed / 1e3f),
+			 (double)(_ack_latency_max / 1e3f));
+	}
+}
+
 }
 }
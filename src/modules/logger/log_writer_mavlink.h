@@ -34,6 +34,7 @@
 #pragma once
 
 #include <stdint.h>
+#include <drivers/drv_hrt.h>
 #include <uORB/topics/ulog_stream.h>
 #include <uORB/topics/ulog_stream_ack.h>
 
@@ -49,7 +50,12 @@ namespace logger
 class LogWriterMavlink
 {
 public:
-	LogWriterMavlink(unsigned int queue_size);
+	/**
+	 * @param queue_size uORB queue size of the ulog_stream topic
+	 * @param window_size maximum number of unacked messages in flight during reliable transfer.
+	 *                    It is limited to queue_size and ulog_stream_ack_s::WINDOW_MAX.
+	 */
+	LogWriterMavlink(unsigned int queue_size, unsigned int window_size);
 	~LogWriterMavlink();
 
 	bool init();
@@ -70,17 +76,46 @@ public:
 		return _need_reliable_transfer;
 	}
 
+	unsigned int window_size() const { return _window_size; }
+
+	void print_statistics() const;
+
 private:
 
-	/** publish message, wait for ack if needed & reset message */
+	/** publish message, wait for a free window slot if needed & reset message */
 	int publish_message();
 
+	/**
+	 * wait until at most max_unacked messages are in flight
+	 * @return 0 on success, -2 on ack timeout (logging is stopped)
+	 */
+	int wait_for_acks(unsigned int max_unacked);
+
+	/** handle a cumulative ack */
+	void handle_ack(uint16_t sequence);
+
 	ulog_stream_s _ulog_stream_data;
 	orb_advert_t _ulog_stream_pub = nullptr;
 	int _ulog_stream_ack_sub = -1;
 	bool _need_reliable_transfer = false;
 	bool _is_started = false;
 	const unsigned int _queue_size;
+	const unsigned int _window_size;
+
+	/** sequences & publication times of the messages in flight, oldest first */
+	uint16_t _unacked_sequence[ulog_stream_ack_s::WINDOW_MAX];
+	hrt_abstime _unacked_time[ulog_stream_ack_s::WINDOW_MAX];
+	unsigned int _unacked_first = 0;
+	unsigned int _num_unacked = 0;
+
+	/* statistics since start_log() */
+	hrt_abstime _start_time = 0;
+	uint32_t _num_messages = 0;
+	uint32_t _num_acked_messages = 0;
+	uint64_t _bytes_sent = 0;
+	hrt_abstime _ack_wait_time = 0; ///< time spent blocked waiting for acks
+	hrt_abstime _ack_latency_sum = 0;
+	hrt_abstime _ack_latency_max = 0;
 };
 
 }
@@ -45,6 +45,7 @@
 #include <uORB/uORB.h>
 #include <uORB/uORBTopics.h>
 #include <uORB/Subscription.hpp>
+#include <uORB/topics/log_file_event.h>
 #include <uORB/topics/log_message.h>
 #include <uORB/topics/parameter_update.h>
 #include <uORB/topics/vehicle_status.h>
@@ -96,6 +97,8 @@ static void timer_callback(void *arg)
 }
 
 
+PX4_MODULE_DEPENDENCIES(logger, "");
+
 int logger_main(int argc, char *argv[])
 {
 	// logger currently assumes little endian
@@ -178,6 +181,8 @@ $ logger on
 	PRINT_MODULE_USAGE_PARAM_INT('r', 280, 0, 8000, "Log rate in Hz, 0 means unlimited rate", true);
 	PRINT_MODULE_USAGE_PARAM_INT('b', 12, 4, 10000, "Log buffer size in KiB", true);
 	PRINT_MODULE_USAGE_PARAM_INT('q', 14, 1, 100, "uORB queue size for mavlink mode", true);
+	PRINT_MODULE_USAGE_PARAM_INT('w', 1, 1, 16,
+				     "Number of unacked messages in flight for reliable mavlink transfer (the client must support >1)", true);
 	PRINT_MODULE_USAGE_PARAM_STRING('p', nullptr, "<topic_name>",
 					 "Poll on a topic instead of running with fixed rate (Log rate and topic intervals are ignored if this is set)", true);
 	PRINT_MODULE_USAGE_COMMAND_DESCR("on", "start logging now, override arming (logger must be running)");
@@ -215,6 +220,7 @@ int Logger::print_status()
 
 	if (_writer.is_started(LogWriter::BackendMavlink)) {
 		PX4_INFO("Mavlink Logging Running");
+		_writer.print_statistics_mavlink();
 	}
 
 	return 0;
@@ -250,6 +256,7 @@ Logger *Logger::instantiate(int argc, char *argv[])
 	bool log_name_timestamp = false;
 	unsigned int queue_size = 14; //TODO: we might be able to reduce this if mavlink polled on the topic and/or
 	// topic sizes get reduced
+	unsigned int window_size = 1;
 	LogWriter::Backend backend = LogWriter::BackendAll;
 	const char *poll_topic = nullptr;
 
@@ -257,7 +264,7 @@ Logger *Logger::instantiate(int argc, char *argv[])
 	int ch;
 	const char *myoptarg = nullptr;
 
-	while ((ch = px4_getopt(argc, argv, "r:b:etfm:q:p:", &myoptind, &myoptarg)) != EOF) {
+	while ((ch = px4_getopt(argc, argv, "r:b:etfm:q:w:p:", &myoptind, &myoptarg)) != EOF) {
 		switch (ch) {
 		case 'r': {
 				unsigned long r = strtoul(myoptarg, nullptr, 10);
@@ -324,6 +331,15 @@ Logger *Logger::instantiate(int argc, char *argv[])
 
 			break;
 
+		case 'w':
+			window_size = strtoul(myoptarg, nullptr, 10);
+
+			if (window_size == 0) {
+				window_size = 1;
+			}
+
+			break;
+
 		case '?':
 			error_flag = true;
 			break;
@@ -340,7 +356,7 @@ Logger *Logger::instantiate(int argc, char *argv[])
 	}
 
 	Logger *logger = new Logger(backend, log_buffer_size, log_interval, poll_topic, log_on_start,
-				    log_until_shutdown, log_name_timestamp, queue_size);
+				    log_until_shutdown, log_name_timestamp, queue_size, window_size);
 
 #if defined(DBGPRINT) && defined(__PX4_NUTTX)
 	struct mallinfo alloc_info = mallinfo();
@@ -369,12 +385,13 @@ Logger *Logger::instantiate(int argc, char *argv[])
 
 
 Logger::Logger(LogWriter::Backend backend, size_t buffer_size, uint32_t log_interval, const char *poll_topic_name,
-	       bool log_on_start, bool log_until_shutdown, bool log_name_timestamp, unsigned int queue_size) :
+	       bool log_on_start, bool log_until_shutdown, bool log_name_timestamp, unsigned int queue_size,
+	       unsigned int window_size) :
 	_arm_override(false),
 	_log_on_start(log_on_start),
 	_log_until_shutdown(log_until_shutdown),
 	_log_name_timestamp(log_name_timestamp),
-	_writer(backend, buffer_size, queue_size),
+	_writer(backend, buffer_size, queue_size, window_size),
 	_log_interval(log_interval)
 {
 	_log_utc_offset = param_find("SDLOG_UTC_OFFSET");
@@ -1091,6 +1108,11 @@ void Logger::run()
 		_mavlink_log_pub = nullptr;
 	}
 
+	if (_log_file_event_pub) {
+		orb_unadvertise(_log_file_event_pub);
+		_log_file_event_pub = nullptr;
+	}
+
 	if (vehicle_command_ack_pub) {
 		orb_unadvertise(vehicle_command_ack_pub);
 	}
@@ -1355,6 +1377,27 @@ void Logger::stop_log_file()
 	write_perf_data(false);
 	_writer.set_need_reliable_transfer(false);
 	_writer.stop_log_file();
+
+	char file_name[LOG_DIR_LEN + sizeof(_log_file_name)];
+	snprintf(file_name, sizeof(file_name), "%s/%s", _log_dir, _log_file_name);
+	publish_log_file_event(log_file_event_s::EVENT_FILE_CLOSED, file_name);
+}
+
+void Logger::publish_log_file_event(uint8_t event, const char *path)
+{
+	log_file_event_s log_file_event = {};
+	log_file_event.timestamp = hrt_absolute_time();
+	log_file_event.event_count = ++_log_file_event_count;
+	log_file_event.event = event;
+	strncpy(log_file_event.path, path, sizeof(log_file_event.path) - 1);
+
+	if (_log_file_event_pub == nullptr) {
+		_log_file_event_pub = orb_advertise_queue(ORB_ID(log_file_event), &log_file_event,
+				      log_file_event_s::ORB_QUEUE_LENGTH);
+
+	} else {
+		orb_publish(ORB_ID(log_file_event), _log_file_event_pub, &log_file_event);
+	}
 }
 
 void Logger::start_log_mavlink()
@@ -1940,7 +1983,12 @@ int Logger::check_free_space()
 		PX4_WARN("removing log directory %s to get more space (left=%u MiB)", directory_to_delete,
 			 (unsigned int)(statfs_buf.f_bavail / 1024U * statfs_buf.f_bsize / 1024U));
 
-		if (remove_directory(directory_to_delete)) {
+		int remove_ret = remove_directory(directory_to_delete);
+
+		// even a failed removal may have deleted some of the files
+		publish_log_file_event(log_file_event_s::EVENT_DIR_REMOVED, directory_to_delete);
+
+		if (remove_ret) {
 			PX4_ERR("Failed to delete directory");
 			break;
 		}
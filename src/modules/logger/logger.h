@@ -94,7 +94,8 @@ class Logger : public ModuleBase<Logger>
 {
 public:
 	Logger(LogWriter::Backend backend, size_t buffer_size, uint32_t log_interval, const char *poll_topic_name,
-	       bool log_on_start, bool log_until_shutdown, bool log_name_timestamp, unsigned int queue_size);
+	       bool log_on_start, bool log_until_shutdown, bool log_name_timestamp, unsigned int queue_size,
+	       unsigned int window_size);
 
 	~Logger();
 
@@ -191,6 +192,13 @@ private:
 
 	void stop_log_file();
 
+	/**
+	 * Publish a change of the log directory on the log_file_event topic
+	 * @param event log_file_event_s::EVENT_*
+	 * @param path file or directory that changed
+	 */
+	void publish_log_file_event(uint8_t event, const char *path);
+
 	void start_log_mavlink();
 
 	void stop_log_mavlink();
@@ -317,6 +325,8 @@ private:
 	uint32_t					_log_interval{0};
 	const orb_metadata				*_polling_topic_meta{nullptr}; ///< if non-null, poll on this topic instead of sleeping
 	orb_advert_t					_mavlink_log_pub{nullptr};
+	orb_advert_t					_log_file_event_pub{nullptr};
+	uint32_t					_log_file_event_count{0}; ///< number of published log file events
 	uint16_t					_next_topic_id{0}; ///< id of next subscribed ulog topic
 	char						*_replay_file_name{nullptr};
 	bool						_should_stop_file_log{false}; /**< if true _next_load_print is set and file logging
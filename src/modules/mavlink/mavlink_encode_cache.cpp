@@ -0,0 +1,127 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2017 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/**
+ * @file mavlink_encode_cache.cpp
+ * Cache of encoded messages shared by all mavlink instances.
+ */
+
+#include <string.h>
+#include <px4_tasks.h>
+
+#include "mavlink_encode_cache.h"
+
+MavlinkEncodeCache::Entry MavlinkEncodeCache::_entries[NUM_ENTRIES] = {};
+pthread_mutex_t MavlinkEncodeCache::_mutex = PTHREAD_MUTEX_INITIALIZER;
+unsigned MavlinkEncodeCache::_hits = 0;
+unsigned MavlinkEncodeCache::_misses = 0;
+
+bool
+MavlinkEncodeCache::send(mavlink_channel_t chan, uint16_t msg_id, int topic_instance, uint64_t topic_timestamp)
+{
+	if (topic_timestamp == 0) {
+		return false;
+	}
+
+	uint8_t payload[MAVLINK_MAX_PAYLOAD_LEN];
+	uint8_t min_len = 0;
+	uint8_t len = 0;
+	uint8_t crc_extra = 0;
+	bool found = false;
+	const uint8_t ns = px4_get_namespace();
+	Entry &entry = MavlinkEncodeCache::entry(msg_id, ns, topic_instance);
+
+	pthread_mutex_lock(&_mutex);
+
+	if (entry.msg_id == msg_id && entry.ns == ns && entry.topic_instance == topic_instance
+	    && entry.topic_timestamp == topic_timestamp) {
+		min_len = entry.min_len;
+		len = entry.len;
+		crc_extra = entry.crc_extra;
+		memcpy(payload, entry.payload, len);
+		found = true;
+		_hits++;
+
+	} else {
+		_misses++;
+	}
+
+	pthread_mutex_unlock(&_mutex);
+
+	// send outside of the lock, writing to the channel can block
+	if (found) {
+		_mav_finalize_message_chan_send(chan, msg_id, (const char *)payload, min_len, len, crc_extra);
+	}
+
+	return found;
+}
+
+void
+MavlinkEncodeCache::put(int topic_instance, uint64_t topic_timestamp, const mavlink_message_t *msg,
+			uint8_t min_len, uint8_t len, uint8_t crc_extra)
+{
+	if (topic_timestamp == 0) {
+		return;
+	}
+
+	// packed for MAVLink 1: the extension fields were dropped and cannot be restored
+	if (msg->magic == MAVLINK_STX_MAVLINK1 && msg->len < len) {
+		return;
+	}
+
+	const uint16_t msg_id = msg->msgid;
+	const uint8_t ns = px4_get_namespace();
+	Entry &entry = MavlinkEncodeCache::entry(msg_id, ns, topic_instance);
+
+	pthread_mutex_lock(&_mutex);
+
+	// never replace a newer sample of the same source, instances can be slightly out of sync
+	if (entry.msg_id != msg_id || entry.ns != ns || entry.topic_instance != topic_instance
+	    || entry.topic_timestamp < topic_timestamp) {
+		entry.msg_id = msg_id;
+		entry.ns = ns;
+		entry.topic_instance = topic_instance;
+		entry.topic_timestamp = topic_timestamp;
+		entry.min_len = min_len;
+		entry.len = len;
+		entry.crc_extra = crc_extra;
+
+		// finalizing trims trailing zero bytes off msg->len (and puts the CRC behind
+		// the trimmed payload), so restore them
+		const uint8_t packed_len = (msg->len < len) ? msg->len : len;
+		memcpy(entry.payload, _MAV_PAYLOAD(msg), packed_len);
+		memset(entry.payload + packed_len, 0, len - packed_len);
+	}
+
+	pthread_mutex_unlock(&_mutex);
+}
@@ -0,0 +1,111 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2017 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/**
+ * @file mavlink_encode_cache.h
+ * Cache of encoded messages shared by all mavlink instances.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <pthread.h>
+
+#include "mavlink_bridge_header.h"
+
+/**
+ * When several mavlink instances run the same stream, each of them would copy the
+ * same topic sample and pack the same message. Streams whose message only depends
+ * on a single topic sample can store the packed message payload here, keyed by
+ * (message id, namespace, topic instance, topic timestamp). The timestamp is the
+ * timestamp field of the sample the message was packed from, so the key always
+ * matches the data. The other instances then only finalize the cached payload
+ * (sequence number, CRC) for their own channel. The namespace is the one of the
+ * calling thread (see px4_get_namespace()), so vehicles in one process never share
+ * messages.
+ *
+ * The cache is direct mapped by this key, a collision simply evicts the older entry.
+ */
+class MavlinkEncodeCache
+{
+public:
+	/**
+	 * Send a cached message.
+	 * @param chan channel to send the message on
+	 * @param msg_id mavlink message id
+	 * @param topic_instance uORB instance of the topic the message was packed from
+	 * @param topic_timestamp timestamp of the topic sample the message was packed from
+	 * @return true on cache hit, the message was sent
+	 */
+	static bool send(mavlink_channel_t chan, uint16_t msg_id, int topic_instance, uint64_t topic_timestamp);
+
+	/**
+	 * Store a packed message.
+	 * @param topic_instance uORB instance of the topic the message was packed from
+	 * @param topic_timestamp timestamp of the topic sample the message was packed from
+	 * @param msg message packed with mavlink_msg_*_encode_chan()
+	 * @param min_len payload length without extensions (MAVLINK_MSG_ID_*_MIN_LEN)
+	 * @param len full payload length (MAVLINK_MSG_ID_*_LEN)
+	 * @param crc_extra CRC seed of the message (MAVLINK_MSG_ID_*_CRC)
+	 */
+	static void put(int topic_instance, uint64_t topic_timestamp, const mavlink_message_t *msg,
+			uint8_t min_len, uint8_t len, uint8_t crc_extra);
+
+	static unsigned hits() { return _hits; }
+	static unsigned misses() { return _misses; }
+
+private:
+	struct Entry {
+		uint64_t topic_timestamp;	///< 0 for an empty entry
+		uint16_t msg_id;
+		uint8_t ns;		///< namespace of the instance that stored the entry
+		uint8_t topic_instance;
+		uint8_t min_len;
+		uint8_t len;
+		uint8_t crc_extra;
+		uint8_t payload[MAVLINK_MAX_PAYLOAD_LEN];	///< packed (wire format) payload
+	};
+
+	static constexpr unsigned NUM_ENTRIES = 16;
+
+	static Entry &entry(uint16_t msg_id, uint8_t ns, uint8_t topic_instance)
+	{
+		return _entries[(msg_id + 7 * ns + 3 * topic_instance) % NUM_ENTRIES];
+	}
+
+	static Entry _entries[NUM_ENTRIES];
+	static pthread_mutex_t _mutex;
+
+	static unsigned _hits;
+	static unsigned _misses;
+};
@@ -34,7 +34,7 @@
 /// @file mavlink_ftp.cpp
 ///	@author px4dev, Don Gagne <don@thegagnes.com>
 
-#include <crc32.h>
+#include <systemlib/crc.h>
 #include <unistd.h>
 #include <stdio.h>
 #include <fcntl.h>
@@ -55,7 +55,11 @@ MavlinkFTP::MavlinkFTP(Mavlink *mavlink) :
 	_mavlink(mavlink),
 	_work_buffer1{nullptr},
 	_work_buffer2{nullptr},
-	_last_work_buffer_access{0}
+	_last_work_buffer_access{0},
+	_read_ahead_buffer{nullptr},
+	_read_ahead_offset{0},
+	_read_ahead_valid{0},
+	_param_burst_size{param_find("MAV_FTP_BURST")}
 {
 	// initialize session
 	_session_info.fd = -1;
@@ -71,6 +75,7 @@ MavlinkFTP::~MavlinkFTP()
 		delete[] _work_buffer2;
 	}
 
+	_free_read_ahead();
 }
 
 unsigned
@@ -545,6 +550,8 @@ MavlinkFTP::_workOpen(PayloadHeader *payload, int oflag)
 	_session_info.fd = fd;
 	_session_info.file_size = fileSize;
 	_session_info.stream_download = false;
+	_session_info.stream_bytes_transmitted = 0;
+	_read_ahead_valid = 0;
 
 	payload->session = 0;
 	payload->size = sizeof(uint32_t);
@@ -571,12 +578,7 @@ MavlinkFTP::_workRead(PayloadHeader *payload)
 		return kErrEOF;
 	}
 
-	if (lseek(_session_info.fd, payload->offset, SEEK_SET) < 0) {
-		PX4_ERR("seek fail");
-		return kErrFailErrno;
-	}
-
-	int bytes_read = ::read(_session_info.fd, &payload->data[0], kMaxDataLength);
+	int bytes_read = _read_session(payload->offset, &payload->data[0], kMaxDataLength);
 
 	if (bytes_read < 0) {
 		// Negative return indicates error other than eof
@@ -600,10 +602,25 @@ MavlinkFTP::_workBurst(PayloadHeader *payload, uint8_t target_system_id)
 #ifdef MAVLINK_FTP_DEBUG
 	PX4_INFO("FTP: burst offset:%d", payload->offset);
 #endif
+	int32_t burst_packets = 146;
+
+	if (_param_burst_size != PARAM_INVALID) {
+		param_get(_param_burst_size, &burst_packets);
+	}
+
+	if (burst_packets < 1) {
+		burst_packets = 1;
+	}
+
+	if (_session_info.stream_bytes_transmitted == 0) {
+		_session_info.stream_start_time = hrt_absolute_time();
+	}
+
 	// Setup for streaming sends
 	_session_info.stream_download = true;
 	_session_info.stream_offset = payload->offset;
 	_session_info.stream_chunk_transmitted = 0;
+	_session_info.stream_chunk_limit = burst_packets * kMaxDataLength;
 	_session_info.stream_seq_number = payload->seq_number + 1;
 	_session_info.stream_target_system_id = target_system_id;
 
@@ -618,6 +635,9 @@ MavlinkFTP::_workWrite(PayloadHeader *payload)
 		return kErrInvalidSession;
 	}
 
+	// the file content changes, so whatever we read ahead is stale
+	_read_ahead_valid = 0;
+
 	if (lseek(_session_info.fd, payload->offset, SEEK_SET) < 0) {
 		// Unable to see to the specified location
 		PX4_ERR("seek fail");
@@ -761,6 +781,7 @@ MavlinkFTP::_workTerminate(PayloadHeader *payload)
 	::close(_session_info.fd);
 	_session_info.fd = -1;
 	_session_info.stream_download = false;
+	_free_read_ahead();
 
 	payload->size = 0;
 
@@ -777,6 +798,8 @@ MavlinkFTP::_workReset(PayloadHeader *payload)
 		_session_info.stream_download = false;
 	}
 
+	_free_read_ahead();
+
 	payload->size = 0;
 
 	return kErrNone;
@@ -875,7 +898,7 @@ MavlinkFTP::_workCalcFileCRC32(PayloadHeader *payload)
 			return kErrFailErrno;
 		}
 
-		checksum = crc32part((uint8_t *)_work_buffer2, bytes_read, checksum);
+		checksum = crc32_signature(checksum, bytes_read, (uint8_t *)_work_buffer2);
 	} while (bytes_read == _work_buffer2_len);
 
 	::close(fd);
@@ -885,6 +908,63 @@ MavlinkFTP::_workCalcFileCRC32(PayloadHeader *payload)
 	return kErrNone;
 }
 
+int
+MavlinkFTP::_read_session(uint32_t offset, uint8_t *dst, unsigned len)
+{
+	if (!_read_ahead_buffer) {
+		_read_ahead_buffer = new uint8_t[_read_ahead_buffer_len];
+		_read_ahead_valid = 0;
+
+		if (!_read_ahead_buffer) {
+			// no memory for read-ahead: read directly into the payload
+			if (lseek(_session_info.fd, offset, SEEK_SET) < 0) {
+				return -1;
+			}
+
+			return ::read(_session_info.fd, dst, len);
+		}
+	}
+
+	// refill if the requested range is not entirely in the buffer. Near EOF the buffer is
+	// refilled once more and returns the short remainder.
+	if (offset < _read_ahead_offset || offset + len > _read_ahead_offset + _read_ahead_valid) {
+		_read_ahead_valid = 0;
+
+		if (lseek(_session_info.fd, offset, SEEK_SET) < 0) {
+			return -1;
+		}
+
+		int bytes_read = ::read(_session_info.fd, _read_ahead_buffer, _read_ahead_buffer_len);
+
+		if (bytes_read < 0) {
+			return -1;
+		}
+
+		_read_ahead_offset = offset;
+		_read_ahead_valid = bytes_read;
+	}
+
+	unsigned available = _read_ahead_offset + _read_ahead_valid - offset;
+
+	if (len > available) {
+		len = available;
+	}
+
+	memcpy(dst, _read_ahead_buffer + (offset - _read_ahead_offset), len);
+	return len;
+}
+
+void
+MavlinkFTP::_free_read_ahead()
+{
+	if (_read_ahead_buffer) {
+		delete[] _read_ahead_buffer;
+		_read_ahead_buffer = nullptr;
+	}
+
+	_read_ahead_valid = 0;
+}
+
 /// @brief Guarantees that the payload data is null terminated.
 ///     @return Returns a pointer to the payload data as a char *
 char *
@@ -978,6 +1058,8 @@ void MavlinkFTP::send(const hrt_abstime t)
 				delete[] _work_buffer2;
 				_work_buffer2 = nullptr;
 			}
+
+			_free_read_ahead();
 		}
 	}
 
@@ -1031,16 +1113,7 @@ void MavlinkFTP::send(const hrt_abstime t)
 		}
 
 		if (error_code == kErrNone) {
-			if (lseek(_session_info.fd, payload->offset, SEEK_SET) < 0) {
-				error_code = kErrFailErrno;
-#ifdef MAVLINK_FTP_DEBUG
-				PX4_WARN("stream download: seek fail");
-#endif
-			}
-		}
-
-		if (error_code == kErrNone) {
-			int bytes_read = ::read(_session_info.fd, &payload->data[0], kMaxDataLength);
+			int bytes_read = _read_session(payload->offset, &payload->data[0], kMaxDataLength);
 
 			if (bytes_read < 0) {
 				// Negative return indicates error other than eof
@@ -1053,6 +1126,7 @@ void MavlinkFTP::send(const hrt_abstime t)
 				payload->size = bytes_read;
 				_session_info.stream_offset += bytes_read;
 				_session_info.stream_chunk_transmitted += bytes_read;
+				_session_info.stream_bytes_transmitted += bytes_read;
 			}
 		}
 
@@ -1070,14 +1144,23 @@ void MavlinkFTP::send(const hrt_abstime t)
 
 			_session_info.stream_download = false;
 
+#ifndef MAVLINK_FTP_UNIT_TEST
+
+			if (error_code == kErrEOF && _session_info.stream_bytes_transmitted > 0) {
+				_mavlink->set_ftp_download_stats(_session_info.stream_bytes_transmitted,
+								 hrt_elapsed_time(&_session_info.stream_start_time));
+			}
+
+#endif
+
 		} else {
 #ifndef MAVLINK_FTP_UNIT_TEST
 
 			if (max_bytes_to_send < (get_size() * 2)) {
 				more_data = false;
 
-				/* perform transfers in 35K chunks - this is determined empirical */
-				if (_session_info.stream_chunk_transmitted > 35000) {
+				/* perform transfers in chunks of MAV_FTP_BURST packets, then wait for the next burst request */
+				if (_session_info.stream_chunk_transmitted >= _session_info.stream_chunk_limit) {
 					payload->burst_complete = true;
 					_session_info.stream_download = false;
 					_session_info.stream_chunk_transmitted = 0;
@@ -41,6 +41,7 @@
 
 #include <px4_defines.h>
 #include <systemlib/err.h>
+#include <systemlib/param/param.h>
 #include <drivers/drv_hrt.h>
 
 #include "mavlink_bridge_header.h"
@@ -132,6 +133,18 @@ private:
 	void		_reply(mavlink_file_transfer_protocol_t *ftp_req);
 	int		_copy_file(const char *src_path, const char *dst_path, size_t length);
 
+	/**
+	 * Read from the session file, served from the read-ahead buffer where possible.
+	 * @param offset file offset to read from
+	 * @param dst destination buffer
+	 * @param len maximum number of bytes to read
+	 * @return number of bytes read, 0 on EOF, <0 on error (errno is set)
+	 */
+	int		_read_session(uint32_t offset, uint8_t *dst, unsigned len);
+
+	/// @brief Drop the read-ahead buffer content and memory
+	void		_free_read_ahead();
+
 	ErrorCode	_workList(PayloadHeader *payload, bool list_hidden = false);
 	ErrorCode	_workOpen(PayloadHeader *payload, int oflag);
 	ErrorCode	_workRead(PayloadHeader *payload);
@@ -171,6 +184,9 @@ private:
 		uint16_t	stream_seq_number;
 		uint8_t		stream_target_system_id;
 		unsigned	stream_chunk_transmitted;
+		unsigned	stream_chunk_limit;		///< bytes per burst before burst_complete is sent
+		uint32_t	stream_bytes_transmitted;	///< bytes sent since the download started
+		hrt_abstime	stream_start_time;		///< time of the first burst request of the download
 	};
 	struct SessionInfo _session_info;	///< Session info, fd=-1 for no active session
 
@@ -190,6 +206,19 @@ private:
 	static constexpr int _work_buffer2_len = 256;
 	hrt_abstime _last_work_buffer_access; ///< timestamp when the buffers were last accessed
 
+	/* read-ahead buffer for the session file: a single read() fills many burst/read payloads.
+	 * It is allocated on the first read and freed together with the work buffers. */
+	uint8_t *_read_ahead_buffer;
+#ifdef __PX4_NUTTX
+	static constexpr unsigned _read_ahead_buffer_len = 1024;
+#else
+	static constexpr unsigned _read_ahead_buffer_len = 64 * 1024;
+#endif
+	uint32_t _read_ahead_offset;	///< file offset of _read_ahead_buffer[0]
+	unsigned _read_ahead_valid;	///< number of valid bytes in _read_ahead_buffer
+
+	param_t _param_burst_size;	///< MAV_FTP_BURST: number of packets sent per burst request
+
 	// prepend a root directory to each file/dir access to avoid enumerating the full FS tree (e.g. on Linux).
 	// Note that requests can still fall outside of the root dir by using ../..
 #ifdef MAVLINK_FTP_UNIT_TEST
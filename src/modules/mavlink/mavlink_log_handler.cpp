@@ -38,12 +38,26 @@
 #include "mavlink_main.h"
 #include <sys/stat.h>
 #include <time.h>
+#include <uORB/topics/log_file_event.h>
 
+#ifdef MAVLINK_LOG_HANDLER_UNIT_TEST
+// Keep the unit test away from the real logs
+#define MOUNTPOINT PX4_ROOTFSDIR "/fs/microsd/log_handler_unit_test_dir"
+#else
 #define MOUNTPOINT PX4_ROOTFSDIR "/fs/microsd"
+#endif
 
 static const char *kLogRoot    = MOUNTPOINT "/log";
-static const char *kLogData    = MOUNTPOINT "/logdata.txt";
-static const char *kTmpData    = MOUNTPOINT "/$log$.txt";
+static const char *kLogData    = MOUNTPOINT "/logdata.bin";
+static const char *kTmpData    = MOUNTPOINT "/$log$.bin";
+
+//-- Record of the log index file. Records have a fixed size so get_entry() can seek
+//   directly to an entry instead of parsing the file from the start.
+struct LogIndexEntry {
+	uint32_t date;
+	uint32_t size;
+	char     path[128];
+};
 
 #ifdef __PX4_NUTTX
 #define PX4LOG_REGULAR_FILE DTYPE_FILE
@@ -78,12 +92,28 @@ stat_file(const char *file, time_t *date = nullptr, uint32_t *size = nullptr)
 	return false;
 }
 
+volatile uint32_t MavlinkLogHandler::_erase_count = 0;
+
 //-------------------------------------------------------------------
 MavlinkLogHandler::MavlinkLogHandler(Mavlink *mavlink)
 	: _pLogHandlerHelper(nullptr),
-	  _mavlink(mavlink)
+	  _mavlink(mavlink),
+	  _log_file_event_sub(-1),
+	  _log_file_event_count(0),
+	  _index_erase_count(0),
+	  _index_valid(false)
+{
+
+}
+
+//-------------------------------------------------------------------
+MavlinkLogHandler::~MavlinkLogHandler()
 {
+	delete _pLogHandlerHelper;
 
+	if (_log_file_event_sub >= 0) {
+		orb_unsubscribe(_log_file_event_sub);
+	}
 }
 
 //-------------------------------------------------------------------
@@ -167,8 +197,9 @@ MavlinkLogHandler::_log_request_list(const mavlink_message_t *msg)
 	}
 
 	if (!_pLogHandlerHelper) {
-		//-- Prepare new request
-		_pLogHandlerHelper = new LogListHelper;
+		//-- Prepare new request, only scan the log directory if the index is out of date
+		_pLogHandlerHelper = new LogListHelper(!_update_index());
+		_index_valid = _pLogHandlerHelper->has_index();
 	}
 
 	if (_pLogHandlerHelper->log_count) {
@@ -258,6 +289,58 @@ MavlinkLogHandler::_log_request_erase(const mavlink_message_t * /*msg*/)
 
 	//-- Delete all logs
 	LogListHelper::delete_all(kLogRoot);
+
+	//-- The index is shared by all instances, make them all rescan
+	unlink(kLogData);
+	_erase_count++;
+	_index_valid = false;
+}
+
+//-------------------------------------------------------------------
+bool
+MavlinkLogHandler::_update_index()
+{
+	/*
+		The logger publishes every log file it closes (and every log
+		directory it removes). A closed log is added to the index, anything
+		else (a missed event, or logs erased by any mavlink instance) needs
+		a rescan of the log directory.
+	*/
+
+	//-- The first listing always scans, events published before it are skipped below
+	if (_log_file_event_sub < 0) {
+		_log_file_event_sub = orb_subscribe(ORB_ID(log_file_event));
+		_index_valid = false;
+	}
+
+	if (_index_erase_count != _erase_count) {
+		_index_erase_count = _erase_count;
+		_index_valid = false;
+	}
+
+	//-- The topic is queued, apply all events since the last request in order
+	bool updated = false;
+
+	while (orb_check(_log_file_event_sub, &updated) == PX4_OK && updated) {
+		log_file_event_s event;
+
+		if (orb_copy(ORB_ID(log_file_event), _log_file_event_sub, &event) != PX4_OK) {
+			_index_valid = false;
+			break;
+		}
+
+		if (_index_valid && event.event == log_file_event_s::EVENT_FILE_CLOSED
+		    && event.event_count == _log_file_event_count + 1) {
+			_index_valid = LogListHelper::add_entry(event.path);
+
+		} else {
+			_index_valid = false;
+		}
+
+		_log_file_event_count = event.event_count;
+	}
+
+	return _index_valid;
 }
 
 //-------------------------------------------------------------------
@@ -332,7 +415,7 @@ MavlinkLogHandler::_log_send_data()
 }
 
 //-------------------------------------------------------------------
-LogListHelper::LogListHelper()
+LogListHelper::LogListHelper(bool rescan)
 	: next_entry(0)
 	, last_entry(0)
 	, log_count(0)
@@ -342,15 +425,31 @@ LogListHelper::LogListHelper()
 	, current_log_data_offset(0)
 	, current_log_data_remaining(0)
 	, current_log_filep(nullptr)
+	, _index_filep(nullptr)
+	, _index_file_pos(0)
 {
-	_init();
+	current_log_filename[0] = 0;
+
+	if (rescan) {
+		_init();
+
+	} else {
+		_open_index();
+	}
 }
 
 //-------------------------------------------------------------------
 LogListHelper::~LogListHelper()
 {
-	// Remove log data files (if any)
-	unlink(kLogData);
+	if (_index_filep) {
+		::fclose(_index_filep);
+	}
+
+	if (current_log_filep) {
+		::fclose(current_log_filep);
+	}
+
+	// The index is kept for the next helper, remove the work file (if any)
 	unlink(kTmpData);
 }
 
@@ -358,39 +457,42 @@ LogListHelper::~LogListHelper()
 bool
 LogListHelper::get_entry(int idx, uint32_t &size, uint32_t &date, char *filename, int filename_len)
 {
-	//-- Find log file in log list file created during init()
+	//-- Find log file in log index created during init()
 	size = 0;
 	date = 0;
-	bool result = false;
-	//-- Open list of log files
-	FILE *f = ::fopen(kLogData, "r");
-
-	if (f) {
-		//--- Find requested entry
-		char line[160];
-		int count = 0;
-
-		while (fgets(line, sizeof(line), f)) {
-			//-- Found our "index"
-			if (count++ == idx) {
-				char file[160];
-
-				if (sscanf(line, "%u %u %s", &date, &size, file) == 3) {
-					if (filename && filename_len > 0) {
-						strncpy(filename, file, filename_len);
-						filename[filename_len - 1] = 0; // ensure null-termination
-					}
 
-					result = true;
-					break;
-				}
-			}
+	if (!_index_filep || idx < 0 || idx >= log_count) {
+		return false;
+	}
+
+	//-- Entries are usually requested in sequence, only seek if needed
+	if (idx != _index_file_pos) {
+		if (fseek(_index_filep, idx * sizeof(LogIndexEntry), SEEK_SET)) {
+			_index_file_pos = -1;
+			return false;
 		}
 
-		fclose(f);
+		_index_file_pos = idx;
 	}
 
-	return result;
+	LogIndexEntry entry;
+
+	if (fread(&entry, sizeof(entry), 1, _index_filep) != 1) {
+		_index_file_pos = -1;
+		return false;
+	}
+
+	_index_file_pos++;
+
+	date = entry.date;
+	size = entry.size;
+
+	if (filename && filename_len > 0) {
+		strncpy(filename, entry.path, filename_len);
+		filename[filename_len - 1] = 0; // ensure null-termination
+	}
+
+	return true;
 }
 
 //-------------------------------------------------------------------
@@ -444,12 +546,11 @@ LogListHelper::_init()
 {
 	/*
 
-		When this helper is created, it scans the log directory
-		and collects all log files found into one file for easy,
-		subsequent access.
+		When this helper is created with rescan, it scans the log directory
+		and collects all log files found into one binary index file
+		with fixed size records for easy, subsequent access.
 	*/
 
-	current_log_filename[0] = 0;
 	// Remove old log data file (if any)
 	unlink(kLogData);
 	// Open log directory
@@ -461,7 +562,7 @@ LogListHelper::_init()
 	}
 
 	// Create work file
-	FILE *f = ::fopen(kTmpData, "w");
+	FILE *f = ::fopen(kTmpData, "wb");
 
 	if (!f) {
 		PX4LOG_WARN("MavlinkLogHandler::init Error creating %s\n", kTmpData);
@@ -494,7 +595,94 @@ LogListHelper::_init()
 	if (rename(kTmpData, kLogData)) {
 		PX4LOG_WARN("MavlinkLogHandler::init Error renaming %s\n", kTmpData);
 		log_count = 0;
+		return;
+	}
+
+	_open_index();
+}
+
+//-------------------------------------------------------------------
+void
+LogListHelper::_open_index()
+{
+	// Keep the index open while the helper exists
+	_index_filep = ::fopen(kLogData, "rb");
+	_index_file_pos = 0;
+	log_count = 0;
+
+	if (!_index_filep) {
+		PX4LOG_WARN("MavlinkLogHandler::init Error opening %s\n", kLogData);
+		return;
+	}
+
+	if (fseek(_index_filep, 0, SEEK_END) == 0) {
+		log_count = ftell(_index_filep) / sizeof(LogIndexEntry);
+	}
+
+	if (fseek(_index_filep, 0, SEEK_SET)) {
+		::fclose(_index_filep);
+		_index_filep = nullptr;
+		log_count = 0;
+	}
+}
+
+//-------------------------------------------------------------------
+bool
+LogListHelper::add_entry(const char *path)
+{
+	//-- Split "<kLogRoot>/<session>/<file>" to date the log like a scan does
+	const size_t root_len = strlen(kLogRoot);
+	const char *file = strrchr(path, '/');
+
+	if (strncmp(path, kLogRoot, root_len) || path[root_len] != '/' || file <= path + root_len) {
+		return false;
+	}
+
+	char dir_path[128];
+	size_t dir_path_len = file - path;
+
+	if (dir_path_len >= sizeof(dir_path)) {
+		return false;
+	}
+
+	memcpy(dir_path, path, dir_path_len);
+	dir_path[dir_path_len] = 0;
+	file++;
+
+	time_t date = 0;
+	uint32_t size = 0;
+
+	if (!_get_session_date(dir_path, dir_path + root_len + 1, date) || !_get_log_time_size(path, file, date, size)) {
+		return false;
 	}
+
+	FILE *f = ::fopen(kLogData, "r+b");
+
+	if (!f) {
+		return false;
+	}
+
+	//-- The log may already be listed if the index was built while it was written
+	LogIndexEntry entry;
+	long pos = -1;
+	long end = 0;
+
+	while (fread(&entry, sizeof(entry), 1, f) == 1) {
+		if (strncmp(entry.path, path, sizeof(entry.path)) == 0) {
+			pos = end;
+		}
+
+		end += sizeof(entry);
+	}
+
+	memset(&entry, 0, sizeof(entry));
+	entry.date = date;
+	entry.size = size;
+	strncpy(entry.path, path, sizeof(entry.path) - 1);
+
+	bool ok = fseek(f, pos >= 0 ? pos : end, SEEK_SET) == 0 && fwrite(&entry, sizeof(entry), 1, f) == 1;
+
+	return (::fclose(f) == 0) && ok;
 }
 
 //-------------------------------------------------------------------
@@ -543,9 +731,16 @@ LogListHelper::_scan_logs(FILE *f, const char *dir, time_t &date)
 
 				if (path_is_ok) {
 					if (_get_log_time_size(log_file_path, result->d_name, ldate, size)) {
-						//-- Write result->out to list file
-						fprintf(f, "%u %u %s\n", (unsigned)ldate, (unsigned)size, log_file_path);
-						log_count++;
+						//-- Write result->out to index file
+						LogIndexEntry entry;
+						memset(&entry, 0, sizeof(entry));
+						entry.date = ldate;
+						entry.size = size;
+						strncpy(entry.path, log_file_path, sizeof(entry.path) - 1);
+
+						if (fwrite(&entry, sizeof(entry), 1, f) == 1) {
+							log_count++;
+						}
 					}
 				}
 			}
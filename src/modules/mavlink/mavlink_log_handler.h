@@ -50,15 +50,27 @@ class Mavlink;
 class LogListHelper
 {
 public:
-	LogListHelper();
+	/**
+	 * @param rescan build the log index by scanning the log directory, otherwise
+	 *               use the index left by a previous helper
+	 */
+	LogListHelper(bool rescan);
 	~LogListHelper();
 
 public:
 	static void delete_all(const char *dir);
 
+	/**
+	 * Add a log file to the index left by a previous helper, or update its entry
+	 * if it is listed already.
+	 * @return false if the index could not be updated and needs a rescan
+	 */
+	static bool add_entry(const char *path);
+
 public:
 
 	bool        get_entry(int idx, uint32_t &size, uint32_t &date, char *filename = 0, int filename_len = 0);
+	bool        has_index() const { return _index_filep != nullptr; }
 	bool        open_for_transmit();
 	size_t      get_log_data(uint8_t len, uint8_t *buffer);
 
@@ -81,10 +93,14 @@ public:
 	char        current_log_filename[128];
 
 private:
+	FILE       *_index_filep;      ///< binary log index, one fixed size record per log file
+	int         _index_file_pos;   ///< index of the entry the index file is currently positioned at
+
 	void        _init();
-	bool        _get_session_date(const char *path, const char *dir, time_t &date);
+	void        _open_index();
+	static bool _get_session_date(const char *path, const char *dir, time_t &date);
 	void        _scan_logs(FILE *f, const char *dir, time_t &date);
-	bool        _get_log_time_size(const char *path, const char *file, time_t &date, uint32_t &size);
+	static bool _get_log_time_size(const char *path, const char *file, time_t &date, uint32_t &size);
 };
 
 // MAVLink LOG_* Message Handler
@@ -92,6 +108,7 @@ class MavlinkLogHandler
 {
 public:
 	MavlinkLogHandler(Mavlink *mavlink);
+	~MavlinkLogHandler();
 
 	// Handle possible LOG message
 	void handle_message(const mavlink_message_t *msg);
@@ -113,7 +130,16 @@ private:
 
 	size_t _log_send_listing();
 	size_t _log_send_data();
+	bool _update_index();
 
 	LogListHelper    *_pLogHandlerHelper;
 	Mavlink *_mavlink;
+	int _log_file_event_sub;          ///< logger log_file_event subscription
+	uint32_t _log_file_event_count;   ///< event_count of the last log_file_event applied to the index
+	uint32_t _index_erase_count;      ///< _erase_count when _index_valid was last checked
+	bool _index_valid;                ///< the log index on the SD card matches the log directory
+
+	static volatile uint32_t _erase_count; ///< number of log erase requests handled by any instance
+
+	friend class MavlinkLogHandlerTest;
 };
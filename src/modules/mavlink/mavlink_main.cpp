@@ -43,6 +43,7 @@
 #include <px4_defines.h>
 #include <px4_getopt.h>
 #include <px4_module.h>
+#include <px4_posix.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -85,6 +86,7 @@
 #include "mavlink_main.h"
 #include "mavlink_messages.h"
 #include "mavlink_receiver.h"
+#include "mavlink_encode_cache.h"
 #include "mavlink_rate_limiter.h"
 #include "mavlink_command_sender.h"
 
@@ -196,6 +198,7 @@ Mavlink::Mavlink() :
 	_task_should_exit(false),
 	next(nullptr),
 	_instance_id(0),
+	_namespace(px4_get_namespace()),
 	_mavlink_log_pub(nullptr),
 	_task_running(false),
 	_mavlink_buffer{},
@@ -246,6 +249,8 @@ Mavlink::Mavlink() :
 	_rate_tx(0.0f),
 	_rate_txerr(0.0f),
 	_rate_rx(0.0f),
+	_ftp_download_bytes(0),
+	_ftp_download_duration(0),
 #ifdef __PX4_POSIX
 	_myaddr {},
 	_src_addr{},
@@ -548,7 +553,8 @@ Mavlink::forward_message(const mavlink_message_t *msg, Mavlink *self)
 {
 	Mavlink *inst;
 	LL_FOREACH(_mavlink_instances, inst) {
-		if (inst != self) {
+		// instances of other vehicles (namespaces) in the same process are separate systems
+		if (inst != self && inst->_namespace == self->_namespace) {
 			const mavlink_msg_entry_t *meta = mavlink_get_msg_entry(msg->msgid);
 
 			// Extract target system and target component if set
@@ -2182,7 +2188,7 @@ Mavlink::task_main(int argc, char *argv[])
 
 	while (!_task_should_exit) {
 		/* main loop */
-		usleep(_main_loop_delay);
+		px4_usleep(_main_loop_delay);
 
 		perf_begin(_loop_perf);
 
@@ -2569,6 +2575,10 @@ Mavlink::display_status()
 
 	printf("\tmavlink chan: #%u\n", _channel);
 
+	if (_namespace != 0) {
+		printf("\tnamespace:\t%i\n", _namespace);
+	}
+
 	if (_rstatus.timestamp > 0) {
 
 		printf("\ttype:\t\t");
@@ -2604,13 +2614,19 @@ Mavlink::display_status()
 	printf("\ttxerr: %.3f kB/s\n", (double)_rate_txerr);
 	printf("\trx: %.3f kB/s\n", (double)_rate_rx);
 	printf("\trate mult: %.3f\n", (double)_rate_mult);
+	printf("\tshared encode cache: %u hits, %u misses\n", MavlinkEncodeCache::hits(), MavlinkEncodeCache::misses());
 
 	if (_mavlink_ulog) {
-		printf("\tULog rate: %.1f%% of max %.1f%%\n", (double)_mavlink_ulog->current_data_rate() * 100.,
-		       (double)_mavlink_ulog->maximum_data_rate() * 100.);
+		printf("\tULog rate: %.1f%% of max %.1f%%, %u retransmissions\n", (double)_mavlink_ulog->current_data_rate() * 100.,
+		       (double)_mavlink_ulog->maximum_data_rate() * 100., (unsigned)_mavlink_ulog->retransmissions());
 	}
 
 	printf("\taccepting commands: %s, FTP enabled: %s\n", accepting_commands() ? "YES" : "NO", _ftp_on ? "YES" : "NO");
+
+	if (_ftp_download_bytes > 0 && _ftp_download_duration > 0) {
+		printf("\tFTP last download: %u bytes in %.2f s (%.1f kB/s)\n", _ftp_download_bytes,
+		       (double)(_ftp_download_duration / 1e6), (double)(_ftp_download_bytes * 1e6 / _ftp_download_duration / 1024.));
+	}
 	printf("\tMAVLink version: %i\n", _protocol_version);
 
 	printf("\ttransport protocol: ");
@@ -2826,6 +2842,8 @@ $ mavlink stream -u 14556 -s HIGHRES_IMU -r 50
 
 }
 
+PX4_MODULE_DEPENDENCIES(mavlink, "");
+
 int mavlink_main(int argc, char *argv[])
 {
 	if (argc < 2) {
@@ -478,11 +478,17 @@ public:
 
 	bool ftp_enabled() const { return _ftp_on; }
 
+	/**
+	 * Store the statistics of the last completed FTP download (called from the receiver thread)
+	 */
+	void set_ftp_download_stats(uint32_t bytes, hrt_abstime duration) { _ftp_download_bytes = bytes; _ftp_download_duration = duration; }
+
 protected:
 	Mavlink			*next;
 
 private:
 	int			_instance_id;
+	int			_namespace;	///< namespace of the vehicle this instance belongs to
 
 	orb_advert_t		_mavlink_log_pub;
 	bool			_task_running;
@@ -562,6 +568,9 @@ private:
 	float			_rate_txerr;
 	float			_rate_rx;
 
+	uint32_t		_ftp_download_bytes;	///< size of the last completed FTP download
+	hrt_abstime		_ftp_download_duration;	///< duration of the last completed FTP download
+
 #ifdef __PX4_POSIX
 	struct sockaddr_in _myaddr;
 	struct sockaddr_in _src_addr;
@@ -45,6 +45,7 @@
 #include "mavlink_main.h"
 #include "mavlink_messages.h"
 #include "mavlink_command_sender.h"
+#include "mavlink_encode_cache.h"
 
 #include <commander/px4_custom_mode.h>
 #include <drivers/drv_pwm_output.h>
@@ -761,7 +762,6 @@ public:
 
 private:
 	MavlinkOrbSubscription *_att_sub;
-	uint64_t _att_time;
 
 	/* do not allow top copying this class */
 	MavlinkStreamAttitude(MavlinkStreamAttitude &);
@@ -770,26 +770,35 @@ private:
 
 protected:
 	explicit MavlinkStreamAttitude(Mavlink *mavlink) : MavlinkStream(mavlink),
-		_att_sub(_mavlink->add_orb_subscription(ORB_ID(vehicle_attitude))),
-		_att_time(0)
+		_att_sub(_mavlink->add_orb_subscription(ORB_ID(vehicle_attitude)))
 	{}
 
 	bool send(const hrt_abstime t)
 	{
 		struct vehicle_attitude_s att;
 
-		if (_att_sub->update(&_att_time, &att)) {
-			mavlink_attitude_t msg = {};
-			matrix::Eulerf euler = matrix::Quatf(att.q);
-			msg.time_boot_ms = att.timestamp / 1000;
-			msg.roll = euler.phi();
-			msg.pitch = euler.theta();
-			msg.yaw = euler.psi();
-			msg.rollspeed = att.rollspeed;
-			msg.pitchspeed = att.pitchspeed;
-			msg.yawspeed = att.yawspeed;
-
-			mavlink_msg_attitude_send_struct(_mavlink->get_channel(), &msg);
+		if (_att_sub->update_if_changed(&att)) {
+			const mavlink_channel_t chan = _mavlink->get_channel();
+
+			if (!MavlinkEncodeCache::send(chan, get_id(), _att_sub->get_instance(), att.timestamp)) {
+				mavlink_attitude_t msg = {};
+
+				matrix::Eulerf euler = matrix::Quatf(att.q);
+				msg.time_boot_ms = att.timestamp / 1000;
+				msg.roll = euler.phi();
+				msg.pitch = euler.theta();
+				msg.yaw = euler.psi();
+				msg.rollspeed = att.rollspeed;
+				msg.pitchspeed = att.pitchspeed;
+				msg.yawspeed = att.yawspeed;
+
+				mavlink_message_t packed;
+				mavlink_msg_attitude_encode_chan(mavlink_system.sysid, mavlink_system.compid, chan, &packed, &msg);
+				MavlinkEncodeCache::put(_att_sub->get_instance(), att.timestamp, &packed,
+							MAVLINK_MSG_ID_ATTITUDE_MIN_LEN, MAVLINK_MSG_ID_ATTITUDE_LEN,
+							MAVLINK_MSG_ID_ATTITUDE_CRC);
+				_mavlink->resend_message(&packed);
+			}
 
 			return true;
 		}
@@ -834,7 +843,6 @@ public:
 
 private:
 	MavlinkOrbSubscription *_att_sub;
-	uint64_t _att_time;
 
 	/* do not allow top copying this class */
 	MavlinkStreamAttitudeQuaternion(MavlinkStreamAttitudeQuaternion &);
@@ -842,27 +850,36 @@ private:
 
 protected:
 	explicit MavlinkStreamAttitudeQuaternion(Mavlink *mavlink) : MavlinkStream(mavlink),
-		_att_sub(_mavlink->add_orb_subscription(ORB_ID(vehicle_attitude))),
-		_att_time(0)
+		_att_sub(_mavlink->add_orb_subscription(ORB_ID(vehicle_attitude)))
 	{}
 
 	bool send(const hrt_abstime t)
 	{
 		struct vehicle_attitude_s att;
 
-		if (_att_sub->update(&_att_time, &att)) {
-			mavlink_attitude_quaternion_t msg = {};
-
-			msg.time_boot_ms = att.timestamp / 1000;
-			msg.q1 = att.q[0];
-			msg.q2 = att.q[1];
-			msg.q3 = att.q[2];
-			msg.q4 = att.q[3];
-			msg.rollspeed = att.rollspeed;
-			msg.pitchspeed = att.pitchspeed;
-			msg.yawspeed = att.yawspeed;
-
-			mavlink_msg_attitude_quaternion_send_struct(_mavlink->get_channel(), &msg);
+		if (_att_sub->update_if_changed(&att)) {
+			const mavlink_channel_t chan = _mavlink->get_channel();
+
+			if (!MavlinkEncodeCache::send(chan, get_id(), _att_sub->get_instance(), att.timestamp)) {
+				mavlink_attitude_quaternion_t msg = {};
+
+				msg.time_boot_ms = att.timestamp / 1000;
+				msg.q1 = att.q[0];
+				msg.q2 = att.q[1];
+				msg.q3 = att.q[2];
+				msg.q4 = att.q[3];
+				msg.rollspeed = att.rollspeed;
+				msg.pitchspeed = att.pitchspeed;
+				msg.yawspeed = att.yawspeed;
+
+				mavlink_message_t packed;
+				mavlink_msg_attitude_quaternion_encode_chan(mavlink_system.sysid, mavlink_system.compid, chan, &packed,
+						&msg);
+				MavlinkEncodeCache::put(_att_sub->get_instance(), att.timestamp, &packed,
+							MAVLINK_MSG_ID_ATTITUDE_QUATERNION_MIN_LEN, MAVLINK_MSG_ID_ATTITUDE_QUATERNION_LEN,
+							MAVLINK_MSG_ID_ATTITUDE_QUATERNION_CRC);
+				_mavlink->resend_message(&packed);
+			}
 
 			return true;
 		}
@@ -1741,7 +1758,6 @@ public:
 
 private:
 	MavlinkOrbSubscription *_pos_sub;
-	uint64_t _pos_time;
 
 	/* do not allow top copying this class */
 	MavlinkStreamLocalPositionNED(MavlinkStreamLocalPositionNED &);
@@ -1749,26 +1765,35 @@ private:
 
 protected:
 	explicit MavlinkStreamLocalPositionNED(Mavlink *mavlink) : MavlinkStream(mavlink),
-		_pos_sub(_mavlink->add_orb_subscription(ORB_ID(vehicle_local_position))),
-		_pos_time(0)
+		_pos_sub(_mavlink->add_orb_subscription(ORB_ID(vehicle_local_position)))
 	{}
 
 	bool send(const hrt_abstime t)
 	{
 		struct vehicle_local_position_s pos;
 
-		if (_pos_sub->update(&_pos_time, &pos)) {
-			mavlink_local_position_ned_t msg = {};
-
-			msg.time_boot_ms = pos.timestamp / 1000;
-			msg.x = pos.x;
-			msg.y = pos.y;
-			msg.z = pos.z;
-			msg.vx = pos.vx;
-			msg.vy = pos.vy;
-			msg.vz = pos.vz;
-
-			mavlink_msg_local_position_ned_send_struct(_mavlink->get_channel(), &msg);
+		if (_pos_sub->update_if_changed(&pos)) {
+			const mavlink_channel_t chan = _mavlink->get_channel();
+
+			if (!MavlinkEncodeCache::send(chan, get_id(), _pos_sub->get_instance(), pos.timestamp)) {
+				mavlink_local_position_ned_t msg = {};
+
+				msg.time_boot_ms = pos.timestamp / 1000;
+				msg.x = pos.x;
+				msg.y = pos.y;
+				msg.z = pos.z;
+				msg.vx = pos.vx;
+				msg.vy = pos.vy;
+				msg.vz = pos.vz;
+
+				mavlink_message_t packed;
+				mavlink_msg_local_position_ned_encode_chan(mavlink_system.sysid, mavlink_system.compid, chan, &packed,
+						&msg);
+				MavlinkEncodeCache::put(_pos_sub->get_instance(), pos.timestamp, &packed,
+							MAVLINK_MSG_ID_LOCAL_POSITION_NED_MIN_LEN, MAVLINK_MSG_ID_LOCAL_POSITION_NED_LEN,
+							MAVLINK_MSG_ID_LOCAL_POSITION_NED_CRC);
+				_mavlink->resend_message(&packed);
+			}
 
 			return true;
 		}
@@ -113,6 +113,20 @@ PARAM_DEFINE_INT32(MAV_FWDEXTSP, 1);
  */
 PARAM_DEFINE_INT32(MAV_BROADCAST, 0);
 
+/**
+ * FTP burst size
+ *
+ * Number of file payload packets sent in response to a single
+ * burst read request before the ground station has to request the
+ * next burst. Larger values improve download throughput on fast,
+ * reliable links (USB, UDP).
+ *
+ * @min 1
+ * @max 4096
+ * @group MAVLink
+ */
+PARAM_DEFINE_INT32(MAV_FTP_BURST, 146);
+
 /**
  * Test parameter
  *
@@ -685,6 +685,138 @@ bool MavlinkFtpTest::_removedirectory_test()
 	return true;
 }
 
+/// @brief Tests reads and a burst of a file larger than the read-ahead buffer, in and out of order.
+bool MavlinkFtpTest::_read_ahead_test()
+{
+	MavlinkFTP::PayloadHeader		payload;
+	const MavlinkFTP::PayloadHeader		*reply;
+	const uint32_t full_packet_bytes = MavlinkFTP::kMaxDataLength;
+
+	// ends after the first refill of the read-ahead buffer, not on a packet boundary
+	const uint32_t file_size = MavlinkFTP::_read_ahead_buffer_len + 3 * full_packet_bytes + 17;
+	uint8_t *bytes = new uint8_t[file_size];
+	ut_assert("new failed", bytes != nullptr);
+
+	for (uint32_t i = 0; i < file_size; i++) {
+		bytes[i] = (uint8_t)(i * 7 + (i >> 8));
+	}
+
+	ut_compare("mkdir failed", ::mkdir(_unittest_microsd_dir, S_IRWXU | S_IRWXG | S_IRWXO), 0);
+	int fd = ::open(_unittest_microsd_file, O_CREAT | O_EXCL | O_WRONLY, S_IRWXU | S_IRWXG | S_IRWXO);
+	ut_assert("open failed", fd != -1);
+	ut_compare("write failed", ::write(fd, bytes, file_size), (ssize_t)file_size);
+	::close(fd);
+
+	payload.opcode = MavlinkFTP::kCmdOpenFileRO;
+	payload.offset = 0;
+
+	bool success = _send_receive_msg(&payload,		// FTP payload header
+					 strlen(_unittest_microsd_file) + 1,	// size in bytes of data
+					 (const uint8_t *)_unittest_microsd_file,	// Data to start into FTP message payload
+					 &reply);		// Payload inside FTP message response
+
+	if (!success) {
+		return false;
+	}
+
+	ut_compare("Didn't get Ack back", reply->opcode, MavlinkFTP::kRspAck);
+	const uint8_t session = reply->session;
+
+	// sequential, straddling the end of the buffer, backwards, short read at EOF, after a refill
+	const uint32_t offsets[] = {
+		0,
+		full_packet_bytes,
+		MavlinkFTP::_read_ahead_buffer_len - 5,
+		3,
+		file_size - 10,
+		MavlinkFTP::_read_ahead_buffer_len + full_packet_bytes,
+	};
+
+	for (size_t i = 0; i < sizeof(offsets) / sizeof(offsets[0]); i++) {
+		payload.opcode = MavlinkFTP::kCmdReadFile;
+		payload.session = session;
+		payload.offset = offsets[i];
+
+		success = _send_receive_msg(&payload,	// FTP payload header
+					    0,		// size in bytes of data
+					    nullptr,	// Data to start into FTP message payload
+					    &reply);	// Payload inside FTP message response
+
+		if (!success) {
+			return false;
+		}
+
+		const uint32_t remaining = file_size - offsets[i];
+		const uint32_t expected_bytes = remaining < full_packet_bytes ? remaining : full_packet_bytes;
+		ut_compare("Didn't get Ack back", reply->opcode, MavlinkFTP::kRspAck);
+		ut_compare("Offset incorrect", reply->offset, offsets[i]);
+		ut_compare("Payload size incorrect", reply->size, expected_bytes);
+		ut_compare("File contents differ", memcmp(reply->data, &bytes[offsets[i]], expected_bytes), 0);
+	}
+
+	// Try going past EOF
+	payload.opcode = MavlinkFTP::kCmdReadFile;
+	payload.session = session;
+	payload.offset = file_size;
+
+	success = _send_receive_msg(&payload,	// FTP payload header
+				    0,		// size in bytes of data
+				    nullptr,	// Data to start into FTP message payload
+				    &reply);	// Payload inside FTP message response
+
+	if (!success) {
+		return false;
+	}
+
+	ut_compare("Didn't get Nak back", reply->opcode, MavlinkFTP::kRspNak);
+	ut_compare("Incorrect error code", reply->data[0], MavlinkFTP::kErrEOF);
+
+	// Burst from the middle of the first buffer fill to EOF, after the reads above moved the buffer
+	StreamInfo stream_info = {};
+	stream_info.ftp_test_class = this;
+	stream_info.file_bytes = bytes;
+	stream_info.file_size = file_size;
+	stream_info.next_offset = 2 * full_packet_bytes + 1;
+	_ftp_server->set_unittest_worker(MavlinkFtpTest::receive_message_handler_stream, &stream_info);
+
+	payload.opcode = MavlinkFTP::kCmdBurstReadFile;
+	payload.session = session;
+	payload.offset = stream_info.next_offset;
+
+	mavlink_message_t msg;
+	_setup_ftp_msg(&payload, 0, nullptr, &msg);
+	_ftp_server->handle_message(&msg);
+
+	// The stream is sent by send(), which runs to EOF in unit test builds
+	hrt_abstime t = 0;
+	_ftp_server->send(t);
+
+	_ftp_server->set_unittest_worker(MavlinkFtpTest::receive_message_handler_generic, this);
+
+	ut_assert("Unexpected burst packet", !stream_info.error);
+	ut_assert("Burst did not reach EOF", stream_info.eof);
+	ut_compare("All packets should have been sent", _ftp_server->get_size(), 0);
+
+	payload.opcode = MavlinkFTP::kCmdTerminateSession;
+	payload.session = session;
+	payload.size = 0;
+
+	success = _send_receive_msg(&payload,	// FTP payload header
+				    0,		// size in bytes of data
+				    nullptr,	// Data to start into FTP message payload
+				    &reply);	// Payload inside FTP message response
+
+	if (!success) {
+		return false;
+	}
+
+	ut_compare("Didn't get Ack back", reply->opcode, MavlinkFTP::kRspAck);
+
+	delete[] bytes;
+
+	return true;
+}
+
 bool MavlinkFtpTest::_createdirectory_test()
 {
 	MavlinkFTP::PayloadHeader		payload;
@@ -865,6 +997,41 @@ bool MavlinkFtpTest::_receive_message_handler_burst(const mavlink_file_transfer_
 	return true;
 }
 
+void MavlinkFtpTest::receive_message_handler_stream(const mavlink_file_transfer_protocol_t *ftp_req, void *worker_data)
+{
+	StreamInfo *stream_info = (StreamInfo *)worker_data;
+	stream_info->ftp_test_class->_receive_message_handler_stream(ftp_req, stream_info);
+}
+
+void MavlinkFtpTest::_receive_message_handler_stream(const mavlink_file_transfer_protocol_t *ftp_msg,
+		StreamInfo *stream_info)
+{
+	const MavlinkFTP::PayloadHeader *reply;
+
+	if (!_decode_message(ftp_msg, &reply) || stream_info->eof) {
+		stream_info->error = true;
+		return;
+	}
+
+	if (reply->opcode == MavlinkFTP::kRspNak) {
+		stream_info->eof = reply->data[0] == MavlinkFTP::kErrEOF && stream_info->next_offset == stream_info->file_size;
+		stream_info->error |= !stream_info->eof;
+		return;
+	}
+
+	const uint32_t remaining = stream_info->file_size - stream_info->next_offset;
+	const uint32_t expected_bytes = remaining < MavlinkFTP::kMaxDataLength ? remaining : MavlinkFTP::kMaxDataLength;
+
+	if (reply->opcode != MavlinkFTP::kRspAck || reply->offset != stream_info->next_offset ||
+	    reply->size != expected_bytes ||
+	    memcmp(reply->data, &stream_info->file_bytes[stream_info->next_offset], expected_bytes) != 0) {
+		stream_info->error = true;
+		return;
+	}
+
+	stream_info->next_offset += expected_bytes;
+}
+
 /// @brief Decode and validate the incoming message
 bool MavlinkFtpTest::_decode_message(const mavlink_file_transfer_protocol_t	*ftp_msg,	///< Incoming FTP message
 				     const MavlinkFTP::PayloadHeader		**payload)	///< Payload inside FTP message response
@@ -955,6 +1122,7 @@ bool MavlinkFtpTest::run_tests()
 	ut_run_test(_read_test);
 	ut_run_test(_read_badsession_test);
 	ut_run_test(_burst_test);
+	ut_run_test(_read_ahead_test);
 	ut_run_test(_removedirectory_test);
 	ut_run_test(_createdirectory_test);
 	ut_run_test(_removefile_test);
@@ -61,6 +61,18 @@ public:
 
 	static void receive_message_handler_burst(const mavlink_file_transfer_protocol_t *ftp_req, void *worker_data);
 
+	/// Worker data for the stream handler of the read-ahead test
+	struct StreamInfo {
+		MavlinkFtpTest		*ftp_test_class;
+		const uint8_t		*file_bytes;
+		uint32_t		file_size;
+		uint32_t		next_offset;	///< offset expected in the next packet
+		bool			eof;		///< Nak EOF received at the end of the file
+		bool			error;		///< unexpected packet received
+	};
+
+	static void receive_message_handler_stream(const mavlink_file_transfer_protocol_t *ftp_req, void *worker_data);
+
 	static const uint8_t serverSystemId = 50;	///< System ID for server
 	static const uint8_t serverComponentId = 1;	///< Component ID for server
 	static const uint8_t serverChannel = 0;		///< Channel to send to
@@ -87,6 +99,7 @@ private:
 	bool _read_test(void);
 	bool _read_badsession_test(void);
 	bool _burst_test(void);
+	bool _read_ahead_test(void);
 	bool _removedirectory_test(void);
 	bool _createdirectory_test(void);
 	bool _removefile_test(void);
@@ -121,6 +134,7 @@ private:
 	};
 
 	bool _receive_message_handler_burst(const mavlink_file_transfer_protocol_t *ftp_req, BurstInfo *burst_info);
+	void _receive_message_handler_stream(const mavlink_file_transfer_protocol_t *ftp_req, StreamInfo *stream_info);
 
 	MavlinkFTP	*_ftp_server;
 	uint16_t	_expected_seq_number;
@@ -0,0 +1,222 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2017 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/// @file mavlink_log_handler_test.cpp
+/// Tests for keeping the log index of the MAVLink log handler up to date from the
+/// logger's log_file_event topic, with several handler instances sharing the index
+
+#include <dirent.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <uORB/topics/log_file_event.h>
+
+#include "mavlink_log_handler_test.h"
+#include "../mavlink_main.h"
+
+// Matches MOUNTPOINT of mavlink_log_handler.cpp built with MAVLINK_LOG_HANDLER_UNIT_TEST
+#define TEST_MOUNTPOINT PX4_ROOTFSDIR "/fs/microsd/log_handler_unit_test_dir"
+
+const char MavlinkLogHandlerTest::_log_root_dir[] = TEST_MOUNTPOINT "/log";
+const char MavlinkLogHandlerTest::_log_session_dir[] = TEST_MOUNTPOINT "/log/sess001";
+
+MavlinkLogHandlerTest::MavlinkLogHandlerTest() :
+	_event_pub(nullptr),
+	_event_count(0)
+{
+}
+
+MavlinkLogHandlerTest::~MavlinkLogHandlerTest()
+{
+	if (_event_pub != nullptr) {
+		orb_unadvertise(_event_pub);
+	}
+}
+
+/// @brief Called before every test to create an empty log directory.
+void MavlinkLogHandlerTest::_init()
+{
+	_cleanup();
+
+	::mkdir(TEST_MOUNTPOINT, S_IRWXU | S_IRWXG | S_IRWXO);
+	::mkdir(_log_root_dir, S_IRWXU | S_IRWXG | S_IRWXO);
+	::mkdir(_log_session_dir, S_IRWXU | S_IRWXG | S_IRWXO);
+
+	// Continue the event count of a logger that may have published before
+	int sub = orb_subscribe(ORB_ID(log_file_event));
+	log_file_event_s event;
+
+	if (sub >= 0) {
+		if (orb_copy(ORB_ID(log_file_event), sub, &event) == PX4_OK && event.event_count > _event_count) {
+			_event_count = event.event_count;
+		}
+
+		orb_unsubscribe(sub);
+	}
+}
+
+/// @brief Called after every test to remove the test logs and index.
+void MavlinkLogHandlerTest::_cleanup()
+{
+	LogListHelper::delete_all(_log_root_dir);
+	::rmdir(_log_root_dir);
+	::unlink(TEST_MOUNTPOINT "/logdata.bin");
+	::rmdir(TEST_MOUNTPOINT);
+}
+
+bool MavlinkLogHandlerTest::_create_log(const char *file, size_t size)
+{
+	char path[128];
+	snprintf(path, sizeof(path), "%s/%s", _log_session_dir, file);
+
+	int fd = ::open(path, O_CREAT | O_WRONLY | O_TRUNC, PX4_O_MODE_666);
+
+	if (fd < 0) {
+		return false;
+	}
+
+	uint8_t buffer[64] = {};
+	bool ok = true;
+
+	while (ok && size > 0) {
+		size_t len = size < sizeof(buffer) ? size : sizeof(buffer);
+		ok = ::write(fd, buffer, len) == (ssize_t)len;
+		size -= len;
+	}
+
+	return (::close(fd) == 0) && ok;
+}
+
+void MavlinkLogHandlerTest::_publish_event(uint8_t event_type, const char *file)
+{
+	log_file_event_s event = {};
+	event.timestamp = hrt_absolute_time();
+	event.event_count = ++_event_count;
+	event.event = event_type;
+	snprintf(event.path, sizeof(event.path), "%s/%s", _log_session_dir, file);
+
+	if (_event_pub == nullptr) {
+		_event_pub = orb_advertise_queue(ORB_ID(log_file_event), &event, log_file_event_s::ORB_QUEUE_LENGTH);
+
+	} else {
+		orb_publish(ORB_ID(log_file_event), _event_pub, &event);
+	}
+}
+
+int MavlinkLogHandlerTest::_request_list(MavlinkLogHandler &handler)
+{
+	mavlink_message_t msg;
+	mavlink_msg_log_request_list_pack(0, 0, &msg, 0, 0, 0, 0xffff);
+	handler.handle_message(&msg);
+
+	return handler._pLogHandlerHelper ? handler._pLogHandlerHelper->log_count : -1;
+}
+
+void MavlinkLogHandlerTest::_erase(MavlinkLogHandler &handler)
+{
+	mavlink_message_t msg;
+	mavlink_msg_log_erase_pack(0, 0, &msg, 0, 0);
+	handler.handle_message(&msg);
+}
+
+/// @brief Closed logs are added to the index without a rescan, also when several
+/// were closed between two listings.
+bool MavlinkLogHandlerTest::_event_test()
+{
+	MavlinkLogHandler handler(nullptr);
+
+	ut_assert("create log failed", _create_log("log001.ulg", 100));
+	ut_compare("initial scan", _request_list(handler), 1);
+
+	ut_assert("create log failed", _create_log("log002.ulg", 200));
+	ut_assert("create log failed", _create_log("log003.ulg", 300));
+	_publish_event(log_file_event_s::EVENT_FILE_CLOSED, "log002.ulg");
+	_publish_event(log_file_event_s::EVENT_FILE_CLOSED, "log003.ulg");
+
+	// Not announced, a rescan would list it
+	ut_assert("create log failed", _create_log("log004.ulg", 400));
+
+	ut_compare("both events applied without rescan", _request_list(handler), 3);
+
+	uint32_t size = 0;
+	uint32_t date = 0;
+	char filename[128];
+	ut_assert("get entry failed", handler._pLogHandlerHelper->get_entry(2, size, date, filename, sizeof(filename)));
+	ut_compare("size of added log", size, 300);
+	ut_assert("path of added log", strstr(filename, "log003.ulg") != nullptr);
+
+	// A missed event needs a rescan
+	_event_count++;
+	_publish_event(log_file_event_s::EVENT_FILE_CLOSED, "log004.ulg");
+	ut_compare("rescan after a missed event", _request_list(handler), 4);
+
+	return true;
+}
+
+/// @brief Erasing the logs through one instance invalidates the index of all of them.
+bool MavlinkLogHandlerTest::_erase_test()
+{
+	MavlinkLogHandler handler_a(nullptr);
+	MavlinkLogHandler handler_b(nullptr);
+
+	ut_assert("create log failed", _create_log("log001.ulg", 100));
+	ut_assert("create log failed", _create_log("log002.ulg", 200));
+	ut_compare("initial scan a", _request_list(handler_a), 2);
+	ut_compare("initial scan b", _request_list(handler_b), 2);
+	ut_compare("b uses the index", _request_list(handler_b), 2);
+
+	_erase(handler_a);
+	ut_compare("logs still listed by b", _request_list(handler_b), 0);
+	ut_compare("logs still listed by a", _request_list(handler_a), 0);
+
+	ut_assert("mkdir failed", ::mkdir(_log_session_dir, S_IRWXU | S_IRWXG | S_IRWXO) == 0);
+	ut_assert("create log failed", _create_log("log001.ulg", 100));
+	_publish_event(log_file_event_s::EVENT_FILE_CLOSED, "log001.ulg");
+	ut_compare("new log after erase, a", _request_list(handler_a), 1);
+	ut_compare("new log after erase, b", _request_list(handler_b), 1);
+
+	return true;
+}
+
+bool MavlinkLogHandlerTest::run_tests()
+{
+	ut_run_test(_event_test);
+	ut_run_test(_erase_test);
+
+	return (_tests_failed == 0);
+}
+
+ut_declare_test(mavlink_log_handler_test, MavlinkLogHandlerTest)
@@ -0,0 +1,77 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2017 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/// @file mavlink_log_handler_test.h
+/// Tests for keeping the log index of the MAVLink log handler up to date
+
+#pragma once
+
+#include <unit_test.h>
+#include <uORB/uORB.h>
+#include "../mavlink_log_handler.h"
+
+class MavlinkLogHandlerTest : public UnitTest
+{
+public:
+	MavlinkLogHandlerTest();
+	virtual ~MavlinkLogHandlerTest();
+
+	virtual bool run_tests(void);
+
+private:
+	virtual void _init(void);
+	virtual void _cleanup(void);
+
+	bool _event_test(void);
+	bool _erase_test(void);
+
+	/// Create a log file of the given size in the test session directory
+	bool _create_log(const char *file, size_t size);
+
+	/// Publish a log_file_event with the next event count
+	void _publish_event(uint8_t event, const char *file);
+
+	/// Send LOG_REQUEST_LIST for all logs to handler
+	/// @return number of logs listed, -1 if no listing was prepared
+	int _request_list(MavlinkLogHandler &handler);
+
+	void _erase(MavlinkLogHandler &handler);
+
+	orb_advert_t _event_pub;
+	uint32_t _event_count;
+
+	static const char _log_root_dir[];
+	static const char _log_session_dir[];
+};
+
+bool mavlink_log_handler_test(void);
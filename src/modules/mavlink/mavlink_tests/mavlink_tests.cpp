@@ -38,10 +38,16 @@
 #include <systemlib/err.h>
 
 #include "mavlink_ftp_test.h"
+#include "mavlink_ulog_test.h"
+#include "mavlink_log_handler_test.h"
 
 extern "C" __EXPORT int mavlink_tests_main(int argc, char *argv[]);
 
 int mavlink_tests_main(int argc, char *argv[])
 {
-	return mavlink_ftp_test() ? 0 : -1;
+	bool ftp_ok = mavlink_ftp_test();
+	bool ulog_ok = mavlink_ulog_test();
+	bool log_handler_ok = mavlink_log_handler_test();
+
+	return (ftp_ok && ulog_ok && log_handler_ok) ? 0 : -1;
 }
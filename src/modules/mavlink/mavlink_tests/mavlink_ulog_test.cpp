@@ -0,0 +1,322 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2017 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/// @file mavlink_ulog_test.cpp
+/// Tests for the reliable ULog streaming window, including a loopback over a simulated lossy link
+
+#include <string.h>
+
+#include "mavlink_ulog_test.h"
+
+static const int link_latency_ms = 20;		///< one-way latency of the simulated link
+static const int ack_timeout_ms = ulog_stream_ack_s::ACK_TIMEOUT;
+
+/// One packet on the simulated link
+struct LinkPacket {
+	int arrival_ms;
+	uint16_t sequence;
+	uint8_t first_byte;
+	uint8_t last_byte;
+};
+
+/// Simulated one-way link with fixed latency and pseudo-random drops
+class SimulatedLink
+{
+public:
+	SimulatedLink(unsigned drop_one_in, uint32_t seed) : _drop_one_in(drop_one_in), _rand(seed) {}
+
+	bool send(int now_ms, uint16_t sequence, uint8_t first_byte = 0, uint8_t last_byte = 0)
+	{
+		if (_drop_one_in > 0 && next_rand() % _drop_one_in == 0) {
+			return true; // dropped
+		}
+
+		if (_count >= capacity) {
+			return false;
+		}
+
+		LinkPacket &packet = _packets[(_first + _count++) % capacity];
+		packet.arrival_ms = now_ms + link_latency_ms;
+		packet.sequence = sequence;
+		packet.first_byte = first_byte;
+		packet.last_byte = last_byte;
+		return true;
+	}
+
+	/// packets are delivered in order, as they all have the same latency
+	bool receive(int now_ms, LinkPacket &packet)
+	{
+		if (_count == 0 || _packets[_first].arrival_ms > now_ms) {
+			return false;
+		}
+
+		packet = _packets[_first];
+		_first = (_first + 1) % capacity;
+		--_count;
+		return true;
+	}
+
+private:
+	uint32_t next_rand()
+	{
+		_rand = _rand * 1103515245u + 12345u;
+		return _rand >> 16;
+	}
+
+	static const int capacity = 256;
+	LinkPacket _packets[capacity];
+	int _first = 0;
+	int _count = 0;
+	const unsigned _drop_one_in;
+	uint32_t _rand;
+};
+
+static void fill_message(ulog_stream_s &msg, uint16_t sequence)
+{
+	memset(&msg, 0, sizeof(msg));
+	msg.timestamp = 1;
+	msg.sequence = sequence;
+	msg.length = sizeof(msg.data);
+	msg.flags = ulog_stream_s::FLAGS_NEED_ACK;
+	msg.data[0] = sequence & 0xff;
+	msg.data[sizeof(msg.data) - 1] = (sequence >> 8) & 0xff;
+}
+
+bool MavlinkULogTest::_window_test()
+{
+	MavlinkULogWindow window;
+	window.reset();
+	ulog_stream_s msg;
+	uint16_t cumulative = 0;
+
+	for (int i = 0; i < MavlinkULogWindow::MAX_SIZE; ++i) {
+		fill_message(msg, 100 + i);
+		ut_assert_false(window.full());
+		const ulog_stream_s *stored = window.add(msg, 0);
+		ut_assert_true(stored != nullptr);
+		ut_compare("stored sequence", stored->sequence, 100 + i);
+	}
+
+	ut_assert_true(window.full());
+	ut_assert_true(window.add(msg, 0) == nullptr);
+
+	// selective acks out of order: the window only moves once the oldest is acked
+	ut_assert_false(window.ack(102, cumulative));
+	ut_assert_false(window.ack(101, cumulative));
+	ut_assert_false(window.ack(999, cumulative));
+	ut_compare("size", window.size(), MavlinkULogWindow::MAX_SIZE);
+
+	ut_assert_true(window.ack(100, cumulative));
+	ut_compare("cumulative ack", cumulative, 102);
+	ut_compare("size", window.size(), MavlinkULogWindow::MAX_SIZE - 3);
+
+	// duplicate acks are ignored
+	ut_assert_false(window.ack(101, cumulative));
+
+	for (int i = 3; i < MavlinkULogWindow::MAX_SIZE; ++i) {
+		ut_assert_true(window.ack(100 + i, cumulative));
+		ut_compare("cumulative ack", cumulative, 100 + i);
+	}
+
+	ut_assert_true(window.empty());
+
+	// sequence wrap-around
+	for (int i = 0; i < 4; ++i) {
+		fill_message(msg, 65534 + i);
+		window.add(msg, 0);
+	}
+
+	ut_assert_false(window.ack(1, cumulative));
+	ut_assert_false(window.ack(0, cumulative));
+	ut_assert_true(window.ack(65534, cumulative));
+	ut_compare("cumulative ack", cumulative, 65534);
+	ut_assert_true(window.ack(65535, cumulative));
+	ut_compare("cumulative ack", cumulative, 1);
+	ut_assert_true(window.empty());
+
+	return true;
+}
+
+bool MavlinkULogTest::_timeout_test()
+{
+	MavlinkULogWindow window;
+	window.reset();
+	ulog_stream_s msg;
+	uint16_t cumulative = 0;
+	bool failed = false;
+	const hrt_abstime timeout = ack_timeout_ms * 1000;
+
+	for (int i = 0; i < 3; ++i) {
+		fill_message(msg, i);
+		window.add(msg, i * 1000);
+	}
+
+	ut_assert_false(window.ack(1, cumulative));
+
+	// nothing timed out yet
+	ut_assert_true(window.next_timeout(timeout, timeout, 3, failed) == nullptr);
+	ut_assert_false(failed);
+
+	// each timed out message is returned once, acked ones never
+	const ulog_stream_s *resend = window.next_timeout(timeout + 5000, timeout, 3, failed);
+	ut_assert_true(resend != nullptr);
+	ut_compare("resend sequence", resend->sequence, 0);
+	resend = window.next_timeout(timeout + 5000, timeout, 3, failed);
+	ut_assert_true(resend != nullptr);
+	ut_compare("resend sequence", resend->sequence, 2);
+	ut_assert_true(window.next_timeout(timeout + 5000, timeout, 3, failed) == nullptr);
+	ut_compare("retransmissions", window.retransmissions(), 2);
+
+	// third try, then give up
+	ut_assert_true(window.next_timeout(2 * timeout + 10000, timeout, 3, failed) != nullptr);
+	ut_assert_true(window.next_timeout(3 * timeout + 20000, timeout, 3, failed) == nullptr);
+	ut_assert_true(failed);
+
+	return true;
+}
+
+bool MavlinkULogTest::_run_loopback(int window_size, int num_messages, unsigned drop_one_in, int &duration_ms)
+{
+	MavlinkULogWindow window;
+	window.reset();
+	SimulatedLink data_link(drop_one_in, 1);
+	SimulatedLink ack_link(drop_one_in, 2);
+
+	// receiver: messages that arrived ahead of a gap, indexed by sequence
+	bool *received = new bool[num_messages];
+
+	if (!received) {
+		return false;
+	}
+
+	memset(received, 0, num_messages * sizeof(bool));
+
+	int next_sequence = 0;		///< next message the logger publishes
+	int logger_acked = 0;		///< number of messages the logger knows are acked (cumulative)
+	int delivered = 0;		///< number of messages the receiver wrote out in order
+	bool ok = true;
+	int now_ms = 0;
+
+	for (; delivered < num_messages && now_ms < 600 * 1000 && ok; ++now_ms) {
+		const hrt_abstime now = (hrt_abstime)now_ms * 1000;
+		ulog_stream_s msg;
+
+		// logger: publish while the window has room
+		while (next_sequence < num_messages && next_sequence - logger_acked < window_size) {
+			fill_message(msg, next_sequence++);
+			const ulog_stream_s *stored = window.add(msg, now);
+			ok = ok && stored && data_link.send(now_ms, stored->sequence, stored->data[0], stored->data[sizeof(msg.data) - 1]);
+		}
+
+		// mavlink: retransmissions
+		bool failed = false;
+		const ulog_stream_s *resend;
+
+		while ((resend = window.next_timeout(now, ack_timeout_ms * 1000, ulog_stream_ack_s::ACK_MAX_TRIES, failed))) {
+			ok = ok && data_link.send(now_ms, resend->sequence, resend->data[0], resend->data[sizeof(msg.data) - 1]);
+		}
+
+		ok = ok && !failed;
+
+		// receiver: ack every message, write out in order
+		LinkPacket packet;
+
+		while (data_link.receive(now_ms, packet)) {
+			ok = ok && ack_link.send(now_ms, packet.sequence);
+
+			if (packet.first_byte != (packet.sequence & 0xff) || packet.last_byte != (packet.sequence >> 8)) {
+				PX4_ERR("corrupted message %i", packet.sequence);
+				ok = false;
+			}
+
+			if (packet.sequence < num_messages) {
+				received[packet.sequence] = true;
+			}
+
+			while (delivered < num_messages && received[delivered]) {
+				++delivered;
+			}
+		}
+
+		// mavlink receive thread: acks
+		while (ack_link.receive(now_ms, packet)) {
+			uint16_t cumulative;
+
+			if (window.ack(packet.sequence, cumulative)) {
+				logger_acked = cumulative + 1;
+			}
+		}
+	}
+
+	delete[] received;
+	duration_ms = now_ms;
+
+	if (delivered != num_messages) {
+		PX4_ERR("window %i: only %i of %i messages delivered", window_size, delivered, num_messages);
+		return false;
+	}
+
+	PX4_INFO("window %2i: %i messages in %i ms simulated time (%u retransmissions)", window_size, num_messages,
+		 duration_ms, window.retransmissions());
+
+	return ok;
+}
+
+bool MavlinkULogTest::_loopback_test()
+{
+	const int num_messages = 500;
+	int duration_stop_and_wait = 0;
+	int duration_window = 0;
+
+	// lossless and lossy links, stop-and-wait and windowed
+	ut_assert_true(_run_loopback(1, num_messages, 0, duration_stop_and_wait));
+	ut_assert_true(_run_loopback(8, num_messages, 0, duration_window));
+	ut_less_than("window is faster", duration_window, duration_stop_and_wait);
+
+	ut_assert_true(_run_loopback(1, num_messages, 10, duration_stop_and_wait));
+	ut_assert_true(_run_loopback(MavlinkULogWindow::MAX_SIZE, num_messages, 10, duration_window));
+	ut_less_than("window is faster", duration_window, duration_stop_and_wait);
+
+	return true;
+}
+
+bool MavlinkULogTest::run_tests()
+{
+	ut_run_test(_window_test);
+	ut_run_test(_timeout_test);
+	ut_run_test(_loopback_test);
+
+	return (_tests_failed == 0);
+}
+
+ut_declare_test(mavlink_ulog_test, MavlinkULogTest)
@@ -56,6 +56,7 @@ MavlinkULog::MavlinkULog(int datarate, float max_rate_factor, uint8_t target_sys
 				      (MAVLINK_MSG_ID_LOGGING_DATA_LEN + MAVLINK_NUM_NON_PAYLOAD_BYTES)))),
 	  _current_rate_factor(max_rate_factor)
 {
+	_window.reset();
 	_ulog_stream_sub = orb_subscribe(ORB_ID(ulog_stream));
 
 	if (_ulog_stream_sub < 0) {
@@ -103,64 +104,37 @@ int MavlinkULog::handle_update(mavlink_channel_t channel)
 		return 0;
 	}
 
-	// check if we're waiting for an ACK
-	if (_last_sent_time) {
-		bool check_for_updates = false;
-
-		if (_ack_received) {
-			_last_sent_time = 0;
-			check_for_updates = true;
+	// re-send the messages for which the ack timed out
+	lock();
+	bool failed = false;
+	const ulog_stream_s *timed_out;
 
-		} else {
+	while ((timed_out = _window.next_timeout(hrt_absolute_time(), ulog_stream_ack_s::ACK_TIMEOUT * 1000,
+			    ulog_stream_ack_s::ACK_MAX_TRIES, failed))) {
+		PX4_DEBUG("re-sending ulog mavlink message %i", timed_out->sequence);
+		send_acked(channel, *timed_out);
+	}
 
-			if (hrt_elapsed_time(&_last_sent_time) > ulog_stream_ack_s::ACK_TIMEOUT * 1000) {
-				if (++_sent_tries > ulog_stream_ack_s::ACK_MAX_TRIES) {
-					return -ETIMEDOUT;
-
-				} else {
-					PX4_DEBUG("re-sending ulog mavlink message (try=%i)", _sent_tries);
-					_last_sent_time = hrt_absolute_time();
-					mavlink_logging_data_acked_t msg;
-					msg.sequence = _ulog_data.sequence;
-					msg.length = _ulog_data.length;
-					msg.first_message_offset = _ulog_data.first_message_offset;
-					msg.target_system = _target_system;
-					msg.target_component = _target_component;
-					memcpy(msg.data, _ulog_data.data, sizeof(msg.data));
-					mavlink_msg_logging_data_acked_send_struct(channel, &msg);
-				}
-			}
-		}
+	unlock();
 
-		if (!check_for_updates) {
-			return 0;
-		}
+	if (failed) {
+		return -ETIMEDOUT;
 	}
 
 	bool updated = false;
 	int ret = orb_check(_ulog_stream_sub, &updated);
 
-	while (updated && !ret && _current_num_msgs < _max_num_messages) {
+	// the logger limits the number of unacked messages, but do not rely on that
+	while (updated && !ret && _current_num_msgs < _max_num_messages && !_window.full()) {
 		orb_copy(ORB_ID(ulog_stream), _ulog_stream_sub, &_ulog_data);
 
 		if (_ulog_data.timestamp > 0) {
 			if (_ulog_data.flags & ulog_stream_s::FLAGS_NEED_ACK) {
-				_sent_tries = 1;
-				_last_sent_time = hrt_absolute_time();
 				lock();
-				_wait_for_ack_sequence = _ulog_data.sequence;
-				_ack_received = false;
+				const ulog_stream_s *stored = _window.add(_ulog_data, hrt_absolute_time());
+				send_acked(channel, *stored);
 				unlock();
 
-				mavlink_logging_data_acked_t msg;
-				msg.sequence = _ulog_data.sequence;
-				msg.length = _ulog_data.length;
-				msg.first_message_offset = _ulog_data.first_message_offset;
-				msg.target_system = _target_system;
-				msg.target_component = _target_component;
-				memcpy(msg.data, _ulog_data.data, sizeof(msg.data));
-				mavlink_msg_logging_data_acked_send_struct(channel, &msg);
-
 			} else {
 				mavlink_logging_data_t msg;
 				msg.sequence = _ulog_data.sequence;
@@ -248,15 +222,29 @@ void MavlinkULog::handle_ack(mavlink_logging_ack_t ack)
 	lock();
 
 	if (_instance) { // make sure stop() was not called right before
-		if (_wait_for_ack_sequence == ack.sequence) {
-			_ack_received = true;
-			publish_ack(ack.sequence);
+		uint16_t cumulative_sequence;
+
+		if (_window.ack(ack.sequence, cumulative_sequence)) {
+			// tell the logger everything up to here arrived, so it can send more
+			publish_ack(cumulative_sequence);
 		}
 	}
 
 	unlock();
 }
 
+void MavlinkULog::send_acked(mavlink_channel_t channel, const ulog_stream_s &ulog_data)
+{
+	mavlink_logging_data_acked_t msg;
+	msg.sequence = ulog_data.sequence;
+	msg.length = ulog_data.length;
+	msg.first_message_offset = ulog_data.first_message_offset;
+	msg.target_system = _target_system;
+	msg.target_component = _target_component;
+	memcpy(msg.data, ulog_data.data, sizeof(msg.data));
+	mavlink_msg_logging_data_acked_send_struct(channel, &msg);
+}
+
 void MavlinkULog::publish_ack(uint16_t sequence)
 {
 	ulog_stream_ack_s ack;
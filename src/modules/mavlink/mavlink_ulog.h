@@ -50,6 +50,7 @@
 #include <uORB/topics/ulog_stream_ack.h>
 
 #include "mavlink_bridge_header.h"
+#include "mavlink_ulog_window.h"
 
 /**
  * @class MavlinkULog
@@ -95,6 +96,7 @@ public:
 
 	float current_data_rate() const { return _current_rate_factor; }
 	float maximum_data_rate() const { return _max_rate_factor; }
+	uint32_t retransmissions() const { return _window.retransmissions(); }
 
 	int get_ulog_stream_fd() const { return _ulog_stream_sub; }
 private:
@@ -115,6 +117,8 @@ private:
 
 	void publish_ack(uint16_t sequence);
 
+	void send_acked(mavlink_channel_t channel, const ulog_stream_s &ulog_data);
+
 	static px4_sem_t _lock;
 	static bool _init;
 	static MavlinkULog *_instance;
@@ -122,10 +126,8 @@ private:
 
 	int _ulog_stream_sub = -1;
 	orb_advert_t _ulog_stream_ack_pub = nullptr;
-	uint16_t _wait_for_ack_sequence;
-	uint8_t _sent_tries = 0;
-	volatile bool _ack_received = false; ///< set to true if a matching ack received
-	hrt_abstime _last_sent_time = 0; ///< last time we sent a message that requires an ack
+	MavlinkULogWindow _window; ///< messages waiting for an ack (protected by _lock)
+	hrt_abstime _last_sent_time = 0; ///< used to time out the initial ack from the logger
 	ulog_stream_s _ulog_data;
 	bool _waiting_for_initial_ack = false;
 	const uint8_t _target_system;
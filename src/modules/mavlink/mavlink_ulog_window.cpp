@@ -0,0 +1,111 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2017 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/**
+ * @file mavlink_ulog_window.cpp
+ * Selective-repeat send window for reliable ULog streaming
+ */
+
+#include "mavlink_ulog_window.h"
+
+#include <string.h>
+
+void MavlinkULogWindow::reset()
+{
+	_first = 0;
+	_count = 0;
+	_retransmissions = 0;
+}
+
+const ulog_stream_s *MavlinkULogWindow::add(const ulog_stream_s &msg, hrt_abstime now)
+{
+	if (full()) {
+		return nullptr;
+	}
+
+	Entry &entry = _entries[(_first + _count) % MAX_SIZE];
+	memcpy(&entry.msg, &msg, sizeof(msg));
+	entry.sent_time = now;
+	entry.tries = 1;
+	entry.acked = false;
+	++_count;
+
+	return &entry.msg;
+}
+
+bool MavlinkULogWindow::ack(uint16_t sequence, uint16_t &cumulative_sequence)
+{
+	for (int i = 0; i < _count; ++i) {
+		Entry &entry = _entries[(_first + i) % MAX_SIZE];
+
+		if (entry.msg.sequence == sequence) {
+			entry.acked = true;
+			break;
+		}
+	}
+
+	bool moved = false;
+
+	while (_count > 0 && _entries[_first].acked) {
+		cumulative_sequence = _entries[_first].msg.sequence;
+		_first = (_first + 1) % MAX_SIZE;
+		--_count;
+		moved = true;
+	}
+
+	return moved;
+}
+
+const ulog_stream_s *MavlinkULogWindow::next_timeout(hrt_abstime now, hrt_abstime timeout, int max_tries,
+		bool &failed)
+{
+	failed = false;
+
+	for (int i = 0; i < _count; ++i) {
+		Entry &entry = _entries[(_first + i) % MAX_SIZE];
+
+		if (!entry.acked && now - entry.sent_time > timeout) {
+			if (entry.tries >= max_tries) {
+				failed = true;
+				return nullptr;
+			}
+
+			entry.sent_time = now;
+			++entry.tries;
+			++_retransmissions;
+			return &entry.msg;
+		}
+	}
+
+	return nullptr;
+}
@@ -0,0 +1,103 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2017 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/**
+ * @file mavlink_ulog_window.h
+ * Selective-repeat send window for reliable ULog streaming
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <drivers/drv_hrt.h>
+
+#include <uORB/topics/ulog_stream.h>
+#include <uORB/topics/ulog_stream_ack.h>
+
+/**
+ * @class MavlinkULogWindow
+ * Keeps the messages that need an ack until they are acked. Each message has its own
+ * retransmit timer and is acked individually (selective repeat), while the window only
+ * slides over a contiguous range of acked messages, which gives the cumulative ack that
+ * is reported back to the logger.
+ * This class is not thread-safe.
+ */
+class MavlinkULogWindow
+{
+public:
+	static constexpr int MAX_SIZE = ulog_stream_ack_s::WINDOW_MAX;
+
+	void reset();
+
+	bool full() const { return _count >= MAX_SIZE; }
+	bool empty() const { return _count == 0; }
+	int size() const { return _count; }
+
+	/**
+	 * add a message that needs an ack. Must only be called if the window is not full.
+	 * @param now time at which the message is sent
+	 * @return the stored copy of the message
+	 */
+	const ulog_stream_s *add(const ulog_stream_s &msg, hrt_abstime now);
+
+	/**
+	 * handle an ack for a single message.
+	 * @param sequence acked sequence
+	 * @param cumulative_sequence set to the sequence up to which all messages are acked, if the window moved
+	 * @return true if the window moved
+	 */
+	bool ack(uint16_t sequence, uint16_t &cumulative_sequence);
+
+	/**
+	 * get the next message for which the ack timed out. Its timer is restarted, so calling
+	 * this in a loop returns each timed out message once.
+	 * @param failed set to true if a message was sent max_tries times already
+	 * @return message to re-send, nullptr if there is none
+	 */
+	const ulog_stream_s *next_timeout(hrt_abstime now, hrt_abstime timeout, int max_tries, bool &failed);
+
+	uint32_t retransmissions() const { return _retransmissions; }
+
+private:
+	struct Entry {
+		ulog_stream_s msg;
+		hrt_abstime sent_time;
+		uint8_t tries;
+		bool acked;
+	};
+
+	Entry _entries[MAX_SIZE];
+	int _first = 0; ///< index of the oldest message
+	int _count = 0;
+	uint32_t _retransmissions = 0;
+};
@@ -62,6 +62,7 @@
 #include <px4_defines.h>
 #include <px4_posix.h>
 #include <px4_tasks.h>
+#include <px4_module.h>
 #include <systemlib/circuit_breaker.h>
 #include <systemlib/err.h>
 #include <systemlib/mixer/mixer.h>
@@ -1399,6 +1400,8 @@ MulticopterAttitudeControl::start()
 	return OK;
 }
 
+PX4_MODULE_DEPENDENCIES(mc_att_control, "");
+
 int mc_att_control_main(int argc, char *argv[])
 {
 	if (argc < 2) {
@@ -53,6 +53,7 @@
 #include <px4_defines.h>
 #include <px4_tasks.h>
 #include <px4_posix.h>
+#include <px4_module.h>
 #include <drivers/drv_hrt.h>
 #include <systemlib/hysteresis/hysteresis.h>
 
@@ -3207,6 +3208,8 @@ MulticopterPositionControl::start()
 	return OK;
 }
 
+PX4_MODULE_DEPENDENCIES(mc_pos_control, "");
+
 int mc_pos_control_main(int argc, char *argv[])
 {
 	if (argc < 2) {
@@ -57,6 +57,7 @@
 #define POLL_MS 1
 #define DEFAULT_RECV_PORT 2019
 #define DEFAULT_SEND_PORT 2020
+#define MAX_TOPIC_INTERVALS 16
 
 void *send(void *data);
 void micrortps_start_topics(struct timespec &begin, int &total_read, uint32_t &received, int &loop);
@@ -75,9 +76,22 @@ struct options {
 	int poll_ms = POLL_MS;
 	uint16_t recv_port = DEFAULT_RECV_PORT;
 	uint16_t send_port = DEFAULT_SEND_PORT;
+	bool batch_frames = false;
+
+	// per-topic update intervals, overriding update_time_ms
+	struct topic_interval {
+		char topic[40];
+		int interval_ms;
+	} topic_intervals[MAX_TOPIC_INTERVALS] = {};
+	int num_topic_intervals = 0;
 };
 
 extern struct options _options;
 extern bool _should_exit_task;
 extern Transport_node *transport_node;
 
+/**
+ * Update interval of a sent topic: the -i override if there is one, update_time_ms otherwise
+ */
+int micrortps_topic_interval(const char *topic);
+
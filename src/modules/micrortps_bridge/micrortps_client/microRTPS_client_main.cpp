@@ -33,12 +33,15 @@
 #include "microRTPS_transport.h"
 #include "microRTPS_client.h"
 
+#include <cerrno>
 #include <cinttypes>
 #include <cstdio>
 #include <cstdlib>
 #include <ctime>
 #include <termios.h>
 
+#include <drivers/drv_hrt.h>
+#include <mathlib/mathlib.h>
 #include <px4_config.h>
 #include <px4_getopt.h>
 #include <px4_module.h>
@@ -64,6 +67,9 @@ static void usage(const char *name)
 	PRINT_MODULE_USAGE_PARAM_INT('p', 1, 1, 1000, "Poll timeout for UART in ms", true);
 	PRINT_MODULE_USAGE_PARAM_INT('u', 0, 0, 10000,
 				     "Interval in ms to limit the update rate of all sent topics (0=unlimited)", true);
+	PRINT_MODULE_USAGE_PARAM_STRING('i', nullptr, "<topic>:<ms>[,<topic>:<ms>...]",
+					"Per-topic update interval, overrides -u for the listed topics", true);
+	PRINT_MODULE_USAGE_PARAM_FLAG('m', "Send all topics updated in one iteration as a single batch frame", true);
 	PRINT_MODULE_USAGE_PARAM_INT('l', 10000, -1, 100000, "Limit number of iterations until the program exits (-1=infinite)",
 				     true);
 	PRINT_MODULE_USAGE_PARAM_INT('w', 1, 1, 1000, "Time in ms for which each iteration sleeps", true);
@@ -72,6 +78,56 @@ static void usage(const char *name)
 
 	PRINT_MODULE_USAGE_COMMAND("stop");
 	PRINT_MODULE_USAGE_COMMAND("status");
+
+	PRINT_MODULE_USAGE_COMMAND_DESCR("bench", "Measure transport throughput over a local UDP loopback");
+	PRINT_MODULE_USAGE_PARAM_INT('l', 10000, 1, 1000000, "Number of messages per run", true);
+	PRINT_MODULE_USAGE_PARAM_INT('r', 2019, 0, 65536, "UDP port of the sending node", true);
+	PRINT_MODULE_USAGE_PARAM_INT('s', 2020, 0, 65536, "UDP port of the receiving node", true);
+}
+
+static int parse_topic_intervals(const char *list)
+{
+	_options.num_topic_intervals = 0;
+
+	while (list && *list) {
+		const char *sep = strchr(list, ':');
+		const char *end = strchr(list, ',');
+
+		if (!end) {
+			end = list + strlen(list);
+		}
+
+		if (!sep || sep > end || sep == list
+		    || (size_t)(sep - list) >= sizeof(_options.topic_intervals[0].topic)) {
+			PX4_ERR("invalid topic interval '%.*s'", (int)(end - list), list);
+			return -1;
+		}
+
+		if (_options.num_topic_intervals >= MAX_TOPIC_INTERVALS) {
+			PX4_ERR("too many topic intervals (max %d)", MAX_TOPIC_INTERVALS);
+			return -1;
+		}
+
+		struct options::topic_interval &entry = _options.topic_intervals[_options.num_topic_intervals++];
+		memcpy(entry.topic, list, sep - list);
+		entry.topic[sep - list] = '\0';
+		entry.interval_ms = strtol(sep + 1, nullptr, 10);
+
+		list = *end ? end + 1 : end;
+	}
+
+	return 0;
+}
+
+int micrortps_topic_interval(const char *topic)
+{
+	for (int i = 0; i < _options.num_topic_intervals; ++i) {
+		if (!strcmp(_options.topic_intervals[i].topic, topic)) {
+			return _options.topic_intervals[i].interval_ms;
+		}
+	}
+
+	return _options.update_time_ms;
 }
 
 static int parse_options(int argc, char *argv[])
@@ -80,7 +136,7 @@ static int parse_options(int argc, char *argv[])
 	int myoptind = 1;
 	const char *myoptarg = nullptr;
 
-	while ((ch = px4_getopt(argc, argv, "t:d:u:l:w:b:p:r:s:", &myoptind, &myoptarg)) != EOF) {
+	while ((ch = px4_getopt(argc, argv, "t:d:u:i:ml:w:b:p:r:s:", &myoptind, &myoptarg)) != EOF) {
 		switch (ch) {
 		case 't': _options.transport      = strcmp(myoptarg, "UDP") == 0 ?
 							    options::eTransports::UDP
@@ -90,6 +146,10 @@ static int parse_options(int argc, char *argv[])
 
 		case 'u': _options.update_time_ms = strtol(myoptarg, nullptr, 10);    break;
 
+		case 'i': if (0 > parse_topic_intervals(myoptarg)) { return -1; } break;
+
+		case 'm': _options.batch_frames   = true;                             break;
+
 		case 'l': _options.loops          = strtol(myoptarg, nullptr, 10);    break;
 
 		case 'w': _options.sleep_ms       = strtol(myoptarg, nullptr, 10);    break;
@@ -156,6 +216,8 @@ static int micrortps_start(int argc, char *argv[])
 		return -1;
 	}
 
+	transport_node->set_frame_batching(_options.batch_frames);
+
 
 	struct timespec begin;
 
@@ -187,6 +249,131 @@ static int micrortps_start(int argc, char *argv[])
 	return 0;
 }
 
+enum class bench_mode {
+	single,		///< one write per message
+	batched,	///< one write per burst, one frame per message
+	frames		///< one write and one frame per burst
+};
+
+static const uint32_t bench_read_timeout_ms = 100;
+static const char *bench_mode_names[] = {"single", "batched", "frames"};
+
+static int micrortps_bench_run(Transport_node &sender, Transport_node &receiver, size_t payload_size,
+			       int messages, bench_mode mode)
+{
+	static const int burst = 32;
+	char payload[512] = {};
+	int sent = 0;
+	int received = 0;
+	size_t total_read = 0;
+	bool batched = (mode != bench_mode::single);
+
+	sender.set_frame_batching(mode == bench_mode::frames);
+
+	for (size_t i = 0; i < payload_size; ++i) {
+		payload[i] = (char)i;
+	}
+
+	hrt_abstime start = hrt_absolute_time();
+
+	while (sent < messages) {
+		int count = math::min(burst, messages - sent);
+
+		for (int i = 0; i < count; ++i) {
+			ssize_t ret = batched ? sender.queue(1, payload, payload_size) : sender.write(1, payload, payload_size);
+
+			if (ret < 0) {
+				PX4_ERR("write failed (%d)", (int)ret);
+				return -1;
+			}
+		}
+
+		if (batched && 0 > sender.flush()) {
+			PX4_ERR("flush failed");
+			return -1;
+		}
+
+		sent += count;
+
+		// Drain each burst so the loopback socket buffer never overflows
+		while (received < sent) {
+			uint8_t topic_ID = 255;
+			char *data = nullptr;
+			size_t data_len = 0;
+			errno = 0;
+			ssize_t ret = receiver.read(&topic_ID, &data, &data_len);
+
+			if (ret > 0 && topic_ID == 1 && data_len == payload_size) {
+				++received;
+				total_read += ret;
+
+			} else if (ret < 0) {
+				if ((errno == EAGAIN || errno == EWOULDBLOCK) && batched) {
+					// A batch datagram carries up to a whole burst, one loss takes all of them
+					PX4_ERR("read timeout, lost %d of %d messages (up to %d per datagram)", sent - received, sent, burst);
+
+				} else if (errno == EAGAIN || errno == EWOULDBLOCK) {
+					PX4_ERR("read timeout, lost %d of %d messages", sent - received, sent);
+
+				} else {
+					PX4_ERR("read failed (%d)", (int)ret);
+				}
+
+				return -1;
+			}
+		}
+	}
+
+	hrt_abstime elapsed = hrt_elapsed_time(&start);
+	double elapsed_secs = elapsed / 1e6;
+
+	printf("%-7s %4u B payload: %8.0f msg/s %10.02f KB/s\n", bench_mode_names[(int)mode],
+	       (unsigned)payload_size, (double)received / elapsed_secs, (double)total_read / (1000 * elapsed_secs));
+
+	return 0;
+}
+
+static int micrortps_bench(int argc, char *argv[])
+{
+	_options.loops = 10000;
+
+	if (0 > parse_options(argc, argv)) {
+		return -1;
+	}
+
+	if (_options.loops < 1) {
+		_options.loops = 1;
+	}
+
+	// Two nodes talking to each other through 127.0.0.1
+	UDP_node sender(_options.recv_port, _options.send_port);
+	UDP_node receiver(_options.send_port, _options.recv_port);
+
+	if (0 > sender.init() || 0 > receiver.init()) {
+		PX4_ERR("UDP init failed");
+		return -1;
+	}
+
+	// Loopback datagrams can still be dropped, don't wait forever for them
+	if (0 > receiver.set_read_timeout(bench_read_timeout_ms)) {
+		return -1;
+	}
+
+	static const size_t payload_sizes[] = {32, 128, 512};
+
+	for (bench_mode mode : {bench_mode::single, bench_mode::batched, bench_mode::frames}) {
+		for (size_t payload_size : payload_sizes) {
+			if (0 > micrortps_bench_run(sender, receiver, payload_size, _options.loops, mode)) {
+				PX4_ERR("%s %u B payload run aborted", bench_mode_names[(int)mode], (unsigned)payload_size);
+				sender.set_frame_batching(false);
+				return -1;
+			}
+		}
+	}
+
+	return 0;
+}
+
 int micrortps_client_main(int argc, char *argv[])
 {
 	if (argc < 2) {
@@ -227,6 +414,19 @@ int micrortps_client_main(int argc, char *argv[])
 		return 0;
 	}
 
+	if (!strcmp(argv[1], "bench")) {
+		if (_rtps_task != -1) {
+			PX4_INFO("Stop the client first");
+			return -1;
+		}
+
+		// the benchmark must not change the options of a later start
+		struct options saved_options = _options;
+		int ret = micrortps_bench(argc - 1, argv + 1);
+		_options = saved_options;
+		return ret;
+	}
+
 	if (!strcmp(argv[1], "stop")) {
 		if (_rtps_task == -1) {
 			PX4_INFO("Not running");
@@ -42,10 +42,12 @@
 #include "navigator.h"
 
 #include <ctype.h>
+#include <stdlib.h>
 
 #include <dataman/dataman.h>
 #include <drivers/drv_hrt.h>
 #include <geo/geo.h>
+#include <mathlib/mathlib.h>
 #include <systemlib/mavlink_log.h>
 #include <v2.0/common/mavlink.h>
 
@@ -74,6 +76,14 @@ Geofence::~Geofence()
 	if (_polygons) {
 		delete[](_polygons);
 	}
+
+	if (_vertices) {
+		delete[](_vertices);
+	}
+
+	if (_segment_splits) {
+		delete[](_segment_splits);
+	}
 }
 
 void Geofence::updateFence()
@@ -183,6 +193,112 @@ void Geofence::_updateFence()
 
 	}
 
+	_loadVertices();
+}
+
+void Geofence::_loadVertices()
+{
+	if (_vertices) {
+		delete[](_vertices);
+		_vertices = nullptr;
+	}
+
+	if (_segment_splits) {
+		delete[](_segment_splits);
+		_segment_splits = nullptr;
+	}
+
+	_num_vertices = 0;
+	_projection_reference = {};
+
+	int total_num_vertices = 0;
+
+	for (int polygon_idx = 0; polygon_idx < _num_polygons; ++polygon_idx) {
+		const PolygonInfo &polygon = _polygons[polygon_idx];
+		bool is_circle_area = polygon.fence_type == MAV_CMD_NAV_FENCE_CIRCLE_INCLUSION
+				      || polygon.fence_type == MAV_CMD_NAV_FENCE_CIRCLE_EXCLUSION;
+		total_num_vertices += is_circle_area ? 1 : polygon.vertex_count;
+	}
+
+	if (total_num_vertices == 0) {
+		return;
+	}
+
+	_vertices = new Vertex[total_num_vertices];
+
+	// a segment crosses each polygon edge at most once and each circle at most twice, plus its two end points
+	_segment_splits = new float[total_num_vertices + _num_polygons + 2];
+
+	if (!_vertices) {
+		_num_polygons = 0;
+		PX4_ERR("alloc failed");
+		return;
+	}
+
+	for (int polygon_idx = 0; polygon_idx < _num_polygons; ++polygon_idx) {
+		PolygonInfo &polygon = _polygons[polygon_idx];
+		bool is_circle_area = polygon.fence_type == MAV_CMD_NAV_FENCE_CIRCLE_INCLUSION
+				      || polygon.fence_type == MAV_CMD_NAV_FENCE_CIRCLE_EXCLUSION;
+		int vertex_count = is_circle_area ? 1 : polygon.vertex_count;
+
+		polygon.vertex_index = _num_vertices;
+		polygon.valid = true;
+		polygon.min_x = FLT_MAX;
+		polygon.max_x = -FLT_MAX;
+		polygon.min_y = FLT_MAX;
+		polygon.max_y = -FLT_MAX;
+
+		for (int i = 0; i < vertex_count; ++i) {
+			mission_fence_point_s mission_fence_point;
+
+			if (dm_read(DM_KEY_FENCE_POINTS, polygon.dataman_index + i, &mission_fence_point,
+				    sizeof(mission_fence_point_s)) != sizeof(mission_fence_point_s)) {
+				PX4_ERR("dm_read failed");
+				polygon.valid = false;
+				break;
+			}
+
+			if (mission_fence_point.frame != MAV_FRAME_GLOBAL && mission_fence_point.frame != MAV_FRAME_GLOBAL_INT
+			    && mission_fence_point.frame != MAV_FRAME_GLOBAL_RELATIVE_ALT
+			    && mission_fence_point.frame != MAV_FRAME_GLOBAL_RELATIVE_ALT_INT) {
+				// TODO: handle different frames
+				PX4_ERR("Frame type %i not supported", (int)mission_fence_point.frame);
+				polygon.valid = false;
+				break;
+			}
+
+			if (!map_projection_initialized(&_projection_reference)) {
+				map_projection_init(&_projection_reference, mission_fence_point.lat, mission_fence_point.lon);
+			}
+
+			Vertex &vertex = _vertices[_num_vertices++];
+			map_projection_project(&_projection_reference, mission_fence_point.lat, mission_fence_point.lon,
+					       &vertex.x, &vertex.y);
+
+			polygon.min_x = math::min(polygon.min_x, vertex.x);
+			polygon.max_x = math::max(polygon.max_x, vertex.x);
+			polygon.min_y = math::min(polygon.min_y, vertex.y);
+			polygon.max_y = math::max(polygon.max_y, vertex.y);
+		}
+
+		if (polygon.valid && is_circle_area) {
+			polygon.min_x -= polygon.circle_radius;
+			polygon.max_x += polygon.circle_radius;
+			polygon.min_y -= polygon.circle_radius;
+			polygon.max_y += polygon.circle_radius;
+		}
+	}
+}
+
+void Geofence::_updateFenceIfChanged()
+{
+	mission_stats_entry_s stats;
+	int ret = dm_read(DM_KEY_FENCE_POINTS, 0, &stats, sizeof(mission_stats_entry_s));
+
+	if (ret == sizeof(mission_stats_entry_s) && _update_counter != stats.update_counter) {
+		PX4_INFO("reloading geofence");
+		_updateFence();
+	}
 }
 
 bool Geofence::checkAll(const struct vehicle_global_position_s &global_position)
@@ -287,20 +403,15 @@ bool Geofence::checkAll(double lat, double lon, float altitude)
 
 bool Geofence::checkPolygons(double lat, double lon, float altitude)
 {
-	// the following uses dm_read, so first we try to lock all items. If that fails, it (most likely) means
-	// the data is currently being updated (via a mavlink geofence transfer), and we do not check for a violation now
+	// the vertices are cached, but we still need to check for a fence update via dm_read, so first we try to lock
+	// all items. If that fails, it (most likely) means the data is currently being updated (via a mavlink geofence
+	// transfer), and we do not check for a violation now
 	if (dm_trylock(DM_KEY_FENCE_POINTS) != 0) {
 		return true;
 	}
 
 	// we got the lock, now check if the fence data got updated
-	mission_stats_entry_s stats;
-	int ret = dm_read(DM_KEY_FENCE_POINTS, 0, &stats, sizeof(mission_stats_entry_s));
-
-	if (ret == sizeof(mission_stats_entry_s) && _update_counter != stats.update_counter) {
-		PX4_INFO("reloading geofence");
-		_updateFence();
-	}
+	_updateFenceIfChanged();
 
 	if (isEmpty()) {
 		dm_unlock(DM_KEY_FENCE_POINTS);
@@ -322,9 +433,12 @@ bool Geofence::checkPolygons(double lat, double lon, float altitude)
 	bool inside_inclusion = false;
 	bool had_inclusion_areas = false;
 
+	float x = 0.f, y = 0.f;
+	map_projection_project(&_projection_reference, lat, lon, &x, &y);
+
 	for (int polygon_idx = 0; polygon_idx < _num_polygons; ++polygon_idx) {
 		if (_polygons[polygon_idx].fence_type == MAV_CMD_NAV_FENCE_CIRCLE_INCLUSION) {
-			bool inside = insideCircle(_polygons[polygon_idx], lat, lon, altitude);
+			bool inside = insideCircle(_polygons[polygon_idx], x, y);
 
 			if (inside) {
 				inside_inclusion = true;
@@ -333,14 +447,14 @@ bool Geofence::checkPolygons(double lat, double lon, float altitude)
 			had_inclusion_areas = true;
 
 		} else if (_polygons[polygon_idx].fence_type == MAV_CMD_NAV_FENCE_CIRCLE_EXCLUSION) {
-			bool inside = insideCircle(_polygons[polygon_idx], lat, lon, altitude);
+			bool inside = insideCircle(_polygons[polygon_idx], x, y);
 
 			if (inside) {
 				outside_exclusion = false;
 			}
 
 		} else { // it's a polygon
-			bool inside = insidePolygon(_polygons[polygon_idx], lat, lon, altitude);
+			bool inside = insidePolygon(_polygons[polygon_idx], x, y);
 
 			if (_polygons[polygon_idx].fence_type == MAV_CMD_NAV_FENCE_POLYGON_VERTEX_INCLUSION) {
 				if (inside) {
@@ -362,76 +476,264 @@ bool Geofence::checkPolygons(double lat, double lon, float altitude)
 	return (!had_inclusion_areas || inside_inclusion) && outside_exclusion;
 }
 
-bool Geofence::insidePolygon(const PolygonInfo &polygon, double lat, double lon, float altitude)
+bool Geofence::checkSegment(double lat_a, double lon_a, double lat_b, double lon_b, bool &fence_busy)
 {
+	// checkPolygons() runs periodically and can skip a check while the fence is being updated. A mission is
+	// only checked once, so a segment that cannot be checked is reported as such instead of being accepted.
+	fence_busy = dm_trylock(DM_KEY_FENCE_POINTS) != 0;
 
-	/* Adaptation of algorithm originally presented as
-	 * PNPOLY - Point Inclusion in Polygon Test
-	 * W. Randolph Franklin (WRF)
-	 * Only supports non-complex polygons (not self intersecting)
-	 */
+	if (fence_busy) {
+		return false;
+	}
 
-	mission_fence_point_s temp_vertex_i;
-	mission_fence_point_s temp_vertex_j;
-	bool c = false;
+	_updateFenceIfChanged();
+
+	if (isEmpty()) {
+		dm_unlock(DM_KEY_FENCE_POINTS);
+		return true;
+	}
+
+	Vertex a, b;
+	map_projection_project(&_projection_reference, lat_a, lon_a, &a.x, &a.y);
+	map_projection_project(&_projection_reference, lat_b, lon_b, &b.x, &b.y);
+
+	bool outside_exclusion = true;
+	bool had_inclusion_areas = false;
+
+	for (int polygon_idx = 0; polygon_idx < _num_polygons && outside_exclusion; ++polygon_idx) {
+		const PolygonInfo &polygon = _polygons[polygon_idx];
+
+		if (polygon.fence_type == MAV_CMD_NAV_FENCE_CIRCLE_INCLUSION
+		    || polygon.fence_type == MAV_CMD_NAV_FENCE_POLYGON_VERTEX_INCLUSION) {
+			had_inclusion_areas = true;
+
+		} else if (!segmentOverlapsBoundingBox(polygon, a, b)) {
+			continue;
+
+		} else if (polygon.fence_type == MAV_CMD_NAV_FENCE_CIRCLE_EXCLUSION) {
+			if (segmentDistanceSquared(_vertices[polygon.vertex_index], a, b) <
+			    polygon.circle_radius * polygon.circle_radius) {
+				outside_exclusion = false;
+			}
+
+		} else { // exclusion polygon
+			if (insidePolygon(polygon, a.x, a.y) || insidePolygon(polygon, b.x, b.y)
+			    || segmentCrossesPolygon(polygon, a, b)) {
+				outside_exclusion = false;
+			}
+		}
+	}
+
+	const bool inside_inclusion = !had_inclusion_areas || (outside_exclusion && segmentInsideInclusion(a, b));
+
+	dm_unlock(DM_KEY_FENCE_POINTS);
+
+	return inside_inclusion && outside_exclusion;
+}
+
+static int compare_floats(const void *a, const void *b)
+{
+	const float fa = *static_cast<const float *>(a);
+	const float fb = *static_cast<const float *>(b);
+	return (fa > fb) - (fa < fb);
+}
+
+bool Geofence::segmentInsideInclusion(const Vertex &a, const Vertex &b)
+{
+	if (!_segment_splits) {
+		return false;
+	}
+
+	// split the segment wherever it crosses the boundary of an inclusion area. Between two splits, the segment
+	// is either completely inside or completely outside of each area, so checking one point per piece is enough.
+	int num_splits = 0;
+	_segment_splits[num_splits++] = 0.f;
+	_segment_splits[num_splits++] = 1.f;
+
+	for (int polygon_idx = 0; polygon_idx < _num_polygons; ++polygon_idx) {
+		const PolygonInfo &polygon = _polygons[polygon_idx];
+
+		if (polygon.fence_type == MAV_CMD_NAV_FENCE_CIRCLE_INCLUSION) {
+			if (segmentOverlapsBoundingBox(polygon, a, b)) {
+				num_splits += segmentCircleSplits(polygon, a, b, &_segment_splits[num_splits]);
+			}
+
+		} else if (polygon.fence_type == MAV_CMD_NAV_FENCE_POLYGON_VERTEX_INCLUSION) {
+			if (segmentOverlapsBoundingBox(polygon, a, b)) {
+				num_splits += segmentPolygonSplits(polygon, a, b, &_segment_splits[num_splits]);
+			}
+		}
+	}
+
+	qsort(_segment_splits, num_splits, sizeof(_segment_splits[0]), compare_floats);
+
+	for (int i = 1; i < num_splits; ++i) {
+		if (_segment_splits[i] <= _segment_splits[i - 1]) {
+			continue; // same split found twice, e.g. at a vertex
+		}
+
+		const float t = 0.5f * (_segment_splits[i - 1] + _segment_splits[i]);
+
+		if (!insideInclusion(a.x + t * (b.x - a.x), a.y + t * (b.y - a.y))) {
+			return false;
+		}
+	}
+
+	return true;
+}
+
+bool Geofence::insideInclusion(float x, float y) const
+{
+	for (int polygon_idx = 0; polygon_idx < _num_polygons; ++polygon_idx) {
+		const PolygonInfo &polygon = _polygons[polygon_idx];
+
+		if ((polygon.fence_type == MAV_CMD_NAV_FENCE_CIRCLE_INCLUSION && insideCircle(polygon, x, y))
+		    || (polygon.fence_type == MAV_CMD_NAV_FENCE_POLYGON_VERTEX_INCLUSION && insidePolygon(polygon, x, y))) {
+			return true;
+		}
+	}
+
+	return false;
+}
+
+bool Geofence::segmentOverlapsBoundingBox(const PolygonInfo &polygon, const Vertex &a, const Vertex &b)
+{
+	return polygon.valid && math::max(a.x, b.x) >= polygon.min_x && math::min(a.x, b.x) <= polygon.max_x
+	       && math::max(a.y, b.y) >= polygon.min_y && math::min(a.y, b.y) <= polygon.max_y;
+}
+
+int Geofence::segmentPolygonSplits(const PolygonInfo &polygon, const Vertex &a, const Vertex &b, float *splits) const
+{
+	const Vertex *vertices = &_vertices[polygon.vertex_index];
+	const float ab_x = b.x - a.x;
+	const float ab_y = b.y - a.y;
+	int num_splits = 0;
 
 	for (unsigned i = 0, j = polygon.vertex_count - 1; i < polygon.vertex_count; j = i++) {
-		if (dm_read(DM_KEY_FENCE_POINTS, polygon.dataman_index + i, &temp_vertex_i,
-			    sizeof(mission_fence_point_s)) != sizeof(mission_fence_point_s)) {
-			break;
+		const Vertex &c = vertices[j];
+		const float cd_x = vertices[i].x - c.x;
+		const float cd_y = vertices[i].y - c.y;
+		const float denominator = ab_x * cd_y - ab_y * cd_x;
+
+		if (fabsf(denominator) < FLT_EPSILON) {
+			continue; // parallel: the segment runs along the edge or does not touch it
 		}
 
-		if (dm_read(DM_KEY_FENCE_POINTS, polygon.dataman_index + j, &temp_vertex_j,
-			    sizeof(mission_fence_point_s)) != sizeof(mission_fence_point_s)) {
-			break;
+		// a + t * (b - a) = c + u * (d - c)
+		const float t = ((c.x - a.x) * cd_y - (c.y - a.y) * cd_x) / denominator;
+		const float u = ((c.x - a.x) * ab_y - (c.y - a.y) * ab_x) / denominator;
+
+		if (t > 0.f && t < 1.f && u >= 0.f && u <= 1.f) {
+			splits[num_splits++] = t;
 		}
+	}
 
-		if (temp_vertex_i.frame != MAV_FRAME_GLOBAL && temp_vertex_i.frame != MAV_FRAME_GLOBAL_INT
-		    && temp_vertex_i.frame != MAV_FRAME_GLOBAL_RELATIVE_ALT
-		    && temp_vertex_i.frame != MAV_FRAME_GLOBAL_RELATIVE_ALT_INT) {
-			// TODO: handle different frames
-			PX4_ERR("Frame type %i not supported", (int)temp_vertex_i.frame);
-			break;
+	return num_splits;
+}
+
+int Geofence::segmentCircleSplits(const PolygonInfo &polygon, const Vertex &a, const Vertex &b, float *splits) const
+{
+	const Vertex &center = _vertices[polygon.vertex_index];
+	const float ab_x = b.x - a.x;
+	const float ab_y = b.y - a.y;
+	const float ca_x = a.x - center.x;
+	const float ca_y = a.y - center.y;
+
+	// |a + t * (b - a) - center|^2 = radius^2
+	const float qa = ab_x * ab_x + ab_y * ab_y;
+	const float qb = 2.f * (ca_x * ab_x + ca_y * ab_y);
+	const float qc = ca_x * ca_x + ca_y * ca_y - polygon.circle_radius * polygon.circle_radius;
+	const float discriminant = qb * qb - 4.f * qa * qc;
+
+	if (qa < FLT_EPSILON || discriminant < 0.f) {
+		return 0;
+	}
+
+	const float root = sqrtf(discriminant);
+	const float t[2] = {(-qb - root) / (2.f * qa), (-qb + root) / (2.f * qa)};
+	int num_splits = 0;
+
+	for (int i = 0; i < 2; ++i) {
+		if (t[i] > 0.f && t[i] < 1.f) {
+			splits[num_splits++] = t[i];
 		}
+	}
 
-		if (((double)temp_vertex_i.lon >= lon) != ((double)temp_vertex_j.lon >= lon) &&
-		    (lat <= (double)(temp_vertex_j.lat - temp_vertex_i.lat) * (lon - (double)temp_vertex_i.lon) /
-		     (double)(temp_vertex_j.lon - temp_vertex_i.lon) + (double)temp_vertex_i.lat)) {
-			c = !c;
+	return num_splits;
+}
+
+bool Geofence::segmentCrossesPolygon(const PolygonInfo &polygon, const Vertex &a, const Vertex &b) const
+{
+	const Vertex *vertices = &_vertices[polygon.vertex_index];
+
+	for (unsigned i = 0, j = polygon.vertex_count - 1; i < polygon.vertex_count; j = i++) {
+		const Vertex &c = vertices[j];
+		const Vertex &d = vertices[i];
+
+		// the segments intersect if the end points of each one lie on different sides of the other one
+		const float side_a = (d.x - c.x) * (a.y - c.y) - (d.y - c.y) * (a.x - c.x);
+		const float side_b = (d.x - c.x) * (b.y - c.y) - (d.y - c.y) * (b.x - c.x);
+		const float side_c = (b.x - a.x) * (c.y - a.y) - (b.y - a.y) * (c.x - a.x);
+		const float side_d = (b.x - a.x) * (d.y - a.y) - (b.y - a.y) * (d.x - a.x);
+
+		if (((side_a > 0.f) != (side_b > 0.f)) && ((side_c > 0.f) != (side_d > 0.f))) {
+			return true;
 		}
 	}
 
-	return c;
+	return false;
 }
 
-bool Geofence::insideCircle(const PolygonInfo &polygon, double lat, double lon, float altitude)
+float Geofence::segmentDistanceSquared(const Vertex &p, const Vertex &a, const Vertex &b)
 {
+	const float ab_x = b.x - a.x;
+	const float ab_y = b.y - a.y;
+	const float length_squared = ab_x * ab_x + ab_y * ab_y;
+	float t = 0.f;
 
-	mission_fence_point_s circle_point;
+	if (length_squared > FLT_EPSILON) {
+		t = math::constrain(((p.x - a.x) * ab_x + (p.y - a.y) * ab_y) / length_squared, 0.f, 1.f);
+	}
+
+	const float dx = p.x - (a.x + t * ab_x);
+	const float dy = p.y - (a.y + t * ab_y);
+	return dx * dx + dy * dy;
+}
 
-	if (dm_read(DM_KEY_FENCE_POINTS, polygon.dataman_index, &circle_point,
-		    sizeof(mission_fence_point_s)) != sizeof(mission_fence_point_s)) {
-		PX4_ERR("dm_read failed");
+bool Geofence::insidePolygon(const PolygonInfo &polygon, float x, float y) const
+{
+	if (!polygon.valid || x < polygon.min_x || x > polygon.max_x || y < polygon.min_y || y > polygon.max_y) {
 		return false;
 	}
 
-	if (circle_point.frame != MAV_FRAME_GLOBAL && circle_point.frame != MAV_FRAME_GLOBAL_INT
-	    && circle_point.frame != MAV_FRAME_GLOBAL_RELATIVE_ALT
-	    && circle_point.frame != MAV_FRAME_GLOBAL_RELATIVE_ALT_INT) {
-		// TODO: handle different frames
-		PX4_ERR("Frame type %i not supported", (int)circle_point.frame);
-		return false;
+	/* Adaptation of algorithm originally presented as
+	 * PNPOLY - Point Inclusion in Polygon Test
+	 * W. Randolph Franklin (WRF)
+	 * Only supports non-complex polygons (not self intersecting)
+	 */
+
+	const Vertex *vertices = &_vertices[polygon.vertex_index];
+	bool c = false;
+
+	for (unsigned i = 0, j = polygon.vertex_count - 1; i < polygon.vertex_count; j = i++) {
+		if ((vertices[i].y >= y) != (vertices[j].y >= y) &&
+		    (x <= (vertices[j].x - vertices[i].x) * (y - vertices[i].y) / (vertices[j].y - vertices[i].y) + vertices[i].x)) {
+			c = !c;
+		}
 	}
 
-	if (!map_projection_initialized(&_projection_reference)) {
-		map_projection_init(&_projection_reference, lat, lon);
+	return c;
+}
+
+bool Geofence::insideCircle(const PolygonInfo &polygon, float x, float y) const
+{
+	if (!polygon.valid || x < polygon.min_x || x > polygon.max_x || y < polygon.min_y || y > polygon.max_y) {
+		return false;
 	}
 
-	float x1, y1, x2, y2;
-	map_projection_project(&_projection_reference, lat, lon, &x1, &y1);
-	map_projection_project(&_projection_reference, circle_point.lat, circle_point.lon, &x2, &y2);
-	float dx = x1 - x2, dy = y1 - y2;
-	return dx * dx + dy * dy < circle_point.circle_radius * circle_point.circle_radius;
+	const Vertex &center = _vertices[polygon.vertex_index];
+	float dx = x - center.x, dy = y - center.y;
+	return dx * dx + dy * dy < polygon.circle_radius * polygon.circle_radius;
 }
 
 bool
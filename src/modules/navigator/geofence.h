@@ -99,6 +99,17 @@ public:
 	 */
 	bool check(const struct mission_item_s &mission_item);
 
+	/**
+	 * Return whether the straight line between two points obeys the horizontal geofence (polygons & circles).
+	 * Every point of the segment must lie within one of the inclusion areas (possibly a different one for
+	 * different parts of the segment) and the segment must not touch any exclusion area.
+	 * Altitude and distance to home are not checked, use check() for the end points.
+	 *
+	 * @param fence_busy set to true if the fence is currently being updated and the segment could not be checked
+	 * @return true: segment is obeying fence, false: segment is violating fence or could not be checked
+	 */
+	bool checkSegment(double lat_a, double lon_a, double lat_b, double lon_b, bool &fence_busy);
+
 	int clearDm();
 
 	bool valid();
@@ -153,10 +164,22 @@ private:
 			uint16_t vertex_count;
 			float circle_radius;
 		};
+		uint16_t vertex_index; ///< index of the first vertex (or the circle center) in _vertices
+		bool valid; ///< false if the vertices could not be loaded (e.g. unsupported frame)
+		float min_x, max_x, min_y, max_y; ///< bounding box in local coordinates [m]
 	};
 	PolygonInfo *_polygons{nullptr};
 	int _num_polygons{0};
 
+	/** fence point in local coordinates [m] w.r.t. _projection_reference (x: north, y: east) */
+	struct Vertex {
+		float x;
+		float y;
+	};
+	Vertex *_vertices{nullptr}; ///< vertices of all polygons, loaded from dataman when the fence changes
+	int _num_vertices{0};
+	float *_segment_splits{nullptr}; ///< scratch buffer for checkSegment(), sized for the current fence
+
 	map_projection_reference_s _projection_reference = {}; ///< reference to convert (lon, lat) to local [m]
 
 	/* Params */
@@ -175,6 +198,17 @@ private:
 	 */
 	void _updateFence();
 
+	/**
+	 * Load all polygon vertices & circle centers from dataman into _vertices (local coordinates)
+	 * and compute the bounding boxes. Called from _updateFence().
+	 */
+	void _loadVertices();
+
+	/**
+	 * reload the fence if the dataman update counter changed. The caller must hold the dataman lock.
+	 */
+	void _updateFenceIfChanged();
+
 	/**
 	 * Check if a point passes the Geofence test.
 	 * This takes all polygons and minimum & maximum altitude into account
@@ -200,16 +234,60 @@ private:
 
 	/**
 	 * Check if a single point is within a polygon
+	 * @param x, y point in local coordinates [m]
 	 * @return true if within polygon
 	 */
-	bool insidePolygon(const PolygonInfo &polygon, double lat, double lon, float altitude);
+	bool insidePolygon(const PolygonInfo &polygon, float x, float y) const;
 
 	/**
 	 * Check if a single point is within a circle
 	 * @param polygon must be a circle!
+	 * @param x, y point in local coordinates [m]
 	 * @return true if within polygon the circle
 	 */
-	bool insideCircle(const PolygonInfo &polygon, double lat, double lon, float altitude);
+	bool insideCircle(const PolygonInfo &polygon, float x, float y) const;
+
+	/**
+	 * Check if the segment a-b intersects any edge of a polygon
+	 * @param polygon must be a polygon!
+	 */
+	bool segmentCrossesPolygon(const PolygonInfo &polygon, const Vertex &a, const Vertex &b) const;
+
+	/**
+	 * Check if every point of the segment a-b is within at least one inclusion area
+	 */
+	bool segmentInsideInclusion(const Vertex &a, const Vertex &b);
+
+	/**
+	 * Check if a single point is within at least one inclusion area
+	 */
+	bool insideInclusion(float x, float y) const;
+
+	/**
+	 * @return false if the segment a-b is completely outside the bounding box of the polygon (or circle)
+	 */
+	static bool segmentOverlapsBoundingBox(const PolygonInfo &polygon, const Vertex &a, const Vertex &b);
+
+	/**
+	 * Find where the segment a-b crosses the edges of a polygon
+	 * @param polygon must be a polygon!
+	 * @param splits output: positions t in (0, 1) of the crossings a + t * (b - a), one per edge at most
+	 * @return number of crossings written to splits
+	 */
+	int segmentPolygonSplits(const PolygonInfo &polygon, const Vertex &a, const Vertex &b, float *splits) const;
+
+	/**
+	 * Find where the segment a-b crosses a circle
+	 * @param polygon must be a circle!
+	 * @param splits output: positions t in (0, 1) of the crossings a + t * (b - a), two at most
+	 * @return number of crossings written to splits
+	 */
+	int segmentCircleSplits(const PolygonInfo &polygon, const Vertex &a, const Vertex &b, float *splits) const;
+
+	/**
+	 * @return squared distance between point p and segment a-b [m^2]
+	 */
+	static float segmentDistanceSquared(const Vertex &p, const Vertex &a, const Vertex &b);
 };
 
 #endif /* GEOFENCE_H_ */
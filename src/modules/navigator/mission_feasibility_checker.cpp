@@ -54,9 +54,35 @@ bool
 MissionFeasibilityChecker::checkMissionFeasible(const mission_s &mission, float max_waypoint_distance,
 		bool land_start_req)
 {
-	dm_item_t dm_current = DM_KEY_WAYPOINTS_OFFBOARD(mission.dataman_id);
-	const size_t nMissionItems = mission.count;
+	_dm_current = DM_KEY_WAYPOINTS_OFFBOARD(mission.dataman_id);
+	loadItems(mission.count);
 
+	const bool feasible = checkItems(mission.count, max_waypoint_distance, land_start_req);
+
+	freeItems();
+
+	return feasible;
+}
+
+bool
+MissionFeasibilityChecker::checkMissionFeasible(const mission_item_s *items, size_t count, float max_waypoint_distance,
+		bool land_start_req)
+{
+	freeItems();
+
+	_items = items;
+	_num_items = count;
+
+	const bool feasible = checkItems(count, max_waypoint_distance, land_start_req);
+
+	freeItems();
+
+	return feasible;
+}
+
+bool
+MissionFeasibilityChecker::checkItems(size_t nMissionItems, float max_waypoint_distance, bool land_start_req)
+{
 	const bool isRotarywing = (_navigator->get_vstatus()->is_rotary_wing || _navigator->get_vstatus()->is_vtol);
 
 	Geofence &geofence = _navigator->get_geofence();
@@ -82,36 +108,85 @@ MissionFeasibilityChecker::checkMissionFeasible(const mission_s &mission, float
 		const double lon = _navigator->get_home_position()->lon;
 
 		failed = failed
-			 || !check_dist_1wp(dm_current, nMissionItems, lat, lon, max_waypoint_distance, warning_issued);
+			 || !check_dist_1wp(nMissionItems, lat, lon, max_waypoint_distance, warning_issued);
 	}
 
 	// check if all mission item commands are supported
-	failed = failed || !checkMissionItemValidity(dm_current, nMissionItems, landed);
-	failed = failed || !checkGeofence(dm_current, nMissionItems, geofence, home_alt, home_valid);
-	failed = failed || !checkHomePositionAltitude(dm_current, nMissionItems, home_alt, home_valid, warned);
+	failed = failed || !checkMissionItemValidity(nMissionItems, landed);
+	failed = failed || !checkGeofence(nMissionItems, geofence, home_alt, home_valid);
+	failed = failed || !checkHomePositionAltitude(nMissionItems, home_alt, home_valid, warned);
 
 	if (isRotarywing) {
 		failed = failed
-			 || !checkRotarywing(dm_current, nMissionItems, home_alt, home_valid, default_acceptance_rad);
+			 || !checkRotarywing(nMissionItems, home_alt, home_valid, default_acceptance_rad);
 
 	} else {
 		failed = failed
-			 || !checkFixedwing(dm_current, nMissionItems, fw_pos_ctrl_status, home_alt, home_valid,
+			 || !checkFixedwing(nMissionItems, fw_pos_ctrl_status, home_alt, home_valid,
 					    default_acceptance_rad, land_start_req);
 	}
 
 	return !failed;
 }
 
+void
+MissionFeasibilityChecker::loadItems(size_t nMissionItems)
+{
+	freeItems();
+
+	if (nMissionItems == 0 || nMissionItems > MAX_LOADED_ITEMS) {
+		return;
+	}
+
+	_loaded_items = new mission_item_s[nMissionItems];
+
+	if (!_loaded_items) {
+		return;
+	}
+
+	for (size_t i = 0; i < nMissionItems; i++) {
+		if (dm_read(_dm_current, i, &_loaded_items[i], sizeof(mission_item_s)) != sizeof(mission_item_s)) {
+			// let the checks read from dataman and report the error
+			freeItems();
+			return;
+		}
+	}
+
+	_items = _loaded_items;
+	_num_items = nMissionItems;
+}
+
+void
+MissionFeasibilityChecker::freeItems()
+{
+	if (_loaded_items) {
+		delete[] _loaded_items;
+		_loaded_items = nullptr;
+	}
+
+	_items = nullptr;
+	_num_items = 0;
+}
+
 bool
-MissionFeasibilityChecker::checkRotarywing(dm_item_t dm_current, size_t nMissionItems,
+MissionFeasibilityChecker::readItem(size_t index, mission_item_s &item)
+{
+	if (index < _num_items) {
+		item = _items[index];
+		return true;
+	}
+
+	return dm_read(_dm_current, index, &item, sizeof(mission_item_s)) == sizeof(mission_item_s);
+}
+
+bool
+MissionFeasibilityChecker::checkRotarywing(size_t nMissionItems,
 		float home_alt, bool home_valid, float default_acceptance_rad)
 {
 	for (size_t i = 0; i < nMissionItems; i++) {
 		struct mission_item_s missionitem = {};
-		const ssize_t len = sizeof(struct mission_item_s);
 
-		if (dm_read(dm_current, i, &missionitem, len) != len) {
+		if (!readItem(i, missionitem)) {
 			/* not supposed to happen unless the datamanager can't access the SD card, etc. */
 			return false;
 		}
@@ -141,20 +216,20 @@ MissionFeasibilityChecker::checkRotarywing(dm_item_t dm_current, size_t nMission
 }
 
 bool
-MissionFeasibilityChecker::checkFixedwing(dm_item_t dm_current, size_t nMissionItems,
+MissionFeasibilityChecker::checkFixedwing(size_t nMissionItems,
 		fw_pos_ctrl_status_s *fw_pos_ctrl_status, float home_alt, bool home_valid,
 		float default_acceptance_rad, bool land_start_req)
 {
 	/* Perform checks and issue feedback to the user for all checks */
-	bool resTakeoff = checkFixedWingTakeoff(dm_current, nMissionItems, home_alt, home_valid, land_start_req);
-	bool resLanding = checkFixedWingLanding(dm_current, nMissionItems, fw_pos_ctrl_status, land_start_req);
+	bool resTakeoff = checkFixedWingTakeoff(nMissionItems, home_alt, home_valid, land_start_req);
+	bool resLanding = checkFixedWingLanding(nMissionItems, fw_pos_ctrl_status, land_start_req);
 
 	/* Mission is only marked as feasible if all checks return true */
 	return (resTakeoff && resLanding);
 }
 
 bool
-MissionFeasibilityChecker::checkGeofence(dm_item_t dm_current, size_t nMissionItems, Geofence &geofence, float home_alt,
+MissionFeasibilityChecker::checkGeofence(size_t nMissionItems, Geofence &geofence, float home_alt,
 		bool home_valid)
 {
 
@@ -163,13 +238,16 @@ MissionFeasibilityChecker::checkGeofence(dm_item_t dm_current, size_t nMissionIt
 		return false;
 	}
 
-	/* Check if all mission items are inside the geofence (if we have a valid geofence) */
+	/* Check if all mission items and the path between them are inside the geofence (if we have a valid geofence) */
 	if (geofence.valid()) {
+		mission_item_s previous_item = {};
+		size_t previous_index = 0;
+		bool has_previous = false;
+
 		for (size_t i = 0; i < nMissionItems; i++) {
 			struct mission_item_s missionitem = {};
-			const ssize_t len = sizeof(missionitem);
 
-			if (dm_read(dm_current, i, &missionitem, len) != len) {
+			if (!readItem(i, missionitem)) {
 				/* not supposed to happen unless the datamanager can't access the SD card, etc. */
 				return false;
 			}
@@ -188,6 +266,27 @@ MissionFeasibilityChecker::checkGeofence(dm_item_t dm_current, size_t nMissionIt
 				mavlink_log_critical(_navigator->get_mavlink_log_pub(), "Geofence violation for waypoint %d", i + 1);
 				return false;
 			}
+
+			if (MissionBlock::item_contains_position(missionitem)) {
+				bool fence_busy = false;
+
+				if (has_previous
+				    && !geofence.checkSegment(previous_item.lat, previous_item.lon, missionitem.lat, missionitem.lon, fence_busy)) {
+					if (fence_busy) {
+						mavlink_log_critical(_navigator->get_mavlink_log_pub(), "Geofence is being updated, mission not checked");
+
+					} else {
+						mavlink_log_critical(_navigator->get_mavlink_log_pub(), "Geofence violation between waypoints %d and %d",
+								     previous_index + 1, i + 1);
+					}
+
+					return false;
+				}
+
+				previous_item = missionitem;
+				previous_index = i;
+				has_previous = true;
+			}
 		}
 	}
 
@@ -195,15 +294,14 @@ MissionFeasibilityChecker::checkGeofence(dm_item_t dm_current, size_t nMissionIt
 }
 
 bool
-MissionFeasibilityChecker::checkHomePositionAltitude(dm_item_t dm_current, size_t nMissionItems,
+MissionFeasibilityChecker::checkHomePositionAltitude(size_t nMissionItems,
 		float home_alt, bool home_valid, bool &warning_issued, bool throw_error)
 {
 	/* Check if all waypoints are above the home altitude */
 	for (size_t i = 0; i < nMissionItems; i++) {
 		struct mission_item_s missionitem = {};
-		const ssize_t len = sizeof(struct mission_item_s);
 
-		if (dm_read(dm_current, i, &missionitem, len) != len) {
+		if (!readItem(i, missionitem)) {
 			warning_issued = true;
 			/* not supposed to happen unless the datamanager can't access the SD card, etc. */
 			return false;
@@ -246,14 +344,13 @@ MissionFeasibilityChecker::checkHomePositionAltitude(dm_item_t dm_current, size_
 }
 
 bool
-MissionFeasibilityChecker::checkMissionItemValidity(dm_item_t dm_current, size_t nMissionItems, bool landed)
+MissionFeasibilityChecker::checkMissionItemValidity(size_t nMissionItems, bool landed)
 {
 	// do not allow mission if we find unsupported item
 	for (size_t i = 0; i < nMissionItems; i++) {
 		struct mission_item_s missionitem;
-		const ssize_t len = sizeof(struct mission_item_s);
 
-		if (dm_read(dm_current, i, &missionitem, len) != len) {
+		if (!readItem(i, missionitem)) {
 			// not supposed to happen unless the datamanager can't access the SD card, etc.
 			mavlink_log_critical(_navigator->get_mavlink_log_pub(), "Mission rejected: Cannot access SD card");
 			return false;
@@ -324,14 +421,13 @@ MissionFeasibilityChecker::checkMissionItemValidity(dm_item_t dm_current, size_t
 }
 
 bool
-MissionFeasibilityChecker::checkFixedWingTakeoff(dm_item_t dm_current, size_t nMissionItems,
+MissionFeasibilityChecker::checkFixedWingTakeoff(size_t nMissionItems,
 		float home_alt, bool home_valid, float default_acceptance_rad)
 {
 	for (size_t i = 0; i < nMissionItems; i++) {
 		struct mission_item_s missionitem = {};
-		const ssize_t len = sizeof(struct mission_item_s);
 
-		if (dm_read(dm_current, i, &missionitem, len) != len) {
+		if (!readItem(i, missionitem)) {
 			/* not supposed to happen unless the datamanager can't access the SD card, etc. */
 			return false;
 		}
@@ -364,7 +460,7 @@ MissionFeasibilityChecker::checkFixedWingTakeoff(dm_item_t dm_current, size_t nM
 }
 
 bool
-MissionFeasibilityChecker::checkFixedWingLanding(dm_item_t dm_current, size_t nMissionItems,
+MissionFeasibilityChecker::checkFixedWingLanding(size_t nMissionItems,
 		fw_pos_ctrl_status_s *fw_pos_ctrl_status, bool land_start_req)
 {
 	/* Go through all mission items and search for a landing waypoint
@@ -378,9 +474,8 @@ MissionFeasibilityChecker::checkFixedWingLanding(dm_item_t dm_current, size_t nM
 
 	for (size_t i = 0; i < nMissionItems; i++) {
 		struct mission_item_s missionitem;
-		const ssize_t len = sizeof(missionitem);
 
-		if (dm_read(dm_current, i, &missionitem, len) != len) {
+		if (!readItem(i, missionitem)) {
 			/* not supposed to happen unless the datamanager can't access the SD card, etc. */
 			return false;
 		}
@@ -403,7 +498,7 @@ MissionFeasibilityChecker::checkFixedWingLanding(dm_item_t dm_current, size_t nM
 			if (i > 0) {
 				landing_approach_index = i - 1;
 
-				if (dm_read(dm_current, landing_approach_index, &missionitem_previous, len) != len) {
+				if (!readItem(landing_approach_index, missionitem_previous)) {
 					/* not supposed to happen unless the datamanager can't access the SD card, etc. */
 					return false;
 				}
@@ -476,7 +571,7 @@ MissionFeasibilityChecker::checkFixedWingLanding(dm_item_t dm_current, size_t nM
 }
 
 bool
-MissionFeasibilityChecker::check_dist_1wp(dm_item_t dm_current, size_t nMissionItems, double curr_lat, double curr_lon,
+MissionFeasibilityChecker::check_dist_1wp(size_t nMissionItems, double curr_lat, double curr_lon,
 		float dist_first_wp, bool &warning_issued)
 {
 	/* check if first waypoint is not too far from home */
@@ -485,7 +580,7 @@ MissionFeasibilityChecker::check_dist_1wp(dm_item_t dm_current, size_t nMissionI
 
 		/* find first waypoint (with lat/lon) item in datamanager */
 		for (size_t i = 0; i < nMissionItems; i++) {
-			if (dm_read(dm_current, i, &mission_item, sizeof(mission_item_s)) == sizeof(mission_item_s)) {
+			if (readItem(i, mission_item)) {
 				if (MissionBlock::item_contains_position(mission_item)) {
 					/* check only items with valid lat/lon */
 
@@ -43,6 +43,7 @@
 #define MISSION_FEASIBILITY_CHECKER_H_
 
 #include <dataman/dataman.h>
+#include <navigator/navigation.h>
 #include <uORB/topics/mission.h>
 #include <uORB/topics/fw_pos_ctrl_status.h>
 
@@ -54,33 +55,52 @@ class MissionFeasibilityChecker
 private:
 	Navigator *_navigator{nullptr};
 
+	/* The mission is read from dataman once into _loaded_items, all checks work on that copy (or on the
+	 * caller's items) through _items. If it does not fit (or allocation fails), readItem() falls back
+	 * to reading from dataman. */
+#ifdef __PX4_NUTTX
+	static constexpr size_t MAX_LOADED_ITEMS = 100;
+#else
+	static constexpr size_t MAX_LOADED_ITEMS = UINT16_MAX;
+#endif
+	dm_item_t _dm_current{DM_KEY_WAYPOINTS_OFFBOARD_0};
+	mission_item_s *_loaded_items{nullptr};
+	const mission_item_s *_items{nullptr};
+	size_t _num_items{0};
+
+	bool checkItems(size_t nMissionItems, float max_waypoint_distance, bool land_start_req);
+
+	void loadItems(size_t nMissionItems);
+	void freeItems();
+	bool readItem(size_t index, mission_item_s &item);
+
 	/* Checks for all airframes */
-	bool checkGeofence(dm_item_t dm_current, size_t nMissionItems, Geofence &geofence, float home_alt, bool home_valid);
+	bool checkGeofence(size_t nMissionItems, Geofence &geofence, float home_alt, bool home_valid);
 
-	bool checkHomePositionAltitude(dm_item_t dm_current, size_t nMissionItems, float home_alt, bool home_valid,
+	bool checkHomePositionAltitude(size_t nMissionItems, float home_alt, bool home_valid,
 				       bool &warning_issued, bool throw_error = false);
 
-	bool checkMissionItemValidity(dm_item_t dm_current, size_t nMissionItems, bool condition_landed);
+	bool checkMissionItemValidity(size_t nMissionItems, bool condition_landed);
 
-	bool check_dist_1wp(dm_item_t dm_current, size_t nMissionItems, double curr_lat, double curr_lon,
+	bool check_dist_1wp(size_t nMissionItems, double curr_lat, double curr_lon,
 			    float dist_first_wp, bool &warning_issued);
 
 	/* Checks specific to fixedwing airframes */
-	bool checkFixedwing(dm_item_t dm_current, size_t nMissionItems, fw_pos_ctrl_status_s *fw_pos_ctrl_status,
+	bool checkFixedwing(size_t nMissionItems, fw_pos_ctrl_status_s *fw_pos_ctrl_status,
 			    float home_alt, bool home_valid, float default_acceptance_rad, bool land_start_req);
 
-	bool checkFixedWingTakeoff(dm_item_t dm_current, size_t nMissionItems, float home_alt, bool home_valid,
+	bool checkFixedWingTakeoff(size_t nMissionItems, float home_alt, bool home_valid,
 				   float default_acceptance_rad);
-	bool checkFixedWingLanding(dm_item_t dm_current, size_t nMissionItems, fw_pos_ctrl_status_s *fw_pos_ctrl_status,
+	bool checkFixedWingLanding(size_t nMissionItems, fw_pos_ctrl_status_s *fw_pos_ctrl_status,
 				   bool land_start_req);
 
 	/* Checks specific to rotarywing airframes */
-	bool checkRotarywing(dm_item_t dm_current, size_t nMissionItems,
+	bool checkRotarywing(size_t nMissionItems,
 			     float home_alt, bool home_valid, float default_acceptance_rad);
 
 public:
 	MissionFeasibilityChecker(Navigator *navigator) : _navigator(navigator) {}
-	~MissionFeasibilityChecker() = default;
+	~MissionFeasibilityChecker() { freeItems(); }
 
 	MissionFeasibilityChecker(const MissionFeasibilityChecker &) = delete;
 	MissionFeasibilityChecker &operator=(const MissionFeasibilityChecker &) = delete;
@@ -90,6 +110,12 @@ public:
 	 */
 	bool checkMissionFeasible(const mission_s &mission, float max_waypoint_distance, bool land_start_req);
 
+	/*
+	 * Same as above, but for a mission that is not stored in dataman
+	 */
+	bool checkMissionFeasible(const mission_item_s *items, size_t count, float max_waypoint_distance,
+				  bool land_start_req);
+
 };
 
 #endif /* MISSION_FEASIBILITY_CHECKER_H_ */
@@ -101,6 +101,12 @@ public:
 	 */
 	void		load_fence_from_file(const char *filename);
 
+	/**
+	 * Time the mission feasibility checks on a synthetic survey mission around home.
+	 * The checks run in the navigator task, this waits until they are done.
+	 */
+	void		request_feasibility_bench(unsigned num_items, unsigned num_runs);
+
 	/**
 	 * Publish the geofence result
 	 */
@@ -225,6 +231,9 @@ public:
 private:
 
 	bool		_task_should_exit{false};	/**< if true, sensor task should exit */
+
+	volatile unsigned _feasibility_bench_items{0};	/**< items of a requested feasibility bench, 0 if none is pending */
+	volatile unsigned _feasibility_bench_runs{0};	/**< runs of a requested feasibility bench */
 	int		_navigator_task{-1};		/**< task handle for sensor task */
 
 	int		_fw_pos_ctrl_status_sub{-1};	/**< notification of vehicle capabilities updates */
@@ -334,5 +343,10 @@ private:
 	void		publish_mission_result();
 
 	void		publish_vehicle_command_ack(const vehicle_command_s &cmd, uint8_t result);
+
+	/**
+	 * Run a requested feasibility bench, called from the navigator task
+	 */
+	void		run_feasibility_bench(unsigned num_items, unsigned num_runs);
 };
 #endif
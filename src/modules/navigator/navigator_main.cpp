@@ -55,6 +55,7 @@
 #include <px4_defines.h>
 #include <px4_posix.h>
 #include <px4_tasks.h>
+#include <px4_module.h>
 #include <sys/ioctl.h>
 #include <sys/stat.h>
 #include <sys/types.h>
@@ -705,6 +706,11 @@ Navigator::task_main()
 		}
 
 		perf_end(_loop_perf);
+
+		if (_feasibility_bench_items > 0) {
+			run_feasibility_bench(_feasibility_bench_items, _feasibility_bench_runs);
+			_feasibility_bench_items = 0;
+		}
 	}
 
 	orb_unsubscribe(_global_pos_sub);
@@ -878,6 +884,84 @@ Navigator::load_fence_from_file(const char *filename)
 	_geofence.loadFromFile(filename);
 }
 
+void
+Navigator::request_feasibility_bench(unsigned num_items, unsigned num_runs)
+{
+	if (_feasibility_bench_items > 0) {
+		PX4_ERR("already running");
+		return;
+	}
+
+	_feasibility_bench_runs = num_runs;
+	_feasibility_bench_items = num_items;
+
+	/* the task picks the request up within its 1 s poll timeout */
+	while (_feasibility_bench_items > 0 && !_task_should_exit) {
+		usleep(10000);
+	}
+}
+
+void
+Navigator::run_feasibility_bench(unsigned num_items, unsigned num_runs)
+{
+	if (_vstatus.arming_state == vehicle_status_s::ARMING_STATE_ARMED) {
+		PX4_ERR("not available while armed");
+		return;
+	}
+
+	if (!home_position_valid()) {
+		PX4_ERR("no home position");
+		return;
+	}
+
+	mission_item_s *items = new mission_item_s[num_items];
+
+	if (!items) {
+		PX4_ERR("alloc failed");
+		return;
+	}
+
+	// lawnmower survey starting at home: 200 m legs to the north, 10 m apart
+	static constexpr float leg_length = 200.f;
+	static constexpr float leg_spacing = 10.f;
+
+	map_projection_reference_s home_reference;
+	map_projection_init(&home_reference, _home_pos.lat, _home_pos.lon);
+
+	for (unsigned i = 0; i < num_items; i++) {
+		const unsigned leg = i / 2;
+		const bool far_end = (i % 2 == 1) != (leg % 2 == 1);
+
+		items[i] = {};
+		items[i].nav_cmd = NAV_CMD_WAYPOINT;
+		items[i].altitude = 20.f;
+		items[i].altitude_is_relative = true;
+		items[i].acceptance_radius = get_default_acceptance_radius();
+		items[i].autocontinue = true;
+		map_projection_reproject(&home_reference, far_end ? leg_length : 0.f, leg * leg_spacing,
+					 &items[i].lat, &items[i].lon);
+	}
+
+	MissionFeasibilityChecker checker(this);
+	bool feasible = false;
+	hrt_abstime elapsed = 0;
+
+	for (unsigned run = 0; run < num_runs; run++) {
+		const hrt_abstime start = hrt_absolute_time();
+		feasible = checker.checkMissionFeasible(items, num_items, 0.f, false);
+		elapsed += hrt_elapsed_time(&start);
+	}
+
+	delete[] items;
+
+	PX4_INFO("%u items, %u runs: %s, %.3f ms per check", num_items, num_runs, feasible ? "feasible" : "not feasible",
+		 (double)(elapsed / num_runs) / 1000.0);
+
+	if (!feasible) {
+		PX4_INFO("checks stopped at the first failure, see the mavlink log");
+	}
+}
+
 bool
 Navigator::abort_landing()
 {
@@ -899,9 +983,12 @@ Navigator::abort_landing()
 
 static void usage()
 {
-	PX4_INFO("usage: navigator {start|stop|status|fencefile}");
+	PX4_INFO("usage: navigator {start|stop|status|fencefile|feasibility_bench [items] [runs]}");
+	PX4_INFO("       feasibility_bench: time the mission checks on a synthetic survey around home (disarmed only)");
 }
 
+PX4_MODULE_DEPENDENCIES(navigator, "");
+
 int navigator_main(int argc, char *argv[])
 {
 	if (argc < 2) {
@@ -948,6 +1035,17 @@ int navigator_main(int argc, char *argv[])
 	} else if (!strcmp(argv[1], "fencefile")) {
 		navigator::g_navigator->load_fence_from_file(GEOFENCE_FILENAME);
 
+	} else if (!strcmp(argv[1], "feasibility_bench")) {
+		const int num_items = argc > 2 ? atoi(argv[2]) : 1000;
+		const int num_runs = argc > 3 ? atoi(argv[3]) : 10;
+
+		if (num_items < 1 || num_items > UINT16_MAX || num_runs < 1) {
+			usage();
+			return 1;
+		}
+
+		navigator::g_navigator->request_feasibility_bench(num_items, num_runs);
+
 	} else {
 		usage();
 		return 1;
@@ -757,7 +757,7 @@ void sdlog2_start_log()
 	perf_write = perf_alloc(PC_ELAPSED, "sd write");
 
 	/* start log buffer emptying thread */
-	if (0 != pthread_create(&logwriter_pthread, &logwriter_attr, logwriter_thread, &lb)) {
+	if (0 != px4_pthread_create(&logwriter_pthread, &logwriter_attr, logwriter_thread, &lb)) {
 		PX4_WARN("error creating logwriter thread");
 	}
 
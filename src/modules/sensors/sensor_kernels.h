@@ -0,0 +1,136 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2017 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+
+#pragma once
+
+/**
+ * @file sensor_kernels.h
+ *
+ * Per-sample math of the sensor voting, on the samples of all instances of a
+ * sensor type at once. The data is stored as structure of arrays with one lane
+ * per instance, and all kernels run over the fixed number of lanes, so that
+ * the compiler can vectorize them.
+ */
+
+#include <mathlib/mathlib.h>
+
+#include "common.h"
+
+namespace sensors
+{
+
+/**
+ * One value per axis and instance.
+ */
+struct SensorSamples3D {
+	float x[SENSOR_COUNT_MAX];
+	float y[SENSOR_COUNT_MAX];
+	float z[SENSOR_COUNT_MAX];
+
+	void set(unsigned instance, float vx, float vy, float vz)
+	{
+		x[instance] = vx;
+		y[instance] = vy;
+		z[instance] = vz;
+	}
+
+	void get(unsigned instance, float v[3]) const
+	{
+		v[0] = x[instance];
+		v[1] = y[instance];
+		v[2] = z[instance];
+	}
+};
+
+/**
+ * Calibration of each instance: corrected = (raw - offset) * scale.
+ */
+struct SensorCorrections3D {
+	SensorSamples3D offset;
+	SensorSamples3D scale;
+
+	/** no correction for an instance */
+	void set_identity(unsigned instance)
+	{
+		offset.set(instance, 0.f, 0.f, 0.f);
+		scale.set(instance, 1.f, 1.f, 1.f);
+	}
+};
+
+/**
+ * Scale the raw data of each instance by gain (e.g. to convert integrals into rates), apply
+ * the corrections and rotate the result into the body frame.
+ * @param data input raw data, output corrected data in body frame
+ * @param gain per-instance factor applied to the raw data
+ * @param corrections per-instance offsets and scales
+ * @param rotation board rotation, shared by all instances
+ */
+static inline void correct_and_rotate(SensorSamples3D &data, const float gain[SENSOR_COUNT_MAX],
+				      const SensorCorrections3D &corrections, const math::Matrix<3, 3> &rotation)
+{
+	const float r00 = rotation(0, 0), r01 = rotation(0, 1), r02 = rotation(0, 2);
+	const float r10 = rotation(1, 0), r11 = rotation(1, 1), r12 = rotation(1, 2);
+	const float r20 = rotation(2, 0), r21 = rotation(2, 1), r22 = rotation(2, 2);
+
+	for (unsigned i = 0; i < SENSOR_COUNT_MAX; i++) {
+		const float x = (data.x[i] * gain[i] - corrections.offset.x[i]) * corrections.scale.x[i];
+		const float y = (data.y[i] * gain[i] - corrections.offset.y[i]) * corrections.scale.y[i];
+		const float z = (data.z[i] * gain[i] - corrections.offset.z[i]) * corrections.scale.z[i];
+
+		data.x[i] = r00 * x + r01 * y + r02 * z;
+		data.y[i] = r10 * x + r11 * y + r12 * z;
+		data.z[i] = r20 * x + r21 * y + r22 * z;
+	}
+}
+
+/**
+ * Rotate the data of each instance by its own rotation (e.g. external magnetometers).
+ * @param data input sensor frame, output body frame
+ * @param rotations per-instance rotation
+ */
+static inline void rotate_each(SensorSamples3D &data, const math::Matrix<3, 3> rotations[SENSOR_COUNT_MAX])
+{
+	for (unsigned i = 0; i < SENSOR_COUNT_MAX; i++) {
+		const math::Matrix<3, 3> &r = rotations[i];
+		const float x = data.x[i];
+		const float y = data.y[i];
+		const float z = data.z[i];
+
+		data.x[i] = r(0, 0) * x + r(0, 1) * y + r(0, 2) * z;
+		data.y[i] = r(1, 0) * x + r(1, 1) * y + r(1, 2) * z;
+		data.z[i] = r(2, 0) * x + r(2, 1) * y + r(2, 2) * z;
+	}
+}
+
+} /* namespace sensors */
@@ -831,6 +831,8 @@ Sensors *Sensors::instantiate(int argc, char *argv[])
 	return new Sensors(hil_enabled);;
 }
 
+PX4_MODULE_DEPENDENCIES(sensors, "gyrosim accelsim barosim adcsim measairspeedsim");
+
 int sensors_main(int argc, char *argv[])
 {
 	return Sensors::main(argc, argv);
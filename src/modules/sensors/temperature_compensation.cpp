@@ -47,10 +47,17 @@
 namespace sensors
 {
 
+TemperatureCompensation::~TemperatureCompensation()
+{
+	delete _offset_tables;
+}
+
 int TemperatureCompensation::initialize_parameter_handles(ParameterHandles &parameter_handles)
 {
 	char nbuf[16];
 
+	parameter_handles.lut_enable = param_find("TC_LUT_ENABLE");
+
 	/* rate gyro calibration parameters */
 	parameter_handles.gyro_tc_enable = param_find("TC_G_ENABLE");
 
@@ -142,13 +149,19 @@ int TemperatureCompensation::parameters_update()
 {
 	int ret = 0;
 
-	ParameterHandles parameter_handles;
-	ret = initialize_parameter_handles(parameter_handles);
+	// the parameter set is fixed, only look the handles up once
+	if (!_parameter_handles_initialized) {
+		ret = initialize_parameter_handles(_parameter_handles);
 
-	if (ret != 0) {
-		return ret;
+		if (ret != 0) {
+			return ret;
+		}
+
+		_parameter_handles_initialized = true;
 	}
 
+	const ParameterHandles &parameter_handles = _parameter_handles;
+
 	/* rate gyro calibration parameters */
 	param_get(parameter_handles.gyro_tc_enable, &(_parameters.gyro_tc_enable));
 
@@ -239,6 +252,27 @@ int TemperatureCompensation::parameters_update()
 		}
 	}
 
+	/* offset lookup tables */
+	_parameters.lut_enable = 0;
+	param_get(parameter_handles.lut_enable, &(_parameters.lut_enable));
+
+	if (_parameters.lut_enable == 1) {
+		if (_offset_tables == nullptr) {
+			_offset_tables = new OffsetTables();
+		}
+
+		if (_offset_tables != nullptr) {
+			generate_offset_tables();
+
+		} else {
+			PX4_ERR("alloc failed, using polynomials");
+		}
+
+	} else if (_offset_tables != nullptr) {
+		delete _offset_tables;
+		_offset_tables = nullptr;
+	}
+
 	/* the offsets & scales might have changed, so make sure to report that change later when applying the
 	 * next corrections
 	 */
@@ -249,6 +283,96 @@ int TemperatureCompensation::parameters_update()
 	return ret;
 }
 
+void TemperatureCompensation::generate_offset_tables()
+{
+	for (int j = 0; j < GYRO_COUNT_MAX + ACCEL_COUNT_MAX; j++) {
+		const bool is_gyro = j < GYRO_COUNT_MAX;
+		const SensorCalData3D &coef = is_gyro ? _parameters.gyro_cal_data[j] : _parameters.accel_cal_data[j - GYRO_COUNT_MAX];
+		OffsetTable<3> &table = is_gyro ? _offset_tables->gyro[j] : _offset_tables->accel[j - GYRO_COUNT_MAX];
+
+		const float step = (coef.max_temp - coef.min_temp) / (OFFSET_TABLE_SIZE - 1);
+		table.valid = step > 0.f;
+
+		if (!table.valid) {
+			continue;
+		}
+
+		table.step_inv = 1.f / step;
+
+		for (int i = 0; i < OFFSET_TABLE_SIZE; i++) {
+			calc_thermal_offsets_3D(coef, coef.min_temp + i * step, table.offset[i]);
+		}
+	}
+
+	for (int j = 0; j < BARO_COUNT_MAX; j++) {
+		SensorCalData1D &coef = _parameters.baro_cal_data[j];
+		OffsetTable<1> &table = _offset_tables->baro[j];
+
+		const float step = (coef.max_temp - coef.min_temp) / (OFFSET_TABLE_SIZE - 1);
+		table.valid = step > 0.f;
+
+		if (!table.valid) {
+			continue;
+		}
+
+		table.step_inv = 1.f / step;
+
+		for (int i = 0; i < OFFSET_TABLE_SIZE; i++) {
+			calc_thermal_offsets_1D(coef, coef.min_temp + i * step, table.offset[i][0]);
+		}
+	}
+}
+
+template<int N>
+bool TemperatureCompensation::lookup_thermal_offsets(const OffsetTable<N> &table, float min_temp, float max_temp,
+		float measured_temp, float offset[])
+{
+	bool ret = true;
+
+	// measured_temp must be finite, the callers fall back to the polynomial otherwise
+
+	// clip the measured temperature to remain within the calibration range
+	if (measured_temp > max_temp) {
+		measured_temp = max_temp;
+		ret = false;
+
+	} else if (measured_temp < min_temp) {
+		measured_temp = min_temp;
+		ret = false;
+	}
+
+	// interpolate linearly between the two neighbouring entries
+	const float position = (measured_temp - min_temp) * table.step_inv;
+	const int index = math::min((int)position, OFFSET_TABLE_SIZE - 2);
+	const float fraction = position - index;
+
+	for (int i = 0; i < N; i++) {
+		offset[i] = table.offset[index][i] + fraction * (table.offset[index + 1][i] - table.offset[index][i]);
+	}
+
+	return ret;
+}
+
+bool TemperatureCompensation::get_thermal_offsets_3D(const SensorCalData3D &coef, const OffsetTable<3> *table,
+		float measured_temp, float offset[])
+{
+	if (table != nullptr && table->valid && PX4_ISFINITE(measured_temp)) {
+		return lookup_thermal_offsets(*table, coef.min_temp, coef.max_temp, measured_temp, offset);
+	}
+
+	return calc_thermal_offsets_3D(coef, measured_temp, offset);
+}
+
+bool TemperatureCompensation::get_thermal_offsets_1D(SensorCalData1D &coef, const OffsetTable<1> *table,
+		float measured_temp, float &offset)
+{
+	if (table != nullptr && table->valid && PX4_ISFINITE(measured_temp)) {
+		return lookup_thermal_offsets(*table, coef.min_temp, coef.max_temp, measured_temp, &offset);
+	}
+
+	return calc_thermal_offsets_1D(coef, measured_temp, offset);
+}
+
 bool TemperatureCompensation::calc_thermal_offsets_1D(SensorCalData1D &coef, float measured_temp, float &offset)
 {
 	bool ret = true;
@@ -350,7 +474,11 @@ int TemperatureCompensation::set_sensor_id(uint32_t device_id, int topic_instanc
 {
 	for (int i = 0; i < sensor_count_max; ++i) {
 		if (device_id == sensor_cal_data[i].ID) {
-			sensor_data.device_mapping[topic_instance] = i;
+			if (sensor_data.device_mapping[topic_instance] != i) {
+				sensor_data.device_mapping[topic_instance] = i;
+				sensor_data.offsets_temperature[topic_instance] = NAN;
+			}
+
 			return i;
 		}
 	}
@@ -358,8 +486,7 @@ int TemperatureCompensation::set_sensor_id(uint32_t device_id, int topic_instanc
 	return -1;
 }
 
-int TemperatureCompensation::apply_corrections_gyro(int topic_instance, math::Vector<3> &sensor_data, float temperature,
-		float *offsets, float *scales)
+int TemperatureCompensation::get_corrections_gyro(int topic_instance, float temperature, float *offsets, float *scales)
 {
 	if (_parameters.gyro_tc_enable != 1) {
 		return 0;
@@ -371,12 +498,16 @@ int TemperatureCompensation::apply_corrections_gyro(int topic_instance, math::Ve
 		return -1;
 	}
 
-	calc_thermal_offsets_3D(_parameters.gyro_cal_data[mapping], temperature, offsets);
+	// the offsets only depend on the temperature
+	if (_gyro_data.update_offsets_temperature(topic_instance, temperature)) {
+		get_thermal_offsets_3D(_parameters.gyro_cal_data[mapping], _offset_tables ? &_offset_tables->gyro[mapping] : nullptr,
+				       temperature, _gyro_data.offsets[topic_instance]);
+	}
 
-	// get the sensor scale factors and correct the data
+	// get the sensor offsets & scale factors
 	for (unsigned axis_index = 0; axis_index < 3; axis_index++) {
+		offsets[axis_index] = _gyro_data.offsets[topic_instance][axis_index];
 		scales[axis_index] = _parameters.gyro_cal_data[mapping].scale[axis_index];
-		sensor_data(axis_index) = (sensor_data(axis_index) - offsets[axis_index]) * scales[axis_index];
 	}
 
 	if (fabsf(temperature - _gyro_data.last_temperature[topic_instance]) > 1.0f) {
@@ -387,8 +518,7 @@ int TemperatureCompensation::apply_corrections_gyro(int topic_instance, math::Ve
 	return 1;
 }
 
-int TemperatureCompensation::apply_corrections_accel(int topic_instance, math::Vector<3> &sensor_data,
-		float temperature, float *offsets, float *scales)
+int TemperatureCompensation::get_corrections_accel(int topic_instance, float temperature, float *offsets, float *scales)
 {
 	if (_parameters.accel_tc_enable != 1) {
 		return 0;
@@ -400,12 +530,16 @@ int TemperatureCompensation::apply_corrections_accel(int topic_instance, math::V
 		return -1;
 	}
 
-	calc_thermal_offsets_3D(_parameters.accel_cal_data[mapping], temperature, offsets);
+	// the offsets only depend on the temperature
+	if (_accel_data.update_offsets_temperature(topic_instance, temperature)) {
+		get_thermal_offsets_3D(_parameters.accel_cal_data[mapping], _offset_tables ? &_offset_tables->accel[mapping] : nullptr,
+				       temperature, _accel_data.offsets[topic_instance]);
+	}
 
-	// get the sensor scale factors and correct the data
+	// get the sensor offsets & scale factors
 	for (unsigned axis_index = 0; axis_index < 3; axis_index++) {
+		offsets[axis_index] = _accel_data.offsets[topic_instance][axis_index];
 		scales[axis_index] = _parameters.accel_cal_data[mapping].scale[axis_index];
-		sensor_data(axis_index) = (sensor_data(axis_index) - offsets[axis_index]) * scales[axis_index];
 	}
 
 	if (fabsf(temperature - _accel_data.last_temperature[topic_instance]) > 1.0f) {
@@ -429,7 +563,13 @@ int TemperatureCompensation::apply_corrections_baro(int topic_instance, float &s
 		return -1;
 	}
 
-	calc_thermal_offsets_1D(_parameters.baro_cal_data[mapping], temperature, *offsets);
+	// the offset only depends on the temperature
+	if (_baro_data.update_offsets_temperature(topic_instance, temperature)) {
+		get_thermal_offsets_1D(_parameters.baro_cal_data[mapping], _offset_tables ? &_offset_tables->baro[mapping] : nullptr,
+				       temperature, _baro_data.offsets[topic_instance][0]);
+	}
+
+	*offsets = _baro_data.offsets[topic_instance][0];
 
 	// get the sensor scale factors and correct the data
 	*scales = _parameters.baro_cal_data[mapping].scale;
@@ -446,6 +586,7 @@ int TemperatureCompensation::apply_corrections_baro(int topic_instance, float &s
 void TemperatureCompensation::print_status()
 {
 	PX4_INFO("Temperature Compensation:");
+	PX4_INFO(" lookup tables: %s", _offset_tables ? "yes" : "no");
 	PX4_INFO(" gyro: enabled: %i", _parameters.gyro_tc_enable);
 
 	if (_parameters.gyro_tc_enable == 1) {
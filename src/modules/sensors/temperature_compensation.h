@@ -61,10 +61,15 @@ static_assert(BARO_COUNT_MAX == 3,
 /**
  ** class TemperatureCompensation
  * Applies temperature compensation to sensor data. Loads the parameters from PX4 param storage.
+ *
+ * The offsets are only recomputed when the temperature of a sensor changed. With TC_LUT_ENABLE
+ * set, they are looked up in tables over the calibrated temperature range (generated on parameter
+ * change) instead of evaluating the polynomials.
  */
 class TemperatureCompensation
 {
 public:
+	~TemperatureCompensation();
 
 	/** (re)load the parameters. Make sure to call this on startup as well */
 	int parameters_update();
@@ -78,23 +83,32 @@ public:
 
 
 	/**
-	 * Apply Thermal corrections to gyro (& other) sensor data.
+	 * Get the thermal corrections of gyro & accel data, to be applied as (data - offset) * scale.
 	 * @param topic_instance uORB topic instance
-	 * @param sensor_data input sensor data, output sensor data with applied corrections
 	 * @param temperature measured current temperature
-	 * @param offsets returns offsets that were applied (length = 3, except for baro), depending on return value
-	 * @param scales returns scales that were applied (length = 3), depending on return value
+	 * @param offsets returns offsets to apply (length = 3), depending on return value
+	 * @param scales returns scales to apply (length = 3), depending on return value
 	 * @return -1: error: correction enabled, but no sensor mapping set (@see set_sendor_id_gyro)
+	 *         0: no correction (correction not enabled),
+	 *         1: corrections returned but no changes to offsets & scales,
+	 *         2: corrections returned and offsets & scales updated
+	 */
+	int get_corrections_gyro(int topic_instance, float temperature, float *offsets, float *scales);
+
+	int get_corrections_accel(int topic_instance, float temperature, float *offsets, float *scales);
+
+	/**
+	 * Apply Thermal corrections to baro data.
+	 * @param topic_instance uORB topic instance
+	 * @param sensor_data input sensor data, output sensor data with applied corrections
+	 * @param temperature measured current temperature
+	 * @param offsets returns offset that was applied, depending on return value
+	 * @param scales returns scale that was applied, depending on return value
+	 * @return -1: error: correction enabled, but no sensor mapping set (@see set_sendor_id_baro)
 	 *         0: no changes (correction not enabled),
 	 *         1: corrections applied but no changes to offsets & scales,
 	 *         2: corrections applied and offsets & scales updated
 	 */
-	int apply_corrections_gyro(int topic_instance, math::Vector<3> &sensor_data, float temperature,
-				   float *offsets, float *scales);
-
-	int apply_corrections_accel(int topic_instance, math::Vector<3> &sensor_data, float temperature,
-				    float *offsets, float *scales);
-
 	int apply_corrections_baro(int topic_instance, float &sensor_data, float temperature,
 				   float *offsets, float *scales);
 
@@ -187,6 +201,7 @@ private:
 
 	// create a struct containing all thermal calibration parameters
 	struct Parameters {
+		int lut_enable;
 		int gyro_tc_enable;
 		SensorCalData3D gyro_cal_data[GYRO_COUNT_MAX];
 		int accel_tc_enable;
@@ -197,6 +212,7 @@ private:
 
 	// create a struct containing the handles required to access all calibration parameters
 	struct ParameterHandles {
+		param_t lut_enable;
 		param_t gyro_tc_enable;
 		SensorCalHandles3D gyro_cal_handles[GYRO_COUNT_MAX];
 		param_t accel_tc_enable;
@@ -252,20 +268,75 @@ private:
 	bool calc_thermal_offsets_3D(const SensorCalData3D &coef, float measured_temp, float offset[]);
 
 
+	static constexpr int OFFSET_TABLE_SIZE = 32; ///< number of temperatures in an offset table
+
+	/**
+	 * Offsets of a sensor at OFFSET_TABLE_SIZE temperatures evenly spaced over [min_temp, max_temp]
+	 * of its calibration.
+	 */
+	template<int N>
+	struct OffsetTable {
+		bool valid; ///< false if the calibrated temperature range is empty
+		float step_inv; ///< 1 / temperature difference between two entries
+		float offset[OFFSET_TABLE_SIZE][N];
+	};
+
+	struct OffsetTables {
+		OffsetTable<3> gyro[GYRO_COUNT_MAX];
+		OffsetTable<3> accel[ACCEL_COUNT_MAX];
+		OffsetTable<1> baro[BARO_COUNT_MAX];
+	};
+
+	/** (re)generate the tables from the current parameters */
+	void generate_offset_tables();
+
+	/**
+	 * Interpolate the offsets from a table, clipping the temperature to the calibrated range like
+	 * calc_thermal_offsets_*.
+	 * @return true if the measured temperature is inside the valid range for the compensation
+	 */
+	template<int N>
+	static bool lookup_thermal_offsets(const OffsetTable<N> &table, float min_temp, float max_temp, float measured_temp,
+					   float offset[]);
+
+	/** get the offsets of a sensor from its table if there is one, from the polynomial otherwise */
+	bool get_thermal_offsets_3D(const SensorCalData3D &coef, const OffsetTable<3> *table, float measured_temp,
+				    float offset[]);
+	bool get_thermal_offsets_1D(SensorCalData1D &coef, const OffsetTable<1> *table, float measured_temp, float &offset);
+
 	Parameters _parameters;
+	ParameterHandles _parameter_handles;
+	bool _parameter_handles_initialized = false;
+
+	OffsetTables *_offset_tables = nullptr; ///< only allocated with TC_LUT_ENABLE set
+
+	/** the offsets are recomputed when the temperature of a sensor changed by at least this much [deg C] */
+	static constexpr float TEMPERATURE_UPDATE_THRESHOLD = 0.05f;
 
 
 	struct PerSensorData {
 		PerSensorData()
 		{
-			for (int i = 0; i < SENSOR_COUNT_MAX; ++i) { device_mapping[i] = 255; last_temperature[i] = -100.0f; }
+			for (int i = 0; i < SENSOR_COUNT_MAX; ++i) { device_mapping[i] = 255; last_temperature[i] = -100.0f; offsets_temperature[i] = NAN; }
 		}
 		void reset_temperature()
 		{
-			for (int i = 0; i < SENSOR_COUNT_MAX; ++i) { last_temperature[i] = -100.0f; }
+			for (int i = 0; i < SENSOR_COUNT_MAX; ++i) { last_temperature[i] = -100.0f; offsets_temperature[i] = NAN; }
+		}
+		/** @return true if the offsets of a topic instance need to be recomputed for the temperature */
+		bool update_offsets_temperature(int topic_instance, float temperature)
+		{
+			if (fabsf(temperature - offsets_temperature[topic_instance]) < TEMPERATURE_UPDATE_THRESHOLD) {
+				return false;
+			}
+
+			offsets_temperature[topic_instance] = temperature;
+			return true;
 		}
 		uint8_t device_mapping[SENSOR_COUNT_MAX]; /// map a topic instance to the parameters index
 		float last_temperature[SENSOR_COUNT_MAX];
+		float offsets_temperature[SENSOR_COUNT_MAX]; /// temperature the offsets were computed for, NAN if none
+		float offsets[SENSOR_COUNT_MAX][3]; /// last computed offsets
 	};
 	PerSensorData _gyro_data;
 	PerSensorData _accel_data;
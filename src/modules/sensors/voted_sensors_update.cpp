@@ -111,6 +111,8 @@ void VotedSensorsUpdate::initialize_sensors()
 	init_sensor_class(ORB_ID(sensor_mag), _mag, MAG_COUNT_MAX);
 	init_sensor_class(ORB_ID(sensor_accel), _accel, ACCEL_COUNT_MAX);
 	init_sensor_class(ORB_ID(sensor_baro), _baro, BARO_COUNT_MAX);
+	init_fifo_class(ORB_ID(sensor_gyro_fifo), _gyro);
+	init_fifo_class(ORB_ID(sensor_accel_fifo), _accel);
 }
 
 void VotedSensorsUpdate::deinit()
@@ -130,6 +132,14 @@ void VotedSensorsUpdate::deinit()
 	for (unsigned i = 0; i < _baro.subscription_count; i++) {
 		orb_unsubscribe(_baro.subscription[i]);
 	}
+
+	for (int i = 0; i < _gyro.fifo_subscription_count; i++) {
+		orb_unsubscribe(_gyro.fifo_subscription[i]);
+	}
+
+	for (int i = 0; i < _accel.fifo_subscription_count; i++) {
+		orb_unsubscribe(_accel.fifo_subscription[i]);
+	}
 }
 
 void VotedSensorsUpdate::parameters_update()
@@ -527,6 +537,13 @@ void VotedSensorsUpdate::accel_poll(struct sensor_combined_s &raw)
 	float *offsets[] = {_corrections.accel_offset_0, _corrections.accel_offset_1, _corrections.accel_offset_2 };
 	float *scales[] = {_corrections.accel_scale_0, _corrections.accel_scale_1, _corrections.accel_scale_2 };
 
+	// gather the new samples of all instances, then correct them in one go
+	SensorSamples3D accel_data = {};
+	SensorCorrections3D corrections = {};
+	float dt_inv[SENSOR_COUNT_MAX] = {};
+	bool updated[SENSOR_COUNT_MAX] = {};
+	uint64_t error_count[SENSOR_COUNT_MAX];
+
 	for (unsigned uorb_index = 0; uorb_index < _accel.subscription_count; uorb_index++) {
 		bool accel_updated;
 		orb_check(_accel.subscription[uorb_index], &accel_updated);
@@ -549,9 +566,24 @@ void VotedSensorsUpdate::accel_poll(struct sensor_combined_s &raw)
 
 			_accel_device_id[uorb_index] = accel_report.device_id;
 
-			math::Vector<3> accel_data;
+			// sample blocks are published before the report they belong to
+			fifo_poll(ORB_ID(sensor_accel_fifo), _accel, _accel_device_id);
+			FifoIntegral &fifo = _accel.fifo_integral[uorb_index];
+
+			if (fifo.dt > 0.f) {
+				/*
+				 * The driver publishes all samples of its FIFO: use the average over all of
+				 * them since the last report, which is free of the aliasing of the samples the
+				 * driver integrates at its polling rate.
+				 */
+				dt_inv[uorb_index] = 1.e6f / fifo.dt;
+				accel_data.set(uorb_index, fifo.integral[0], fifo.integral[1], fifo.integral[2]);
+
+				_last_sensor_data[uorb_index].accelerometer_integral_dt = (uint32_t)fifo.dt;
+
+				fifo = {};
 
-			if (accel_report.integral_dt != 0) {
+			} else if (accel_report.integral_dt != 0) {
 				/*
 				 * Using data that has been integrated in the driver before downsampling is preferred
 				 * becasue it reduces aliasing errors. Correct the raw sensor data for scale factor errors
@@ -560,9 +592,8 @@ void VotedSensorsUpdate::accel_poll(struct sensor_combined_s &raw)
 				*/
 
 				// convert the delta velocities to an equivalent acceleration before application of corrections
-				float dt_inv = 1.e6f / accel_report.integral_dt;
-				accel_data = math::Vector<3>(accel_report.x_integral * dt_inv, accel_report.y_integral * dt_inv,
-							     accel_report.z_integral * dt_inv);
+				dt_inv[uorb_index] = 1.e6f / accel_report.integral_dt;
+				accel_data.set(uorb_index, accel_report.x_integral, accel_report.y_integral, accel_report.z_integral);
 
 				_last_sensor_data[uorb_index].accelerometer_integral_dt = accel_report.integral_dt;
 
@@ -571,7 +602,8 @@ void VotedSensorsUpdate::accel_poll(struct sensor_combined_s &raw)
 
 				// Correct each sensor for temperature effects
 				// Filtering and/or downsampling of temperature should be performed in the driver layer
-				accel_data = math::Vector<3>(accel_report.x, accel_report.y, accel_report.z);
+				dt_inv[uorb_index] = 1.f;
+				accel_data.set(uorb_index, accel_report.x, accel_report.y, accel_report.z);
 
 				// handle the cse where this is our first output
 				if (_last_accel_timestamp[uorb_index] == 0) {
@@ -584,23 +616,40 @@ void VotedSensorsUpdate::accel_poll(struct sensor_combined_s &raw)
 			}
 
 			// handle temperature compensation
+			int ret = 0;
+
 			if (!_hil_enabled) {
-				if (_temperature_compensation.apply_corrections_accel(uorb_index, accel_data, accel_report.temperature,
-						offsets[uorb_index], scales[uorb_index]) == 2) {
+				ret = _temperature_compensation.get_corrections_accel(uorb_index, accel_report.temperature,
+						offsets[uorb_index], scales[uorb_index]);
+
+				if (ret == 2) {
 					_corrections_changed = true;
 				}
 			}
 
-			// rotate corrected measurements from sensor to body frame
-			accel_data = _board_rotation * accel_data;
+			if (ret > 0) {
+				corrections.offset.set(uorb_index, offsets[uorb_index][0], offsets[uorb_index][1], offsets[uorb_index][2]);
+				corrections.scale.set(uorb_index, scales[uorb_index][0], scales[uorb_index][1], scales[uorb_index][2]);
 
-			_last_sensor_data[uorb_index].accelerometer_m_s2[0] = accel_data(0);
-			_last_sensor_data[uorb_index].accelerometer_m_s2[1] = accel_data(1);
-			_last_sensor_data[uorb_index].accelerometer_m_s2[2] = accel_data(2);
+			} else {
+				corrections.set_identity(uorb_index);
+			}
 
 			_last_accel_timestamp[uorb_index] = accel_report.timestamp;
-			_accel.voter.put(uorb_index, accel_report.timestamp, _last_sensor_data[uorb_index].accelerometer_m_s2,
-					 accel_report.error_count, _accel.priority[uorb_index]);
+			error_count[uorb_index] = accel_report.error_count;
+			updated[uorb_index] = true;
+		}
+	}
+
+	// correct the measurements and rotate them from sensor to body frame
+	correct_and_rotate(accel_data, dt_inv, corrections, _board_rotation);
+
+	for (unsigned uorb_index = 0; uorb_index < _accel.subscription_count; uorb_index++) {
+		if (updated[uorb_index]) {
+			accel_data.get(uorb_index, _last_sensor_data[uorb_index].accelerometer_m_s2);
+
+			_accel.voter.put(uorb_index, _last_accel_timestamp[uorb_index], _last_sensor_data[uorb_index].accelerometer_m_s2,
+					 error_count[uorb_index], _accel.priority[uorb_index]);
 		}
 	}
 
@@ -634,6 +683,13 @@ void VotedSensorsUpdate::gyro_poll(struct sensor_combined_s &raw)
 	float *offsets[] = {_corrections.gyro_offset_0, _corrections.gyro_offset_1, _corrections.gyro_offset_2 };
 	float *scales[] = {_corrections.gyro_scale_0, _corrections.gyro_scale_1, _corrections.gyro_scale_2 };
 
+	// gather the new samples of all instances, then correct them in one go
+	SensorSamples3D gyro_rate = {};
+	SensorCorrections3D corrections = {};
+	float dt_inv[SENSOR_COUNT_MAX] = {};
+	bool updated[SENSOR_COUNT_MAX] = {};
+	uint64_t error_count[SENSOR_COUNT_MAX];
+
 	for (unsigned uorb_index = 0; uorb_index < _gyro.subscription_count; uorb_index++) {
 		bool gyro_updated;
 		orb_check(_gyro.subscription[uorb_index], &gyro_updated);
@@ -656,9 +712,20 @@ void VotedSensorsUpdate::gyro_poll(struct sensor_combined_s &raw)
 
 			_gyro_device_id[uorb_index] = gyro_report.device_id;
 
-			math::Vector<3> gyro_rate;
+			// sample blocks are published before the report they belong to
+			fifo_poll(ORB_ID(sensor_gyro_fifo), _gyro, _gyro_device_id);
+			FifoIntegral &fifo = _gyro.fifo_integral[uorb_index];
+
+			if (fifo.dt > 0.f) {
+				// average over all FIFO samples since the last report, see accel_poll()
+				dt_inv[uorb_index] = 1.e6f / fifo.dt;
+				gyro_rate.set(uorb_index, fifo.integral[0], fifo.integral[1], fifo.integral[2]);
 
-			if (gyro_report.integral_dt != 0) {
+				_last_sensor_data[uorb_index].gyro_integral_dt = (uint32_t)fifo.dt;
+
+				fifo = {};
+
+			} else if (gyro_report.integral_dt != 0) {
 				/*
 				 * Using data that has been integrated in the driver before downsampling is preferred
 				 * becasue it reduces aliasing errors. Correct the raw sensor data for scale factor errors
@@ -667,9 +734,8 @@ void VotedSensorsUpdate::gyro_poll(struct sensor_combined_s &raw)
 				*/
 
 				// convert the delta angles to an equivalent angular rate before application of corrections
-				float dt_inv = 1.e6f / gyro_report.integral_dt;
-				gyro_rate = math::Vector<3>(gyro_report.x_integral * dt_inv, gyro_report.y_integral * dt_inv,
-							    gyro_report.z_integral * dt_inv);
+				dt_inv[uorb_index] = 1.e6f / gyro_report.integral_dt;
+				gyro_rate.set(uorb_index, gyro_report.x_integral, gyro_report.y_integral, gyro_report.z_integral);
 
 				_last_sensor_data[uorb_index].gyro_integral_dt = gyro_report.integral_dt;
 
@@ -678,7 +744,8 @@ void VotedSensorsUpdate::gyro_poll(struct sensor_combined_s &raw)
 
 				// Correct each sensor for temperature effects
 				// Filtering and/or downsampling of temperature should be performed in the driver layer
-				gyro_rate = math::Vector<3>(gyro_report.x, gyro_report.y, gyro_report.z);
+				dt_inv[uorb_index] = 1.f;
+				gyro_rate.set(uorb_index, gyro_report.x, gyro_report.y, gyro_report.z);
 
 				// handle the case where this is our first output
 				if (_last_sensor_data[uorb_index].timestamp == 0) {
@@ -691,23 +758,40 @@ void VotedSensorsUpdate::gyro_poll(struct sensor_combined_s &raw)
 			}
 
 			// handle temperature compensation
+			int ret = 0;
+
 			if (!_hil_enabled) {
-				if (_temperature_compensation.apply_corrections_gyro(uorb_index, gyro_rate, gyro_report.temperature,
-						offsets[uorb_index], scales[uorb_index]) == 2) {
+				ret = _temperature_compensation.get_corrections_gyro(uorb_index, gyro_report.temperature,
+						offsets[uorb_index], scales[uorb_index]);
+
+				if (ret == 2) {
 					_corrections_changed = true;
 				}
 			}
 
-			// rotate corrected measurements from sensor to body frame
-			gyro_rate = _board_rotation * gyro_rate;
+			if (ret > 0) {
+				corrections.offset.set(uorb_index, offsets[uorb_index][0], offsets[uorb_index][1], offsets[uorb_index][2]);
+				corrections.scale.set(uorb_index, scales[uorb_index][0], scales[uorb_index][1], scales[uorb_index][2]);
 
-			_last_sensor_data[uorb_index].gyro_rad[0] = gyro_rate(0);
-			_last_sensor_data[uorb_index].gyro_rad[1] = gyro_rate(1);
-			_last_sensor_data[uorb_index].gyro_rad[2] = gyro_rate(2);
+			} else {
+				corrections.set_identity(uorb_index);
+			}
 
 			_last_sensor_data[uorb_index].timestamp = gyro_report.timestamp;
-			_gyro.voter.put(uorb_index, gyro_report.timestamp, _last_sensor_data[uorb_index].gyro_rad,
-					gyro_report.error_count, _gyro.priority[uorb_index]);
+			error_count[uorb_index] = gyro_report.error_count;
+			updated[uorb_index] = true;
+		}
+	}
+
+	// correct the measurements and rotate them from sensor to body frame
+	correct_and_rotate(gyro_rate, dt_inv, corrections, _board_rotation);
+
+	for (unsigned uorb_index = 0; uorb_index < _gyro.subscription_count; uorb_index++) {
+		if (updated[uorb_index]) {
+			gyro_rate.get(uorb_index, _last_sensor_data[uorb_index].gyro_rad);
+
+			_gyro.voter.put(uorb_index, _last_sensor_data[uorb_index].timestamp, _last_sensor_data[uorb_index].gyro_rad,
+					error_count[uorb_index], _gyro.priority[uorb_index]);
 		}
 	}
 
@@ -739,6 +823,13 @@ void VotedSensorsUpdate::gyro_poll(struct sensor_combined_s &raw)
 
 void VotedSensorsUpdate::mag_poll(struct sensor_combined_s &raw)
 {
+	static_assert(MAG_COUNT_MAX == SENSOR_COUNT_MAX, "rotate_each() needs a mag rotation per lane");
+
+	// gather the new samples of all instances, then rotate them in one go
+	SensorSamples3D mag_data = {};
+	bool updated[SENSOR_COUNT_MAX] = {};
+	uint64_t error_count[SENSOR_COUNT_MAX];
+
 	for (unsigned uorb_index = 0; uorb_index < _mag.subscription_count; uorb_index++) {
 		bool mag_updated;
 		orb_check(_mag.subscription[uorb_index], &mag_updated);
@@ -764,16 +855,22 @@ void VotedSensorsUpdate::mag_poll(struct sensor_combined_s &raw)
 				_mag.priority[uorb_index] = (uint8_t)priority;
 			}
 
-			math::Vector<3> vect(mag_report.x, mag_report.y, mag_report.z);
-			vect = _mag_rotation[uorb_index] * vect;
-
-			_last_sensor_data[uorb_index].magnetometer_ga[0] = vect(0);
-			_last_sensor_data[uorb_index].magnetometer_ga[1] = vect(1);
-			_last_sensor_data[uorb_index].magnetometer_ga[2] = vect(2);
+			mag_data.set(uorb_index, mag_report.x, mag_report.y, mag_report.z);
 
 			_last_mag_timestamp[uorb_index] = mag_report.timestamp;
-			_mag.voter.put(uorb_index, mag_report.timestamp, vect.data,
-				       mag_report.error_count, _mag.priority[uorb_index]);
+			error_count[uorb_index] = mag_report.error_count;
+			updated[uorb_index] = true;
+		}
+	}
+
+	rotate_each(mag_data, _mag_rotation);
+
+	for (unsigned uorb_index = 0; uorb_index < _mag.subscription_count; uorb_index++) {
+		if (updated[uorb_index]) {
+			mag_data.get(uorb_index, _last_sensor_data[uorb_index].magnetometer_ga);
+
+			_mag.voter.put(uorb_index, _last_mag_timestamp[uorb_index], _last_sensor_data[uorb_index].magnetometer_ga,
+				       error_count[uorb_index], _mag.priority[uorb_index]);
 		}
 	}
 
@@ -991,6 +1088,56 @@ void VotedSensorsUpdate::init_sensor_class(const struct orb_metadata *meta, Sens
 	sensor_data.subscription_count = group_count;
 }
 
+void VotedSensorsUpdate::init_fifo_class(const struct orb_metadata *meta, SensorData &sensor_data)
+{
+	int group_count = math::min(orb_group_count(meta), (int)SENSOR_COUNT_MAX);
+
+	for (int i = sensor_data.fifo_subscription_count; i < group_count; i++) {
+		sensor_data.fifo_subscription[i] = orb_subscribe_multi(meta, i);
+	}
+
+	sensor_data.fifo_subscription_count = math::max(group_count, sensor_data.fifo_subscription_count);
+}
+
+void VotedSensorsUpdate::fifo_poll(const struct orb_metadata *meta, SensorData &sensor_data, const uint32_t device_ids[])
+{
+	for (int i = 0; i < sensor_data.fifo_subscription_count; i++) {
+		bool updated;
+
+		// the topic is queued: go through all blocks published since the last poll
+		while (orb_check(sensor_data.fifo_subscription[i], &updated) == 0 && updated) {
+			sensor_imu_fifo_s block;
+
+			if (orb_copy(meta, sensor_data.fifo_subscription[i], &block) != 0) {
+				break;
+			}
+
+			for (int uorb_index = 0; uorb_index < sensor_data.subscription_count; uorb_index++) {
+				if (block.device_id == 0 || block.device_id != device_ids[uorb_index]) {
+					continue;
+				}
+
+				unsigned samples = math::min((unsigned)block.samples, (unsigned)sensor_imu_fifo_s::SAMPLES_MAX);
+				float sum[3] = {};
+
+				for (unsigned n = 0; n < samples; n++) {
+					sum[0] += block.x[n];
+					sum[1] += block.y[n];
+					sum[2] += block.z[n];
+				}
+
+				FifoIntegral &fifo = sensor_data.fifo_integral[uorb_index];
+				const float dt_s = block.dt * 1.e-6f;
+				fifo.integral[0] += sum[0] * dt_s;
+				fifo.integral[1] += sum[1] * dt_s;
+				fifo.integral[2] += sum[2] * dt_s;
+				fifo.dt += samples * block.dt;
+				break;
+			}
+		}
+	}
+}
+
 void VotedSensorsUpdate::print_status()
 {
 	PX4_INFO("gyro status:");
@@ -56,10 +56,12 @@
 #include <uORB/topics/sensor_preflight.h>
 #include <uORB/topics/sensor_correction.h>
 #include <uORB/topics/sensor_selection.h>
+#include <uORB/topics/sensor_imu_fifo.h>
 
 #include <DevMgr.hpp>
 
 #include "temperature_compensation.h"
+#include "sensor_kernels.h"
 #include "common.h"
 
 namespace sensors
@@ -151,16 +153,27 @@ public:
 
 private:
 
+	/**
+	 * Sum of the FIFO samples of a sensor instance since its last report.
+	 */
+	struct FifoIntegral {
+		float integral[3]; /**< sum of sample * dt [unit * s] */
+		float dt; /**< time covered by the samples [us] */
+	};
+
 	struct SensorData {
 		SensorData()
 			: last_best_vote(0),
 			  subscription_count(0),
 			  voter(1),
-			  last_failover_count(0)
+			  last_failover_count(0),
+			  fifo_subscription_count(0)
 		{
 			for (unsigned i = 0; i < SENSOR_COUNT_MAX; i++) {
 				subscription[i] = -1;
 				priority[i] = 0;
+				fifo_subscription[i] = -1;
+				fifo_integral[i] = {};
 			}
 		}
 
@@ -170,10 +183,25 @@ private:
 		int subscription_count;
 		DataValidatorGroup voter;
 		unsigned int last_failover_count;
+
+		int fifo_subscription[SENSOR_COUNT_MAX]; /**< sample block subscriptions, in the order of the fifo topic instances */
+		int fifo_subscription_count;
+		FifoIntegral fifo_integral[SENSOR_COUNT_MAX]; /**< per instance of subscription */
 	};
 
 	void	init_sensor_class(const struct orb_metadata *meta, SensorData &sensor_data, uint8_t sensor_count_max);
 
+	/**
+	 * Subscribe to new instances of a sample block topic (sensor_gyro_fifo, sensor_accel_fifo).
+	 */
+	void	init_fifo_class(const struct orb_metadata *meta, SensorData &sensor_data);
+
+	/**
+	 * Integrate all queued sample blocks of a sensor type, into the instance with the same device id.
+	 * @param device_ids device id of each instance of sensor_data
+	 */
+	void	fifo_poll(const struct orb_metadata *meta, SensorData &sensor_data, const uint32_t device_ids[]);
+
 	/**
 	 * Poll the accelerometer for updated data.
 	 *
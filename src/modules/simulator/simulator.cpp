@@ -39,6 +39,7 @@
 #include <px4_log.h>
 #include <px4_tasks.h>
 #include <px4_time.h>
+#include <px4_module.h>
 #include <pthread.h>
 #include <poll.h>
 #include <systemlib/err.h>
@@ -48,14 +49,15 @@
 #include <string.h>
 #include <sys/types.h>
 #include <drivers/drv_board_led.h>
+#include <mathlib/mathlib.h>
 
 #include "simulator.h"
 
 using namespace simulator;
 
-static px4_task_t g_sim_task = -1;
+static ModuleNamespaceData<px4_task_t> g_sim_task(-1);
 
-Simulator *Simulator::_instance = nullptr;
+ModuleNamespaceData<Simulator *> Simulator::_instance(nullptr);
 
 Simulator *Simulator::getInstance()
 {
@@ -146,10 +148,29 @@ int Simulator::start(int argc, char *argv[])
 	_instance = new Simulator();
 
 	if (_instance) {
+#ifndef __PX4_QURT
+		// each namespace parses the simulator link on its own channel (the serial RC input uses MAVLINK_COMM_1)
+		if (px4_get_namespace() > 0) {
+			_instance->_mavlink_channel = (mavlink_channel_t)(MAVLINK_COMM_1 + px4_get_namespace());
+		}
+
+#endif
+
 		drv_led_start();
 
-		if (argc == 5 && strcmp(argv[3], "-u") == 0) {
-			udp_port = atoi(argv[4]);
+		for (int i = 3; i < argc - 1; i++) {
+			if (strcmp(argv[i], "-u") == 0) {
+				udp_port = atoi(argv[i + 1]);
+			}
+
+#ifndef __PX4_QURT
+
+			if (strcmp(argv[i], "-b") == 0) {
+				// a datagram holds at most 16 HIL_SENSOR samples
+				_instance->_bench_batch = math::constrain(atoi(argv[i + 1]), 1, 16);
+			}
+
+#endif
 		}
 
 		if (argv[2][1] == 's') {
@@ -178,12 +199,18 @@ int Simulator::start(int argc, char *argv[])
 
 static void usage()
 {
-	PX4_WARN("Usage: simulator {start -[spt] [-u udp_port] |stop}");
+	PX4_WARN("Usage: simulator {start -[spt] [-u udp_port] [-l] [-b batch] |stop|status}");
 	PX4_WARN("Simulate raw sensors:     simulator start -s");
 	PX4_WARN("Publish sensors combined: simulator start -p");
 	PX4_WARN("Dummy unit test data:     simulator start -t");
+	PX4_WARN("Lockstep with sim time:   simulator start -s -l");
+	PX4_WARN("Lockstep clock and stalls: simulator status");
+	PX4_WARN("Benchmark IMU ingestion:  simulator start -s -b <samples per datagram>");
+	PX4_WARN("Each namespace runs its own simulator, use -u to give it its own UDP port");
 }
 
+PX4_MODULE_DEPENDENCIES(simulator, "");
+
 __BEGIN_DECLS
 extern int simulator_main(int argc, char *argv[]);
 __END_DECLS
@@ -204,8 +231,23 @@ extern "C" {
 					return 0;
 				}
 
-				// enable lockstep support
-				px4_enable_sim_lockstep();
+				if (MAVLINK_COMM_1 + px4_get_namespace() >= MAVLINK_COMM_NUM_BUFFERS) {
+					PX4_ERR("no MAVLink channel left for namespace %i", px4_get_namespace());
+					return -EINVAL;
+				}
+
+				// run in lockstep with the simulation time if requested
+				for (int i = 3; i < argc; i++) {
+					if (strcmp(argv[i], "-l") == 0) {
+						// there is only one system clock, it cannot follow several simulations
+						if (px4_get_namespace() != 0) {
+							PX4_ERR("lockstep is only supported in namespace 0");
+							return -EINVAL;
+						}
+
+						px4_enable_sim_lockstep();
+					}
+				}
 
 				g_sim_task = px4_task_spawn_cmd("simulator",
 								SCHED_DEFAULT,
@@ -229,6 +271,15 @@ extern "C" {
 				ret = -EINVAL;
 			}
 
+		} else if (argc == 2 && strcmp(argv[1], "status") == 0) {
+			if (g_sim_task < 0) {
+				PX4_INFO("Simulator not running");
+
+			} else {
+				PX4_INFO("Simulator running");
+				hrt_lockstep_print_status();
+			}
+
 		} else if (argc == 2 && strcmp(argv[1], "stop") == 0) {
 			if (g_sim_task < 0) {
 				PX4_WARN("Simulator not running");
@@ -38,6 +38,7 @@
 
 #pragma once
 
+#include <px4_module.h>
 #include <px4_posix.h>
 #include <uORB/topics/hil_sensor.h>
 #include <uORB/topics/manual_control_setpoint.h>
@@ -63,6 +64,7 @@
 #include <v1.0/mavlink_types.h>
 #include <v1.0/common/mavlink.h>
 #include <geo/geo.h>
+#include <netinet/in.h>
 namespace simulator
 {
 
@@ -188,6 +190,10 @@ protected:
 
 };
 
+// number of datagrams received with a single system call (each can hold several HIL_SENSOR samples)
+#define SIM_RECV_BATCH	16
+#define SIM_RECV_BUFLEN	2048
+
 class Simulator : public control::SuperBlock
 {
 public:
@@ -241,6 +247,9 @@ private:
 		_perf_airspeed(perf_alloc_once(PC_ELAPSED, "sim_airspeed_delay")),
 		_perf_sim_delay(perf_alloc_once(PC_ELAPSED, "sim_network_delay")),
 		_perf_sim_interval(perf_alloc(PC_INTERVAL, "sim_network_interval")),
+		_perf_sim_datagrams(perf_alloc_once(PC_COUNT, "sim_datagrams")),
+		_perf_sim_samples(perf_alloc_once(PC_COUNT, "sim_imu_samples")),
+		_perf_sim_ingest(perf_alloc_once(PC_ELAPSED, "sim_imu_ingest")),
 		_accel_pub(nullptr),
 		_baro_pub(nullptr),
 		_gyro_pub(nullptr),
@@ -270,6 +279,14 @@ private:
 		_hil_ref_lon(0),
 		_hil_ref_alt(0),
 		_hil_ref_timestamp(0),
+		_bench_batch(0),
+		_bench_port(0),
+		_fd(-1),
+		_buf{},
+		_srcaddr{},
+		_addrlen(sizeof(_srcaddr)),
+		_mavlink_channel(MAVLINK_COMM_0),
+		_batt_sim_start(0),
 		_rc_input{},
 		_actuators{},
 		_attitude{},
@@ -305,7 +322,8 @@ private:
 
 	void initializeSensorData();
 
-	static Simulator *_instance;
+	// one simulator per namespace, so that several vehicles can be simulated in one process
+	static ModuleNamespaceData<Simulator *> _instance;
 
 	// simulated sensor instances
 	simulator::Report<simulator::RawAccelData>	_accel;
@@ -323,6 +341,9 @@ private:
 	perf_counter_t _perf_airspeed;
 	perf_counter_t _perf_sim_delay;
 	perf_counter_t _perf_sim_interval;
+	perf_counter_t _perf_sim_datagrams;
+	perf_counter_t _perf_sim_samples;
+	perf_counter_t _perf_sim_ingest;
 
 	// uORB publisher handlers
 	orb_advert_t _accel_pub;
@@ -384,8 +405,22 @@ private:
 
 	control::BlockParamFloat _battery_drain_interval_s; ///< battery drain interval
 
+	unsigned _bench_batch; ///< HIL_SENSOR samples per datagram of the built-in load generator, 0 if disabled
+	int _bench_port;
+
+	// UDP connection to the flight simulator
+	int _fd;
+	unsigned char _buf[SIM_RECV_BATCH][SIM_RECV_BUFLEN];
+	sockaddr_in _srcaddr;
+	socklen_t _addrlen;
+	mavlink_channel_t _mavlink_channel; ///< parser state of the UDP link, different in each namespace
+
+	hrt_abstime _batt_sim_start;
+
 	void poll_topics();
 	void handle_message(mavlink_message_t *msg, bool publish);
+	void handle_datagram(const unsigned char *buf, int len, bool publish, mavlink_status_t *status);
+	int receive_datagrams(bool publish, mavlink_status_t *status);
 	void send_controls();
 	void pollForMAVLinkMessages(bool publish, int udp_port);
 
@@ -396,5 +431,7 @@ private:
 	void parameters_update(bool force);
 	static void *sending_trampoline(void *);
 	void send();
+	static void *bench_trampoline(void *);
+	void bench();
 #endif
 };
@@ -71,11 +71,15 @@ static const float mg2ms2 = CONSTANTS_ONE_G / 1000.0f;
 static int openUart(const char *uart_name, int baud);
 #endif
 
-static int _fd;
-static unsigned char _buf[1024];
-sockaddr_in _srcaddr;
-static socklen_t _addrlen = sizeof(_srcaddr);
-static hrt_abstime batt_sim_start = 0;
+// queue depth of the simulated sensor topics, so that batched samples are not overwritten
+#define SIM_SENSOR_QUEUE_LENGTH	8
+
+// HIL_SENSOR fields_updated bits of each sensor
+#define SIM_FIELDS_ACCEL	((1 << 0) | (1 << 1) | (1 << 2))
+#define SIM_FIELDS_GYRO		((1 << 3) | (1 << 4) | (1 << 5))
+#define SIM_FIELDS_MAG		((1 << 6) | (1 << 7) | (1 << 8))
+#define SIM_FIELDS_BARO		((1 << 9) | (1 << 11) | (1 << 12))
+#define SIM_FIELDS_ALL		0x1FFF
 
 const unsigned mode_flag_armed = 128; // following MAVLink spec
 const unsigned mode_flag_custom = 1;
@@ -298,10 +302,17 @@ void Simulator::handle_message(mavlink_message_t *msg, bool publish)
 			hrt_abstime curr_sitl_time = hrt_absolute_time();
 			hrt_abstime curr_sim_time = imu.time_usec;
 
-			if (compensation_enabled && _initialized
-			    && _last_sim_timestamp > 0 && _last_sitl_timestamp > 0
-			    && _last_sitl_timestamp < curr_sitl_time
-			    && _last_sim_timestamp < curr_sim_time) {
+			if (hrt_lockstep_enabled()) {
+				// the simulation time drives the HRT: advance it by the simulated
+				// interval, once everything triggered by the last sample is done
+				if (_last_sim_timestamp > 0 && _last_sim_timestamp < curr_sim_time) {
+					hrt_lockstep_set_time(curr_sitl_time + (curr_sim_time - _last_sim_timestamp));
+				}
+
+			} else if (compensation_enabled && _initialized
+				   && _last_sim_timestamp > 0 && _last_sitl_timestamp > 0
+				   && _last_sitl_timestamp < curr_sitl_time
+				   && _last_sim_timestamp < curr_sim_time) {
 
 				px4_clock_gettime(CLOCK_MONOTONIC, &ts);
 				uint64_t timestamp = ts_to_abstime(&ts);
@@ -350,19 +361,24 @@ void Simulator::handle_message(mavlink_message_t *msg, bool publish)
 			// correct timestamp
 			imu.time_usec = now;
 
+			perf_count(_perf_sim_samples);
+			perf_begin(_perf_sim_ingest);
+
 			if (publish) {
 				publish_sensor_topics(&imu);
 			}
 
 			update_sensors(&imu);
 
+			perf_end(_perf_sim_ingest);
+
 			// battery simulation
 			const float discharge_interval_us = _battery_drain_interval_s.get() * 1000 * 1000;
 
 			bool armed = (_vehicle_status.arming_state == vehicle_status_s::ARMING_STATE_ARMED);
 
-			if (!armed || batt_sim_start == 0 || batt_sim_start > now) {
-				batt_sim_start = now;
+			if (!armed || _batt_sim_start == 0 || _batt_sim_start > now) {
+				_batt_sim_start = now;
 			}
 
 			unsigned cellcount = _battery.cell_count();
@@ -372,7 +388,7 @@ void Simulator::handle_message(mavlink_message_t *msg, bool publish)
 
 			float discharge_v = _battery.full_cell_voltage() - _battery.empty_cell_voltage();
 
-			vbatt = (_battery.full_cell_voltage() - (discharge_v * ((now - batt_sim_start) / discharge_interval_us)))  * cellcount;
+			vbatt = (_battery.full_cell_voltage() - (discharge_v * ((now - _batt_sim_start) / discharge_interval_us)))  * cellcount;
 
 			float batt_voltage_loaded = _battery.empty_cell_voltage() - 0.05f;
 
@@ -529,14 +545,11 @@ void Simulator::handle_message(mavlink_message_t *msg, bool publish)
 
 }
 
-void Simulator::send_mavlink_message(const uint8_t msgid, const void *msg, uint8_t component_ID)
+static unsigned pack_mavlink_message(uint8_t *buf, const uint8_t msgid, const void *msg, uint8_t component_ID)
 {
-	component_ID = 0;
 	uint8_t payload_len = mavlink_message_lengths[msgid];
 	unsigned packet_len = payload_len + MAVLINK_NUM_NON_PAYLOAD_BYTES;
 
-	uint8_t buf[MAVLINK_MAX_PACKET_LEN];
-
 	/* header */
 	buf[0] = MAVLINK_STX;
 	buf[1] = payload_len;
@@ -558,6 +571,14 @@ void Simulator::send_mavlink_message(const uint8_t msgid, const void *msg, uint8
 	buf[MAVLINK_NUM_HEADER_BYTES + payload_len] = (uint8_t)(checksum & 0xFF);
 	buf[MAVLINK_NUM_HEADER_BYTES + payload_len + 1] = (uint8_t)(checksum >> 8);
 
+	return packet_len;
+}
+
+void Simulator::send_mavlink_message(const uint8_t msgid, const void *msg, uint8_t component_ID)
+{
+	uint8_t buf[MAVLINK_MAX_PACKET_LEN];
+	unsigned packet_len = pack_mavlink_message(buf, msgid, msg, 0);
+
 	ssize_t len = sendto(_fd, buf, packet_len, 0, (struct sockaddr *)&_srcaddr, _addrlen);
 
 	if (len <= 0) {
@@ -665,6 +686,154 @@ void Simulator::initializeSensorData()
 	write_airspeed_data(&airspeed);
 }
 
+void *Simulator::bench_trampoline(void * /*unused*/)
+{
+	_instance->bench();
+	return nullptr;
+}
+
+void Simulator::bench()
+{
+	// Load generator standing in for the flight simulator: it sends synthetic
+	// HIL_SENSOR samples (batched into datagrams) to our own port at doubling
+	// rates and stops at the first rate at which samples get lost.
+	static const unsigned bench_rates[] = {250, 500, 1000, 2000, 4000, 8000, 16000, 32000, 64000};
+	const hrt_abstime step_duration = 2000000;
+
+	int fd = socket(AF_INET, SOCK_DGRAM, 0);
+
+	if (fd < 0) {
+		PX4_ERR("bench: create socket failed");
+		return;
+	}
+
+	struct sockaddr_in addr = {};
+	addr.sin_family = AF_INET;
+	addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+	addr.sin_port = htons(_bench_port);
+
+	mavlink_hil_sensor_t imu = {};
+	imu.zacc = -CONSTANTS_ONE_G;
+	imu.xmag = 0.2f;
+	imu.zmag = 0.4f;
+	imu.abs_pressure = PRESS_GROUND / 100.0f;
+	imu.temperature = 32.0f;
+
+	uint8_t buf[SIM_RECV_BUFLEN];
+	unsigned len = 0;
+
+	for (unsigned i = 0; i < _bench_batch; i++) {
+		// like a high rate IMU stream: only every 10th sample has a new mag & baro
+		imu.fields_updated = (i % 10 == 0) ? SIM_FIELDS_ALL : (SIM_FIELDS_ACCEL | SIM_FIELDS_GYRO);
+		len += pack_mavlink_message(&buf[len], MAVLINK_MSG_ID_HIL_SENSOR, &imu, 0);
+	}
+
+	unsigned max_rate = 0;
+
+	for (unsigned r = 0; r < sizeof(bench_rates) / sizeof(bench_rates[0]) && !px4_exit_requested(); r++) {
+		const unsigned rate = bench_rates[r];
+		const hrt_abstime interval = 1000000ULL * _bench_batch / rate;
+
+		uint64_t sent = 0;
+		const uint64_t ingested_start = perf_event_count(_perf_sim_samples);
+		const hrt_abstime start = hrt_system_time();
+		hrt_abstime next = start;
+
+		while (hrt_system_time() - start < step_duration) {
+			// send all datagrams that are due, then sleep until the next one
+			while (next <= hrt_system_time()) {
+				if (sendto(fd, buf, len, 0, (struct sockaddr *)&addr, sizeof(addr)) == (ssize_t)len) {
+					sent += _bench_batch;
+				}
+
+				next += interval;
+			}
+
+			const hrt_abstime now = hrt_system_time();
+
+			if (next > now) {
+				usleep(math::min(next - now, (hrt_abstime)1000));
+			}
+		}
+
+		// let the receive thread drain the socket
+		usleep(100000);
+
+		const uint64_t ingested = perf_event_count(_perf_sim_samples) - ingested_start;
+
+		PX4_INFO("bench: %5u Hz, batch %u: sent %llu, ingested %llu samples", rate, _bench_batch,
+			 (unsigned long long)sent, (unsigned long long)ingested);
+
+		// allow for 1% loss, e.g. scheduling hiccups at the start of a step
+		if (ingested * 100 < sent * 99) {
+			break;
+		}
+
+		max_rate = rate;
+	}
+
+	::close(fd);
+
+	PX4_INFO("bench: max sustainable IMU rate: %u Hz (%u samples per datagram)", max_rate, _bench_batch);
+	perf_print_counter(_perf_sim_ingest);
+}
+
+void Simulator::handle_datagram(const unsigned char *buf, int len, bool publish, mavlink_status_t *status)
+{
+	mavlink_message_t msg;
+
+	perf_count(_perf_sim_datagrams);
+
+	for (int i = 0; i < len; i++) {
+		if (mavlink_parse_char(_mavlink_channel, buf[i], &msg, status)) {
+			// have a message, handle it
+			handle_message(&msg, publish);
+		}
+	}
+}
+
+int Simulator::receive_datagrams(bool publish, mavlink_status_t *status)
+{
+#ifdef __PX4_LINUX
+	// fetch all pending datagrams (up to SIM_RECV_BATCH) with one system call
+	struct mmsghdr msgs[SIM_RECV_BATCH];
+	struct iovec iovecs[SIM_RECV_BATCH];
+	struct sockaddr_in addrs[SIM_RECV_BATCH];
+
+	memset(msgs, 0, sizeof(msgs));
+
+	for (unsigned i = 0; i < SIM_RECV_BATCH; i++) {
+		iovecs[i].iov_base = _buf[i];
+		iovecs[i].iov_len = sizeof(_buf[i]);
+		msgs[i].msg_hdr.msg_iov = &iovecs[i];
+		msgs[i].msg_hdr.msg_iovlen = 1;
+		msgs[i].msg_hdr.msg_name = &addrs[i];
+		msgs[i].msg_hdr.msg_namelen = sizeof(addrs[i]);
+	}
+
+	int count = recvmmsg(_fd, msgs, SIM_RECV_BATCH, MSG_DONTWAIT, nullptr);
+
+	for (int i = 0; i < count; i++) {
+		// replies go to the sender of the latest datagram, as with recvfrom()
+		memcpy(&_srcaddr, &addrs[i], sizeof(_srcaddr));
+		_addrlen = msgs[i].msg_hdr.msg_namelen;
+
+		handle_datagram(_buf[i], msgs[i].msg_len, publish, status);
+	}
+
+	return count;
+#else
+	int len = recvfrom(_fd, _buf[0], sizeof(_buf[0]), 0, (struct sockaddr *)&_srcaddr, &_addrlen);
+
+	if (len > 0) {
+		handle_datagram(_buf[0], len, publish, status);
+		return 1;
+	}
+
+	return len;
+#endif
+}
+
 void Simulator::pollForMAVLinkMessages(bool publish, int udp_port)
 {
 	// set the threads name
@@ -699,6 +868,14 @@ void Simulator::pollForMAVLinkMessages(bool publish, int udp_port)
 		return;
 	}
 
+	if (_bench_batch > 0) {
+		// the built-in load generator replaces the flight simulator
+		pthread_t bench_thread;
+		_bench_port = udp_port;
+		px4_pthread_create(&bench_thread, nullptr, Simulator::bench_trampoline, nullptr);
+		pthread_detach(bench_thread);
+	}
+
 	// create a thread for sending data to the simulator
 	pthread_t sender_thread;
 
@@ -759,7 +936,7 @@ void Simulator::pollForMAVLinkMessages(bool publish, int udp_port)
 				pstart_time = hrt_system_time();
 			}
 
-			len = recvfrom(_fd, _buf, sizeof(_buf), 0, (struct sockaddr *)&_srcaddr, &_addrlen);
+			len = recvfrom(_fd, _buf[0], sizeof(_buf[0]), 0, (struct sockaddr *)&_srcaddr, &_addrlen);
 			// send hearbeat
 			mavlink_heartbeat_t hb = {};
 			hb.autopilot = 12;
@@ -771,7 +948,7 @@ void Simulator::pollForMAVLinkMessages(bool publish, int udp_port)
 				mavlink_status_t udp_status = {};
 
 				for (int i = 0; i < len; i++) {
-					if (mavlink_parse_char(MAVLINK_COMM_0, _buf[i], &msg, &udp_status)) {
+					if (mavlink_parse_char(_mavlink_channel, _buf[0][i], &msg, &udp_status)) {
 						// have a message, handle it
 						handle_message(&msg, publish);
 
@@ -789,8 +966,10 @@ void Simulator::pollForMAVLinkMessages(bool publish, int udp_port)
 		return;
 	}
 
-	// reset system time
-	(void)hrt_reset();
+	// reset system time, unless other vehicles (namespaces) are already running on it
+	if (px4_get_namespace() == 0) {
+		(void)hrt_reset();
+	}
 
 	// subscribe to topics
 	for (unsigned i = 0; i < (sizeof(_actuator_outputs_sub) / sizeof(_actuator_outputs_sub[0])); i++) {
@@ -800,7 +979,7 @@ void Simulator::pollForMAVLinkMessages(bool publish, int udp_port)
 	_vehicle_status_sub = orb_subscribe(ORB_ID(vehicle_status));
 
 	// got data from simulator, now activate the sending thread
-	pthread_create(&sender_thread, &sender_thread_attr, Simulator::sending_trampoline, nullptr);
+	px4_pthread_create(&sender_thread, &sender_thread_attr, Simulator::sending_trampoline, nullptr);
 	pthread_attr_destroy(&sender_thread_attr);
 
 	mavlink_status_t udp_status = {};
@@ -825,7 +1004,8 @@ void Simulator::pollForMAVLinkMessages(bool publish, int udp_port)
 
 		//timed out
 		if (pret == 0) {
-			if (!sim_delay) {
+			// in lockstep the time does not advance without data anyway
+			if (!sim_delay && !hrt_lockstep_enabled()) {
 				// we do not want to spam the console by default
 				// PX4_WARN("mavlink sim timeout for %d ms", max_wait_ms);
 				sim_delay = true;
@@ -852,18 +1032,7 @@ void Simulator::pollForMAVLinkMessages(bool publish, int udp_port)
 
 		// got data from simulator
 		if (fds[0].revents & POLLIN) {
-			len = recvfrom(_fd, _buf, sizeof(_buf), 0, (struct sockaddr *)&_srcaddr, &_addrlen);
-
-			if (len > 0) {
-				mavlink_message_t msg;
-
-				for (int i = 0; i < len; i++) {
-					if (mavlink_parse_char(MAVLINK_COMM_0, _buf[i], &msg, &udp_status)) {
-						// have a message, handle it
-						handle_message(&msg, publish);
-					}
-				}
-			}
+			receive_datagrams(publish, &udp_status);
 		}
 
 #ifdef ENABLE_UART_RC_INPUT
@@ -990,14 +1159,33 @@ int openUart(const char *uart_name, int baud)
 }
 #endif
 
+/**
+ * Publish a simulated sensor sample on a queued topic: with several samples per
+ * datagram, a subscriber would otherwise only see the last one.
+ */
+static void publish_sensor_queued(const struct orb_metadata *meta, orb_advert_t *handle, const void *data)
+{
+	if (*handle == nullptr) {
+		int instance;
+		*handle = orb_advertise_multi_queue(meta, data, &instance, ORB_PRIO_HIGH, SIM_SENSOR_QUEUE_LENGTH);
+
+	} else {
+		orb_publish(meta, *handle, data);
+	}
+}
+
 int Simulator::publish_sensor_topics(mavlink_hil_sensor_t *imu)
 {
 
 	uint64_t timestamp = hrt_absolute_time();
 
-	if ((imu->fields_updated & 0x1FFF) != 0x1FFF) {
-		PX4_DEBUG("All sensor fields in mavlink HIL_SENSOR packet not updated.  Got %08x", imu->fields_updated);
-	}
+	/*
+	 * Each sensor is only published when the message flags it as updated, so that
+	 * a high rate IMU stream can carry slower sensors without repeating stale
+	 * samples. Simulators that leave fields_updated at 0 get every sensor
+	 * published for every message.
+	 */
+	const uint32_t fields_updated = (imu->fields_updated != 0) ? imu->fields_updated : SIM_FIELDS_ALL;
 
 	/*
 	  static int count=0;
@@ -1014,7 +1202,7 @@ int Simulator::publish_sensor_topics(mavlink_hil_sensor_t *imu)
 	last_timestamp = timestamp;
 	*/
 	/* gyro */
-	{
+	if (fields_updated & SIM_FIELDS_GYRO) {
 		struct gyro_report gyro = {};
 
 		gyro.timestamp = timestamp;
@@ -1027,12 +1215,11 @@ int Simulator::publish_sensor_topics(mavlink_hil_sensor_t *imu)
 
 		gyro.temperature = imu->temperature;
 
-		int gyro_multi;
-		orb_publish_auto(ORB_ID(sensor_gyro), &_gyro_pub, &gyro, &gyro_multi, ORB_PRIO_HIGH);
+		publish_sensor_queued(ORB_ID(sensor_gyro), &_gyro_pub, &gyro);
 	}
 
 	/* accelerometer */
-	{
+	if (fields_updated & SIM_FIELDS_ACCEL) {
 		struct accel_report accel = {};
 
 		accel.timestamp = timestamp;
@@ -1045,12 +1232,11 @@ int Simulator::publish_sensor_topics(mavlink_hil_sensor_t *imu)
 
 		accel.temperature = imu->temperature;
 
-		int accel_multi;
-		orb_publish_auto(ORB_ID(sensor_accel), &_accel_pub, &accel, &accel_multi, ORB_PRIO_HIGH);
+		publish_sensor_queued(ORB_ID(sensor_accel), &_accel_pub, &accel);
 	}
 
 	/* magnetometer */
-	{
+	if (fields_updated & SIM_FIELDS_MAG) {
 		struct mag_report mag = {};
 
 		mag.timestamp = timestamp;
@@ -1063,12 +1249,11 @@ int Simulator::publish_sensor_topics(mavlink_hil_sensor_t *imu)
 
 		mag.temperature = imu->temperature;
 
-		int mag_multi;
-		orb_publish_auto(ORB_ID(sensor_mag), &_mag_pub, &mag, &mag_multi, ORB_PRIO_HIGH);
+		publish_sensor_queued(ORB_ID(sensor_mag), &_mag_pub, &mag);
 	}
 
 	/* baro */
-	{
+	if (fields_updated & SIM_FIELDS_BARO) {
 		struct baro_report baro = {};
 
 		baro.timestamp = timestamp;
@@ -1076,8 +1261,7 @@ int Simulator::publish_sensor_topics(mavlink_hil_sensor_t *imu)
 		baro.altitude = imu->pressure_alt;
 		baro.temperature = imu->temperature;
 
-		int baro_multi;
-		orb_publish_auto(ORB_ID(sensor_baro), &_baro_pub, &baro, &baro_multi, ORB_PRIO_HIGH);
+		publish_sensor_queued(ORB_ID(sensor_baro), &_baro_pub, &baro);
 	}
 
 	return OK;
@@ -43,6 +43,11 @@
 #include <stdlib.h>
 #include <systemlib/err.h>
 
+#if defined(__PX4_POSIX) && !defined(__PX4_QURT)
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
 #include "tinybson.h"
 
 #if 0
@@ -58,12 +63,53 @@
 #define BSON_WRITE write
 #define BSON_FSYNC px4_fsync
 
+static int
+read_buffered(bson_decoder_t decoder, void *p, size_t s)
+{
+	uint8_t *dst = (uint8_t *)p;
+
+	while (s > 0) {
+		if (decoder->fbufpos == decoder->fbuflen) {
+			/* large reads bypass the buffer */
+			if (s >= decoder->fbufsize) {
+				return (BSON_READ(decoder->fd, dst, s) == (int)s) ? 0 : -1;
+			}
+
+			int result = BSON_READ(decoder->fd, decoder->fbuf, decoder->fbufsize);
+
+			if (result <= 0) {
+				return -1;
+			}
+
+			decoder->fbufpos = 0;
+			decoder->fbuflen = result;
+		}
+
+		size_t n = decoder->fbuflen - decoder->fbufpos;
+
+		if (n > s) {
+			n = s;
+		}
+
+		memcpy(dst, decoder->fbuf + decoder->fbufpos, n);
+		decoder->fbufpos += n;
+		dst += n;
+		s -= n;
+	}
+
+	return 0;
+}
+
 static int
 read_x(bson_decoder_t decoder, void *p, size_t s)
 {
 	CODER_CHECK(decoder);
 
 	if (decoder->fd > -1) {
+		if (decoder->fbuf != NULL) {
+			return read_buffered(decoder, p, s);
+		}
+
 		return (BSON_READ(decoder->fd, p, s) == (int)s) ? 0 : -1;
 	}
 
@@ -112,11 +158,23 @@ read_double(bson_decoder_t decoder, double *d)
 
 int
 bson_decoder_init_file(bson_decoder_t decoder, int fd, bson_decoder_callback callback, void *priv)
+{
+	return bson_decoder_init_file_buffered(decoder, fd, NULL, 0, callback, priv);
+}
+
+int
+bson_decoder_init_file_buffered(bson_decoder_t decoder, int fd, void *buf, unsigned bufsize,
+				bson_decoder_callback callback, void *priv)
 {
 	int32_t	junk;
 
 	decoder->fd = fd;
+	decoder->fbuf = (uint8_t *)buf;
+	decoder->fbufsize = bufsize;
+	decoder->fbufpos = 0;
+	decoder->fbuflen = 0;
 	decoder->buf = NULL;
+	decoder->mapping = NULL;
 	decoder->dead = false;
 	decoder->callback = callback;
 	decoder->priv = priv;
@@ -145,7 +203,9 @@ bson_decoder_init_buf(bson_decoder_t decoder, void *buf, unsigned bufsize, bson_
 	}
 
 	decoder->fd = -1;
+	decoder->fbuf = NULL;
 	decoder->buf = (uint8_t *)buf;
+	decoder->mapping = NULL;
 	decoder->dead = false;
 
 	if (bufsize == 0) {
@@ -176,6 +236,53 @@ bson_decoder_init_buf(bson_decoder_t decoder, void *buf, unsigned bufsize, bson_
 	return 0;
 }
 
+#if defined(__PX4_POSIX) && !defined(__PX4_QURT)
+int
+bson_decoder_init_file_mapped(bson_decoder_t decoder, int fd, bson_decoder_callback callback, void *priv)
+{
+	struct stat st;
+	const off_t offset = lseek(fd, 0, SEEK_CUR);
+	const long page_size = sysconf(_SC_PAGESIZE);
+
+	if (offset < 0 || page_size <= 0 || fstat(fd, &st) != 0 || st.st_size - offset < (off_t)sizeof(int32_t)) {
+		return -1;
+	}
+
+	/* the document starts at the current file offset, but the mapping has to start on a page boundary */
+	const off_t map_offset = offset - offset % page_size;
+	const size_t map_size = st.st_size - map_offset;
+
+	void *mapping = mmap(NULL, map_size, PROT_READ, MAP_PRIVATE, fd, map_offset);
+
+	if (mapping == MAP_FAILED) {
+		return -1;
+	}
+
+	if (bson_decoder_init_buf(decoder, (uint8_t *)mapping + (offset - map_offset), st.st_size - offset, callback, priv)) {
+		munmap(mapping, map_size);
+		return -1;
+	}
+
+	decoder->mapping = mapping;
+	decoder->mapping_size = map_size;
+	return 0;
+}
+#endif
+
+void
+bson_decoder_fini(bson_decoder_t decoder)
+{
+#if defined(__PX4_POSIX) && !defined(__PX4_QURT)
+
+	if (decoder->mapping != NULL) {
+		munmap(decoder->mapping, decoder->mapping_size);
+		decoder->mapping = NULL;
+		decoder->buf = NULL;
+	}
+
+#endif
+}
+
 int
 bson_decoder_next(bson_decoder_t decoder)
 {
@@ -204,11 +311,14 @@ bson_decoder_next(bson_decoder_t decoder)
 
 	/* if there are unread bytes pending in the stream, discard them */
 	while (decoder->pending > 0) {
-		if (read_int8(decoder, &tbyte)) {
+		uint8_t junk[16];
+		size_t n = (decoder->pending < (int32_t)sizeof(junk)) ? (size_t)decoder->pending : sizeof(junk);
+
+		if (read_x(decoder, junk, n)) {
 			CODER_KILL(decoder, "read error discarding pending bytes");
 		}
 
-		decoder->pending--;
+		decoder->pending -= n;
 	}
 
 	/* get the type byte */
@@ -333,12 +443,49 @@ bson_decoder_data_pending(bson_decoder_t decoder)
 	return decoder->pending;
 }
 
+static int
+flush_buffered(bson_encoder_t encoder)
+{
+	if (encoder->fbufpos > 0) {
+		if (BSON_WRITE(encoder->fd, encoder->fbuf, encoder->fbufpos) != (int)encoder->fbufpos) {
+			return -1;
+		}
+
+		encoder->fbufpos = 0;
+	}
+
+	return 0;
+}
+
+static int
+write_buffered(bson_encoder_t encoder, const void *p, size_t s)
+{
+	if ((encoder->fbufpos + s) > encoder->fbufsize) {
+		if (flush_buffered(encoder)) {
+			return -1;
+		}
+
+		/* large writes bypass the buffer */
+		if (s >= encoder->fbufsize) {
+			return (BSON_WRITE(encoder->fd, p, s) == (int)s) ? 0 : -1;
+		}
+	}
+
+	memcpy(encoder->fbuf + encoder->fbufpos, p, s);
+	encoder->fbufpos += s;
+	return 0;
+}
+
 static int
 write_x(bson_encoder_t encoder, const void *p, size_t s)
 {
 	CODER_CHECK(encoder);
 
 	if (encoder->fd > -1) {
+		if (encoder->fbuf != NULL) {
+			return write_buffered(encoder, p, s);
+		}
+
 		return (BSON_WRITE(encoder->fd, p, s) == (int)s) ? 0 : -1;
 	}
 
@@ -404,8 +551,17 @@ write_name(bson_encoder_t encoder, const char *name)
 
 int
 bson_encoder_init_file(bson_encoder_t encoder, int fd)
+{
+	return bson_encoder_init_file_buffered(encoder, fd, NULL, 0);
+}
+
+int
+bson_encoder_init_file_buffered(bson_encoder_t encoder, int fd, void *buf, unsigned bufsize)
 {
 	encoder->fd = fd;
+	encoder->fbuf = (uint8_t *)buf;
+	encoder->fbufsize = bufsize;
+	encoder->fbufpos = 0;
 	encoder->buf = NULL;
 	encoder->dead = false;
 
@@ -420,6 +576,7 @@ int
 bson_encoder_init_buf(bson_encoder_t encoder, void *buf, unsigned bufsize)
 {
 	encoder->fd = -1;
+	encoder->fbuf = NULL;
 	encoder->buf = (uint8_t *)buf;
 	encoder->bufpos = 0;
 	encoder->dead = false;
@@ -455,8 +612,12 @@ bson_encoder_fini(bson_encoder_t encoder)
 		memcpy(encoder->buf, &len, sizeof(len));
 	}
 
-	/* sync file */
+	/* write out what is left in the block buffer and sync file */
 	if (encoder->fd > -1) {
+		if (encoder->fbuf != NULL && flush_buffered(encoder)) {
+			CODER_KILL(encoder, "write error on flush");
+		}
+
 		BSON_FSYNC(encoder->fd);
 	}
 
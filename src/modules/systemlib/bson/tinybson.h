@@ -78,6 +78,11 @@ typedef enum bson_binary_subtype {
  */
 #define BSON_BUF_INCREMENT	128
 
+/**
+ * Suggested size of the block buffer for buffered file encoding/decoding.
+ */
+#define BSON_FILE_BUFSIZE	512
+
 /**
  * Node structure passed to the callback.
  */
@@ -105,11 +110,21 @@ struct bson_decoder_s {
 	/* file reader state */
 	int			fd;
 
+	/* optional block buffer for the file reader */
+	uint8_t			*fbuf;
+	unsigned		fbufsize;
+	unsigned		fbufpos;
+	unsigned		fbuflen;
+
 	/* buffer reader state */
 	uint8_t			*buf;
 	size_t			bufsize;
 	unsigned		bufpos;
 
+	/* file mapping backing buf, released by bson_decoder_fini */
+	void			*mapping;
+	size_t			mapping_size;
+
 	bool			dead;
 	bson_decoder_callback	callback;
 	void			*priv;
@@ -129,6 +144,40 @@ struct bson_decoder_s {
  */
 __EXPORT int bson_decoder_init_file(bson_decoder_t decoder, int fd, bson_decoder_callback callback, void *priv);
 
+/**
+ * Initialise the decoder to read from a file in blocks.
+ *
+ * The file is read bufsize bytes at a time instead of once per element, so the file
+ * position after decoding is undefined.
+ *
+ * @param decoder		Decoder state structure to be initialised.
+ * @param fd			File to read BSON data from.
+ * @param buf			Block buffer, must remain valid while decoding.
+ * @param bufsize		Size of buf, e.g. BSON_FILE_BUFSIZE.
+ * @param callback		Callback to be invoked by bson_decoder_next
+ * @param priv          Callback private data, stored in node.
+ * @return			Zero on success.
+ */
+__EXPORT int bson_decoder_init_file_buffered(bson_decoder_t decoder, int fd, void *buf, unsigned bufsize,
+		bson_decoder_callback callback, void *priv);
+
+#if defined(__PX4_POSIX) && !defined(__PX4_QURT)
+/**
+ * Initialise the decoder to read from a file by mapping it into memory.
+ *
+ * Decoding starts at the current file offset, like bson_decoder_init_file, but the
+ * offset is not advanced. The mapping is released by bson_decoder_fini.
+ *
+ * @param decoder		Decoder state structure to be initialised.
+ * @param fd			File to read BSON data from.
+ * @param callback		Callback to be invoked by bson_decoder_next
+ * @param priv          Callback private data, stored in node.
+ * @return			Zero on success, -1 if the file cannot be mapped (fall back to reading it then).
+ */
+__EXPORT int bson_decoder_init_file_mapped(bson_decoder_t decoder, int fd, bson_decoder_callback callback,
+		void *priv);
+#endif
+
 /**
  * Initialise the decoder to read from a buffer in memory.
  *
@@ -153,6 +202,13 @@ __EXPORT int bson_decoder_init_buf(bson_decoder_t decoder, void *buf, unsigned b
  */
 __EXPORT int bson_decoder_next(bson_decoder_t decoder);
 
+/**
+ * Release the resources of the decoder (the file mapping, if any).
+ *
+ * @param decoder		Decoder state, must have been initialised with bson_decoder_init.
+ */
+__EXPORT void bson_decoder_fini(bson_decoder_t decoder);
+
 /**
  * Copy node data.
  *
@@ -174,6 +230,11 @@ typedef struct bson_encoder_s {
 	/* file writer state */
 	int		fd;
 
+	/* optional block buffer for the file writer */
+	uint8_t		*fbuf;
+	unsigned	fbufsize;
+	unsigned	fbufpos;
+
 	/* buffer writer state */
 	uint8_t		*buf;
 	unsigned	bufsize;
@@ -193,6 +254,19 @@ typedef struct bson_encoder_s {
  */
 __EXPORT int bson_encoder_init_file(bson_encoder_t encoder, int fd);
 
+/**
+ * Initialze the encoder for writing to a file in blocks.
+ *
+ * Data is written once buf is full and by bson_encoder_fini.
+ *
+ * @param encoder		Encoder state structure to be initialised.
+ * @param fd			File to write to.
+ * @param buf			Block buffer, must remain valid until bson_encoder_fini.
+ * @param bufsize		Size of buf, e.g. BSON_FILE_BUFSIZE.
+ * @return			Zero on success.
+ */
+__EXPORT int bson_encoder_init_file_buffered(bson_encoder_t encoder, int fd, void *buf, unsigned bufsize);
+
 /**
  * Initialze the encoder for writing to a buffer.
  *
@@ -38,34 +38,304 @@
  * Included Files
  ****************************************************************************/
 
+#include <stdbool.h>
 #include <stdint.h>
 #include <stdlib.h>
+#include <string.h>
 #include "crc.h"
 
 /****************************************************************************
  * Pre-processor Definitions
  ****************************************************************************/
 
-/****************************************************************************
- * Private Types
- ****************************************************************************/
+/* On POSIX targets the tables are extended for slice-by-8 processing at startup
+ * (7 KB per CRC); flash constrained targets stay with the 256 entry byte tables. */
+#if defined(__PX4_POSIX) && !defined(__PX4_QURT)
+#  define CRC_SLICE_BY_8
+#endif
+
+#if defined(__ARM_FEATURE_CRC32)
+#  include <arm_acle.h>
+#  define CRC32_ARMV8
+#elif defined(CRC_SLICE_BY_8) && (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+#  include <immintrin.h>
+#  define CRC32_CLMUL
+#endif
+
+#ifdef CRC_SLICE_BY_8
+#  define CRC_SLICES 8
+#  define CRC_TABLE_CONST
+#else
+#  define CRC_SLICES 1
+#  define CRC_TABLE_CONST const
+#endif
 
 /****************************************************************************
- * Private Function Prototypes
+ * Private Data
  ****************************************************************************/
 
+/* CRC-16-CCITT, polynomial 0x1021 (MSB first) */
+static CRC_TABLE_CONST uint16_t crc16_ccitt_table[CRC_SLICES][256] = { {
+		0x0000, 0x1021, 0x2042, 0x3063, 0x4084, 0x50a5, 0x60c6, 0x70e7,
+		0x8108, 0x9129, 0xa14a, 0xb16b, 0xc18c, 0xd1ad, 0xe1ce, 0xf1ef,
+		0x1231, 0x0210, 0x3273, 0x2252, 0x52b5, 0x4294, 0x72f7, 0x62d6,
+		0x9339, 0x8318, 0xb37b, 0xa35a, 0xd3bd, 0xc39c, 0xf3ff, 0xe3de,
+		0x2462, 0x3443, 0x0420, 0x1401, 0x64e6, 0x74c7, 0x44a4, 0x5485,
+		0xa56a, 0xb54b, 0x8528, 0x9509, 0xe5ee, 0xf5cf, 0xc5ac, 0xd58d,
+		0x3653, 0x2672, 0x1611, 0x0630, 0x76d7, 0x66f6, 0x5695, 0x46b4,
+		0xb75b, 0xa77a, 0x9719, 0x8738, 0xf7df, 0xe7fe, 0xd79d, 0xc7bc,
+		0x48c4, 0x58e5, 0x6886, 0x78a7, 0x0840, 0x1861, 0x2802, 0x3823,
+		0xc9cc, 0xd9ed, 0xe98e, 0xf9af, 0x8948, 0x9969, 0xa90a, 0xb92b,
+		0x5af5, 0x4ad4, 0x7ab7, 0x6a96, 0x1a71, 0x0a50, 0x3a33, 0x2a12,
+		0xdbfd, 0xcbdc, 0xfbbf, 0xeb9e, 0x9b79, 0x8b58, 0xbb3b, 0xab1a,
+		0x6ca6, 0x7c87, 0x4ce4, 0x5cc5, 0x2c22, 0x3c03, 0x0c60, 0x1c41,
+		0xedae, 0xfd8f, 0xcdec, 0xddcd, 0xad2a, 0xbd0b, 0x8d68, 0x9d49,
+		0x7e97, 0x6eb6, 0x5ed5, 0x4ef4, 0x3e13, 0x2e32, 0x1e51, 0x0e70,
+		0xff9f, 0xefbe, 0xdfdd, 0xcffc, 0xbf1b, 0xaf3a, 0x9f59, 0x8f78,
+		0x9188, 0x81a9, 0xb1ca, 0xa1eb, 0xd10c, 0xc12d, 0xf14e, 0xe16f,
+		0x1080, 0x00a1, 0x30c2, 0x20e3, 0x5004, 0x4025, 0x7046, 0x6067,
+		0x83b9, 0x9398, 0xa3fb, 0xb3da, 0xc33d, 0xd31c, 0xe37f, 0xf35e,
+		0x02b1, 0x1290, 0x22f3, 0x32d2, 0x4235, 0x5214, 0x6277, 0x7256,
+		0xb5ea, 0xa5cb, 0x95a8, 0x8589, 0xf56e, 0xe54f, 0xd52c, 0xc50d,
+		0x34e2, 0x24c3, 0x14a0, 0x0481, 0x7466, 0x6447, 0x5424, 0x4405,
+		0xa7db, 0xb7fa, 0x8799, 0x97b8, 0xe75f, 0xf77e, 0xc71d, 0xd73c,
+		0x26d3, 0x36f2, 0x0691, 0x16b0, 0x6657, 0x7676, 0x4615, 0x5634,
+		0xd94c, 0xc96d, 0xf90e, 0xe92f, 0x99c8, 0x89e9, 0xb98a, 0xa9ab,
+		0x5844, 0x4865, 0x7806, 0x6827, 0x18c0, 0x08e1, 0x3882, 0x28a3,
+		0xcb7d, 0xdb5c, 0xeb3f, 0xfb1e, 0x8bf9, 0x9bd8, 0xabbb, 0xbb9a,
+		0x4a75, 0x5a54, 0x6a37, 0x7a16, 0x0af1, 0x1ad0, 0x2ab3, 0x3a92,
+		0xfd2e, 0xed0f, 0xdd6c, 0xcd4d, 0xbdaa, 0xad8b, 0x9de8, 0x8dc9,
+		0x7c26, 0x6c07, 0x5c64, 0x4c45, 0x3ca2, 0x2c83, 0x1ce0, 0x0cc1,
+		0xef1f, 0xff3e, 0xcf5d, 0xdf7c, 0xaf9b, 0xbfba, 0x8fd9, 0x9ff8,
+		0x6e17, 0x7e36, 0x4e55, 0x5e74, 0x2e93, 0x3eb2, 0x0ed1, 0x1ef0
+	}
+};
+
+/* CRC-16/ARC, polynomial 0x8005 (reflected: 0xA001) */
+static CRC_TABLE_CONST uint16_t crc16_arc_table[CRC_SLICES][256] = { {
+		0x0000, 0xc0c1, 0xc181, 0x0140, 0xc301, 0x03c0, 0x0280, 0xc241,
+		0xc601, 0x06c0, 0x0780, 0xc741, 0x0500, 0xc5c1, 0xc481, 0x0440,
+		0xcc01, 0x0cc0, 0x0d80, 0xcd41, 0x0f00, 0xcfc1, 0xce81, 0x0e40,
+		0x0a00, 0xcac1, 0xcb81, 0x0b40, 0xc901, 0x09c0, 0x0880, 0xc841,
+		0xd801, 0x18c0, 0x1980, 0xd941, 0x1b00, 0xdbc1, 0xda81, 0x1a40,
+		0x1e00, 0xdec1, 0xdf81, 0x1f40, 0xdd01, 0x1dc0, 0x1c80, 0xdc41,
+		0x1400, 0xd4c1, 0xd581, 0x1540, 0xd701, 0x17c0, 0x1680, 0xd641,
+		0xd201, 0x12c0, 0x1380, 0xd341, 0x1100, 0xd1c1, 0xd081, 0x1040,
+		0xf001, 0x30c0, 0x3180, 0xf141, 0x3300, 0xf3c1, 0xf281, 0x3240,
+		0x3600, 0xf6c1, 0xf781, 0x3740, 0xf501, 0x35c0, 0x3480, 0xf441,
+		0x3c00, 0xfcc1, 0xfd81, 0x3d40, 0xff01, 0x3fc0, 0x3e80, 0xfe41,
+		0xfa01, 0x3ac0, 0x3b80, 0xfb41, 0x3900, 0xf9c1, 0xf881, 0x3840,
+		0x2800, 0xe8c1, 0xe981, 0x2940, 0xeb01, 0x2bc0, 0x2a80, 0xea41,
+		0xee01, 0x2ec0, 0x2f80, 0xef41, 0x2d00, 0xedc1, 0xec81, 0x2c40,
+		0xe401, 0x24c0, 0x2580, 0xe541, 0x2700, 0xe7c1, 0xe681, 0x2640,
+		0x2200, 0xe2c1, 0xe381, 0x2340, 0xe101, 0x21c0, 0x2080, 0xe041,
+		0xa001, 0x60c0, 0x6180, 0xa141, 0x6300, 0xa3c1, 0xa281, 0x6240,
+		0x6600, 0xa6c1, 0xa781, 0x6740, 0xa501, 0x65c0, 0x6480, 0xa441,
+		0x6c00, 0xacc1, 0xad81, 0x6d40, 0xaf01, 0x6fc0, 0x6e80, 0xae41,
+		0xaa01, 0x6ac0, 0x6b80, 0xab41, 0x6900, 0xa9c1, 0xa881, 0x6840,
+		0x7800, 0xb8c1, 0xb981, 0x7940, 0xbb01, 0x7bc0, 0x7a80, 0xba41,
+		0xbe01, 0x7ec0, 0x7f80, 0xbf41, 0x7d00, 0xbdc1, 0xbc81, 0x7c40,
+		0xb401, 0x74c0, 0x7580, 0xb541, 0x7700, 0xb7c1, 0xb681, 0x7640,
+		0x7200, 0xb2c1, 0xb381, 0x7340, 0xb101, 0x71c0, 0x7080, 0xb041,
+		0x5000, 0x90c1, 0x9181, 0x5140, 0x9301, 0x53c0, 0x5280, 0x9241,
+		0x9601, 0x56c0, 0x5780, 0x9741, 0x5500, 0x95c1, 0x9481, 0x5440,
+		0x9c01, 0x5cc0, 0x5d80, 0x9d41, 0x5f00, 0x9fc1, 0x9e81, 0x5e40,
+		0x5a00, 0x9ac1, 0x9b81, 0x5b40, 0x9901, 0x59c0, 0x5880, 0x9841,
+		0x8801, 0x48c0, 0x4980, 0x8941, 0x4b00, 0x8bc1, 0x8a81, 0x4a40,
+		0x4e00, 0x8ec1, 0x8f81, 0x4f40, 0x8d01, 0x4dc0, 0x4c80, 0x8c41,
+		0x4400, 0x84c1, 0x8581, 0x4540, 0x8701, 0x47c0, 0x4680, 0x8641,
+		0x8201, 0x42c0, 0x4380, 0x8341, 0x4100, 0x81c1, 0x8081, 0x4040
+	}
+};
+
+/* CRC-32 (IEEE 802.3), polynomial 0x04C11DB7 (reflected: 0xEDB88320) */
+static CRC_TABLE_CONST uint32_t crc32_table[CRC_SLICES][256] = { {
+		0x00000000, 0x77073096, 0xee0e612c, 0x990951ba, 0x076dc419, 0x706af48f, 0xe963a535, 0x9e6495a3,
+		0x0edb8832, 0x79dcb8a4, 0xe0d5e91e, 0x97d2d988, 0x09b64c2b, 0x7eb17cbd, 0xe7b82d07, 0x90bf1d91,
+		0x1db71064, 0x6ab020f2, 0xf3b97148, 0x84be41de, 0x1adad47d, 0x6ddde4eb, 0xf4d4b551, 0x83d385c7,
+		0x136c9856, 0x646ba8c0, 0xfd62f97a, 0x8a65c9ec, 0x14015c4f, 0x63066cd9, 0xfa0f3d63, 0x8d080df5,
+		0x3b6e20c8, 0x4c69105e, 0xd56041e4, 0xa2677172, 0x3c03e4d1, 0x4b04d447, 0xd20d85fd, 0xa50ab56b,
+		0x35b5a8fa, 0x42b2986c, 0xdbbbc9d6, 0xacbcf940, 0x32d86ce3, 0x45df5c75, 0xdcd60dcf, 0xabd13d59,
+		0x26d930ac, 0x51de003a, 0xc8d75180, 0xbfd06116, 0x21b4f4b5, 0x56b3c423, 0xcfba9599, 0xb8bda50f,
+		0x2802b89e, 0x5f058808, 0xc60cd9b2, 0xb10be924, 0x2f6f7c87, 0x58684c11, 0xc1611dab, 0xb6662d3d,
+		0x76dc4190, 0x01db7106, 0x98d220bc, 0xefd5102a, 0x71b18589, 0x06b6b51f, 0x9fbfe4a5, 0xe8b8d433,
+		0x7807c9a2, 0x0f00f934, 0x9609a88e, 0xe10e9818, 0x7f6a0dbb, 0x086d3d2d, 0x91646c97, 0xe6635c01,
+		0x6b6b51f4, 0x1c6c6162, 0x856530d8, 0xf262004e, 0x6c0695ed, 0x1b01a57b, 0x8208f4c1, 0xf50fc457,
+		0x65b0d9c6, 0x12b7e950, 0x8bbeb8ea, 0xfcb9887c, 0x62dd1ddf, 0x15da2d49, 0x8cd37cf3, 0xfbd44c65,
+		0x4db26158, 0x3ab551ce, 0xa3bc0074, 0xd4bb30e2, 0x4adfa541, 0x3dd895d7, 0xa4d1c46d, 0xd3d6f4fb,
+		0x4369e96a, 0x346ed9fc, 0xad678846, 0xda60b8d0, 0x44042d73, 0x33031de5, 0xaa0a4c5f, 0xdd0d7cc9,
+		0x5005713c, 0x270241aa, 0xbe0b1010, 0xc90c2086, 0x5768b525, 0x206f85b3, 0xb966d409, 0xce61e49f,
+		0x5edef90e, 0x29d9c998, 0xb0d09822, 0xc7d7a8b4, 0x59b33d17, 0x2eb40d81, 0xb7bd5c3b, 0xc0ba6cad,
+		0xedb88320, 0x9abfb3b6, 0x03b6e20c, 0x74b1d29a, 0xead54739, 0x9dd277af, 0x04db2615, 0x73dc1683,
+		0xe3630b12, 0x94643b84, 0x0d6d6a3e, 0x7a6a5aa8, 0xe40ecf0b, 0x9309ff9d, 0x0a00ae27, 0x7d079eb1,
+		0xf00f9344, 0x8708a3d2, 0x1e01f268, 0x6906c2fe, 0xf762575d, 0x806567cb, 0x196c3671, 0x6e6b06e7,
+		0xfed41b76, 0x89d32be0, 0x10da7a5a, 0x67dd4acc, 0xf9b9df6f, 0x8ebeeff9, 0x17b7be43, 0x60b08ed5,
+		0xd6d6a3e8, 0xa1d1937e, 0x38d8c2c4, 0x4fdff252, 0xd1bb67f1, 0xa6bc5767, 0x3fb506dd, 0x48b2364b,
+		0xd80d2bda, 0xaf0a1b4c, 0x36034af6, 0x41047a60, 0xdf60efc3, 0xa867df55, 0x316e8eef, 0x4669be79,
+		0xcb61b38c, 0xbc66831a, 0x256fd2a0, 0x5268e236, 0xcc0c7795, 0xbb0b4703, 0x220216b9, 0x5505262f,
+		0xc5ba3bbe, 0xb2bd0b28, 0x2bb45a92, 0x5cb36a04, 0xc2d7ffa7, 0xb5d0cf31, 0x2cd99e8b, 0x5bdeae1d,
+		0x9b64c2b0, 0xec63f226, 0x756aa39c, 0x026d930a, 0x9c0906a9, 0xeb0e363f, 0x72076785, 0x05005713,
+		0x95bf4a82, 0xe2b87a14, 0x7bb12bae, 0x0cb61b38, 0x92d28e9b, 0xe5d5be0d, 0x7cdcefb7, 0x0bdbdf21,
+		0x86d3d2d4, 0xf1d4e242, 0x68ddb3f8, 0x1fda836e, 0x81be16cd, 0xf6b9265b, 0x6fb077e1, 0x18b74777,
+		0x88085ae6, 0xff0f6a70, 0x66063bca, 0x11010b5c, 0x8f659eff, 0xf862ae69, 0x616bffd3, 0x166ccf45,
+		0xa00ae278, 0xd70dd2ee, 0x4e048354, 0x3903b3c2, 0xa7672661, 0xd06016f7, 0x4969474d, 0x3e6e77db,
+		0xaed16a4a, 0xd9d65adc, 0x40df0b66, 0x37d83bf0, 0xa9bcae53, 0xdebb9ec5, 0x47b2cf7f, 0x30b5ffe9,
+		0xbdbdf21c, 0xcabac28a, 0x53b39330, 0x24b4a3a6, 0xbad03605, 0xcdd70693, 0x54de5729, 0x23d967bf,
+		0xb3667a2e, 0xc4614ab8, 0x5d681b02, 0x2a6f2b94, 0xb40bbe37, 0xc30c8ea1, 0x5a05df1b, 0x2d02ef8d
+	}
+};
+
+#ifdef CRC32_CLMUL
+static bool crc32_clmul_supported = false;
+#endif
+
 /****************************************************************************
- * Private Data
+ * Private Functions
  ****************************************************************************/
 
+#ifdef CRC_SLICE_BY_8
 /****************************************************************************
- * Public Data
+ * Name: crc_tables_init
+ *
+ * Description:
+ *   Derive the tables for slice-by-8 processing from the byte tables:
+ *   table[k][b] is the CRC contribution of byte b followed by k zero bytes.
+ *   Runs before main(), so no locking is needed in the CRC functions.
+ *
  ****************************************************************************/
 
+__attribute__((constructor))
+static void crc_tables_init(void)
+{
+	for (unsigned b = 0; b < 256; b++) {
+		for (unsigned k = 1; k < CRC_SLICES; k++) {
+			uint16_t c16 = crc16_ccitt_table[k - 1][b];
+			crc16_ccitt_table[k][b] = (uint16_t)(c16 << 8) ^ crc16_ccitt_table[0][c16 >> 8];
+
+			c16 = crc16_arc_table[k - 1][b];
+			crc16_arc_table[k][b] = (c16 >> 8) ^ crc16_arc_table[0][c16 & 0xff];
+
+			uint32_t c32 = crc32_table[k - 1][b];
+			crc32_table[k][b] = (c32 >> 8) ^ crc32_table[0][c32 & 0xff];
+		}
+	}
+
+#ifdef CRC32_CLMUL
+	__builtin_cpu_init();
+	crc32_clmul_supported = __builtin_cpu_supports("pclmul") && __builtin_cpu_supports("sse4.1");
+#endif
+}
+#endif /* CRC_SLICE_BY_8 */
+
+#ifdef CRC32_CLMUL
 /****************************************************************************
- * Private Functions
+ * Name: crc32_clmul
+ *
+ * Description:
+ *   CRC-32 by folding 64 byte blocks with carry-less multiplication, see
+ *   "Fast CRC Computation for Generic Polynomials Using PCLMULQDQ
+ *   Instruction", Intel, 2009. The constants are the bit-reflected ones
+ *   given at the end of the paper.
+ *
+ * Input Parameters:
+ *    crc    - The running crc 32
+ *    length - The number of bytes, a multiple of 16 and at least 64
+ *    bytes  - The data
+ *
  ****************************************************************************/
 
+__attribute__((target("pclmul,sse4.1")))
+static uint32_t crc32_clmul(uint32_t crc, size_t length, const uint8_t *bytes)
+{
+	static const uint64_t k1k2[2] __attribute__((aligned(16))) = { 0x0154442bd4ull, 0x01c6e41596ull };
+	static const uint64_t k3k4[2] __attribute__((aligned(16))) = { 0x01751997d0ull, 0x00ccaa009eull };
+	static const uint64_t k5k0[2] __attribute__((aligned(16))) = { 0x0163cd6124ull, 0x0000000000ull };
+	static const uint64_t poly[2] __attribute__((aligned(16))) = { 0x01db710641ull, 0x01f7011641ull };
+
+	__m128i x0, x1, x2, x3, x4, x5, x6, x7, x8;
+
+	x1 = _mm_loadu_si128((const __m128i *)(bytes + 0x00));
+	x2 = _mm_loadu_si128((const __m128i *)(bytes + 0x10));
+	x3 = _mm_loadu_si128((const __m128i *)(bytes + 0x20));
+	x4 = _mm_loadu_si128((const __m128i *)(bytes + 0x30));
+	x1 = _mm_xor_si128(x1, _mm_cvtsi32_si128(crc));
+	x0 = _mm_load_si128((const __m128i *)k1k2);
+
+	bytes += 64;
+	length -= 64;
+
+	/* fold 4 x 128 bits in parallel */
+	while (length >= 64) {
+		x5 = _mm_clmulepi64_si128(x1, x0, 0x00);
+		x6 = _mm_clmulepi64_si128(x2, x0, 0x00);
+		x7 = _mm_clmulepi64_si128(x3, x0, 0x00);
+		x8 = _mm_clmulepi64_si128(x4, x0, 0x00);
+
+		x1 = _mm_clmulepi64_si128(x1, x0, 0x11);
+		x2 = _mm_clmulepi64_si128(x2, x0, 0x11);
+		x3 = _mm_clmulepi64_si128(x3, x0, 0x11);
+		x4 = _mm_clmulepi64_si128(x4, x0, 0x11);
+
+		x1 = _mm_xor_si128(_mm_xor_si128(x1, x5), _mm_loadu_si128((const __m128i *)(bytes + 0x00)));
+		x2 = _mm_xor_si128(_mm_xor_si128(x2, x6), _mm_loadu_si128((const __m128i *)(bytes + 0x10)));
+		x3 = _mm_xor_si128(_mm_xor_si128(x3, x7), _mm_loadu_si128((const __m128i *)(bytes + 0x20)));
+		x4 = _mm_xor_si128(_mm_xor_si128(x4, x8), _mm_loadu_si128((const __m128i *)(bytes + 0x30)));
+
+		bytes += 64;
+		length -= 64;
+	}
+
+	/* fold into 128 bits */
+	x0 = _mm_load_si128((const __m128i *)k3k4);
+
+	x5 = _mm_clmulepi64_si128(x1, x0, 0x00);
+	x1 = _mm_clmulepi64_si128(x1, x0, 0x11);
+	x1 = _mm_xor_si128(_mm_xor_si128(x1, x2), x5);
+
+	x5 = _mm_clmulepi64_si128(x1, x0, 0x00);
+	x1 = _mm_clmulepi64_si128(x1, x0, 0x11);
+	x1 = _mm_xor_si128(_mm_xor_si128(x1, x3), x5);
+
+	x5 = _mm_clmulepi64_si128(x1, x0, 0x00);
+	x1 = _mm_clmulepi64_si128(x1, x0, 0x11);
+	x1 = _mm_xor_si128(_mm_xor_si128(x1, x4), x5);
+
+	/* remaining 128 bit blocks */
+	while (length >= 16) {
+		x5 = _mm_clmulepi64_si128(x1, x0, 0x00);
+		x1 = _mm_clmulepi64_si128(x1, x0, 0x11);
+		x1 = _mm_xor_si128(_mm_xor_si128(x1, _mm_loadu_si128((const __m128i *)bytes)), x5);
+
+		bytes += 16;
+		length -= 16;
+	}
+
+	/* fold 128 bits to 64 bits */
+	x2 = _mm_clmulepi64_si128(x1, x0, 0x10);
+	x3 = _mm_setr_epi32(~0, 0, ~0, 0);
+	x1 = _mm_srli_si128(x1, 8);
+	x1 = _mm_xor_si128(x1, x2);
+
+	x0 = _mm_loadl_epi64((const __m128i *)k5k0);
+
+	x2 = _mm_srli_si128(x1, 4);
+	x1 = _mm_and_si128(x1, x3);
+	x1 = _mm_clmulepi64_si128(x1, x0, 0x00);
+	x1 = _mm_xor_si128(x1, x2);
+
+	/* Barrett reduction to 32 bits */
+	x0 = _mm_load_si128((const __m128i *)poly);
+
+	x2 = _mm_and_si128(x1, x3);
+	x2 = _mm_clmulepi64_si128(x2, x0, 0x10);
+	x2 = _mm_and_si128(x2, x3);
+	x2 = _mm_clmulepi64_si128(x2, x0, 0x00);
+	x1 = _mm_xor_si128(x1, x2);
+
+	return (uint32_t)_mm_extract_epi32(x1, 1);
+}
+#endif /* CRC32_CLMUL */
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -88,28 +358,15 @@
 
 uint16_t crc16_add(uint16_t crc, uint8_t value)
 {
-	uint32_t i;
-	const uint16_t poly = 0x1021u;
-	crc ^= (uint16_t)((uint16_t) value << 8u);
-
-	for (i = 0; i < 8; i++) {
-		if (crc & (1u << 15u)) {
-			crc = (uint16_t)((crc << 1u) ^ poly);
-
-		} else {
-			crc = (uint16_t)(crc << 1u);
-		}
-	}
-
-	return crc;
+	return (uint16_t)(crc << 8) ^ crc16_ccitt_table[0][(crc >> 8) ^ value];
 }
 
 /****************************************************************************
  * Name: crc16_signature
  *
  * Description:
- *   Calculates a CRC-16-CCITT using the crc16_add
- *   function
+ *   Calculates a CRC-16-CCITT over a buffer, 8 bytes at a time where the
+ *   slice tables are available.
  *
  * Input Parameters:
  *    initial - The Initial value to uses as the crc's starting point
@@ -123,13 +380,135 @@ uint16_t crc16_add(uint16_t crc, uint8_t value)
 
 uint16_t crc16_signature(uint16_t initial, size_t length, const uint8_t *bytes)
 {
-	size_t i;
+	uint16_t crc = initial;
+
+#ifdef CRC_SLICE_BY_8
+
+	while (length >= 8) {
+		crc = crc16_ccitt_table[7][bytes[0] ^ (crc >> 8)] ^
+		      crc16_ccitt_table[6][bytes[1] ^ (crc & 0xff)] ^
+		      crc16_ccitt_table[5][bytes[2]] ^
+		      crc16_ccitt_table[4][bytes[3]] ^
+		      crc16_ccitt_table[3][bytes[4]] ^
+		      crc16_ccitt_table[2][bytes[5]] ^
+		      crc16_ccitt_table[1][bytes[6]] ^
+		      crc16_ccitt_table[0][bytes[7]];
+		bytes += 8;
+		length -= 8;
+	}
+
+#endif
+
+	while (length-- > 0) {
+		crc = crc16_add(crc, *bytes++);
+	}
+
+	return crc ^ CRC16_OUTPUT_XOR;
+}
+
+/****************************************************************************
+ * Name: crc16_arc_signature
+ *
+ * Description:
+ *   Calculates a CRC-16/ARC over a buffer, 8 bytes at a time where the
+ *   slice tables are available.
+ *
+ ****************************************************************************/
+
+uint16_t crc16_arc_signature(uint16_t initial, size_t length, const uint8_t *bytes)
+{
+	uint16_t crc = initial;
+
+#ifdef CRC_SLICE_BY_8
+
+	while (length >= 8) {
+		crc = crc16_arc_table[7][bytes[0] ^ (crc & 0xff)] ^
+		      crc16_arc_table[6][bytes[1] ^ (crc >> 8)] ^
+		      crc16_arc_table[5][bytes[2]] ^
+		      crc16_arc_table[4][bytes[3]] ^
+		      crc16_arc_table[3][bytes[4]] ^
+		      crc16_arc_table[2][bytes[5]] ^
+		      crc16_arc_table[1][bytes[6]] ^
+		      crc16_arc_table[0][bytes[7]];
+		bytes += 8;
+		length -= 8;
+	}
+
+#endif
+
+	while (length-- > 0) {
+		crc = (crc >> 8) ^ crc16_arc_table[0][(crc ^ *bytes++) & 0xff];
+	}
+
+	return crc;
+}
+
+/****************************************************************************
+ * Name: crc32_signature
+ *
+ * Description:
+ *   Calculates a CRC-32 over a buffer, using the ARMv8 CRC instructions or
+ *   carry-less multiplication on x86 when available, otherwise 8 (POSIX)
+ *   or 1 byte at a time from tables.
+ *
+ ****************************************************************************/
+
+uint32_t crc32_signature(uint32_t initial, size_t length, const uint8_t *bytes)
+{
+	uint32_t crc = initial;
+
+#if defined(CRC32_ARMV8)
 
-	for (i = 0u; i < length; i++) {
-		initial = crc16_add(initial, bytes[i]);
+	while (length >= 8) {
+		uint64_t word;
+		memcpy(&word, bytes, sizeof(word));
+		crc = __crc32d(crc, word);
+		bytes += 8;
+		length -= 8;
 	}
 
-	return initial ^ CRC16_OUTPUT_XOR;
+	while (length-- > 0) {
+		crc = __crc32b(crc, *bytes++);
+	}
+
+	return crc;
+#else
+
+#  ifdef CRC32_CLMUL
+
+	if (crc32_clmul_supported && length >= 64) {
+		size_t blocks = length & ~(size_t)15;
+		crc = crc32_clmul(crc, blocks, bytes);
+		bytes += blocks;
+		length -= blocks;
+	}
+
+#  endif
+#  ifdef CRC_SLICE_BY_8
+
+	while (length >= 8) {
+		uint32_t lo = (uint32_t)bytes[0] | ((uint32_t)bytes[1] << 8) | ((uint32_t)bytes[2] << 16) | ((uint32_t)bytes[3] << 24);
+		lo ^= crc;
+		crc = crc32_table[7][lo & 0xff] ^
+		      crc32_table[6][(lo >> 8) & 0xff] ^
+		      crc32_table[5][(lo >> 16) & 0xff] ^
+		      crc32_table[4][lo >> 24] ^
+		      crc32_table[3][bytes[4]] ^
+		      crc32_table[2][bytes[5]] ^
+		      crc32_table[1][bytes[6]] ^
+		      crc32_table[0][bytes[7]];
+		bytes += 8;
+		length -= 8;
+	}
+
+#  endif
+
+	while (length-- > 0) {
+		crc = (crc >> 8) ^ crc32_table[0][(crc ^ *bytes++) & 0xff];
+	}
+
+	return crc;
+#endif
 }
 
 /****************************************************************************
@@ -39,6 +39,10 @@
 /****************************************************************************
  * Included Files
  ****************************************************************************/
+
+#include <stddef.h>
+#include <stdint.h>
+
 /****************************************************************************
  * Pre-processor Definitions
  ****************************************************************************/
@@ -58,6 +62,9 @@
 /****************************************************************************
  * Public Function Prototypes
  ****************************************************************************/
+
+__BEGIN_DECLS
+
 /****************************************************************************
  * Name: crc16_add
  *
@@ -114,3 +121,45 @@ uint16_t crc16_signature(uint16_t initial, size_t length,
  ****************************************************************************/
 
 uint64_t crc64_add_word(uint64_t crc, uint32_t value);
+
+/****************************************************************************
+ * Name: crc16_arc_signature
+ *
+ * Description:
+ *   Calculates a CRC-16/ARC (polynomial 0x8005, reflected, no output xor),
+ *   as used by the microRTPS transport. Check: 0xBB3D with initial 0
+ *
+ * Input Parameters:
+ *    initial - The Initial value to uses as the crc's starting point
+ *    length  - The number of bytes to add to the crc
+ *    bytes   - A pointer to any array of length bytes
+ *
+ * Returned Value:
+ *   The crc16 of the array of bytes
+ *
+ ****************************************************************************/
+
+uint16_t crc16_arc_signature(uint16_t initial, size_t length, const uint8_t *bytes);
+
+/****************************************************************************
+ * Name: crc32_signature
+ *
+ * Description:
+ *   Calculates a CRC-32 (IEEE 802.3, polynomial 0x04C11DB7, reflected)
+ *   without input or output inversion, i.e. the same as crc32part().
+ *   The standard CRC-32 is ~crc32_signature(0xFFFFFFFF, ...),
+ *   Check: 0xCBF43926
+ *
+ * Input Parameters:
+ *    initial - The Initial value to uses as the crc's starting point
+ *    length  - The number of bytes to add to the crc
+ *    bytes   - A pointer to any array of length bytes
+ *
+ * Returned Value:
+ *   The crc32 of the array of bytes
+ *
+ ****************************************************************************/
+
+uint32_t crc32_signature(uint32_t initial, size_t length, const uint8_t *bytes);
+
+__END_DECLS
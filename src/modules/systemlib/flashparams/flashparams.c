@@ -72,7 +72,7 @@ struct param_wbuf_s {
 };
 
 static int
-param_export_internal(bool only_unsaved)
+param_export_internal(UT_array *param_values, bool only_unsaved)
 {
 	struct param_wbuf_s *s = NULL;
 	struct bson_encoder_s encoder;
@@ -352,9 +352,9 @@ out:
 	return result;
 }
 
-int flash_param_save(void)
+int flash_param_save(UT_array *param_values)
 {
-	return param_export_internal(false);
+	return param_export_internal(param_values, false);
 }
 
 int flash_param_load(void)
@@ -55,17 +55,17 @@ __BEGIN_DECLS
 
 /*
  * When using the flash based parameter store we have to force
- * the param_values and 2 functions to be global
+ * 2 functions to be global
  */
 
 #define FLASH_PARAMS_EXPOSE __EXPORT
 
-__EXPORT extern UT_array        *param_values;
 __EXPORT int param_set_external(param_t param, const void *val, bool mark_saved, bool notify_changes);
 __EXPORT const void *param_get_value_ptr_external(param_t param);
 
-/* The interface hooks to the Flash based storage. The caller is responsible for locking */
-__EXPORT int flash_param_save(void);
+/* The interface hooks to the Flash based storage. The caller is responsible for locking,
+ * flash_param_save() stores the modified values in param_values */
+__EXPORT int flash_param_save(UT_array *param_values);
 __EXPORT int flash_param_load(void);
 __EXPORT int flash_param_import(void);
 __END_DECLS
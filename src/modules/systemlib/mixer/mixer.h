@@ -652,8 +652,21 @@ private:
 	void update_saturation_status(unsigned index, bool clipping_high, bool clipping_low);
 	saturation_status _saturation_status;
 
+	/**
+	 * Mixing kernel for a fixed rotor count, which lets the compiler fully
+	 * unroll the per-rotor passes. N = 0 handles any rotor count at runtime.
+	 *
+	 * @param outputs		Output buffer of at least _rotor_count elements.
+	 * @return			The number of outputs written.
+	 */
+	template<unsigned N>
+	unsigned			mix_rotors(float *outputs);
+
+	typedef unsigned(MultirotorMixer::*MixKernel)(float *outputs);
+
 	unsigned			_rotor_count;
 	const Rotor			*_rotors;
+	MixKernel			_mix_kernel;	/**< kernel selected for the rotor count of the geometry */
 
 	float 				*_outputs_prev = nullptr;
 
@@ -85,9 +85,28 @@ MultirotorMixer::MultirotorMixer(ControlCallback control_cb,
 	_thrust_factor(0.0f),
 	_rotor_count(_config_rotor_count[(MultirotorGeometryUnderlyingType)geometry]),
 	_rotors(_config_index[(MultirotorGeometryUnderlyingType)geometry]),
+	_mix_kernel(&MultirotorMixer::mix_rotors<0>),
 	_outputs_prev(new float[_rotor_count])
 {
 	memset(_outputs_prev, _idle_speed, _rotor_count * sizeof(float));
+
+	/* use a kernel with fixed loop counts for the common geometries */
+	switch (_rotor_count) {
+	case 4:
+		_mix_kernel = &MultirotorMixer::mix_rotors<4>;
+		break;
+
+	case 6:
+		_mix_kernel = &MultirotorMixer::mix_rotors<6>;
+		break;
+
+	case 8:
+		_mix_kernel = &MultirotorMixer::mix_rotors<8>;
+		break;
+
+	default:
+		break;
+	}
 }
 
 MultirotorMixer::~MultirotorMixer()
@@ -203,6 +222,21 @@ MultirotorMixer::from_text(Mixer::ControlCallback control_cb, uintptr_t cb_handl
 unsigned
 MultirotorMixer::mix(float *outputs, unsigned space)
 {
+	return (this->*_mix_kernel)(outputs);
+}
+
+template<unsigned N>
+unsigned
+MultirotorMixer::mix_rotors(float *outputs)
+{
+	/* compile-time rotor count for the specialized kernels */
+	const unsigned rotor_count = (N > 0) ? N : _rotor_count;
+
+	/* local copies, stores to outputs would otherwise force reloading the members in every iteration */
+	const Rotor *rotors = _rotors;
+	const float idle_speed = _idle_speed;
+	const float thrust_factor = _thrust_factor;
+
 	/* Summary of mixing strategy:
 	1) mix roll, pitch and thrust without yaw.
 	2) if some outputs violate range [0,1] then try to shift all outputs to minimize violation ->
@@ -229,12 +263,12 @@ MultirotorMixer::mix(float *outputs, unsigned space)
 	float thrust_decrease_factor = 0.6f;
 
 	/* perform initial mix pass yielding unbounded outputs, ignore yaw */
-	for (unsigned i = 0; i < _rotor_count; i++) {
-		float out = roll * _rotors[i].roll_scale +
-			    pitch * _rotors[i].pitch_scale +
+	for (unsigned i = 0; i < rotor_count; i++) {
+		float out = roll * rotors[i].roll_scale +
+			    pitch * rotors[i].pitch_scale +
 			    thrust;
 
-		out *= _rotors[i].out_scale;
+		out *= rotors[i].out_scale;
 
 		/* calculate min and max output values */
 		if (out < min_out) {
@@ -303,22 +337,22 @@ MultirotorMixer::mix(float *outputs, unsigned space)
 	float thrust_reduction = 0.0f;
 
 	// mix again but now with thrust boost, scale roll/pitch and also add yaw
-	for (unsigned i = 0; i < _rotor_count; i++) {
-		float out = (roll * _rotors[i].roll_scale +
-			     pitch * _rotors[i].pitch_scale) * roll_pitch_scale +
-			    yaw * _rotors[i].yaw_scale +
+	for (unsigned i = 0; i < rotor_count; i++) {
+		float out = (roll * rotors[i].roll_scale +
+			     pitch * rotors[i].pitch_scale) * roll_pitch_scale +
+			    yaw * rotors[i].yaw_scale +
 			    thrust + boost;
 
-		out *= _rotors[i].out_scale;
+		out *= rotors[i].out_scale;
 
 		// scale yaw if it violates limits. inform about yaw limit reached
 		if (out < 0.0f) {
-			if (fabsf(_rotors[i].yaw_scale) <= FLT_EPSILON) {
+			if (fabsf(rotors[i].yaw_scale) <= FLT_EPSILON) {
 				yaw = 0.0f;
 
 			} else {
-				yaw = -((roll * _rotors[i].roll_scale + pitch * _rotors[i].pitch_scale) *
-					roll_pitch_scale + thrust + boost) / _rotors[i].yaw_scale;
+				yaw = -((roll * rotors[i].roll_scale + pitch * rotors[i].pitch_scale) *
+					roll_pitch_scale + thrust + boost) / rotors[i].yaw_scale;
 			}
 
 		} else if (out > 1.0f) {
@@ -327,12 +361,12 @@ MultirotorMixer::mix(float *outputs, unsigned space)
 			// keep the maximum requested reduction
 			thrust_reduction = fmaxf(thrust_reduction, prop_reduction);
 
-			if (fabsf(_rotors[i].yaw_scale) <= FLT_EPSILON) {
+			if (fabsf(rotors[i].yaw_scale) <= FLT_EPSILON) {
 				yaw = 0.0f;
 
 			} else {
-				yaw = (1.0f - ((roll * _rotors[i].roll_scale + pitch * _rotors[i].pitch_scale) *
-					       roll_pitch_scale + (thrust - thrust_reduction) + boost)) / _rotors[i].yaw_scale;
+				yaw = (1.0f - ((roll * rotors[i].roll_scale + pitch * rotors[i].pitch_scale) *
+					       roll_pitch_scale + (thrust - thrust_reduction) + boost)) / rotors[i].yaw_scale;
 			}
 		}
 	}
@@ -341,10 +375,10 @@ MultirotorMixer::mix(float *outputs, unsigned space)
 	thrust -= thrust_reduction;
 
 	// add yaw and scale outputs to range idle_speed...1
-	for (unsigned i = 0; i < _rotor_count; i++) {
-		outputs[i] = (roll * _rotors[i].roll_scale +
-			      pitch * _rotors[i].pitch_scale) * roll_pitch_scale +
-			     yaw * _rotors[i].yaw_scale +
+	for (unsigned i = 0; i < rotor_count; i++) {
+		outputs[i] = (roll * rotors[i].roll_scale +
+			      pitch * rotors[i].pitch_scale) * roll_pitch_scale +
+			     yaw * rotors[i].yaw_scale +
 			     thrust + boost;
 
 		/*
@@ -353,18 +387,18 @@ MultirotorMixer::mix(float *outputs, unsigned space)
 			this model assumes normalized input / output in the range [0,1] so this is the right place
 			to do it as at this stage the outputs are in that range.
 		 */
-		if (_thrust_factor > 0.0f) {
-			outputs[i] = -(1.0f - _thrust_factor) / (2.0f * _thrust_factor) + sqrtf((1.0f - _thrust_factor) *
-					(1.0f - _thrust_factor) / (4.0f * _thrust_factor * _thrust_factor) + (outputs[i] < 0.0f ? 0.0f : outputs[i] /
-							_thrust_factor));
+		if (thrust_factor > 0.0f) {
+			outputs[i] = -(1.0f - thrust_factor) / (2.0f * thrust_factor) + sqrtf((1.0f - thrust_factor) *
+					(1.0f - thrust_factor) / (4.0f * thrust_factor * thrust_factor) + (outputs[i] < 0.0f ? 0.0f : outputs[i] /
+							thrust_factor));
 		}
 
-		outputs[i] = math::constrain(_idle_speed + (outputs[i] * (1.0f - _idle_speed)), _idle_speed, 1.0f);
+		outputs[i] = math::constrain(idle_speed + (outputs[i] * (1.0f - idle_speed)), idle_speed, 1.0f);
 
 	}
 
 	/* slew rate limiting and saturation checking */
-	for (unsigned i = 0; i < _rotor_count; i++) {
+	for (unsigned i = 0; i < rotor_count; i++) {
 		bool clipping_high = false;
 		bool clipping_low = false;
 
@@ -372,7 +406,7 @@ MultirotorMixer::mix(float *outputs, unsigned space)
 		if (outputs[i] > 0.99f) {
 			clipping_high = true;
 
-		} else if (outputs[i] < _idle_speed + 0.01f) {
+		} else if (outputs[i] < idle_speed + 0.01f) {
 			clipping_low = true;
 
 		}
@@ -401,7 +435,7 @@ MultirotorMixer::mix(float *outputs, unsigned space)
 	// this will force the caller of the mixer to always supply new slew rate values, otherwise no slew rate limiting will happen
 	_delta_out_max = 0.0f;
 
-	return _rotor_count;
+	return rotor_count;
 }
 
 /*
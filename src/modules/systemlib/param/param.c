@@ -55,6 +55,7 @@
 #include <systemlib/err.h>
 #include <errno.h>
 #include <px4_sem.h>
+#include <px4_tasks.h>
 #include <math.h>
 
 #include <sys/stat.h>
@@ -83,7 +84,6 @@
 #include <crc32.h>
 
 static const char *param_default_file = PX4_ROOTFSDIR"/eeprom/parameters";
-static char *param_user_file = NULL;
 
 #if 0
 # define debug(fmt, args...)		do { warnx(fmt, ##args); } while(0)
@@ -102,9 +102,6 @@ static char *param_user_file = NULL;
 #ifndef PARAM_NO_AUTOSAVE
 #include <px4_workqueue.h>
 /* autosaving variables */
-static hrt_abstime last_autosave_timestamp = 0;
-static struct work_s autosave_work;
-static bool autosave_scheduled = false;
 static bool autosave_disabled = false;
 #endif /* PARAM_NO_AUTOSAVE */
 
@@ -149,16 +146,44 @@ get_param_info_count(void)
 	return param_info_count;
 }
 
-/** flexible array holding modified parameter values */
-FLASH_PARAMS_EXPOSE UT_array        *param_values;
+/**
+ * Parameter state of a namespace (see px4_get_namespace()). Several vehicles in
+ * one process have their own values, parameter file and parameter_update
+ * publication. Metadata and used flags are shared.
+ */
+struct param_namespace_s {
+	UT_array	*values;	/**< flexible array holding modified parameter values */
+	char		*user_file;	/**< parameter file set with param_set_default_file() */
+#if !defined(PARAM_NO_ORB)
+	orb_advert_t	topic;		/**< parameter update topic handle */
+#endif
+#ifndef PARAM_NO_AUTOSAVE
+	hrt_abstime	last_autosave_timestamp;
+	struct work_s	autosave_work;
+	bool		autosave_scheduled;
+#endif
+};
 
-/** array info for the modified parameters array */
-FLASH_PARAMS_EXPOSE const UT_icd    param_icd = {sizeof(struct param_wbuf_s), NULL, NULL, NULL};
+static struct param_namespace_s param_namespaces[PX4_MAX_NAMESPACES];
 
-#if !defined(PARAM_NO_ORB)
-/** parameter update topic handle */
-static orb_advert_t param_topic = NULL;
+/**
+ * Get the parameter state of the calling task's namespace.
+ *
+ * With several namespaces this is a thread-local lookup, so functions call it
+ * once and keep the pointer.
+ */
+static inline struct param_namespace_s *
+param_ns(void)
+{
+#if PX4_MAX_NAMESPACES > 1
+	return &param_namespaces[px4_get_namespace()];
+#else
+	return &param_namespaces[0];
 #endif
+}
+
+/** array info for the modified parameters array */
+FLASH_PARAMS_EXPOSE const UT_icd    param_icd = {sizeof(struct param_wbuf_s), NULL, NULL, NULL};
 
 static void param_set_used_internal(param_t param);
 
@@ -167,7 +192,7 @@ static param_t param_find_internal(const char *name, bool notification);
 // the following implements an RW-lock using 2 semaphores (used as mutexes). It gives
 // priority to readers, meaning a writer could suffer from starvation, but in our use-case
 // we only have short periods of reads and writes are rare.
-static px4_sem_t param_sem; ///< this protects against concurrent access to param_values
+static px4_sem_t param_sem; ///< this protects against concurrent access to the modified values
 static int reader_lock_holders = 0;
 static px4_sem_t reader_lock_holders_lock; ///< this protects against concurrent access to reader_lock_holders
 
@@ -283,13 +308,14 @@ static struct param_wbuf_s *
 param_find_changed(param_t param)
 {
 	struct param_wbuf_s	*s = NULL;
+	struct param_namespace_s *ns = param_ns();
 
 	param_assert_locked();
 
-	if (param_values != NULL) {
+	if (ns->values != NULL) {
 		struct param_wbuf_s key;
 		key.param = param;
-		s = utarray_find(param_values, &key, param_compare_values);
+		s = utarray_find(ns->values, &key, param_compare_values);
 	}
 
 	return s;
@@ -299,6 +325,7 @@ static void
 _param_notify_changes(void)
 {
 #if !defined(PARAM_NO_ORB)
+	struct param_namespace_s *ns = param_ns();
 	struct parameter_update_s pup = {
 		.timestamp = hrt_absolute_time(),
 		.dummy = 0
@@ -308,11 +335,11 @@ _param_notify_changes(void)
 	 * If we don't have a handle to our topic, create one now; otherwise
 	 * just publish.
 	 */
-	if (param_topic == NULL) {
-		param_topic = orb_advertise(ORB_ID(parameter_update), &pup);
+	if (ns->topic == NULL) {
+		ns->topic = orb_advertise(ORB_ID(parameter_update), &pup);
 
 	} else {
-		orb_publish(ORB_ID(parameter_update), param_topic, &pup);
+		orb_publish(ORB_ID(parameter_update), ns->topic, &pup);
 	}
 
 #endif
@@ -602,10 +629,11 @@ static void
 autosave_worker(void *arg)
 {
 	bool disabled = false;
+	struct param_namespace_s *ns = param_ns();
 
 	param_lock_writer();
-	last_autosave_timestamp = hrt_absolute_time();
-	autosave_scheduled = false;
+	ns->last_autosave_timestamp = hrt_absolute_time();
+	ns->autosave_scheduled = false;
 	disabled = autosave_disabled;
 	param_unlock_writer();
 
@@ -632,8 +660,9 @@ static void
 param_autosave(void)
 {
 #ifndef PARAM_NO_AUTOSAVE
+	struct param_namespace_s *ns = param_ns();
 
-	if (autosave_scheduled || autosave_disabled) {
+	if (ns->autosave_scheduled || autosave_disabled) {
 		return;
 	}
 
@@ -644,14 +673,14 @@ param_autosave(void)
 	hrt_abstime delay = 300 * 1000;
 
 	const hrt_abstime rate_limit = 2000 * 1000; // rate-limit saving to 2 seconds
-	hrt_abstime last_save_elapsed = hrt_elapsed_time(&last_autosave_timestamp);
+	hrt_abstime last_save_elapsed = hrt_elapsed_time(&ns->last_autosave_timestamp);
 
 	if (last_save_elapsed < rate_limit && rate_limit > last_save_elapsed + delay) {
 		delay = rate_limit - last_save_elapsed;
 	}
 
-	autosave_scheduled = true;
-	work_queue(LPWORK, &autosave_work, (worker_t)&autosave_worker, NULL, USEC2TICK(delay));
+	ns->autosave_scheduled = true;
+	work_queue(LPWORK, &ns->autosave_work, (worker_t)&autosave_worker, NULL, USEC2TICK(delay));
 #endif /* PARAM_NO_AUTOSAVE */
 }
 
@@ -659,11 +688,13 @@ void
 param_control_autosave(bool enable)
 {
 #ifndef PARAM_NO_AUTOSAVE
+	struct param_namespace_s *ns = param_ns();
+
 	param_lock_writer();
 
-	if (!enable && autosave_scheduled) {
-		work_cancel(LPWORK, &autosave_work);
-		autosave_scheduled = false;
+	if (!enable && ns->autosave_scheduled) {
+		work_cancel(LPWORK, &ns->autosave_work);
+		ns->autosave_scheduled = false;
 	}
 
 	autosave_disabled = !enable;
@@ -677,14 +708,15 @@ param_set_internal(param_t param, const void *val, bool mark_saved, bool notify_
 {
 	int result = -1;
 	bool params_changed = false;
+	struct param_namespace_s *ns = param_ns();
 
 	param_lock_writer();
 
-	if (param_values == NULL) {
-		utarray_new(param_values, &param_icd);
+	if (ns->values == NULL) {
+		utarray_new(ns->values, &param_icd);
 	}
 
-	if (param_values == NULL) {
+	if (ns->values == NULL) {
 		debug("failed to allocate modified values array");
 		goto out;
 	}
@@ -704,8 +736,8 @@ param_set_internal(param_t param, const void *val, bool mark_saved, bool notify_
 			params_changed = true;
 
 			/* add it to the array and sort */
-			utarray_push_back(param_values, &buf);
-			utarray_sort(param_values, param_compare_values);
+			utarray_push_back(ns->values, &buf);
+			utarray_sort(ns->values, param_compare_values);
 
 			/* find it after sorting */
 			s = param_find_changed(param);
@@ -836,8 +868,9 @@ param_reset(param_t param)
 
 		/* if we found one, erase it */
 		if (s != NULL) {
-			int pos = utarray_eltidx(param_values, s);
-			utarray_erase(param_values, pos, 1);
+			struct param_namespace_s *ns = param_ns();
+			int pos = utarray_eltidx(ns->values, s);
+			utarray_erase(ns->values, pos, 1);
 		}
 
 		param_found = true;
@@ -856,14 +889,16 @@ param_reset(param_t param)
 static void
 param_reset_all_internal(bool auto_save)
 {
+	struct param_namespace_s *ns = param_ns();
+
 	param_lock_writer();
 
-	if (param_values != NULL) {
-		utarray_free(param_values);
+	if (ns->values != NULL) {
+		utarray_free(ns->values);
 	}
 
 	/* mark as reset / deleted */
-	param_values = NULL;
+	ns->values = NULL;
 
 	if (auto_save) {
 		param_autosave();
@@ -911,14 +946,16 @@ param_reset_excludes(const char *excludes[], int num_excludes)
 int
 param_set_default_file(const char *filename)
 {
-	if (param_user_file != NULL) {
+	struct param_namespace_s *ns = param_ns();
+
+	if (ns->user_file != NULL) {
 		// we assume this is not in use by some other thread
-		free(param_user_file);
-		param_user_file = NULL;
+		free(ns->user_file);
+		ns->user_file = NULL;
 	}
 
 	if (filename) {
-		param_user_file = strdup(filename);
+		ns->user_file = strdup(filename);
 	}
 
 	return 0;
@@ -927,7 +964,20 @@ param_set_default_file(const char *filename)
 const char *
 param_get_default_file(void)
 {
-	return (param_user_file != NULL) ? param_user_file : param_default_file;
+	struct param_namespace_s *ns = param_ns();
+
+#if PX4_MAX_NAMESPACES > 1
+
+	/* without a file of their own, other namespaces must not use the file of namespace 0 */
+	if (ns->user_file == NULL && px4_get_namespace() != 0) {
+		char filename[64];
+		snprintf(filename, sizeof(filename), "%s_%i", param_default_file, px4_get_namespace());
+		ns->user_file = strdup(filename);
+	}
+
+#endif
+
+	return (ns->user_file != NULL) ? ns->user_file : param_default_file;
 }
 
 int
@@ -966,7 +1016,7 @@ param_save_default(void)
 	PARAM_CLOSE(fd);
 #else
 	param_lock_writer();
-	res = flash_param_save();
+	res = flash_param_save(param_ns()->values);
 	param_unlock_writer();
 #endif
 	return res;
@@ -1011,8 +1061,10 @@ int
 param_export(int fd, bool only_unsaved)
 {
 	struct param_wbuf_s *s = NULL;
+	struct param_namespace_s *ns = param_ns();
 	struct bson_encoder_s encoder;
 	int	result = -1;
+	uint8_t *iobuf;
 
 	int shutdown_lock_ret = px4_shutdown_lock();
 
@@ -1025,15 +1077,17 @@ param_export(int fd, bool only_unsaved)
 
 	param_lock_reader();
 
-	bson_encoder_init_file(&encoder, fd);
+	/* write in blocks, or an element at a time if there is no memory for the buffer */
+	iobuf = malloc(BSON_FILE_BUFSIZE);
+	bson_encoder_init_file_buffered(&encoder, fd, iobuf, (iobuf != NULL) ? BSON_FILE_BUFSIZE : 0);
 
 	/* no modified parameters -> we are done */
-	if (param_values == NULL) {
+	if (ns->values == NULL) {
 		result = 0;
 		goto out;
 	}
 
-	while ((s = (struct param_wbuf_s *)utarray_next(param_values, s)) != NULL) {
+	while ((s = (struct param_wbuf_s *)utarray_next(ns->values, s)) != NULL) {
 
 		int32_t	i;
 		float	f;
@@ -1121,6 +1175,8 @@ out:
 		px4_shutdown_unlock();
 	}
 
+	free(iobuf);
+
 	return result;
 }
 
@@ -1253,9 +1309,21 @@ param_import_internal(int fd, bool mark_saved)
 	struct bson_decoder_s decoder;
 	int result = -1;
 	struct param_import_state state;
+	uint8_t *iobuf = NULL;
+	int ret = -1;
+
+#if defined(__PX4_POSIX) && !defined(__PX4_QURT)
+	/* decode straight from the page cache if the file can be mapped */
+	ret = bson_decoder_init_file_mapped(&decoder, fd, param_import_callback, &state);
+#endif
 
+	if (ret != 0) {
+		iobuf = malloc(BSON_FILE_BUFSIZE);
+		ret = bson_decoder_init_file_buffered(&decoder, fd, iobuf, (iobuf != NULL) ? BSON_FILE_BUFSIZE : 0,
+						      param_import_callback, &state);
+	}
 
-	if (bson_decoder_init_file(&decoder, fd, param_import_callback, &state)) {
+	if (ret != 0) {
 		debug("decoder init failed");
 		goto out;
 	}
@@ -1270,6 +1338,8 @@ param_import_internal(int fd, bool mark_saved)
 	} while (result > 0);
 
 out:
+	bson_decoder_fini(&decoder);
+	free(iobuf);
 
 	if (result < 0) {
 		debug("BSON error decoding parameters");
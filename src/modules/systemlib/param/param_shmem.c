@@ -1036,6 +1036,7 @@ param_export(int fd, bool only_unsaved)
 	struct param_wbuf_s *s = NULL;
 	struct bson_encoder_s encoder;
 	int	result = -1;
+	uint8_t *iobuf;
 
 	int shutdown_lock_ret = px4_shutdown_lock();
 
@@ -1045,7 +1046,9 @@ param_export(int fd, bool only_unsaved)
 
 	param_lock();
 
-	bson_encoder_init_file(&encoder, fd);
+	/* write in blocks, or an element at a time if there is no memory for the buffer */
+	iobuf = malloc(BSON_FILE_BUFSIZE);
+	bson_encoder_init_file_buffered(&encoder, fd, iobuf, (iobuf != NULL) ? BSON_FILE_BUFSIZE : 0);
 
 	/* no modified parameters -> we are done */
 	if (param_values == NULL) {
@@ -1120,6 +1123,11 @@ param_export(int fd, bool only_unsaved)
 	result = 0;
 
 out:
+
+	if (result == 0) {
+		result = bson_encoder_fini(&encoder);
+	}
+
 	param_unlock();
 
 	fsync(fd); // make sure the data is flushed before releasing the shutdown lock
@@ -1128,9 +1136,7 @@ out:
 		px4_shutdown_unlock();
 	}
 
-	if (result == 0) {
-		result = bson_encoder_fini(&encoder);
-	}
+	free(iobuf);
 
 	return result;
 }
@@ -1259,8 +1265,21 @@ param_import_internal(int fd, bool mark_saved)
 	struct bson_decoder_s decoder;
 	int result = -1;
 	struct param_import_state state;
+	uint8_t *iobuf = NULL;
+	int ret = -1;
+
+#if defined(__PX4_POSIX) && !defined(__PX4_QURT)
+	/* decode straight from the page cache if the file can be mapped */
+	ret = bson_decoder_init_file_mapped(&decoder, fd, param_import_callback, &state);
+#endif
 
-	if (bson_decoder_init_file(&decoder, fd, param_import_callback, &state)) {
+	if (ret != 0) {
+		iobuf = malloc(BSON_FILE_BUFSIZE);
+		ret = bson_decoder_init_file_buffered(&decoder, fd, iobuf, (iobuf != NULL) ? BSON_FILE_BUFSIZE : 0,
+						      param_import_callback, &state);
+	}
+
+	if (ret != 0) {
 		PX4_DEBUG("decoder init failed");
 		goto out;
 	}
@@ -1273,6 +1292,8 @@ param_import_internal(int fd, bool mark_saved)
 	} while (result > 0);
 
 out:
+	bson_decoder_fini(&decoder);
+	free(iobuf);
 
 	if (result < 0) {
 		PX4_DEBUG("BSON error decoding parameters");
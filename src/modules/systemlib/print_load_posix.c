@@ -39,6 +39,10 @@
  * @author Lorenz Meier <lorenz@px4.io>
  */
 
+#if defined(__PX4_LINUX) && !defined(_GNU_SOURCE)
+#define _GNU_SOURCE /* sched_getaffinity() */
+#endif
+
 #include <px4_posix.h>
 
 #include <unistd.h>
@@ -54,6 +58,13 @@
 #include <mach/mach.h>
 #endif
 
+#ifdef __PX4_LINUX
+#include <dirent.h>
+#include <fcntl.h>
+#include <sched.h>
+#include <stdlib.h>
+#endif
+
 #ifdef __PX4_QURT
 // dprintf is not available on QURT. Use the usual output to mini-dm.
 #define dprintf(_fd, _text, ...) ((_fd) == 1 ? PX4_INFO((_text), ##__VA_ARGS__) : (void)(_fd))
@@ -76,6 +87,9 @@ void init_print_load_s(uint64_t t, struct print_load_s *s)
 
 	for (int i = 0; i < CONFIG_MAX_TASKS; i++) {
 		s->last_times[i] = 0;
+#ifdef __PX4_LINUX
+		s->last_tids[i] = 0;
+#endif
 	}
 
 	s->interval_time_ms_inv = 0.f;
@@ -92,8 +106,169 @@ void print_load(uint64_t t, int fd, struct print_load_s *print_state)
 	}
 
 #if defined (__PX4_LINUX)
-	dprintf(fd, "%sTOP NOT IMPLEMENTED ON LINUX\n",
-		clear_line);
+	/* every px4 task is a thread of this process: walk /proc/self/task */
+	DIR *dir = opendir("/proc/self/task");
+
+	if (dir == NULL) {
+		dprintf(fd, "%scannot open /proc/self/task\n", clear_line);
+		return;
+	}
+
+	const long ticks_per_sec = sysconf(_SC_CLK_TCK);
+	const float interval_s = (t - print_state->new_time) / 1e6f;
+	const int ncpus = sysconf(_SC_NPROCESSORS_ONLN);
+
+	dprintf(fd, "%sThreads on %d CPUs, %.1f s interval\n%s\n",
+		clear_line, ncpus, (double)interval_s, clear_line);
+	dprintf(fd, "%s %6s %-16s %8s %6s %4s %6s %3s %8s %7s %6s\n",
+		clear_line, "TID", "COMMAND", "CPU(ms)", "CPU(%)", "PRIO", "POLICY", "CPU", "AFFINITY", "MINFLT", "MAJFLT");
+
+	int last_tids[CONFIG_MAX_TASKS];
+	uint32_t last_times[CONFIG_MAX_TASKS];
+	memcpy(last_tids, print_state->last_tids, sizeof(last_tids));
+	memcpy(last_times, print_state->last_times, sizeof(last_times));
+	int idx = 0;
+
+	struct dirent *entry;
+
+	while ((entry = readdir(dir)) != NULL) {
+		if (entry->d_name[0] == '.') {
+			continue;
+		}
+
+		char path[sizeof(entry->d_name) + 24];
+		char buf[512];
+		snprintf(path, sizeof(path), "/proc/self/task/%s/stat", entry->d_name);
+
+		int stat_fd = open(path, O_RDONLY);
+
+		if (stat_fd < 0) {
+			continue;
+		}
+
+		ssize_t len = read(stat_fd, buf, sizeof(buf) - 1);
+		close(stat_fd);
+
+		if (len <= 0) {
+			continue;
+		}
+
+		buf[len] = '\0';
+
+		/* the thread name may contain spaces and parentheses: it ends at the last ')' */
+		char *name_start = strchr(buf, '(');
+		char *name_end = strrchr(buf, ')');
+
+		if (name_start == NULL || name_end == NULL) {
+			continue;
+		}
+
+		*name_end = '\0';
+
+		unsigned long minflt = 0, majflt = 0;
+		unsigned long utime = 0, stime = 0;
+		long priority = 0;
+		int processor = -1;
+		unsigned policy = 0;
+
+		/* fields after the name start at 3 (state): minflt=10, majflt=12, utime=14, stime=15, priority=18,
+		 * processor=39, policy=41 */
+		char *field = name_end + 2;
+
+		for (int n = 3; n <= 41 && field != NULL; n++) {
+			switch (n) {
+			case 10:
+				minflt = strtoul(field, NULL, 10);
+				break;
+
+			case 12:
+				majflt = strtoul(field, NULL, 10);
+				break;
+
+			case 14:
+				utime = strtoul(field, NULL, 10);
+				break;
+
+			case 15:
+				stime = strtoul(field, NULL, 10);
+				break;
+
+			case 18:
+				priority = strtol(field, NULL, 10);
+				break;
+
+			case 39:
+				processor = atoi(field);
+				break;
+
+			case 41:
+				policy = strtoul(field, NULL, 10);
+				break;
+			}
+
+			field = strchr(field, ' ');
+
+			if (field != NULL) {
+				field++;
+			}
+		}
+
+		const int tid = atoi(entry->d_name);
+		const uint32_t total_ms = (uint32_t)((utime + stime) * 1000 / ticks_per_sec);
+
+		/* CPU share since the last call, matched by thread id */
+		float load = 0.f;
+
+		for (int i = 0; i < CONFIG_MAX_TASKS; i++) {
+			if (last_tids[i] == tid && interval_s > 0.f) {
+				load = (total_ms - last_times[i]) / (interval_s * 10.f);
+				break;
+			}
+		}
+
+		if (idx < CONFIG_MAX_TASKS) {
+			print_state->last_tids[idx] = tid;
+			print_state->last_times[idx] = total_ms;
+			idx++;
+		}
+
+		/* realtime tasks report priority as -1 - rt_priority */
+		const char *policy_str = policy == SCHED_FIFO ? "FIFO" : (policy == SCHED_RR ? "RR" : "OTHER");
+
+		unsigned long long affinity = 0;
+		cpu_set_t cpuset;
+
+		if (sched_getaffinity(tid, sizeof(cpuset), &cpuset) == 0) {
+			for (int cpu = 0; cpu < 64 && cpu < CPU_SETSIZE; cpu++) {
+				if (CPU_ISSET(cpu, &cpuset)) {
+					affinity |= 1ULL << cpu;
+				}
+			}
+		}
+
+		dprintf(fd, "%s %6d %-16s %8u %6.1f %4ld %6s %3d %8llx %7lu %6lu\n",
+			clear_line,
+			tid,
+			name_start + 1,
+			total_ms,
+			(double)load,
+			policy == SCHED_OTHER ? priority : -priority - 1,
+			policy_str,
+			processor,
+			affinity,
+			minflt,
+			majflt);
+	}
+
+	closedir(dir);
+
+	for (int i = idx; i < CONFIG_MAX_TASKS; i++) {
+		print_state->last_tids[i] = 0;
+	}
+
+	print_state->new_time = t;
+
+	dprintf(fd, "%s\n", clear_line);
 
 #elif defined (__PX4_QURT)
 	dprintf(fd, "%sTOP NOT IMPLEMENTED ON QURT\n",
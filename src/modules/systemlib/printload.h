@@ -58,6 +58,9 @@ struct print_load_s {
 	uint64_t new_time;
 	uint64_t interval_start_time;
 	uint32_t last_times[CONFIG_MAX_TASKS]; // in [ms]. This wraps if a process needs more than 49 days of CPU
+#ifdef __PX4_LINUX
+	int last_tids[CONFIG_MAX_TASKS]; // kernel thread id belonging to last_times
+#endif
 	float interval_time_ms_inv;
 };
 
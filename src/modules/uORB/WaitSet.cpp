@@ -0,0 +1,129 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2017 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/**
+ * @file WaitSet.cpp
+ *
+ */
+
+#include "WaitSet.hpp"
+#include "uORB.h"
+#include <px4_defines.h>
+#include <string.h>
+
+namespace uORB
+{
+
+WaitSet::WaitSet() :
+	_count(0),
+	_updated(0)
+{
+	memset(_fds, 0, sizeof(_fds));
+}
+
+int WaitSet::add(int handle)
+{
+	if (handle < 0 || _count >= MAX_HANDLES) {
+		return -1;
+	}
+
+	_fds[_count].fd = handle;
+	_fds[_count].events = POLLIN;
+	return _count++;
+}
+
+void WaitSet::set(unsigned index, int handle)
+{
+	if (index < _count) {
+		_fds[index].fd = handle;
+		_updated &= ~(1u << index);
+	}
+}
+
+int WaitSet::wait(int timeout_ms)
+{
+	_updated = 0;
+
+	if (_count == 0) {
+		return 0;
+	}
+
+#ifndef __PX4_NUTTX
+
+	// On POSIX, poll() registers and unregisters a poll waiter on every device, which costs about twice as much
+	// as checking each handle with orb_check(). Only use it when the caller actually wants to block.
+	if (timeout_ms == 0) {
+		int ret = 0;
+
+		for (unsigned i = 0; i < _count; i++) {
+			bool is_updated = false;
+
+			if (orb_check(_fds[i].fd, &is_updated) == PX4_OK && is_updated) {
+				_updated |= (1u << i);
+				ret++;
+			}
+		}
+
+		return ret;
+	}
+
+#endif /* __PX4_NUTTX */
+
+	int ret = px4_poll(_fds, _count, timeout_ms);
+
+	if (ret > 0) {
+		for (unsigned i = 0; i < _count; i++) {
+			if (_fds[i].revents & POLLIN) {
+				_updated |= (1u << i);
+			}
+		}
+	}
+
+	return ret;
+}
+
+bool WaitSet::updated(int handle)
+{
+	for (unsigned i = 0; i < _count; i++) {
+		if (_fds[i].fd == handle) {
+			const uint32_t bit = 1u << i;
+			const bool is_updated = (_updated & bit) != 0;
+			_updated &= ~bit;
+			return is_updated;
+		}
+	}
+
+	return false;
+}
+
+} // namespace uORB
@@ -0,0 +1,120 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2017 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/**
+ * @file WaitSet.hpp
+ *
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <px4_posix.h>
+
+namespace uORB
+{
+
+/**
+ * A group of subscriptions (handles from orb_subscribe()) that are checked
+ * for updates together.
+ *
+ * Checking N subscriptions with orb_check() costs N ioctl() calls through
+ * the device layer, even if most of them did not change. wait() checks the
+ * whole group with a single poll() and returns which handles have new data,
+ * optionally blocking until any of them is updated. On POSIX, where poll()
+ * is more expensive than the ioctl() calls, a non-blocking wait() falls
+ * back to orb_check() per handle and is no faster than calling orb_check()
+ * directly, so it only pays off in loops that run on NuttX or block.
+ *
+ * The caller still owns the handles and copies the data with orb_copy().
+ */
+class __EXPORT WaitSet
+{
+public:
+	static constexpr unsigned MAX_HANDLES = 32;
+
+	WaitSet();
+	~WaitSet() = default;
+
+	// no copy, assignment, move, move assignment
+	WaitSet(const WaitSet &) = delete;
+	WaitSet &operator=(const WaitSet &) = delete;
+	WaitSet(WaitSet &&) = delete;
+	WaitSet &operator=(WaitSet &&) = delete;
+
+	/**
+	 * Add a subscription handle to the set.
+	 *
+	 * @param handle	A handle returned from orb_subscribe().
+	 * @return		The bit index of the handle in the mask returned by
+	 *			updated_mask(), or -1 if the set is full or handle is invalid.
+	 */
+	int add(int handle);
+
+	/**
+	 * Replace the handle at a given index, e.g. when switching between
+	 * instances of a multi-instance topic.
+	 */
+	void set(unsigned index, int handle);
+
+	/**
+	 * Check all handles for updates.
+	 *
+	 * @param timeout_ms	0 to return immediately, > 0 to wait up to that
+	 *			long for any handle to be updated, < 0 to wait forever.
+	 * @return		The number of updated handles, 0 on timeout, or
+	 *			negative on error (as px4_poll()).
+	 */
+	int wait(int timeout_ms = 0);
+
+	/**
+	 * Bitmask of the handles found updated by the last wait(), indexed as
+	 * returned by add().
+	 */
+	uint32_t updated_mask() const { return _updated; }
+
+	/**
+	 * Whether handle was found updated by the last wait(). This clears the
+	 * flag, so a second call before the next wait() returns false.
+	 */
+	bool updated(int handle);
+
+	unsigned size() const { return _count; }
+
+private:
+	px4_pollfd_struct_t _fds[MAX_HANDLES];
+	unsigned _count;
+	uint32_t _updated;
+};
+
+} // namespace uORB
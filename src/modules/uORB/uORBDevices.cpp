@@ -64,6 +64,7 @@
 #include "uORBUtils.hpp"
 #include "uORBManager.hpp"
 #include "uORBCommunicator.hpp"
+#include <px4_rt_memory.h>
 #include <px4_sem.hpp>
 #include <stdlib.h>
 
@@ -99,7 +100,7 @@ uORB::DeviceNode::DeviceNode(const struct orb_metadata *meta, const char *name,
 uORB::DeviceNode::~DeviceNode()
 {
 	if (_data != nullptr) {
-		delete[] _data;
+		px4_rt_memory_free(_data);
 	}
 
 }
@@ -275,7 +276,7 @@ uORB::DeviceNode::write(device::file_t *filp, const char *buffer, size_t buflen)
 
 			/* re-check size */
 			if (nullptr == _data) {
-				_data = new uint8_t[_meta->o_size * _queue_size];
+				_data = (uint8_t *)px4_rt_memory_alloc(_meta->o_size * _queue_size);
 			}
 
 			unlock();
@@ -286,7 +287,7 @@ uORB::DeviceNode::write(device::file_t *filp, const char *buffer, size_t buflen)
 
 		/* re-check size */
 		if (nullptr == _data) {
-			_data = new uint8_t[_meta->o_size * _queue_size];
+			_data = (uint8_t *)px4_rt_memory_alloc(_meta->o_size * _queue_size);
 		}
 
 		unlock();
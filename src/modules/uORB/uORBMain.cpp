@@ -38,10 +38,11 @@
 #include "uORBCommon.hpp"
 #include <px4_log.h>
 #include <px4_module.h>
+#include <px4_tasks.h>
 
 extern "C" { __EXPORT int uorb_main(int argc, char *argv[]); }
 
-static uORB::DeviceMaster *g_dev = nullptr;
+static uORB::DeviceMaster *g_dev[PX4_MAX_NAMESPACES] = {};
 static void usage()
 {
 	PRINT_MODULE_DESCRIPTION(
@@ -91,9 +92,11 @@ uorb_main(int argc, char *argv[])
 	/*
 	 * Start/load the driver.
 	 */
+	uORB::DeviceMaster *&dev = g_dev[px4_get_namespace()];
+
 	if (!strcmp(argv[1], "start")) {
 
-		if (g_dev != nullptr) {
+		if (dev != nullptr) {
 			PX4_WARN("already loaded");
 			/* user wanted to start uorb, its already running, no error */
 			return 0;
@@ -104,13 +107,18 @@ uorb_main(int argc, char *argv[])
 			return -ENOMEM;
 		}
 
-		/* create the driver */
-		g_dev = uORB::Manager::get_instance()->get_device_master(uORB::PUBSUB);
+		/* create the driver (in the current namespace) */
+		dev = uORB::Manager::get_instance()->get_device_master(uORB::PUBSUB);
 
-		if (g_dev == nullptr) {
+		if (dev == nullptr) {
 			return -errno;
 		}
 
+		if (px4_get_namespace() != 0) {
+			/* the log message publication only exists once per process */
+			return OK;
+		}
+
 #if !defined(__PX4_QURT) && !defined(__PX4_POSIX_EAGLE) && !defined(__PX4_POSIX_EXCELSIOR)
 		/* FIXME: this fails on Snapdragon (see https://github.com/PX4/Firmware/issues/5406),
 		 * so we disable logging messages to the ulog for now. This needs further investigations.
@@ -125,8 +133,8 @@ uorb_main(int argc, char *argv[])
 	 * Print driver information.
 	 */
 	if (!strcmp(argv[1], "status")) {
-		if (g_dev != nullptr) {
-			g_dev->printStatistics(true);
+		if (dev != nullptr) {
+			dev->printStatistics(true);
 
 		} else {
 			PX4_INFO("uorb is not running");
@@ -136,8 +144,8 @@ uorb_main(int argc, char *argv[])
 	}
 
 	if (!strcmp(argv[1], "top")) {
-		if (g_dev != nullptr) {
-			g_dev->showTop(argv + 2, argc - 2);
+		if (dev != nullptr) {
+			dev->showTop(argv + 2, argc - 2);
 
 		} else {
 			PX4_INFO("uorb is not running");
@@ -64,8 +64,10 @@ bool uORB::Manager::initialize()
 uORB::Manager::Manager()
 	: _comm_channel(nullptr)
 {
-	for (int i = 0; i < Flavor_count; ++i) {
-		_device_masters[i] = nullptr;
+	for (int ns = 0; ns < PX4_MAX_NAMESPACES; ++ns) {
+		for (int i = 0; i < Flavor_count; ++i) {
+			_device_masters[ns][i] = nullptr;
+		}
 	}
 
 #ifdef ORB_USE_PUBLISHER_RULES
@@ -86,26 +88,31 @@ uORB::Manager::Manager()
 
 uORB::Manager::~Manager()
 {
-	for (int i = 0; i < Flavor_count; ++i) {
-		if (_device_masters[i]) {
-			delete _device_masters[i];
+	for (int ns = 0; ns < PX4_MAX_NAMESPACES; ++ns) {
+		for (int i = 0; i < Flavor_count; ++i) {
+			if (_device_masters[ns][i]) {
+				delete _device_masters[ns][i];
+			}
 		}
 	}
 }
 
 uORB::DeviceMaster *uORB::Manager::get_device_master(Flavor flavor)
 {
-	if (!_device_masters[flavor]) {
-		_device_masters[flavor] = new DeviceMaster(flavor);
+	// the master device registers in the namespace of the calling thread
+	DeviceMaster *&device_master = _device_masters[px4_get_namespace()][flavor];
+
+	if (!device_master) {
+		device_master = new DeviceMaster(flavor);
 
-		if (_device_masters[flavor]) {
-			int ret = _device_masters[flavor]->init();
+		if (device_master) {
+			int ret = device_master->init();
 
 			if (ret != PX4_OK) {
 				PX4_ERR("Initialization of DeviceMaster failed (%i)", ret);
 				errno = -ret;
-				delete _device_masters[flavor];
-				_device_masters[flavor] = nullptr;
+				delete device_master;
+				device_master = nullptr;
 			}
 
 		} else {
@@ -114,7 +121,7 @@ uORB::DeviceMaster *uORB::Manager::get_device_master(Flavor flavor)
 		}
 	}
 
-	return _device_masters[flavor];
+	return device_master;
 }
 
 int uORB::Manager::orb_exists(const struct orb_metadata *meta, int instance)
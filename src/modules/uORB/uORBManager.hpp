@@ -36,6 +36,7 @@
 
 #include "uORBCommon.hpp"
 #include "uORBDevices.hpp"
+#include <px4_tasks.h>
 #include <stdint.h>
 #ifdef __PX4_NUTTX
 #include "ORBSet.hpp"
@@ -79,8 +80,8 @@ public:
 	}
 
 	/**
-	 * Get the DeviceMaster for a given Flavor. If it does not exist,
-	 * it will be created and initialized.
+	 * Get the DeviceMaster for a given Flavor in the namespace of the calling
+	 * thread. If it does not exist, it will be created and initialized.
 	 * Note: the first call to this is not thread-safe.
 	 * @return nullptr if initialization failed (and errno will be set)
 	 */
@@ -412,7 +413,7 @@ private: // data members
 	ORBSet _remote_subscriber_topics;
 	ORBSet _remote_topics;
 
-	DeviceMaster *_device_masters[Flavor_count]; ///< Allow at most one DeviceMaster per Flavor
+	DeviceMaster *_device_masters[PX4_MAX_NAMESPACES][Flavor_count]; ///< Allow at most one DeviceMaster per Flavor and namespace
 
 private: //class methods
 	Manager();
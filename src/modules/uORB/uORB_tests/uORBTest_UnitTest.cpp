@@ -33,6 +33,7 @@
 
 #include "uORBTest_UnitTest.hpp"
 #include "../uORBCommon.hpp"
+#include "../WaitSet.hpp"
 #include <px4_config.h>
 #include <px4_time.h>
 #include <stdio.h>
@@ -195,7 +196,13 @@ int uORBTest::UnitTest::test()
 		return ret;
 	}
 
-	return test_queue_poll_notify();
+	ret = test_queue_poll_notify();
+
+	if (ret != OK) {
+		return ret;
+	}
+
+	return test_wait_set();
 }
 
 int uORBTest::UnitTest::test_unadvertise()
@@ -815,6 +822,67 @@ int uORBTest::UnitTest::test_queue_poll_notify()
 }
 
 
+int uORBTest::UnitTest::test_wait_set()
+{
+	test_note("Testing wait set");
+
+	struct orb_test t = {};
+	struct orb_test_medium m = {};
+
+	orb_advert_t ptopic = orb_advertise(ORB_ID(orb_test), &t);
+	orb_advert_t ptopic_medium = orb_advertise(ORB_ID(orb_test_medium), &m);
+
+	if (ptopic == nullptr || ptopic_medium == nullptr) {
+		return test_fail("advertise failed: %d", errno);
+	}
+
+	int sfd = orb_subscribe(ORB_ID(orb_test));
+	int sfd_medium = orb_subscribe(ORB_ID(orb_test_medium));
+
+	uORB::WaitSet wait_set;
+
+	if (wait_set.add(sfd) != 0 || wait_set.add(sfd_medium) != 1) {
+		return test_fail("wait set add failed");
+	}
+
+	/* consume the initial advertisement */
+	orb_copy(ORB_ID(orb_test), sfd, &t);
+	orb_copy(ORB_ID(orb_test_medium), sfd_medium, &m);
+
+	if (wait_set.wait(0) != 0 || wait_set.updated_mask() != 0) {
+		return test_fail("spurious update (mask 0x%x)", wait_set.updated_mask());
+	}
+
+	m.val = 42;
+	orb_publish(ORB_ID(orb_test_medium), ptopic_medium, &m);
+
+	if (wait_set.wait(0) != 1 || wait_set.updated_mask() != (1u << 1)) {
+		return test_fail("wrong update mask 0x%x", wait_set.updated_mask());
+	}
+
+	if (wait_set.updated(sfd) || !wait_set.updated(sfd_medium) || wait_set.updated(sfd_medium)) {
+		return test_fail("updated(handle) mismatch");
+	}
+
+	orb_copy(ORB_ID(orb_test_medium), sfd_medium, &m);
+
+	if (m.val != 42) {
+		return test_fail("copy mismatch: %d expected 42", m.val);
+	}
+
+	/* blocking wait times out if nothing is published */
+	if (wait_set.wait(10) != 0) {
+		return test_fail("blocking wait did not time out");
+	}
+
+	orb_unsubscribe(sfd);
+	orb_unsubscribe(sfd_medium);
+	orb_unadvertise(ptopic);
+	orb_unadvertise(ptopic_medium);
+
+	return test_note("PASS wait set");
+}
+
 int uORBTest::UnitTest::test_fail(const char *fmt, ...)
 {
 	va_list ap;
@@ -47,6 +47,7 @@
  *
  */
 #include "vtol_att_control_main.h"
+#include <px4_module.h>
 #include <systemlib/mavlink_log.h>
 
 namespace VTOL_att_control
@@ -896,6 +897,8 @@ VtolAttitudeControl::start()
 }
 
 
+PX4_MODULE_DEPENDENCIES(vtol_att_control, "");
+
 int vtol_att_control_main(int argc, char *argv[])
 {
 	if (argc < 2) {
@@ -40,6 +40,30 @@
 
 pthread_mutex_t px4_modules_mutex = PTHREAD_MUTEX_INITIALIZER;
 
+#ifdef __PX4_POSIX
+
+// only written during static initialization, before any task is started
+const ModuleDependencies *ModuleDependencies::_first = nullptr;
+
+ModuleDependencies::ModuleDependencies(const char *module, const char *depends_on)
+	: _module(module), _depends_on(depends_on), _next(_first)
+{
+	_first = this;
+}
+
+const ModuleDependencies *ModuleDependencies::find(const char *module)
+{
+	for (const ModuleDependencies *dependencies = _first; dependencies; dependencies = dependencies->_next) {
+		if (strcmp(dependencies->_module, module) == 0) {
+			return dependencies;
+		}
+	}
+
+	return nullptr;
+}
+
+#endif /* __PX4_POSIX */
+
 #ifndef __PX4_NUTTX
 
 void PRINT_MODULE_DESCRIPTION(const char *description)
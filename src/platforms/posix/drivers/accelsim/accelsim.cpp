@@ -47,6 +47,7 @@
 #include <math.h>
 #include <unistd.h>
 #include <px4_getopt.h>
+#include <px4_module.h>
 #include <errno.h>
 
 #include <simulator/simulator.h>
@@ -1146,6 +1147,8 @@ usage()
 
 } // namespace
 
+PX4_MODULE_DEPENDENCIES(accelsim, "simulator");
+
 int
 accelsim_main(int argc, char *argv[])
 {
@@ -42,6 +42,7 @@
 
 #include <px4_config.h>
 #include <px4_time.h>
+#include <px4_module.h>
 #include <board_config.h>
 #include <drivers/device/device.h>
 
@@ -223,6 +224,8 @@ test()
 }
 }
 
+PX4_MODULE_DEPENDENCIES(adcsim, "simulator");
+
 int
 adcsim_main(int argc, char *argv[])
 {
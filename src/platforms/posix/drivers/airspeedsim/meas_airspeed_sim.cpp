@@ -45,6 +45,7 @@
 
 
 #include <px4_config.h>
+#include <px4_module.h>
 
 #include <sys/types.h>
 #include <stdint.h>
@@ -499,6 +500,8 @@ meas_airspeed_usage()
 	PX4_WARN("\tstart|stop|reset|test|info");
 }
 
+PX4_MODULE_DEPENDENCIES(measairspeedsim, "simulator");
+
 int
 measairspeedsim_main(int argc, char *argv[])
 {
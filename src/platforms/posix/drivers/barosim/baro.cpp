@@ -41,6 +41,7 @@
 #include <px4_defines.h>
 #include <px4_time.h>
 #include <px4_getopt.h>
+#include <px4_module.h>
 
 #include <sys/types.h>
 #include <stdint.h>
@@ -345,6 +346,8 @@ usage()
 
 }; // namespace barosim
 
+PX4_MODULE_DEPENDENCIES(barosim, "simulator");
+
 int
 barosim_main(int argc, char *argv[])
 {
@@ -55,6 +55,7 @@
 #include <fcntl.h>
 #include <px4_config.h>
 #include <px4_tasks.h>
+#include <px4_module.h>
 #include <drivers/drv_hrt.h>
 #include <drivers/device/device.h>
 #include <drivers/drv_gps.h>
@@ -587,6 +588,8 @@ usage(const char *reason)
 
 
 
+PX4_MODULE_DEPENDENCIES(gpssim, "simulator");
+
 int
 gpssim_main(int argc, char *argv[])
 {
@@ -45,6 +45,7 @@
 
 #include <px4_config.h>
 #include <px4_getopt.h>
+#include <px4_module.h>
 
 #include <sys/types.h>
 #include <stdint.h>
@@ -1459,6 +1460,8 @@ usage()
 
 } // namespace
 
+PX4_MODULE_DEPENDENCIES(gyrosim, "simulator");
+
 int
 gyrosim_main(int argc, char *argv[])
 {
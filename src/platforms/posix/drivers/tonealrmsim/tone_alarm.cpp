@@ -88,6 +88,7 @@
 
 #include <px4_config.h>
 #include <px4_posix.h>
+#include <px4_module.h>
 
 #include <drivers/device/device.h>
 #include <drivers/drv_tone_alarm.h>
@@ -790,6 +791,8 @@ play_string(const char *str, bool free_buffer)
 
 } // namespace
 
+PX4_MODULE_DEPENDENCIES(tone_alarm, "");
+
 int
 tone_alarm_main(int argc, char *argv[])
 {
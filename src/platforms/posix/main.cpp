@@ -43,6 +43,7 @@
 #include <string>
 #include <sstream>
 #include <vector>
+#include <map>
 #include <signal.h>
 #include <unistd.h>
 #include <stdio.h>
@@ -50,6 +51,9 @@
 #include "px4_middleware.h"
 #include "px4_posix.h"
 #include "px4_log.h"
+#include "px4_tasks.h"
+#include "px4_module.h"
+#include "px4_rt_memory.h"
 #include "DriverFramework.hpp"
 #include <termios.h>
 #include <sys/stat.h>
@@ -187,11 +191,18 @@ static string pwd()
 static void print_prompt()
 {
 	cout.flush();
-	cout << "pxh> ";
+
+	if (px4_get_namespace() != 0) {
+		cout << "pxh(" << px4_get_namespace() << ")> ";
+
+	} else {
+		cout << "pxh> ";
+	}
+
 	cout.flush();
 }
 
-static void run_cmd(const vector<string> &appargs, bool exit_on_fail, bool silently_fail = false)
+static apps_map_type &get_apps()
 {
 	static apps_map_type apps;
 	static bool initialized = false;
@@ -201,10 +212,18 @@ static void run_cmd(const vector<string> &appargs, bool exit_on_fail, bool silen
 		initialized = true;
 	}
 
+	return apps;
+}
+
+static void run_cmd(const vector<string> &appargs, bool exit_on_fail, bool silently_fail = false)
+{
+	apps_map_type &apps = get_apps();
+
 	// command is appargs[0]
 	string command = appargs[0];
+	apps_map_type::const_iterator app = apps.find(command);
 
-	if (apps.find(command) != apps.end()) {
+	if (app != apps.end()) {
 		const char *arg[appargs.size() + 2];
 
 		unsigned int i = 0;
@@ -216,7 +235,7 @@ static void run_cmd(const vector<string> &appargs, bool exit_on_fail, bool silen
 
 		arg[i] = (char *)nullptr;
 
-		int retval = apps[command](i, (char **)arg);
+		int retval = app->second(i, (char **)arg);
 
 		if (retval) {
 			cout << "Command '" << command << "' failed, returned " << retval << endl;
@@ -229,6 +248,22 @@ static void run_cmd(const vector<string> &appargs, bool exit_on_fail, bool silen
 	} else if (command == "help") {
 		list_builtins(apps);
 
+	} else if (command == "namespace") {
+		// all following commands (and the tasks they start) run in this namespace
+		if (appargs.size() > 1 && appargs[1] != "") {
+			int ret = px4_set_namespace(atoi(appargs[1].c_str()));
+
+			if (ret != 0) {
+				cout << "Invalid namespace: " << appargs[1] << " (0-" << PX4_MAX_NAMESPACES - 1 << ")" << endl;
+
+				if (exit_on_fail) {
+					exit(1);
+				}
+			}
+		}
+
+		cout << "namespace " << px4_get_namespace() << endl;
+
 	} else if (command.length() == 0 || command[0] == '#') {
 		// Do nothing
 
@@ -241,13 +276,20 @@ static void run_cmd(const vector<string> &appargs, bool exit_on_fail, bool silen
 static void usage()
 {
 
-	cout << "./px4 [-d] [data_directory] startup_config [-h]" << endl;
+	cout << "./px4 [-d] [-m] [-p] [-t] [data_directory] startup_config [-h]" << endl;
 	cout << "   -d            - Optional flag to run the app in daemon mode and does not listen for user input." <<
 	     endl;
 	cout << "                   This is needed if px4 is intended to be run as a upstart job on linux" << endl;
+	cout << "   -m            - Optional flag to lock all memory (this also pre-faults task stacks) and pre-touch uORB buffers," << endl;
+	cout << "                   to avoid page faults in real-time tasks (needs CAP_IPC_LOCK)" << endl;
+	cout << "   -p            - Optional flag to start modules in parallel, as far as their declared dependencies allow" << endl;
+	cout << "   -t            - Optional flag to print a timeline of the startup commands (implied by -p)" << endl;
 	cout << "<data_directory> - directory where ROMFS and posix-configs are located (if not given, CWD is used)" << endl;
 	cout << "<startup_config> - config file for starting/stopping px4 modules" << endl;
 	cout << "   -h            - help/usage information" << endl;
+	cout << "The 'namespace <n>' shell command runs the following commands as vehicle <n> (0-" << PX4_MAX_NAMESPACES - 1 <<
+	     ")." << endl;
+	cout << "WARNING: modules with file-scope state (and DriverFramework drivers) can only run in one namespace" << endl;
 }
 
 static void process_line(string &line, bool exit_on_fail)
@@ -260,6 +302,158 @@ static void process_line(string &line, bool exit_on_fail)
 	run_cmd(appargs, exit_on_fail);
 }
 
+/**
+ * A command of the startup script, with its timing for the boot timeline.
+ */
+struct startup_command_s {
+	string line;
+	int ns;					///< namespace of the shell when the command was read
+	bool concurrent;			///< runs in its own thread
+	vector<startup_command_s *> depends_on;	///< concurrent commands that must be done first
+	uint64_t start;				///< [us] relative to the start of the script
+	uint64_t end;				///< [us] relative to the start of the script
+	volatile bool done;
+	pthread_t thread;
+	bool joined;
+};
+
+static uint64_t _startup_begin = 0;
+static pthread_mutex_t _startup_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t _startup_cond = PTHREAD_COND_INITIALIZER;
+
+static void run_startup_command(startup_command_s *cmd)
+{
+	cmd->start = hrt_system_time() - _startup_begin;
+	// TODO: this should be true but for that we have to check all startup files
+	process_line(cmd->line, false);
+	cmd->end = hrt_system_time() - _startup_begin;
+}
+
+static void *startup_command_thread(void *arg)
+{
+	startup_command_s *cmd = (startup_command_s *)arg;
+
+	px4_set_namespace(cmd->ns);
+
+	pthread_mutex_lock(&_startup_mutex);
+
+	for (startup_command_s *dependency : cmd->depends_on) {
+		while (!dependency->done) {
+			pthread_cond_wait(&_startup_cond, &_startup_mutex);
+		}
+	}
+
+	pthread_mutex_unlock(&_startup_mutex);
+
+	run_startup_command(cmd);
+
+	pthread_mutex_lock(&_startup_mutex);
+	cmd->done = true;
+	pthread_cond_broadcast(&_startup_cond);
+	pthread_mutex_unlock(&_startup_mutex);
+
+	return nullptr;
+}
+
+static void wait_for_startup_commands(vector<startup_command_s *> &commands)
+{
+	for (startup_command_s *cmd : commands) {
+		if (cmd->concurrent && !cmd->joined) {
+			pthread_join(cmd->thread, nullptr);
+			cmd->joined = true;
+		}
+	}
+}
+
+/**
+ * Run the startup script. In parallel mode the start command of a module that declares
+ * its dependencies (PX4_MODULE_DEPENDENCIES) runs in its own thread, as soon as the
+ * start commands of the modules it depends on and earlier starts of the same module are
+ * done. Every other command first waits for all concurrent commands and then runs
+ * sequentially, so the starts between two such commands form a group.
+ */
+static void run_startup_script(ifstream &infile, bool parallel, bool print_timeline)
+{
+	vector<startup_command_s *> commands;
+	map<pair<int, string>, startup_command_s *> module_starts; // concurrent starts by (namespace, module)
+
+	// build the application map before any concurrent command needs it
+	get_apps();
+
+	_startup_begin = hrt_system_time();
+
+	for (string line; getline(infile, line, '\n');) {
+
+		if (px4_exit_requested()) {
+			break;
+		}
+
+		string module, verb;
+		stringstream(line) >> module >> verb;
+
+		if (module.empty() || module[0] == '#') {
+			continue;
+		}
+
+		startup_command_s *cmd = new startup_command_s();
+		cmd->line = line;
+		cmd->ns = px4_get_namespace();
+		commands.push_back(cmd);
+
+		const ModuleDependencies *dependencies = (parallel && verb == "start") ? ModuleDependencies::find(module.c_str()) :
+				nullptr;
+
+		if (dependencies) {
+			// a second start of the same module (e.g. another mavlink instance) waits for the first
+			auto previous = module_starts.find(make_pair(cmd->ns, module));
+
+			if (previous != module_starts.end()) {
+				cmd->depends_on.push_back(previous->second);
+			}
+
+			string dependency;
+			stringstream dependency_list(dependencies->depends_on());
+
+			while (dependency_list >> dependency) {
+				auto started = module_starts.find(make_pair(cmd->ns, dependency));
+
+				if (started != module_starts.end()) {
+					cmd->depends_on.push_back(started->second);
+				}
+			}
+
+			cmd->concurrent = pthread_create(&cmd->thread, nullptr, startup_command_thread, cmd) == 0;
+
+			if (cmd->concurrent) {
+				module_starts[make_pair(cmd->ns, module)] = cmd;
+				continue;
+			}
+		}
+
+		wait_for_startup_commands(commands);
+		run_startup_command(cmd);
+		cmd->done = true;
+	}
+
+	wait_for_startup_commands(commands);
+
+	if (print_timeline) {
+		printf("\nBoot timeline (%s), times in ms from the start of the script:\n", parallel ? "parallel" : "sequential");
+		printf("   start      end duration  command\n");
+
+		for (startup_command_s *cmd : commands) {
+			printf("%8.1f %8.1f %8.1f  %c %s\n", cmd->start / 1e3, cmd->end / 1e3, (cmd->end - cmd->start) / 1e3,
+			       cmd->concurrent ? '|' : ' ', cmd->line.c_str());
+		}
+
+		printf("Startup script done after %.1f ms\n\n", (hrt_system_time() - _startup_begin) / 1e3);
+	}
+
+	for (startup_command_s *cmd : commands) {
+		delete cmd;
+	}
+}
+
 static void restore_term()
 {
 	cout << "Restoring terminal\n";
@@ -296,6 +490,9 @@ int main(int argc, char **argv)
 {
 	bool daemon_mode = false;
 	bool chroot_on = false;
+	bool lock_memory = false;
+	bool parallel_startup = false;
+	bool print_boot_timeline = false;
 
 	tcgetattr(0, &orig_term);
 	atexit(restore_term);
@@ -338,6 +535,16 @@ int main(int argc, char **argv)
 			} else if (strncmp(argv[index], "-c", 2) == 0) {
 				chroot_on = true;
 
+			} else if (strncmp(argv[index], "-m", 2) == 0) {
+				lock_memory = true;
+
+			} else if (strncmp(argv[index], "-p", 2) == 0) {
+				parallel_startup = true;
+				print_boot_timeline = true;
+
+			} else if (strncmp(argv[index], "-t", 2) == 0) {
+				print_boot_timeline = true;
+
 			} else {
 				PX4_ERR("Unknown/unhandled parameter: %s", argv[index]);
 				return 1;
@@ -445,6 +652,15 @@ int main(int argc, char **argv)
 		touch(microsd_path + "dataman");
 	}
 
+	// lock memory before any task is started, so that all stacks get pre-faulted
+	if (lock_memory) {
+		int ret = px4_rt_memory_init(PX4_RT_MEMORY_ARENA_SIZE);
+
+		if (ret != 0) {
+			PX4_ERR("Error locking memory (%i), continuing without", ret);
+		}
+	}
+
 	// initialize
 	DriverFramework::Framework::initialize();
 	px4::init_once();
@@ -456,15 +672,7 @@ int main(int argc, char **argv)
 		ifstream infile(commands_file.c_str());
 
 		if (infile.is_open()) {
-			for (string line; getline(infile, line, '\n');) {
-
-				if (px4_exit_requested()) {
-					break;
-				}
-
-				// TODO: this should be true but for that we have to check all startup files
-				process_line(line, false);
-			}
+			run_startup_script(infile, parallel_startup, print_boot_timeline);
 
 		} else {
 			PX4_ERR("Error opening commands file: %s", commands_file.c_str());
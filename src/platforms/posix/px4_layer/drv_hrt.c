@@ -37,20 +37,41 @@
  * High-resolution timer with callouts and timekeeping.
  */
 
+#if defined(__PX4_LINUX) && !defined(_GNU_SOURCE)
+#define _GNU_SOURCE	/* sem_clockwait() */
+#endif
+
 #include <px4_time.h>
 #include <px4_posix.h>
 #include <px4_defines.h>
 #include <px4_workqueue.h>
 #include <px4_tasks.h>
 #include <drivers/drv_hrt.h>
+#include <systemlib/perf_counter.h>
 #include <semaphore.h>
 #include <time.h>
 #include <string.h>
 #include <inttypes.h>
 #include <errno.h>
+#include <stdlib.h>
 #include "hrt_work.h"
 
-static struct sq_queue_s	callout_queue;
+/* semaphore waits timed on CLOCK_MONOTONIC (glibc 2.30+) */
+#if defined(__PX4_LINUX) && defined(__GLIBC__)
+#if __GLIBC_PREREQ(2, 30)
+#define HRT_HAVE_SEM_CLOCKWAIT
+#endif
+#endif
+
+/*
+ * Pending callouts, kept as a binary min-heap ordered by deadline so that
+ * entering and removing a call is O(log n) instead of a walk of a sorted list.
+ * The heap grows on demand and is protected by _hrt_lock.
+ */
+#define HRT_CALLOUT_HEAP_INITIAL_SIZE 32
+static struct hrt_call	**callout_heap = NULL;
+static unsigned		callout_count = 0;
+static unsigned		callout_capacity = 0;
 
 /* latency histogram */
 #define LATENCY_BUCKET_COUNT 8
@@ -71,11 +92,62 @@ static hrt_abstime px4_timestart = 0;
 #else
 static int32_t dsp_offset = 0;
 #endif
+/*
+ * hrt_absolute_time() is lock-free: _start_delay_time and _delay_interval are
+ * published by the (rare) writers through the sequence counter _delay_seq
+ * (odd while an update is in progress), and monotonicity is enforced with an
+ * atomic max on max_time. _hrt_mutex only serializes the writers.
+ */
 static hrt_abstime _start_delay_time = 0;
 static hrt_abstime _delay_interval = 0;
 static hrt_abstime max_time = 0;
+static uint32_t _delay_seq = 0;
 pthread_mutex_t _hrt_mutex = PTHREAD_MUTEX_INITIALIZER;
 
+/*
+ * Lockstep: when enabled, the HRT is a virtual clock that only advances through
+ * hrt_lockstep_set_time(). Tasks blocked in hrt_lockstep_wait() are woken when
+ * the clock reaches their deadline or when their semaphore is posted through
+ * hrt_lockstep_post(), and then count as running until they block in
+ * hrt_lockstep_wait() again. hrt_lockstep_set_time() waits for that count to
+ * drop to zero before advancing the clock, so a step only starts once all the
+ * work triggered by the previous one has completed.
+ *
+ * If it gives up waiting (a stall), the count is dropped and a new generation
+ * starts. Tasks counted in an older generation are no longer part of the count:
+ * they must not decrement it, and count again once they are woken.
+ */
+struct lockstep_waiter {
+	struct lockstep_waiter *next;
+	px4_sem_t *sem;
+	hrt_abstime deadline;
+	unsigned generation;	/* generation the waiter was counted in when woken */
+	bool woken;
+	bool timed_out;
+};
+
+static bool _lockstep_enabled = false;
+static hrt_abstime _lockstep_time = 0;
+static struct lockstep_waiter *_lockstep_waiters = NULL;
+static unsigned _lockstep_running = 0;
+static unsigned _lockstep_generation = 0;
+static perf_counter_t _lockstep_stalls = NULL;
+static px4_sem_t _lockstep_idle;
+static pthread_mutex_t _lockstep_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+/* set while the calling thread is counted in _lockstep_running, in generation
+ * _lockstep_counted_generation */
+static __thread bool _lockstep_counted = false;
+static __thread unsigned _lockstep_counted_generation = 0;
+
+/* wall-clock time hrt_lockstep_set_time() waits for running tasks before it
+ * advances anyway (a task blocking outside of hrt_lockstep_wait() or exiting) */
+#define HRT_LOCKSTEP_TIMEOUT_US 100000
+
+/* time going backwards by less than this is expected from threads racing between
+ * reading the clock and updating max_time, and is not reported */
+#define HRT_NEGATIVE_TIME_REPORT_THRESHOLD 1000
+
 static void
 hrt_call_invoke(void);
 
@@ -94,6 +166,101 @@ static void hrt_unlock(void)
 	px4_sem_post(&_hrt_lock);
 }
 
+static void callout_heap_sift_up(unsigned index)
+{
+	struct hrt_call *entry = callout_heap[index];
+
+	while (index > 0) {
+		unsigned parent = (index - 1) / 2;
+
+		if (callout_heap[parent]->deadline <= entry->deadline) {
+			break;
+		}
+
+		callout_heap[index] = callout_heap[parent];
+		callout_heap[index]->heap_index = index;
+		index = parent;
+	}
+
+	callout_heap[index] = entry;
+	entry->heap_index = index;
+}
+
+static void callout_heap_sift_down(unsigned index)
+{
+	struct hrt_call *entry = callout_heap[index];
+
+	for (;;) {
+		unsigned child = 2 * index + 1;
+
+		if (child >= callout_count) {
+			break;
+		}
+
+		if (child + 1 < callout_count && callout_heap[child + 1]->deadline < callout_heap[child]->deadline) {
+			++child;
+		}
+
+		if (entry->deadline <= callout_heap[child]->deadline) {
+			break;
+		}
+
+		callout_heap[index] = callout_heap[child];
+		callout_heap[index]->heap_index = index;
+		index = child;
+	}
+
+	callout_heap[index] = entry;
+	entry->heap_index = index;
+}
+
+static struct hrt_call *callout_heap_peek(void)
+{
+	return (callout_count > 0) ? callout_heap[0] : NULL;
+}
+
+static bool callout_heap_push(struct hrt_call *entry)
+{
+	if (callout_count == callout_capacity) {
+		unsigned capacity = (callout_capacity > 0) ? 2 * callout_capacity : HRT_CALLOUT_HEAP_INITIAL_SIZE;
+		struct hrt_call **heap = (struct hrt_call **)realloc(callout_heap, capacity * sizeof(struct hrt_call *));
+
+		if (heap == NULL) {
+			PX4_ERR("hrt callout heap alloc failed");
+			return false;
+		}
+
+		callout_heap = heap;
+		callout_capacity = capacity;
+	}
+
+	callout_heap[callout_count] = entry;
+	callout_heap_sift_up(callout_count++);
+	return true;
+}
+
+/*
+ * Remove entry from the heap if it is queued. The entry keeps its heap slot,
+ * which is only trusted if the slot still points back at the entry (an entry
+ * that was never queued may hold any value there).
+ */
+static void callout_heap_remove(struct hrt_call *entry)
+{
+	unsigned index = entry->heap_index;
+
+	if (index >= callout_count || callout_heap[index] != entry) {
+		return;
+	}
+
+	--callout_count;
+
+	if (index < callout_count) {
+		callout_heap[index] = callout_heap[callout_count];
+		callout_heap_sift_down(index);
+		callout_heap_sift_up(index);
+	}
+}
+
 #if defined(__PX4_APPLE_LEGACY)
 #include <sys/time.h>
 
@@ -167,13 +334,24 @@ hrt_abstime _hrt_absolute_time_internal(void)
 
 #else
 
-	if (!px4_timestart) {
+	hrt_abstime timestart = __atomic_load_n(&px4_timestart, __ATOMIC_RELAXED);
+
+	if (!timestart) {
 		px4_clock_gettime(CLOCK_MONOTONIC, &ts);
-		px4_timestart = ts_to_abstime(&ts);
+		hrt_abstime expected = 0;
+
+		/* the first caller sets the start time, the others use it */
+		if (__atomic_compare_exchange_n(&px4_timestart, &expected, ts_to_abstime(&ts), false,
+						__ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+			timestart = ts_to_abstime(&ts);
+
+		} else {
+			timestart = expected;
+		}
 	}
 
 	px4_clock_gettime(CLOCK_MONOTONIC, &ts);
-	return ts_to_abstime(&ts) - px4_timestart;
+	return ts_to_abstime(&ts) - timestart;
 #endif
 }
 
@@ -190,26 +368,46 @@ int hrt_set_absolute_time_offset(int32_t time_diff_us)
  */
 hrt_abstime hrt_absolute_time(void)
 {
-	pthread_mutex_lock(&_hrt_mutex);
+	if (__atomic_load_n(&_lockstep_enabled, __ATOMIC_ACQUIRE)) {
+		return __atomic_load_n(&_lockstep_time, __ATOMIC_ACQUIRE);
+	}
+
+	hrt_abstime start_delay_time;
+	hrt_abstime delay_interval;
+	uint32_t seq;
+
+	/* read a consistent pair of the delay state, retry if a writer was active */
+	do {
+		seq = __atomic_load_n(&_delay_seq, __ATOMIC_ACQUIRE);
+		start_delay_time = __atomic_load_n(&_start_delay_time, __ATOMIC_RELAXED);
+		delay_interval = __atomic_load_n(&_delay_interval, __ATOMIC_RELAXED);
+		__atomic_thread_fence(__ATOMIC_ACQUIRE);
+	} while ((seq & 1) || seq != __atomic_load_n(&_delay_seq, __ATOMIC_RELAXED));
 
 	hrt_abstime ret;
 
-	if (_start_delay_time > 0) {
-		ret = _start_delay_time;
+	if (start_delay_time > 0) {
+		ret = start_delay_time;
 
 	} else {
 		ret = _hrt_absolute_time_internal();
 	}
 
-	ret -= _delay_interval;
+	ret -= delay_interval;
 
-	if (ret < max_time) {
-		PX4_ERR("WARNING! TIME IS NEGATIVE! %d vs %d", (int)ret, (int)max_time);
-		ret = max_time;
-	}
+	/* atomic max: never return a time older than what any thread has seen */
+	hrt_abstime last = __atomic_load_n(&max_time, __ATOMIC_RELAXED);
 
-	max_time = ret;
-	pthread_mutex_unlock(&_hrt_mutex);
+	do {
+		if (ret < last) {
+			if (last - ret > HRT_NEGATIVE_TIME_REPORT_THRESHOLD) {
+				PX4_ERR("WARNING! TIME IS NEGATIVE! %d vs %d", (int)ret, (int)last);
+			}
+
+			ret = last;
+			break;
+		}
+	} while (!__atomic_compare_exchange_n(&max_time, &last, ret, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED));
 
 	return ret;
 }
@@ -217,12 +415,31 @@ hrt_abstime hrt_absolute_time(void)
 __EXPORT hrt_abstime hrt_reset(void)
 {
 #ifndef __PX4_QURT
-	px4_timestart = 0;
+	__atomic_store_n(&px4_timestart, 0, __ATOMIC_RELAXED);
 #endif
-	max_time = 0;
+	__atomic_store_n(&max_time, 0, __ATOMIC_RELAXED);
+
+	if (__atomic_load_n(&_lockstep_enabled, __ATOMIC_ACQUIRE)) {
+		__atomic_store_n(&_lockstep_time, 0, __ATOMIC_RELEASE);
+		return 0;
+	}
+
 	return _hrt_absolute_time_internal();
 }
 
+/*
+ * Update the delay state. Must be called with _hrt_mutex held.
+ */
+static void hrt_set_delay_state(hrt_abstime start_delay_time, hrt_abstime delay_interval)
+{
+	uint32_t seq = __atomic_load_n(&_delay_seq, __ATOMIC_RELAXED);
+	__atomic_store_n(&_delay_seq, seq + 1, __ATOMIC_RELAXED);
+	__atomic_thread_fence(__ATOMIC_RELEASE);
+	__atomic_store_n(&_start_delay_time, start_delay_time, __ATOMIC_RELAXED);
+	__atomic_store_n(&_delay_interval, delay_interval, __ATOMIC_RELAXED);
+	__atomic_store_n(&_delay_seq, seq + 2, __ATOMIC_RELEASE);
+}
+
 /*
  * Convert a timespec to absolute time.
  */
@@ -236,6 +453,16 @@ hrt_abstime ts_to_abstime(struct timespec *ts)
 	return result;
 }
 
+/*
+ * Convert absolute time to a timespec.
+ */
+void	abstime_to_ts(struct timespec *ts, hrt_abstime abstime)
+{
+	ts->tv_sec = abstime / 1000000;
+	abstime -= ts->tv_sec * 1000000;
+	ts->tv_nsec = abstime * 1000;
+}
+
 /*
  * Compute the delta between a timestamp taken in the past
  * and now.
@@ -278,7 +505,7 @@ bool	hrt_called(struct hrt_call *entry)
 void	hrt_cancel(struct hrt_call *entry)
 {
 	hrt_lock();
-	sq_rem(&entry->link, &callout_queue);
+	callout_heap_remove(entry);
 	entry->deadline = 0;
 
 	/* if this is a periodic call being removed by the callout, prevent it from
@@ -314,7 +541,7 @@ void	hrt_call_delay(struct hrt_call *entry, hrt_abstime delay)
  */
 void	hrt_init(void)
 {
-	sq_init(&callout_queue);
+	callout_count = 0;
 
 	int sem_ret = px4_sem_init(&_hrt_lock, 0, 1);
 
@@ -328,7 +555,7 @@ void	hrt_init(void)
 void	hrt_start_delay()
 {
 	pthread_mutex_lock(&_hrt_mutex);
-	_start_delay_time = _hrt_absolute_time_internal();
+	hrt_set_delay_state(_hrt_absolute_time_internal(), _delay_interval);
 	pthread_mutex_unlock(&_hrt_mutex);
 }
 
@@ -342,8 +569,7 @@ void	hrt_stop_delay_delta(hrt_abstime delta)
 		delta = delta_measured;
 	}
 
-	_delay_interval += delta;
-	_start_delay_time = 0;
+	hrt_set_delay_state(0, _delay_interval + delta);
 
 	pthread_mutex_unlock(&_hrt_mutex);
 
@@ -353,37 +579,303 @@ void	hrt_stop_delay()
 {
 	pthread_mutex_lock(&_hrt_mutex);
 	uint64_t delta = _hrt_absolute_time_internal() - _start_delay_time;
-	_delay_interval += delta;
-	_start_delay_time = 0;
+	hrt_set_delay_state(0, _delay_interval + delta);
 
 	pthread_mutex_unlock(&_hrt_mutex);
 
 }
 
-static void
-hrt_call_enter(struct hrt_call *entry)
+/*
+ * Wait on sem for at most delay microseconds of real (not lockstep) time. The
+ * timeout is measured on CLOCK_MONOTONIC, so setting the wall clock (NTP,
+ * date) neither cuts the wait short nor stretches it.
+ */
+static int hrt_sem_wait_for(px4_sem_t *sem, hrt_abstime delay)
 {
-	struct hrt_call	*call, *next;
+	struct timespec ts;
+	px4_clock_gettime(CLOCK_MONOTONIC, &ts);
+	const hrt_abstime deadline = ts_to_abstime(&ts) + delay;
 
-	//PX4_INFO("hrt_call_enter");
-	call = (struct hrt_call *)sq_peek(&callout_queue);
+	int err;
 
-	if ((call == NULL) || (entry->deadline < call->deadline)) {
-		sq_addfirst(&entry->link, &callout_queue);
-		//if (call != NULL) PX4_INFO("call enter at head, reschedule (%lu %lu)", entry->deadline, call->deadline);
-		/* we changed the next deadline, reschedule the timer event */
-		hrt_call_reschedule();
+	do {
+#ifdef HRT_HAVE_SEM_CLOCKWAIT
+		abstime_to_ts(&ts, deadline);
+		errno = 0;
+		err = (sem_clockwait(sem, CLOCK_MONOTONIC, &ts) == 0) ? 0 : errno;
+#else
+		/* px4_sem_timedwait() only takes an absolute CLOCK_REALTIME timeout:
+		 * convert the time left right before waiting */
+		px4_clock_gettime(CLOCK_MONOTONIC, &ts);
+		const hrt_abstime now = ts_to_abstime(&ts);
+
+		if (deadline <= now) {
+			return -ETIMEDOUT;
+		}
+
+		px4_clock_gettime(CLOCK_REALTIME, &ts);
+
+		uint64_t nsecs = ts.tv_nsec + (deadline - now) * 1000;
+		ts.tv_sec += nsecs / 1000000000;
+		ts.tv_nsec = nsecs % 1000000000;
+
+		errno = 0;
+#ifdef __PX4_DARWIN
+		err = px4_sem_timedwait(sem, &ts);
+#else
+		err = (px4_sem_timedwait(sem, &ts) == 0) ? 0 : errno;
+#endif
+
+		/* the wall clock was stepped forward while waiting: wait for the rest */
+		if (err == ETIMEDOUT) {
+			px4_clock_gettime(CLOCK_MONOTONIC, &ts);
+
+			if (ts_to_abstime(&ts) < deadline) {
+				err = EINTR;
+			}
+		}
+
+#endif
+	} while (err == EINTR);
+
+	return -err;
+}
+
+/*
+ * Wait on sem until hrt_absolute_time() reaches deadline. The time left is
+ * re-checked against hrt_absolute_time() after every timeout, which also
+ * covers the clock being held back by hrt_start_delay().
+ */
+static int hrt_sem_wait_until(px4_sem_t *sem, hrt_abstime deadline)
+{
+	for (;;) {
+		const hrt_abstime now = hrt_absolute_time();
+
+		if (deadline <= now) {
+			return -ETIMEDOUT;
+		}
+
+		int ret = hrt_sem_wait_for(sem, deadline - now);
+
+		if (ret != -ETIMEDOUT) {
+			return ret;
+		}
+	}
+}
+
+/*
+ * Count the calling thread as running in the current lockstep step, unless it
+ * already is. Must be called with _lockstep_mutex held.
+ */
+static void hrt_lockstep_count(void)
+{
+	if (_lockstep_counted && _lockstep_counted_generation == _lockstep_generation) {
+		return;
+	}
+
+	_lockstep_counted = true;
+	_lockstep_counted_generation = _lockstep_generation;
+	++_lockstep_running;
+}
+
+/*
+ * The calling thread is about to block: it no longer counts as running in the
+ * current lockstep step. Must be called with _lockstep_mutex held.
+ */
+static void hrt_lockstep_done(void)
+{
+	if (!_lockstep_counted) {
+		return;
+	}
+
+	_lockstep_counted = false;
+
+	/* counted before a stall: that count was already dropped */
+	if (_lockstep_counted_generation != _lockstep_generation) {
+		return;
+	}
+
+	if (--_lockstep_running == 0) {
+		px4_sem_post(&_lockstep_idle);
+	}
+}
+
+void	hrt_lockstep_enable(void)
+{
+	pthread_mutex_lock(&_lockstep_mutex);
+
+	if (!_lockstep_enabled) {
+		_lockstep_stalls = perf_alloc(PC_COUNT, "hrt_lockstep_stall");
+
+		px4_sem_init(&_lockstep_idle, 0, 0);
+
+		// _lockstep_idle use case is a signal
+		px4_sem_setprotocol(&_lockstep_idle, SEM_PRIO_NONE);
+
+		/* continue from the current time rather than jumping */
+		__atomic_store_n(&_lockstep_time, hrt_absolute_time(), __ATOMIC_RELEASE);
+		__atomic_store_n(&_lockstep_enabled, true, __ATOMIC_RELEASE);
+	}
+
+	pthread_mutex_unlock(&_lockstep_mutex);
+}
+
+bool	hrt_lockstep_enabled(void)
+{
+	return __atomic_load_n(&_lockstep_enabled, __ATOMIC_ACQUIRE);
+}
+
+void	hrt_lockstep_set_time(hrt_abstime time)
+{
+	if (!hrt_lockstep_enabled()) {
+		return;
+	}
+
+	pthread_mutex_lock(&_lockstep_mutex);
+
+	/* let everything woken by the previous step run to completion */
+	while (_lockstep_running > 0) {
+		pthread_mutex_unlock(&_lockstep_mutex);
+		int ret = hrt_sem_wait_for(&_lockstep_idle, HRT_LOCKSTEP_TIMEOUT_US);
+		pthread_mutex_lock(&_lockstep_mutex);
+
+		if (ret == -ETIMEDOUT && _lockstep_running > 0) {
+			if (perf_event_count(_lockstep_stalls) == 0) {
+				PX4_WARN("lockstep: %u tasks did not complete their step, advancing", _lockstep_running);
+			}
+
+			perf_count(_lockstep_stalls);
+			++_lockstep_generation;
+			_lockstep_running = 0;
+		}
+	}
+
+	if (time > _lockstep_time) {
+		__atomic_store_n(&_lockstep_time, time, __ATOMIC_RELEASE);
+
+		for (struct lockstep_waiter *waiter = _lockstep_waiters; waiter; waiter = waiter->next) {
+			if (!waiter->woken && waiter->deadline <= time) {
+				waiter->woken = true;
+				waiter->timed_out = true;
+				waiter->generation = _lockstep_generation;
+				++_lockstep_running;
+				px4_sem_post(waiter->sem);
+			}
+		}
+	}
+
+	pthread_mutex_unlock(&_lockstep_mutex);
+}
+
+int	hrt_lockstep_wait(px4_sem_t *sem, hrt_abstime deadline)
+{
+	if (!hrt_lockstep_enabled()) {
+		if (deadline == HRT_ABSTIME_MAX) {
+			while (px4_sem_wait(sem) != 0 && errno == EINTR) {
+			}
+
+			return 0;
+		}
+
+		return hrt_sem_wait_until(sem, deadline);
+	}
+
+	pthread_mutex_lock(&_lockstep_mutex);
+
+	/* already posted: keep running in this step without blocking */
+	if (px4_sem_trywait(sem) == 0) {
+		hrt_lockstep_count();
+		pthread_mutex_unlock(&_lockstep_mutex);
+		return 0;
+	}
+
+	if (deadline <= _lockstep_time) {
+		pthread_mutex_unlock(&_lockstep_mutex);
+		return -ETIMEDOUT;
+	}
+
+	struct lockstep_waiter waiter = { _lockstep_waiters, sem, deadline, 0, false, false };
+	_lockstep_waiters = &waiter;
+	hrt_lockstep_done();
+
+	pthread_mutex_unlock(&_lockstep_mutex);
+
+	while (px4_sem_wait(sem) != 0 && errno == EINTR) {
+	}
+
+	pthread_mutex_lock(&_lockstep_mutex);
+
+	struct lockstep_waiter **link = &_lockstep_waiters;
+
+	while (*link != &waiter) {
+		link = &(*link)->next;
+	}
+
+	*link = waiter.next;
+
+	/* posted without hrt_lockstep_post(), or counted before a stall: count
+	 * ourselves, late */
+	if (waiter.woken && waiter.generation == _lockstep_generation) {
+		_lockstep_counted = true;
+		_lockstep_counted_generation = _lockstep_generation;
 
 	} else {
-		do {
-			next = (struct hrt_call *)sq_next(&call->link);
+		hrt_lockstep_count();
+	}
+
+	pthread_mutex_unlock(&_lockstep_mutex);
 
-			if ((next == NULL) || (entry->deadline < next->deadline)) {
-				//lldbg("call enter after head\n");
-				sq_addafter(&call->link, &entry->link, &callout_queue);
+	return waiter.timed_out ? -ETIMEDOUT : 0;
+}
+
+void	hrt_lockstep_print_status(void)
+{
+	if (!hrt_lockstep_enabled()) {
+		PX4_INFO("lockstep: disabled");
+		return;
+	}
+
+	pthread_mutex_lock(&_lockstep_mutex);
+	PX4_INFO("lockstep: time %" PRIu64 " us, %u tasks running", _lockstep_time, _lockstep_running);
+	pthread_mutex_unlock(&_lockstep_mutex);
+
+	perf_print_counter(_lockstep_stalls);
+}
+
+int	hrt_lockstep_post(px4_sem_t *sem)
+{
+	if (hrt_lockstep_enabled()) {
+		pthread_mutex_lock(&_lockstep_mutex);
+
+		/* count the waiter as running before it can wake up, so that the
+		 * step cannot be considered complete in between */
+		for (struct lockstep_waiter *waiter = _lockstep_waiters; waiter; waiter = waiter->next) {
+			if (waiter->sem == sem && !waiter->woken) {
+				waiter->woken = true;
+				waiter->generation = _lockstep_generation;
+				++_lockstep_running;
 				break;
 			}
-		} while ((call = next) != NULL);
+		}
+
+		pthread_mutex_unlock(&_lockstep_mutex);
+	}
+
+	return px4_sem_post(sem);
+}
+
+static void
+hrt_call_enter(struct hrt_call *entry)
+{
+	//PX4_INFO("hrt_call_enter");
+	if (!callout_heap_push(entry)) {
+		entry->deadline = 0;
+		return;
+	}
+
+	if (callout_heap_peek() == entry) {
+		/* we changed the next deadline, reschedule the timer event */
+		hrt_call_reschedule();
 	}
 
 	//PX4_INFO("scheduled");
@@ -420,7 +912,7 @@ hrt_call_reschedule()
 {
 	hrt_abstime	now = hrt_absolute_time();
 	hrt_abstime	delay = HRT_INTERVAL_MAX;
-	struct hrt_call	*next = (struct hrt_call *)sq_peek(&callout_queue);
+	struct hrt_call	*next = callout_heap_peek();
 	hrt_abstime	deadline = now + HRT_INTERVAL_MAX;
 
 	//PX4_INFO("hrt_call_reschedule");
@@ -467,15 +959,12 @@ hrt_call_internal(struct hrt_call *entry, hrt_abstime deadline, hrt_abstime inte
 
 	//PX4_INFO("hrt_call_internal after lock");
 	/* if the entry is currently queued, remove it */
-	/* note that we are using a potentially uninitialised
-	   entry->link here, but it is safe as sq_rem() doesn't
-	   dereference the passed node unless it is found in the
-	   list. So we potentially waste a bit of time searching the
-	   queue for the uninitialised entry->link but we don't do
-	   anything actually unsafe.
+	/* note that entry->deadline may be uninitialised here, but it
+	   is safe as callout_heap_remove() checks the heap slot of the
+	   entry against the queued entries before using it.
 	*/
 	if (entry->deadline != 0) {
-		sq_rem(&entry->link, &callout_queue);
+		callout_heap_remove(entry);
 	}
 
 #if 1
@@ -491,6 +980,7 @@ hrt_call_internal(struct hrt_call *entry, hrt_abstime deadline, hrt_abstime inte
 	entry->period = interval;
 	entry->callout = callout;
 	entry->arg = arg;
+	entry->ns = px4_get_namespace();
 
 	hrt_call_enter(entry);
 	hrt_unlock();
@@ -535,13 +1025,6 @@ void	hrt_call_at(struct hrt_call *entry, hrt_abstime calltime, hrt_callout callo
 	hrt_call_internal(entry, calltime, 0, callout, arg);
 }
 
-#if 0
-/*
- * Convert absolute time to a timespec.
- */
-void	abstime_to_ts(struct timespec *ts, hrt_abstime abstime);
-#endif
-
 static void
 hrt_call_invoke(void)
 {
@@ -554,7 +1037,7 @@ hrt_call_invoke(void)
 		/* get the current time */
 		hrt_abstime now = hrt_absolute_time();
 
-		call = (struct hrt_call *)sq_peek(&callout_queue);
+		call = callout_heap_peek();
 
 		if (call == NULL) {
 			break;
@@ -564,7 +1047,7 @@ hrt_call_invoke(void)
 			break;
 		}
 
-		sq_rem(&call->link, &callout_queue);
+		callout_heap_remove(call);
 		//PX4_INFO("call pop");
 
 		/* save the intended deadline for periodic calls */
@@ -579,6 +1062,7 @@ hrt_call_invoke(void)
 			hrt_unlock();
 
 			//PX4_INFO("call %p: %p(%p)", call, call->callout, call->arg);
+			px4_set_namespace(call->ns);
 			call->callout(call->arg);
 
 			hrt_lock();
@@ -62,7 +62,7 @@
 
 #define MAX_CMD_LEN 100
 
-#define PX4_MAX_TASKS 50
+#define PX4_MAX_TASKS 256
 #define SHELL_TASK_ID (PX4_MAX_TASKS+1)
 
 pthread_t _shell_task_id = 0;
@@ -71,20 +71,77 @@ pthread_mutex_t task_mutex = PTHREAD_MUTEX_INITIALIZER;
 struct task_entry {
 	pthread_t pid;
 	std::string name;
+	int ns;
 	bool isused;
-	task_entry() : isused(false) {}
+	task_entry() : ns(0), isused(false) {}
 };
 
+static thread_local int current_namespace = 0;
+
 static task_entry taskmap[PX4_MAX_TASKS] = {};
 
+#define PX4_MAX_AFFINITY_RULES 16
+
+struct affinity_rule {
+	std::string name;
+	uint64_t cpumask;
+};
+
+// explicit per-task placement, and the default for SCHED_FIFO tasks without a rule.
+// Both are protected by task_mutex.
+static affinity_rule affinity_rules[PX4_MAX_AFFINITY_RULES] = {};
+static int affinity_rule_count = 0;
+static uint64_t affinity_rt_cpumask = 0;
+
 typedef struct {
 	px4_main_t entry;
+	uint64_t cpumask; // 0 = no restriction
+	int ns; // namespace, inherited from the spawning thread
 	char name[16]; //pthread_setname_np is restricted to 16 chars
 	int argc;
 	char *argv[];
 	// strings are allocated after the struct data
 } pthdata_t;
 
+static int set_thread_affinity(pthread_t thread, uint64_t cpumask)
+{
+#ifdef __PX4_LINUX
+	cpu_set_t cpuset;
+	CPU_ZERO(&cpuset);
+
+	for (int cpu = 0; cpu < 64; cpu++) {
+		if (cpumask & (1ULL << cpu)) {
+			CPU_SET(cpu, &cpuset);
+		}
+	}
+
+	return pthread_setaffinity_np(thread, sizeof(cpuset), &cpuset);
+#else
+	(void)thread;
+	(void)cpumask;
+	return ENOTSUP;
+#endif
+}
+
+/**
+ * Find the CPU placement for a task. Must be called with task_mutex held.
+ * @return cpu mask, 0 if the task is not restricted
+ */
+static uint64_t affinity_for_task(const char *name, int scheduler)
+{
+	for (int i = 0; i < affinity_rule_count; i++) {
+		if (affinity_rules[i].name == name) {
+			return affinity_rules[i].cpumask;
+		}
+	}
+
+	if (scheduler == SCHED_FIFO) {
+		return affinity_rt_cpumask;
+	}
+
+	return 0;
+}
+
 static void *entry_adapter(void *ptr)
 {
 	pthdata_t *data = (pthdata_t *) ptr;
@@ -102,6 +159,17 @@ static void *entry_adapter(void *ptr)
 		PX4_ERR("px4_task_spawn_cmd: failed to set name of thread %d %d\n", rv, errno);
 	}
 
+	// pin the thread from within, so the placement also applies if we fell back to default attributes
+	if (data->cpumask != 0) {
+		rv = set_thread_affinity(pthread_self(), data->cpumask);
+
+		if (rv) {
+			PX4_ERR("px4_task_spawn_cmd: failed to set affinity of %s (%d)", data->name, rv);
+		}
+	}
+
+	current_namespace = data->ns;
+
 	data->entry(data->argc, data->argv);
 	free(ptr);
 	PX4_DEBUG("Before px4_task_exit");
@@ -156,6 +224,7 @@ px4_task_t px4_task_spawn_cmd(const char *name, int scheduler, int priority, int
 	taskdata->name[15] = 0;
 	taskdata->entry = entry;
 	taskdata->argc = argc;
+	taskdata->ns = current_namespace;
 
 	for (i = 0; i < argc; i++) {
 		PX4_DEBUG("arg %d %s\n", i, argv[i]);
@@ -225,11 +294,14 @@ px4_task_t px4_task_spawn_cmd(const char *name, int scheduler, int priority, int
 
 	pthread_mutex_lock(&task_mutex);
 
+	taskdata->cpumask = affinity_for_task(name, scheduler);
+
 	int taskid = 0;
 
 	for (i = 0; i < PX4_MAX_TASKS; ++i) {
 		if (taskmap[i].isused == false) {
 			taskmap[i].name = name;
+			taskmap[i].ns = current_namespace;
 			taskmap[i].isused = true;
 			taskid = i;
 			break;
@@ -362,7 +434,14 @@ void px4_show_tasks()
 
 	for (idx = 0; idx < PX4_MAX_TASKS; idx++) {
 		if (taskmap[idx].isused) {
-			PX4_INFO("   %-10s %lu", taskmap[idx].name.c_str(), (unsigned long)taskmap[idx].pid);
+			if (taskmap[idx].ns != 0) {
+				PX4_INFO("   %-10s %lu (namespace %i)", taskmap[idx].name.c_str(), (unsigned long)taskmap[idx].pid,
+					 taskmap[idx].ns);
+
+			} else {
+				PX4_INFO("   %-10s %lu", taskmap[idx].name.c_str(), (unsigned long)taskmap[idx].pid);
+			}
+
 			count++;
 		}
 	}
@@ -373,12 +452,123 @@ void px4_show_tasks()
 
 }
 
+int px4_task_set_affinity(const char *taskname, uint64_t cpumask)
+{
+#ifndef __PX4_LINUX
+	return -ENOTSUP;
+#else
+	int ret = 0;
+	int i;
+
+	pthread_mutex_lock(&task_mutex);
+
+	for (i = 0; i < affinity_rule_count; i++) {
+		if (affinity_rules[i].name == taskname) {
+			break;
+		}
+	}
+
+	if (i == affinity_rule_count) {
+		if (affinity_rule_count >= PX4_MAX_AFFINITY_RULES) {
+			pthread_mutex_unlock(&task_mutex);
+			return -ENOSPC;
+		}
+
+		affinity_rules[i].name = taskname;
+		affinity_rule_count++;
+	}
+
+	affinity_rules[i].cpumask = cpumask;
+
+	// apply to already running instances as well
+	for (int idx = 0; idx < PX4_MAX_TASKS; idx++) {
+		if (taskmap[idx].isused && taskmap[idx].name == taskname) {
+			int rv = set_thread_affinity(taskmap[idx].pid, cpumask != 0 ? cpumask : ~0ULL);
+
+			if (rv != 0) {
+				ret = -rv;
+			}
+		}
+	}
+
+	pthread_mutex_unlock(&task_mutex);
+	return ret;
+#endif
+}
+
+int px4_task_set_rt_affinity(uint64_t cpumask)
+{
+#ifndef __PX4_LINUX
+	return -ENOTSUP;
+#else
+	int ret = 0;
+
+	pthread_mutex_lock(&task_mutex);
+
+	affinity_rt_cpumask = cpumask;
+
+	for (int idx = 0; idx < PX4_MAX_TASKS; idx++) {
+		if (!taskmap[idx].isused) {
+			continue;
+		}
+
+		int policy;
+		struct sched_param param;
+
+		if (pthread_getschedparam(taskmap[idx].pid, &policy, &param) != 0 || policy != SCHED_FIFO) {
+			continue;
+		}
+
+		bool has_rule = false;
+
+		for (int i = 0; i < affinity_rule_count; i++) {
+			if (affinity_rules[i].name == taskmap[idx].name) {
+				has_rule = true;
+				break;
+			}
+		}
+
+		if (!has_rule) {
+			int rv = set_thread_affinity(taskmap[idx].pid, cpumask != 0 ? cpumask : ~0ULL);
+
+			if (rv != 0) {
+				ret = -rv;
+			}
+		}
+	}
+
+	pthread_mutex_unlock(&task_mutex);
+	return ret;
+#endif
+}
+
+void px4_task_show_affinity()
+{
+	pthread_mutex_lock(&task_mutex);
+
+	if (affinity_rt_cpumask != 0) {
+		PX4_INFO("SCHED_FIFO tasks: cpu mask 0x%llx", (unsigned long long)affinity_rt_cpumask);
+	}
+
+	for (int i = 0; i < affinity_rule_count; i++) {
+		PX4_INFO("%-16s cpu mask 0x%llx", affinity_rules[i].name.c_str(),
+			 (unsigned long long)affinity_rules[i].cpumask);
+	}
+
+	if (affinity_rt_cpumask == 0 && affinity_rule_count == 0) {
+		PX4_INFO("no affinity rules");
+	}
+
+	pthread_mutex_unlock(&task_mutex);
+}
+
 bool px4_task_is_running(const char *taskname)
 {
 	int idx;
 
 	for (idx = 0; idx < PX4_MAX_TASKS; idx++) {
-		if (taskmap[idx].isused && (strcmp(taskmap[idx].name.c_str(), taskname) == 0)) {
+		if (taskmap[idx].isused && taskmap[idx].ns == current_namespace
+		    && (strcmp(taskmap[idx].name.c_str(), taskname) == 0)) {
 			return true;
 		}
 	}
@@ -386,6 +576,58 @@ bool px4_task_is_running(const char *taskname)
 	return false;
 }
 
+int px4_get_namespace()
+{
+	return current_namespace;
+}
+
+int px4_set_namespace(int ns)
+{
+	if (ns < 0 || ns >= PX4_MAX_NAMESPACES) {
+		return -EINVAL;
+	}
+
+	current_namespace = ns;
+	return 0;
+}
+
+struct pthread_ns_data_s {
+	void *(*start_routine)(void *);
+	void *arg;
+	int ns;
+};
+
+static void *pthread_ns_entry(void *arg)
+{
+	pthread_ns_data_s data = *(pthread_ns_data_s *)arg;
+	free(arg);
+
+	current_namespace = data.ns;
+
+	return data.start_routine(data.arg);
+}
+
+int px4_pthread_create(pthread_t *thread, const pthread_attr_t *attr, void *(*start_routine)(void *), void *arg)
+{
+	pthread_ns_data_s *data = (pthread_ns_data_s *)malloc(sizeof(pthread_ns_data_s));
+
+	if (data == nullptr) {
+		return ENOMEM;
+	}
+
+	data->start_routine = start_routine;
+	data->arg = arg;
+	data->ns = current_namespace;
+
+	int ret = pthread_create(thread, attr, pthread_ns_entry, data);
+
+	if (ret != 0) {
+		free(data);
+	}
+
+	return ret;
+}
+
 px4_task_t px4_getpid()
 {
 	pthread_t pid = pthread_self();
@@ -433,6 +675,26 @@ int px4_prctl(int option, const char *arg2, px4_task_t pid)
 #else
 		rv = pthread_setname_np(pthread_self(), arg2);
 #endif
+
+		// threads not started through px4_task_spawn_cmd() get their placement when they name themselves
+		if (rv == 0) {
+			int policy;
+			struct sched_param param;
+			uint64_t cpumask = 0;
+
+			pthread_mutex_lock(&task_mutex);
+
+			if (pthread_getschedparam(pthread_self(), &policy, &param) == 0) {
+				cpumask = affinity_for_task(arg2, policy);
+			}
+
+			pthread_mutex_unlock(&task_mutex);
+
+			if (cpumask != 0) {
+				set_thread_affinity(pthread_self(), cpumask);
+			}
+		}
+
 		break;
 
 	default:
@@ -0,0 +1,185 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2017 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/**
+ * @file px4_rt_memory.cpp
+ *
+ * Locked memory and allocation arena for real-time operation, see px4_rt_memory.h
+ */
+
+#include <px4_rt_memory.h>
+#include <px4_log.h>
+
+#include <errno.h>
+#include <pthread.h>
+#include <stdint.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/resource.h>
+
+#ifdef __PX4_LINUX
+#include <malloc.h>
+#endif
+
+static bool _enabled = false;
+
+/** header in front of each arena block, keeps the block aligned to max_align_t */
+struct alignas(max_align_t) arena_block_s {
+	size_t size; ///< usable size of the block
+	arena_block_s *next_free; ///< next block in the free list, if the block is free
+};
+
+static uint8_t *_arena = nullptr;
+static size_t _arena_size = 0;
+static size_t _arena_used = 0;
+static size_t _arena_free = 0; ///< bytes in freed blocks
+static arena_block_s *_arena_free_list = nullptr;
+static unsigned _arena_fallbacks = 0;
+static pthread_mutex_t _arena_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+int px4_rt_memory_init(size_t arena_size)
+{
+	if (_enabled) {
+		return 0;
+	}
+
+	if (mlockall(MCL_CURRENT | MCL_FUTURE) != 0) {
+		return -errno;
+	}
+
+#ifdef __PX4_LINUX
+	// keep freed heap memory mapped (and therefore locked), and serve large blocks
+	// from the heap instead of fresh mmaps
+	mallopt(M_TRIM_THRESHOLD, -1);
+	mallopt(M_MMAP_MAX, 0);
+#endif
+
+	if (arena_size > 0) {
+		void *arena = mmap(nullptr, arena_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+
+		if (arena == MAP_FAILED) {
+			int ret = -errno;
+			munlockall();
+			return ret;
+		}
+
+		// MCL_FUTURE already populates the mapping, touching it makes sure of it on every kernel
+		memset(arena, 0, arena_size);
+
+		_arena = (uint8_t *)arena;
+		_arena_size = arena_size;
+	}
+
+	_enabled = true;
+	return 0;
+}
+
+bool px4_rt_memory_enabled()
+{
+	return _enabled;
+}
+
+void *px4_rt_memory_alloc(size_t size)
+{
+	if (_arena != nullptr) {
+		const size_t aligned_size = (size + alignof(max_align_t) - 1) & ~(alignof(max_align_t) - 1);
+		arena_block_s *block = nullptr;
+
+		pthread_mutex_lock(&_arena_mutex);
+
+		// best fit from the freed blocks first
+		arena_block_s **best = nullptr;
+
+		for (arena_block_s **prev = &_arena_free_list; *prev != nullptr; prev = &(*prev)->next_free) {
+			if ((*prev)->size >= aligned_size && (best == nullptr || (*prev)->size < (*best)->size)) {
+				best = prev;
+			}
+		}
+
+		if (best != nullptr) {
+			block = *best;
+			*best = block->next_free;
+			_arena_free -= block->size;
+
+		} else if (_arena_used + sizeof(arena_block_s) + aligned_size <= _arena_size) {
+			block = (arena_block_s *)(_arena + _arena_used);
+			block->size = aligned_size;
+			_arena_used += sizeof(arena_block_s) + aligned_size;
+
+		} else {
+			_arena_fallbacks++;
+		}
+
+		pthread_mutex_unlock(&_arena_mutex);
+
+		if (block != nullptr) {
+			return block + 1;
+		}
+	}
+
+	return malloc(size);
+}
+
+void px4_rt_memory_free(void *ptr)
+{
+	if (_arena != nullptr && (uint8_t *)ptr >= _arena && (uint8_t *)ptr < _arena + _arena_size) {
+		arena_block_s *block = (arena_block_s *)ptr - 1;
+
+		pthread_mutex_lock(&_arena_mutex);
+		block->next_free = _arena_free_list;
+		_arena_free_list = block;
+		_arena_free += block->size;
+		pthread_mutex_unlock(&_arena_mutex);
+		return;
+	}
+
+	free(ptr);
+}
+
+void px4_rt_memory_status()
+{
+	if (_enabled) {
+		PX4_INFO("memory locked, arena: %zu of %zu bytes used (%zu in freed blocks), %u allocations from the heap",
+			 _arena_used, _arena_size, _arena_free, _arena_fallbacks);
+
+	} else {
+		PX4_INFO("memory not locked");
+	}
+
+	struct rusage usage;
+
+	if (getrusage(RUSAGE_SELF, &usage) == 0) {
+		PX4_INFO("page faults: %ld major, %ld minor (per task: see top)", usage.ru_majflt, usage.ru_minflt);
+	}
+}
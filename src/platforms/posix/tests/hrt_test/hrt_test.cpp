@@ -45,6 +45,7 @@
 #include "hrt_test.h"
 #include <unistd.h>
 #include <stdio.h>
+#include <pthread.h>
 #include <cstring>
 
 px4::AppState HRTTest::appState;
@@ -63,6 +64,51 @@ static void timer_expired(void *arg)
 	}
 }
 
+static constexpr int BENCHMARK_CALLS = 1000000;
+static constexpr int BENCHMARK_MAX_THREADS = 8;
+
+static void *benchmark_thread(void *arg)
+{
+	hrt_abstime last = 0;
+
+	for (int i = 0; i < BENCHMARK_CALLS; i++) {
+		hrt_abstime now = hrt_absolute_time();
+
+		if (now < last) {
+			PX4_ERR("time went backwards");
+		}
+
+		last = now;
+	}
+
+	return nullptr;
+}
+
+/**
+ * Measure the cost of hrt_absolute_time() with several threads calling it concurrently
+ */
+static void benchmark_absolute_time(int num_threads)
+{
+	pthread_t threads[BENCHMARK_MAX_THREADS];
+	struct timespec start, end;
+
+	clock_gettime(CLOCK_MONOTONIC, &start);
+
+	for (int i = 0; i < num_threads; i++) {
+		pthread_create(&threads[i], nullptr, benchmark_thread, nullptr);
+	}
+
+	for (int i = 0; i < num_threads; i++) {
+		pthread_join(threads[i], nullptr);
+	}
+
+	clock_gettime(CLOCK_MONOTONIC, &end);
+
+	double elapsed_ns = (end.tv_sec - start.tv_sec) * 1e9 + (end.tv_nsec - start.tv_nsec);
+	PX4_INFO("hrt_absolute_time: %d threads: %.1f ns per call (wall time per thread)", num_threads,
+		 elapsed_ns / BENCHMARK_CALLS);
+}
+
 int HRTTest::main()
 {
 	appState.setRunning(true);
@@ -89,5 +135,9 @@ int HRTTest::main()
 	hrt_cancel(&t1);
 	PX4_INFO("HRT_CALL + %d\n", hrt_called(&t1));
 
+	for (int num_threads = 1; num_threads <= BENCHMARK_MAX_THREADS; num_threads *= 2) {
+		benchmark_absolute_time(num_threads);
+	}
+
 	return 0;
 }
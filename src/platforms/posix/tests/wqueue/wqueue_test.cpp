@@ -41,6 +41,7 @@
 
 #include <px4_time.h>
 #include <px4_workqueue.h>
+#include <px4_log.h>
 #include "wqueue_test.h"
 #include <unistd.h>
 #include <stdio.h>
@@ -90,6 +91,127 @@ void WQueueTest::do_hp_work()
 	work_queue(HPWORK, &_hpwork, (worker_t)&hp_worker_cb, this, 1000);
 }
 
+void WQueueTest::jitter_record(JitterItem *item, hrt_abstime now)
+{
+	uint64_t late = (now > item->expected) ? now - item->expected : 0;
+
+	item->late_sum += late;
+
+	if (late > item->late_max) {
+		item->late_max = late;
+	}
+
+	++item->count;
+}
+
+void WQueueTest::jitter_work_cb(void *p)
+{
+	JitterItem *item = (JitterItem *)p;
+	hrt_abstime now = hrt_absolute_time();
+
+	jitter_record(item, now);
+
+	if (item->stop) {
+		return;
+	}
+
+	item->expected = now + item->period;
+	work_queue(HPWORK, &item->work, (worker_t)&jitter_work_cb, item, USEC2TICK(item->period));
+}
+
+void WQueueTest::jitter_hrt_cb(void *p)
+{
+	JitterItem *item = (JitterItem *)p;
+
+	jitter_record(item, hrt_absolute_time());
+
+	/* hrt_call_every() does not drift, the next call is one period later */
+	item->expected += item->period;
+}
+
+void WQueueTest::jitter_report(const char *name, JitterItem *items)
+{
+	uint64_t late_sum = 0;
+	uint64_t late_max = 0;
+	unsigned count = 0;
+
+	for (unsigned i = 0; i < JITTER_ITEMS; i++) {
+		late_sum += items[i].late_sum;
+		count += items[i].count;
+
+		if (items[i].late_max > late_max) {
+			late_max = items[i].late_max;
+		}
+	}
+
+	PX4_INFO("%s: %u items, %u runs, lateness mean %llu us, max %llu us", name, JITTER_ITEMS, count,
+		 (unsigned long long)(count > 0 ? late_sum / count : 0), (unsigned long long)late_max);
+}
+
+/*
+ * Wakeup jitter with JITTER_ITEMS periodic items on the HP work queue and as
+ * many hrt_call_every() callouts, measured as the time between when each run
+ * was due and when it actually ran.
+ */
+void WQueueTest::jitter_benchmark()
+{
+	JitterItem *items = new JitterItem[JITTER_ITEMS];
+
+	if (items == nullptr) {
+		PX4_ERR("alloc failed");
+		return;
+	}
+
+	memset(items, 0, sizeof(JitterItem) * JITTER_ITEMS);
+
+	for (unsigned i = 0; i < JITTER_ITEMS; i++) {
+		items[i].period = (i % 8 + 1) * USEC_PER_TICK;
+		items[i].expected = hrt_absolute_time() + items[i].period;
+		work_queue(HPWORK, &items[i].work, (worker_t)&jitter_work_cb, &items[i], USEC2TICK(items[i].period));
+	}
+
+	sleep(5);
+
+	/*
+	 * The callback re-queues itself, so a cancel can race with a running callback.
+	 * Stop the re-queueing first and wait until every item has run once more
+	 * before cancelling, the items must not be linked into the queue when they are
+	 * cleared or freed below.
+	 */
+	for (unsigned i = 0; i < JITTER_ITEMS; i++) {
+		items[i].stop = true;
+	}
+
+	usleep(2 * 8 * USEC_PER_TICK + 10000);
+
+	for (unsigned i = 0; i < JITTER_ITEMS; i++) {
+		work_cancel(HPWORK, &items[i].work);
+	}
+
+	jitter_report("work_queue", items);
+
+	memset(items, 0, sizeof(JitterItem) * JITTER_ITEMS);
+
+	for (unsigned i = 0; i < JITTER_ITEMS; i++) {
+		items[i].period = 1000 + (i % 8) * 250;
+		items[i].expected = hrt_absolute_time() + items[i].period;
+		hrt_call_every(&items[i].call, items[i].period, items[i].period, (hrt_callout)&jitter_hrt_cb, &items[i]);
+	}
+
+	sleep(5);
+
+	for (unsigned i = 0; i < JITTER_ITEMS; i++) {
+		hrt_cancel(&items[i].call);
+	}
+
+	/* let a callout which was already running when it got cancelled finish */
+	usleep(2 * (1000 + 7 * 250));
+
+	jitter_report("hrt_call", items);
+
+	delete[] items;
+}
+
 int WQueueTest::main()
 {
 	appState.setRunning(true);
@@ -108,5 +230,7 @@ int WQueueTest::main()
 		sleep(2);
 	}
 
+	jitter_benchmark();
+
 	return 0;
 }
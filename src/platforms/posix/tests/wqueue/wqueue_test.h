@@ -41,6 +41,7 @@
 
 #include <px4_app.h>
 #include <px4_workqueue.h>
+#include <drivers/drv_hrt.h>
 #include <string.h>
 
 class WQueueTest
@@ -60,12 +61,32 @@ public:
 
 	static px4::AppState appState; /* track requests to terminate app */
 private:
+	/* number of periodic items used by the jitter benchmark */
+	static constexpr unsigned JITTER_ITEMS = 128;
+
+	struct JitterItem {
+		work_s work;
+		struct hrt_call call;
+		uint64_t period;        /* period in us */
+		hrt_abstime expected;   /* time the next run is due */
+		uint64_t late_sum;
+		uint64_t late_max;
+		unsigned count;
+		volatile bool stop;     /* set to stop the callback from re-queueing itself */
+	};
+
 	static void hp_worker_cb(void *p);
 	static void lp_worker_cb(void *p);
+	static void jitter_work_cb(void *p);
+	static void jitter_hrt_cb(void *p);
 
 	void do_lp_work(void);
 	void do_hp_work(void);
 
+	void jitter_benchmark(void);
+	static void jitter_record(JitterItem *item, hrt_abstime now);
+	static void jitter_report(const char *name, JitterItem *items);
+
 	bool _lpwork_done;
 	bool _hpwork_done;
 	work_s _lpwork;
@@ -51,6 +51,7 @@
 #include <px4_workqueue.h>
 #include <px4_posix.h>
 #include "hrt_work.h"
+#include "work_sched.h"
 
 /****************************************************************************
  * Pre-processor Definitions
@@ -113,6 +114,7 @@ int hrt_work_queue(struct work_s *work, worker_t worker, void *arg, uint32_t del
 	work->worker = worker;           /* Work callback */
 	work->arg    = arg;              /* Callback argument */
 	work->delay  = delay;            /* Delay until work performed */
+	work->ns     = px4_get_namespace(); /* Namespace to run in */
 
 	/* Now, time-tag that entry and put it in the work queue.  This must be
 	 * done with interrupts disabled.  This permits this function to be called
@@ -120,18 +122,15 @@ int hrt_work_queue(struct work_s *work, worker_t worker, void *arg, uint32_t del
 	 */
 
 	hrt_work_lock();
-	work->qtime  = hrt_absolute_time(); /* Time work queued */
+	work->qtime    = hrt_absolute_time(); /* Time work queued */
+	work->deadline = work->qtime + delay;
 	//PX4_INFO("hrt work_queue adding work delay=%u time=%lu", delay, work->qtime);
 
-	dq_addlast((dq_entry_t *)work, &wqueue->q);
-
-	if (px4_getpid() != wqueue->pid) { /* only need to wake up if called from a different thread */
-#ifdef __PX4_QURT
-		px4_task_kill(wqueue->pid, SIGALRM);      /* Wake up the worker thread */
-#else
-		//wqueue->pid == own task? -> don't signal
-		px4_task_kill(wqueue->pid, SIGCONT);      /* Wake up the worker thread */
-#endif
+	/* only need to wake up if the work is now due earlier and if called from a
+	 * different thread (the worker looks at the queue head again after each item)
+	 */
+	if (work_insert_sorted(&wqueue->q, work) && px4_getpid() != wqueue->pid) {
+		work_wakeup(&_hrt_work_wake, wqueue->pid);
 	}
 
 	hrt_work_unlock();
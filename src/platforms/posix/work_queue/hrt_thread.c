@@ -50,6 +50,7 @@
 #include <px4_workqueue.h>
 #include <drivers/drv_hrt.h>
 #include "hrt_work.h"
+#include "work_sched.h"
 
 /****************************************************************************
  * Pre-processor Definitions
@@ -70,6 +71,7 @@ struct wqueue_s g_hrt_work;
  * Private Variables
  ****************************************************************************/
 px4_sem_t _hrt_work_lock;
+px4_sem_t _hrt_work_wake;
 
 /****************************************************************************
  * Private Functions
@@ -116,9 +118,8 @@ static void hrt_work_process()
 	volatile struct work_s *work;
 	worker_t  worker;
 	void *arg;
-	uint64_t elapsed;
-	uint32_t remaining;
-	uint32_t next;
+	int ns;
+	uint64_t next;
 
 	// set the threads name
 #ifdef __PX4_DARWIN
@@ -133,91 +134,74 @@ static void hrt_work_process()
 	 */
 
 	/* Default to sleeping for 1 sec */
-	next  = 1000000;
+	next  = hrt_absolute_time() + 1000000;
 
 	hrt_work_lock();
 
 	work  = (struct work_s *)wqueue->q.head;
 
 	while (work) {
-		/* Is this work ready?  It is ready if there is no delay or if
-		 * the delay has elapsed. qtime is the time that the work was added
-		 * to the work queue.  It will always be greater than or equal to
-		 * zero.  Therefore a delay of zero will always execute immediately.
+		/* Is this work ready?  The queue is sorted by deadline, so if the
+		 * head is not ready, nothing else is either.
 		 */
 
-		elapsed = hrt_absolute_time() - work->qtime;
+		//PX4_INFO("hrt work_process: deadline=%lu work=%p", work->deadline, work);
+		if (work->deadline > hrt_absolute_time()) {
+			/* Schedule to wake up exactly when the work is ready */
 
-		//PX4_INFO("hrt work_process: in usec elapsed=%lu delay=%u work=%p", elapsed, work->delay, work);
-		if (elapsed >= work->delay) {
-			/* Remove the ready-to-execute work from the list */
-
-			(void)dq_rem((struct dq_entry_s *) & (work->dq), &(wqueue->q));
-			//PX4_INFO("Dequeued work=%p", work);
+			if (work->deadline < next) {
+				next = work->deadline;
+			}
 
-			/* Extract the work description from the entry (in case the work
-			 * instance by the re-used after it has been de-queued).
-			 */
+			break;
+		}
 
-			worker = work->worker;
-			arg    = work->arg;
+		/* Remove the ready-to-execute work from the list */
 
-			/* Mark the work as no longer being queued */
+		(void)dq_rem((struct dq_entry_s *) & (work->dq), &(wqueue->q));
+		//PX4_INFO("Dequeued work=%p", work);
 
-			work->worker = NULL;
+		/* Extract the work description from the entry (in case the work
+		 * instance by the re-used after it has been de-queued).
+		 */
 
-			/* Do the work.  Re-enable interrupts while the work is being
-			 * performed... we don't have any idea how long that will take!
-			 */
+		worker = work->worker;
+		arg    = work->arg;
+		ns     = work->ns;
 
-			hrt_work_unlock();
+		/* Mark the work as no longer being queued */
 
-			if (!worker) {
-				PX4_ERR("MESSED UP: worker = 0");
-				PX4_BACKTRACE();
+		work->worker = NULL;
 
-			} else {
-				worker(arg);
-			}
+		/* Do the work.  Re-enable interrupts while the work is being
+		 * performed... we don't have any idea how long that will take!
+		 */
 
-			/* Now, unfortunately, since we re-enabled interrupts we don't
-			 * know the state of the work list and we will have to start
-			 * back at the head of the list.
-			 */
+		hrt_work_unlock();
 
-			hrt_work_lock();
-			work  = (struct work_s *)wqueue->q.head;
+		if (!worker) {
+			PX4_ERR("MESSED UP: worker = 0");
+			PX4_BACKTRACE();
 
 		} else {
-			/* This one is not ready.. will it be ready before the next
-			 * scheduled wakeup interval?
-			 */
-
-			/* Here: elapsed < work->delay */
-			remaining = work->delay - elapsed;
-
-			//PX4_INFO("remaining=%u delay=%u elapsed=%lu", remaining, work->delay, elapsed);
-			if (remaining < next) {
-				/* Yes.. Then schedule to wake up when the work is ready */
-
-				next = remaining;
-			}
+			px4_set_namespace(ns);
+			worker(arg);
+		}
 
-			/* Then try the next in the list. */
+		/* Since we re-enabled interrupts the head of the list may have
+		 * changed, so look at it again.
+		 */
 
-			work = (struct work_s *)work->dq.flink;
-			//PX4_INFO("next %u work %p", next, work);
-		}
+		hrt_work_lock();
+		work  = (struct work_s *)wqueue->q.head;
 	}
 
-	/* Wait awhile to check the work list.  We will wait here until either
-	 * the time elapses or until we are awakened by a signal.
+	/* Wait to check the work list.  We will wait here until either the next
+	 * deadline is reached or until new work is queued ahead of it.
 	 */
 	hrt_work_unlock();
 
-	/* might sleep less if a signal received and new item was queued */
-	//PX4_INFO("Sleeping for %u usec", next);
-	usleep(next);
+	work_wait_until(&_hrt_work_wake, next);
 }
 
 /****************************************************************************
@@ -274,6 +258,7 @@ static int work_hrtthread(int argc, char *argv[])
 void hrt_work_queue_init(void)
 {
 	px4_sem_init(&_hrt_work_lock, 0, 1);
+	px4_sem_init(&_hrt_work_wake, 0, 0);
 	memset(&g_hrt_work, 0, sizeof(g_hrt_work));
 
 	// Create high priority worker thread
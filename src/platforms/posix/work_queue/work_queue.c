@@ -47,7 +47,9 @@
 #include <queue.h>
 #include <stdio.h>
 #include <semaphore.h>
+#include <drivers/drv_hrt.h>
 #include "work_lock.h"
+#include "work_sched.h"
 
 #ifdef CONFIG_SCHED_WORKQUEUE
 
@@ -115,6 +117,7 @@ int work_queue(int qid, struct work_s *work, worker_t worker, void *arg, uint32_
 	work->worker = worker;           /* Work callback */
 	work->arg    = arg;              /* Callback argument */
 	work->delay  = delay;            /* Delay until work performed */
+	work->ns     = px4_get_namespace(); /* Namespace to run in */
 
 	/* Now, time-tag that entry and put it in the work queue.  This must be
 	 * done with interrupts disabled.  This permits this function to be called
@@ -122,14 +125,14 @@ int work_queue(int qid, struct work_s *work, worker_t worker, void *arg, uint32_
 	 */
 
 	work_lock(qid);
-	work->qtime  = clock_systimer(); /* Time work queued */
-
-	dq_addlast((dq_entry_t *)work, &wqueue->q);
-#ifdef __PX4_QURT
-	px4_task_kill(wqueue->pid, SIGALRM);      /* Wake up the worker thread */
-#else
-	px4_task_kill(wqueue->pid, SIGCONT);      /* Wake up the worker thread */
-#endif
+	work->qtime    = hrt_absolute_time(); /* Time work queued */
+	work->deadline = work->qtime + (uint64_t)delay * USEC_PER_TICK;
+
+	/* The worker only needs waking if it is now due earlier */
+
+	if (work_insert_sorted(&wqueue->q, work)) {
+		work_wakeup(&_work_wake[qid], wqueue->pid);
+	}
 
 	work_unlock(qid);
 	return PX4_OK;
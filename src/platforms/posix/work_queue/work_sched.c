@@ -0,0 +1,127 @@
+/****************************************************************************
+ *
+ *   Copyright (C) 2017 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/**
+ * @file work_sched.c
+ *
+ * Deadline ordering and timed wakeup shared by the POSIX work queues.
+ *
+ * The queues are kept sorted by deadline so that the worker threads only ever
+ * have to look at the head of the queue, and they sleep on a semaphore with a
+ * timeout of exactly the next deadline instead of a usleep() that has to be
+ * interrupted by a signal when new work arrives.
+ */
+
+#include <px4_time.h>
+#include <px4_tasks.h>
+#include <drivers/drv_hrt.h>
+#include <queue.h>
+#include <errno.h>
+#include <signal.h>
+#include <unistd.h>
+#include "work_sched.h"
+
+bool work_insert_sorted(struct dq_queue_s *queue, struct work_s *work)
+{
+	dq_entry_t *node = (dq_entry_t *)work;
+	dq_entry_t *prev = queue->tail;
+
+	/* Periodic work is requeued with the latest deadline most of the time,
+	 * so search from the tail: this is O(1) in the common case.
+	 */
+	while (prev && ((struct work_s *)prev)->deadline > work->deadline) {
+		prev = prev->blink;
+	}
+
+	if (prev) {
+		node->flink = prev->flink;
+		node->blink = prev;
+
+		if (prev->flink) {
+			prev->flink->blink = node;
+
+		} else {
+			queue->tail = node;
+		}
+
+		prev->flink = node;
+		return false;
+	}
+
+	node->blink = NULL;
+	node->flink = queue->head;
+
+	if (queue->head) {
+		queue->head->blink = node;
+
+	} else {
+		queue->tail = node;
+	}
+
+	queue->head = node;
+	return true;
+}
+
+void work_wait_until(px4_sem_t *wake, uint64_t deadline)
+{
+#ifdef __PX4_QURT
+	const hrt_abstime now = hrt_absolute_time();
+
+	if (deadline <= now) {
+		return;
+	}
+
+	/* px4_sem_timedwait() is implemented on top of the hrt work queue on QuRT,
+	 * so it cannot be used by the work queues themselves.
+	 */
+	(void)wake;
+	usleep(deadline - now);
+#else
+	/* a post means new work was queued ahead of deadline; a timeout that the
+	 * deadline was reached. Either way the caller re-examines its queue head.
+	 * In lockstep mode the deadline is reached when the simulation gets there.
+	 */
+	hrt_lockstep_wait(wake, deadline);
+#endif
+}
+
+void work_wakeup(px4_sem_t *wake, px4_task_t pid)
+{
+#ifdef __PX4_QURT
+	(void)wake;
+	px4_task_kill(pid, SIGALRM);
+#else
+	(void)pid;
+	hrt_lockstep_post(wake);
+#endif
+}
@@ -0,0 +1,72 @@
+/****************************************************************************
+ *
+ *   Copyright (C) 2017 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/**
+ * @file work_sched.h
+ *
+ * Deadline ordering and timed wakeup shared by the POSIX work queues.
+ */
+
+#pragma once
+
+#include <px4_posix.h>
+#include <px4_tasks.h>
+#include <px4_workqueue.h>
+#include <stdint.h>
+
+__BEGIN_DECLS
+
+/* posted to wake up the worker thread of each queue */
+extern px4_sem_t _work_wake[];
+extern px4_sem_t _hrt_work_wake;
+
+/**
+ * Insert work into queue, keeping the queue sorted by work->deadline.
+ * Work with equal deadlines runs in the order it was queued.
+ * Must be called with the queue lock held.
+ *
+ * @return true if work is now at the head of the queue
+ */
+bool work_insert_sorted(struct dq_queue_s *queue, struct work_s *work);
+
+/**
+ * Block on wake until it is posted or until the hrt time deadline is reached.
+ */
+void work_wait_until(px4_sem_t *wake, uint64_t deadline);
+
+/**
+ * Wake up the worker thread pid blocked in work_wait_until() on wake.
+ */
+void work_wakeup(px4_sem_t *wake, px4_task_t pid);
+
+__END_DECLS
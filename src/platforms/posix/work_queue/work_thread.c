@@ -50,6 +50,7 @@
 #include <pthread.h>
 #include <drivers/drv_hrt.h>
 #include "work_lock.h"
+#include "work_sched.h"
 
 #ifdef CONFIG_SCHED_WORKQUEUE
 
@@ -72,6 +73,7 @@ struct wqueue_s g_work[NWORKERS];
  * Private Variables
  ****************************************************************************/
 px4_sem_t _work_lock[NWORKERS];
+px4_sem_t _work_wake[NWORKERS];
 
 /****************************************************************************
  * Private Functions
@@ -96,93 +98,78 @@ static void work_process(struct wqueue_s *wqueue, int lock_id)
 	volatile struct work_s *work;
 	worker_t  worker;
 	void *arg;
-	uint64_t elapsed;
-	uint32_t remaining;
-	uint32_t next;
+	int ns;
+	uint64_t next;
 
 	/* Then process queued work.  We need to keep interrupts disabled while
 	 * we process items in the work list.
 	 */
 
-	next  = CONFIG_SCHED_WORKPERIOD;
+	next  = hrt_absolute_time() + CONFIG_SCHED_WORKPERIOD;
 
 	work_lock(lock_id);
 
 	work  = (struct work_s *)wqueue->q.head;
 
 	while (work) {
-		/* Is this work ready?  It is ready if there is no delay or if
-		 * the delay has elapsed. qtime is the time that the work was added
-		 * to the work queue.  It will always be greater than or equal to
-		 * zero.  Therefore a delay of zero will always execute immediately.
+		/* Is this work ready?  The queue is sorted by deadline, so if the
+		 * head is not ready, nothing else is either.
 		 */
 
-		elapsed = USEC2TICK(clock_systimer() - work->qtime);
+		if (work->deadline > hrt_absolute_time()) {
+			/* Schedule to wake up exactly when the work is ready */
 
-		//printf("work_process: in ticks elapsed=%lu delay=%u\n", elapsed, work->delay);
-		if (elapsed >= work->delay) {
-			/* Remove the ready-to-execute work from the list */
-
-			(void)dq_rem((struct dq_entry_s *)work, &wqueue->q);
+			if (work->deadline < next) {
+				next = work->deadline;
+			}
 
-			/* Extract the work description from the entry (in case the work
-			 * instance by the re-used after it has been de-queued).
-			 */
+			break;
+		}
 
-			worker = work->worker;
-			arg    = work->arg;
+		/* Remove the ready-to-execute work from the list */
 
-			/* Mark the work as no longer being queued */
+		(void)dq_rem((struct dq_entry_s *)work, &wqueue->q);
 
-			work->worker = NULL;
+		/* Extract the work description from the entry (in case the work
+		 * instance by the re-used after it has been de-queued).
+		 */
 
-			/* Do the work.  Re-enable interrupts while the work is being
-			 * performed... we don't have any idea how long that will take!
-			 */
+		worker = work->worker;
+		arg    = work->arg;
+		ns     = work->ns;
 
-			work_unlock(lock_id);
+		/* Mark the work as no longer being queued */
 
-			if (!worker) {
-				PX4_WARN("MESSED UP: worker = 0\n");
+		work->worker = NULL;
 
-			} else {
-				worker(arg);
-			}
+		/* Do the work.  Re-enable interrupts while the work is being
+		 * performed... we don't have any idea how long that will take!
+		 */
 
-			/* Now, unfortunately, since we re-enabled interrupts we don't
-			 * know the state of the work list and we will have to start
-			 * back at the head of the list.
-			 */
+		work_unlock(lock_id);
 
-			work_lock(lock_id);
-			work  = (struct work_s *)wqueue->q.head;
+		if (!worker) {
+			PX4_WARN("MESSED UP: worker = 0\n");
 
 		} else {
-			/* This one is not ready.. will it be ready before the next
-			 * scheduled wakeup interval?
-			 */
-
-			/* Here: elapsed < work->delay */
-			remaining = USEC_PER_TICK * (work->delay - elapsed);
-
-			if (remaining < next) {
-				/* Yes.. Then schedule to wake up when the work is ready */
-
-				next = remaining;
-			}
+			px4_set_namespace(ns);
+			worker(arg);
+		}
 
-			/* Then try the next in the list. */
+		/* Since we re-enabled interrupts the head of the list may have
+		 * changed, so look at it again.
+		 */
 
-			work = (struct work_s *)work->dq.flink;
-		}
+		work_lock(lock_id);
+		work  = (struct work_s *)wqueue->q.head;
 	}
 
-	/* Wait awhile to check the work list.  We will wait here until either
-	 * the time elapses or until we are awakened by a signal.
+	/* Wait to check the work list.  We will wait here until either the next
+	 * deadline is reached or until new work is queued ahead of it.
 	 */
 	work_unlock(lock_id);
 
-	usleep(next);
+	work_wait_until(&_work_wake[lock_id], next);
 }
 
 /****************************************************************************
@@ -192,8 +179,11 @@ void work_queues_init(void)
 {
 	px4_sem_init(&_work_lock[HPWORK], 0, 1);
 	px4_sem_init(&_work_lock[LPWORK], 0, 1);
+	px4_sem_init(&_work_wake[HPWORK], 0, 0);
+	px4_sem_init(&_work_wake[LPWORK], 0, 0);
 #ifdef CONFIG_SCHED_USRWORK
 	px4_sem_init(&_work_lock[USRWORK], 0, 1);
+	px4_sem_init(&_work_wake[USRWORK], 0, 0);
 #endif
 
 	// Create high priority worker thread
@@ -54,16 +54,89 @@
  * There could be one mutex per module instantiation, but to reduce the memory footprint
  * there is only a single global mutex. This sounds bad, but we actually don't expect
  * contention here, as module startup is sequential.
+ * On POSIX the startup can be parallel (px4 -p), so there each module has its own mutex.
  */
 extern pthread_mutex_t px4_modules_mutex;
 
+#ifdef __PX4_POSIX
+
+/**
+ * Start dependencies of a module, used by the parallel startup on POSIX (px4 -p):
+ * the start command of a module with a declaration runs concurrently with the
+ * surrounding commands, once the start commands of the modules it depends on
+ * (if they are part of the startup script) returned. All other commands run
+ * sequentially. Declare with PX4_MODULE_DEPENDENCIES().
+ */
+class ModuleDependencies
+{
+public:
+	/**
+	 * @param module command name of the module
+	 * @param depends_on space-separated command names of the modules it depends on (can be empty)
+	 */
+	ModuleDependencies(const char *module, const char *depends_on);
+
+	/**
+	 * Find the declaration of a module.
+	 * @return nullptr if the module does not declare its dependencies
+	 */
+	static const ModuleDependencies *find(const char *module);
+
+	const char *module() const { return _module; }
+	const char *depends_on() const { return _depends_on; }
+
+private:
+	const char *_module;
+	const char *_depends_on;
+	const ModuleDependencies *_next;
+
+	static const ModuleDependencies *_first;
+};
+
+#define PX4_MODULE_DEPENDENCIES(module_name, depends_on) \
+	static const ModuleDependencies __module_dependencies_##module_name(#module_name, depends_on)
+
+#else
+#define PX4_MODULE_DEPENDENCIES(module_name, depends_on)
+#endif /* __PX4_POSIX */
+
+/**
+ * Static module state with a separate value for each namespace (see px4_get_namespace()).
+ * Reads and writes access the value of the calling thread's namespace.
+ */
+template<typename V>
+class ModuleNamespaceData
+{
+public:
+	explicit ModuleNamespaceData(V init)
+	{
+		for (auto &value : _values) {
+			value = init;
+		}
+	}
+
+	operator V() const { return _values[px4_get_namespace()]; }
+
+	V operator->() const { return _values[px4_get_namespace()]; }
+
+	ModuleNamespaceData &operator=(V value)
+	{
+		_values[px4_get_namespace()] = value;
+		return *this;
+	}
+
+private:
+	volatile V _values[PX4_MAX_NAMESPACES];
+};
+
 /**
  ** class ModuleBase
  *
  * Base class for modules, implementing common functionality, such as 'start',
  * 'stop' and 'status' commands.
  * Currently does not support modules which allow multiple instances, such as
- * mavlink.
+ * mavlink, but a module runs once per namespace: its instance and task are
+ * looked up in the namespace of the calling thread.
  *
  * The class is implemented as curiously recurring template pattern (CRTP). It
  * allows to have a static object in the base class that is different for
@@ -348,9 +421,9 @@ protected:
 		return (T *)_object;
 	}
 
-	// there will be one instance for each template type
-	static volatile T *_object; ///< instance if the module is running
-	static int _task_id;        ///< task handle: -1 = invalid, otherwise task is assumed to be running
+	// there will be one instance for each template type (and namespace)
+	static ModuleNamespaceData<T *> _object; ///< instance if the module is running
+	static ModuleNamespaceData<int> _task_id; ///< task handle: -1 = invalid, otherwise task is assumed to be running
 
 	static constexpr const int task_id_is_work_queue = -2; ///< special value if task runs on the work queue
 
@@ -358,15 +431,27 @@ private:
 
 	volatile bool _task_should_exit = false;
 
+#ifdef __PX4_POSIX
+	static pthread_mutex_t _module_mutex;
+
+	static void lock_module() { pthread_mutex_lock(&_module_mutex); }
+	static void unlock_module() { pthread_mutex_unlock(&_module_mutex); }
+#else
 	static void lock_module() { pthread_mutex_lock(&px4_modules_mutex); }
 	static void unlock_module() { pthread_mutex_unlock(&px4_modules_mutex); }
+#endif
 };
 
 template<class T>
-volatile T *ModuleBase<T>::_object = nullptr;
+ModuleNamespaceData<T *> ModuleBase<T>::_object(nullptr);
 
 template<class T>
-int ModuleBase<T>::_task_id = -1;
+ModuleNamespaceData<int> ModuleBase<T>::_task_id(-1);
+
+#ifdef __PX4_POSIX
+template<class T>
+pthread_mutex_t ModuleBase<T>::_module_mutex = PTHREAD_MUTEX_INITIALIZER;
+#endif
 
 
 #endif /* __cplusplus */
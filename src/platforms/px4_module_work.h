@@ -0,0 +1,203 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2017 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+
+/**
+ * @file px4_module_work.h
+ */
+
+#pragma once
+
+#include <px4_config.h>
+#include <px4_module.h>
+#include <px4_workqueue.h>
+#include <drivers/drv_hrt.h>
+
+#ifdef __cplusplus
+
+/**
+ ** class ModuleWorkItem
+ *
+ * ModuleBase variant for modules that run on a work queue instead of in their own
+ * thread. The module implements cycle(), which is called on the work queue thread
+ * periodically (see set_interval()) and each time schedule() is called.
+ *
+ * cycle() must not block: modules that wait on I/O or sleep in their loop (e.g.
+ * commander, navigator, logger) keep their own thread.
+ *
+ * Required methods for a derived class:
+ * - custom_command & print_usage as for ModuleBase
+	static T *instantiate(int argc, char *argv[]) {
+		// this is called from task_spawn(), in the context of the 'start' command
+		// parse the arguments, create a new object T, subscribe, call set_interval()
+		// & return it
+		// or return nullptr on error
+	}
+	void cycle() override {
+		// check/copy topics and do the work, must not block
+	}
+ */
+template<class T>
+class ModuleWorkItem : public ModuleBase<T>
+{
+public:
+	/**
+	 * @param queue work queue to run on (HPWORK or LPWORK)
+	 */
+	ModuleWorkItem(int queue) :
+		_queue(queue)
+	{
+#ifndef __PX4_NUTTX
+		pthread_mutex_init(&_schedule_mutex, nullptr);
+#endif
+	}
+
+	virtual ~ModuleWorkItem()
+	{
+		work_cancel(_queue, &_work);
+#ifndef __PX4_NUTTX
+		pthread_mutex_destroy(&_schedule_mutex);
+#endif
+	}
+
+	/**
+	 * Create the object from the 'start' command and schedule its first cycle.
+	 */
+	static int task_spawn(int argc, char *argv[])
+	{
+		T *object = T::instantiate(argc, argv);
+
+		if (object == nullptr) {
+			PX4_ERR("start failed");
+			return -1;
+		}
+
+		ModuleBase<T>::_object = object;
+		ModuleBase<T>::_task_id = ModuleBase<T>::task_id_is_work_queue;
+
+		object->schedule(0);
+		return 0;
+	}
+
+	/** @see ModuleBase::request_stop(), run a cycle so the module can exit without waiting for the interval */
+	void request_stop() override
+	{
+		ModuleBase<T>::request_stop();
+		schedule(0);
+	}
+
+protected:
+
+	/**
+	 * Called on the work queue each time the module is scheduled.
+	 */
+	virtual void cycle() = 0;
+
+	/**
+	 * Schedule cycle() every interval_us after the end of the previous cycle.
+	 * 0 disables periodic scheduling.
+	 */
+	void set_interval(uint32_t interval_us) { _interval = interval_us; }
+
+	/**
+	 * Schedule cycle() to run after delay_us, unless it is already scheduled to run earlier.
+	 * This can be called from any thread (and from interrupt context on NuttX).
+	 */
+	void schedule(uint32_t delay_us)
+	{
+		const hrt_abstime deadline = hrt_absolute_time() + delay_us;
+
+		lock_schedule();
+
+		if (_scheduled_deadline == 0 || deadline < _scheduled_deadline) {
+			if (_scheduled_deadline != 0) {
+				work_cancel(_queue, &_work);
+			}
+
+			_scheduled_deadline = deadline;
+			work_queue(_queue, &_work, (worker_t)&ModuleWorkItem::cycle_trampoline, this, USEC2TICK(delay_us));
+		}
+
+		unlock_schedule();
+	}
+
+private:
+
+	static void cycle_trampoline(void *arg)
+	{
+		ModuleWorkItem *item = reinterpret_cast<ModuleWorkItem *>(arg);
+		item->run_cycle();
+	}
+
+	void run_cycle()
+	{
+		lock_schedule();
+		_scheduled_deadline = 0;
+		unlock_schedule();
+
+		if (this->should_exit()) {
+			ModuleBase<T>::exit_and_cleanup();
+			return;
+		}
+
+		cycle();
+
+		if (this->should_exit()) {
+			ModuleBase<T>::exit_and_cleanup();
+			return;
+		}
+
+		if (_interval > 0) {
+			schedule(_interval);
+		}
+	}
+
+#ifdef __PX4_NUTTX
+	void lock_schedule() { _schedule_flags = px4_enter_critical_section(); }
+	void unlock_schedule() { px4_leave_critical_section(_schedule_flags); }
+
+	irqstate_t _schedule_flags{0};
+#else
+	void lock_schedule() { pthread_mutex_lock(&_schedule_mutex); }
+	void unlock_schedule() { pthread_mutex_unlock(&_schedule_mutex); }
+
+	pthread_mutex_t _schedule_mutex;
+#endif
+
+	const int _queue;
+	struct work_s _work {};
+	uint32_t _interval{0};
+	hrt_abstime _scheduled_deadline{0}; ///< 0 if not queued
+};
+
+#endif /* __cplusplus */
@@ -77,6 +77,7 @@ typedef struct pollfd px4_pollfd_struct_t;
 #define px4_fsync 	_GLOBAL fsync
 #define px4_access 	_GLOBAL access
 #define px4_getpid 	_GLOBAL getpid
+#define px4_usleep 	_GLOBAL usleep
 
 #define  PX4_STACK_OVERHEAD	0
 
@@ -111,6 +112,7 @@ __EXPORT int		px4_poll(px4_pollfd_struct_t *fds, nfds_t nfds, int timeout);
 __EXPORT int		px4_fsync(int fd);
 __EXPORT int		px4_access(const char *pathname, int mode);
 __EXPORT px4_task_t	px4_getpid(void);
+__EXPORT int		px4_usleep(useconds_t usec);
 
 __EXPORT void		px4_enable_sim_lockstep(void);
 __EXPORT void		px4_sim_start_delay(void);
@@ -0,0 +1,86 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2017 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/**
+ * @file px4_rt_memory.h
+ *
+ * Memory setup for real-time operation on Linux: locked and pre-faulted memory,
+ * and a pre-touched arena for buffers that are allocated while the system is running
+ * (e.g. uORB queues on first publication).
+ */
+
+#pragma once
+
+#include <px4_defines.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdlib.h>
+
+/** default size of the pre-touched arena */
+#define PX4_RT_MEMORY_ARENA_SIZE	(2 * 1024 * 1024)
+
+__BEGIN_DECLS
+
+#if defined(__PX4_POSIX) && !defined(__PX4_QURT)
+
+/**
+ * Lock all current and future memory of the process (mlockall), stop the heap from
+ * being returned to the OS, and map and touch an arena of arena_size bytes.
+ * The stacks of tasks spawned afterwards are locked, and thus pre-faulted, by the kernel.
+ * @return 0 on success, -errno otherwise (mlockall needs CAP_IPC_LOCK or a large enough RLIMIT_MEMLOCK)
+ */
+__EXPORT int px4_rt_memory_init(size_t arena_size);
+
+/** true if px4_rt_memory_init() succeeded */
+__EXPORT bool px4_rt_memory_enabled(void);
+
+/**
+ * Allocate from the arena if enabled, otherwise (or if the arena is exhausted) from the heap.
+ * Blocks returned to the arena are reused for allocations of the same or a smaller size
+ * (e.g. a topic that is advertised again), they are neither split nor merged.
+ */
+__EXPORT void *px4_rt_memory_alloc(size_t size);
+
+__EXPORT void px4_rt_memory_free(void *ptr);
+
+/** Print the arena usage and the page faults of the process */
+__EXPORT void px4_rt_memory_status(void);
+
+#else
+
+static inline void *px4_rt_memory_alloc(size_t size) { return malloc(size); }
+static inline void px4_rt_memory_free(void *ptr) { free(ptr); }
+
+#endif
+
+__END_DECLS
@@ -52,6 +52,8 @@
 
 #ifdef __PX4_DARWIN
 
+#include <pthread.h>
+
 __BEGIN_DECLS
 
 typedef struct {
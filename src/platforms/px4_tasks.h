@@ -43,6 +43,8 @@
 #pragma once
 
 #include <stdbool.h>
+#include <stdint.h>
+#include <errno.h>
 
 #ifdef __PX4_ROS
 
@@ -182,10 +184,51 @@ __EXPORT bool px4_task_is_running(const char *taskname);
 #ifdef __PX4_POSIX
 /** set process (and thread) options */
 __EXPORT int px4_prctl(int option, const char *arg2, px4_task_t pid);
+
+/**
+ * Restrict a task to a set of CPUs (bit n = CPU n). Applies to running instances
+ * and to every later spawn of a task with that name. A mask of 0 lifts the restriction.
+ * @return 0 on success, -ENOTSUP if the OS has no thread affinity
+ */
+__EXPORT int px4_task_set_affinity(const char *taskname, uint64_t cpumask);
+
+/**
+ * Restrict all SCHED_FIFO tasks without an explicit affinity to a set of CPUs,
+ * typically the ones isolated from the Linux scheduler (isolcpus=). 0 lifts the restriction.
+ */
+__EXPORT int px4_task_set_rt_affinity(uint64_t cpumask);
+
+/** Show the configured task affinities */
+__EXPORT void px4_task_show_affinity(void);
 #endif
 
 /** return the name of the current task */
 __EXPORT const char *px4_get_taskname(void);
 
+#if defined(__PX4_POSIX) && !defined(__PX4_QURT)
+/**
+ * Number of namespaces. A namespace is an isolated instance of the system (uORB
+ * topics, devices, parameters and modules), so that several vehicles can be
+ * simulated in one process. Namespace 0 is the default.
+ */
+#define PX4_MAX_NAMESPACES 32
+
+/** return the namespace of the calling thread. Tasks and work inherit it from their creator. */
+__EXPORT int px4_get_namespace(void);
+
+/** set the namespace of the calling thread */
+__EXPORT int px4_set_namespace(int ns);
+
+/** pthread_create() for helper threads of a task: the thread runs in the namespace of its creator */
+__EXPORT int px4_pthread_create(pthread_t *thread, const pthread_attr_t *attr, void *(*start_routine)(void *),
+				void *arg);
+#else
+#define PX4_MAX_NAMESPACES 1
+#define px4_pthread_create pthread_create
+
+static inline int px4_get_namespace(void) { return 0; }
+static inline int px4_set_namespace(int ns) { return (ns == 0) ? 0 : -EINVAL; }
+#endif
+
 __END_DECLS
 
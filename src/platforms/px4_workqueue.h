@@ -74,6 +74,8 @@ struct work_s {
 	void *arg;             /* Callback argument */
 	uint64_t  qtime;       /* Time work queued */
 	uint32_t  delay;       /* Delay until work performed */
+	uint64_t  deadline;    /* Absolute time (hrt) the work is due, queues are sorted by it */
+	int       ns;          /* Namespace of the queuing thread, the work runs in it */
 };
 
 /****************************************************************************
@@ -0,0 +1,205 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2017 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/**
+ * @file affinity.cpp
+ * Place tasks on CPUs (POSIX only)
+ */
+
+#include <px4_config.h>
+#include <px4_log.h>
+#include <px4_module.h>
+#include <px4_tasks.h>
+
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+__EXPORT int affinity_main(int argc, char *argv[]);
+
+static void print_usage(void)
+{
+	PRINT_MODULE_DESCRIPTION(
+		R"DESCR_STR(
+### Description
+Pin tasks to a set of CPUs on multi-core Linux targets. Rules apply to tasks already running and to
+tasks started later, so they are usually given at the top of the startup script, either inline or
+through a file with one `<task> <cpus>` line per task (`rt <cpus>` sets the SCHED_FIFO default).
+
+CPU lists use the kernel notation, e.g. `2`, `2-3` or `0,2-3`. `none` removes a restriction.
+
+### Examples
+Move all realtime tasks to the cores isolated with `isolcpus=2,3`, and keep the log writer off them:
+$ affinity rt 2-3
+$ affinity set log_writer_file 0-1
+)DESCR_STR");
+
+	PRINT_MODULE_USAGE_NAME_SIMPLE("affinity", "command");
+	PRINT_MODULE_USAGE_COMMAND_DESCR("set", "Pin a task: <task> <cpus>");
+	PRINT_MODULE_USAGE_COMMAND_DESCR("rt", "Pin all SCHED_FIFO tasks without an explicit rule: <cpus>");
+	PRINT_MODULE_USAGE_COMMAND_DESCR("load", "Load rules from a file: <file>");
+	PRINT_MODULE_USAGE_COMMAND_DESCR("status", "Print the configured rules");
+}
+
+/**
+ * Parse a cpu list ("0,2-3" or "none") into a bit mask.
+ * @return 0 on success, -1 on a malformed list
+ */
+static int parse_cpus(const char *str, uint64_t *mask)
+{
+	*mask = 0;
+
+	if (strcmp(str, "none") == 0) {
+		return 0;
+	}
+
+	while (*str) {
+		char *end;
+		long first = strtol(str, &end, 10);
+		long last = first;
+
+		if (end == str) {
+			return -1;
+		}
+
+		if (*end == '-') {
+			str = end + 1;
+			last = strtol(str, &end, 10);
+
+			if (end == str) {
+				return -1;
+			}
+		}
+
+		if (first < 0 || last > 63 || first > last) {
+			return -1;
+		}
+
+		for (long cpu = first; cpu <= last; cpu++) {
+			*mask |= 1ULL << cpu;
+		}
+
+		if (*end == ',') {
+			end++;
+
+		} else if (*end != '\0') {
+			return -1;
+		}
+
+		str = end;
+	}
+
+	return *mask != 0 ? 0 : -1;
+}
+
+static int apply(const char *task, const char *cpus)
+{
+	uint64_t mask;
+
+	if (parse_cpus(cpus, &mask) != 0) {
+		PX4_ERR("invalid cpu list '%s'", cpus);
+		return 1;
+	}
+
+	int ret;
+
+	if (strcmp(task, "rt") == 0) {
+		ret = px4_task_set_rt_affinity(mask);
+
+	} else {
+		ret = px4_task_set_affinity(task, mask);
+	}
+
+	if (ret != 0) {
+		PX4_ERR("setting affinity of %s failed (%i)", task, ret);
+		return 1;
+	}
+
+	return 0;
+}
+
+static int load(const char *path)
+{
+	FILE *fp = fopen(path, "r");
+
+	if (fp == nullptr) {
+		PX4_ERR("cannot open %s (%i)", path, errno);
+		return 1;
+	}
+
+	char line[80];
+	int ret = 0;
+
+	while (fgets(line, sizeof(line), fp) != nullptr) {
+		char task[32];
+		char cpus[32];
+
+		if (line[0] == '#' || sscanf(line, "%31s %31s", task, cpus) != 2) {
+			continue;
+		}
+
+		ret |= apply(task, cpus);
+	}
+
+	fclose(fp);
+	return ret;
+}
+
+int affinity_main(int argc, char *argv[])
+{
+	if (argc < 2) {
+		print_usage();
+		return 1;
+	}
+
+	if (!strcmp(argv[1], "set") && argc == 4) {
+		return apply(argv[2], argv[3]);
+	}
+
+	if (!strcmp(argv[1], "rt") && argc == 3) {
+		return apply("rt", argv[2]);
+	}
+
+	if (!strcmp(argv[1], "load") && argc == 3) {
+		return load(argv[2]);
+	}
+
+	if (!strcmp(argv[1], "status")) {
+		px4_task_show_affinity();
+		return 0;
+	}
+
+	print_usage();
+	return 1;
+}
@@ -40,11 +40,13 @@
 #include <inttypes.h>
 
 #include <px4_defines.h>
+#include <fcntl.h>
 #include <stdio.h>
 #include <string.h>
 #include <stdlib.h>
 #include <limits.h>
 #include <math.h>
+#include <unistd.h>
 
 #include <systemlib/err.h>
 #include <systemlib/bson/tinybson.h>
@@ -57,7 +59,8 @@ static const int64_t sample_big_int = (int64_t)INT_MAX + 123LL;
 static const double sample_double = 2.5f;
 static const char *sample_string = "this is a test";
 static const uint8_t sample_data[256] = {0};
-//static const char *sample_filename = "/fs/microsd/bson.test";
+static const char *sample_filename = PX4_ROOTFSDIR "/fs/microsd/bson.test";
+static const unsigned sample_node_count = 6;
 
 static int
 encode(bson_encoder_t encoder)
@@ -105,158 +108,210 @@ decode_callback(bson_decoder_t decoder, void *private, bson_node_t node)
 	if (!strcmp(node->name, "bool1")) {
 		if (node->type != BSON_BOOL) {
 			PX4_ERR("FAIL: decoder: bool1 type %d, expected %d", node->type, BSON_BOOL);
-			return 1;
+			return -1;
 		}
 
 		if (node->b != sample_bool) {
 			PX4_ERR("FAIL: decoder: bool1 value %s, expected %s",
 				(node->b ? "true" : "false"),
 				(sample_bool ? "true" : "false"));
-			return 1;
+			return -1;
 		}
 
 		PX4_INFO("PASS: decoder: bool1");
+		(*(unsigned *)private)++;
 		return 1;
 	}
 
 	if (!strcmp(node->name, "int1")) {
 		if (node->type != BSON_INT32) {
 			PX4_ERR("FAIL: decoder: int1 type %d, expected %d", node->type, BSON_INT32);
-			return 1;
+			return -1;
 		}
 
 		if (node->i != sample_small_int) {
 			PX4_ERR("FAIL: decoder: int1 value %" PRIu64 ", expected %d", node->i, sample_small_int);
-			return 1;
+			return -1;
 		}
 
 		warnx("PASS: decoder: int1");
+		(*(unsigned *)private)++;
 		return 1;
 	}
 
 	if (!strcmp(node->name, "int2")) {
 		if (node->type != BSON_INT64) {
 			PX4_ERR("FAIL: decoder: int2 type %d, expected %d", node->type, BSON_INT64);
-			return 1;
+			return -1;
 		}
 
 		if (node->i != sample_big_int) {
 			PX4_ERR("FAIL: decoder: int2 value %" PRIu64 ", expected %" PRIu64, node->i, sample_big_int);
-			return 1;
+			return -1;
 		}
 
 		warnx("PASS: decoder: int2");
+		(*(unsigned *)private)++;
 		return 1;
 	}
 
 	if (!strcmp(node->name, "double1")) {
 		if (node->type != BSON_DOUBLE) {
 			PX4_ERR("FAIL: decoder: double1 type %d, expected %d", node->type, BSON_DOUBLE);
-			return 1;
+			return -1;
 		}
 
 		if (fabs(node->d - sample_double) > 1e-12) {
 			PX4_ERR("FAIL: decoder: double1 value %f, expected %f", node->d, sample_double);
-			return 1;
+			return -1;
 		}
 
 		warnx("PASS: decoder: double1");
+		(*(unsigned *)private)++;
 		return 1;
 	}
 
 	if (!strcmp(node->name, "string1")) {
 		if (node->type != BSON_STRING) {
 			PX4_ERR("FAIL: decoder: string1 type %d, expected %d", node->type, BSON_STRING);
-			return 1;
+			return -1;
 		}
 
 		len = bson_decoder_data_pending(decoder);
 
 		if (len != strlen(sample_string) + 1) {
 			PX4_ERR("FAIL: decoder: string1 length %d wrong, expected %zd", len, strlen(sample_string) + 1);
-			return 1;
+			return -1;
 		}
 
 		char sbuf[len];
 
 		if (bson_decoder_copy_data(decoder, sbuf)) {
 			PX4_ERR("FAIL: decoder: string1 copy failed");
-			return 1;
+			return -1;
 		}
 
 		if (bson_decoder_data_pending(decoder) != 0) {
 			PX4_ERR("FAIL: decoder: string1 copy did not exhaust all data");
-			return 1;
+			return -1;
 		}
 
 		if (sbuf[len - 1] != '\0') {
 			PX4_ERR("FAIL: decoder: string1 not 0-terminated");
-			return 1;
+			return -1;
 		}
 
 		if (strcmp(sbuf, sample_string)) {
 			PX4_ERR("FAIL: decoder: string1 value '%s', expected '%s'", sbuf, sample_string);
-			return 1;
+			return -1;
 		}
 
 		warnx("PASS: decoder: string1");
+		(*(unsigned *)private)++;
 		return 1;
 	}
 
 	if (!strcmp(node->name, "data1")) {
 		if (node->type != BSON_BINDATA) {
 			PX4_ERR("FAIL: decoder: data1 type %d, expected %d", node->type, BSON_BINDATA);
-			return 1;
+			return -1;
 		}
 
 		len = bson_decoder_data_pending(decoder);
 
 		if (len != sizeof(sample_data)) {
 			PX4_ERR("FAIL: decoder: data1 length %d, expected %zu", len, sizeof(sample_data));
-			return 1;
+			return -1;
 		}
 
 		if (node->subtype != BSON_BIN_BINARY) {
 			PX4_ERR("FAIL: decoder: data1 subtype %d, expected %d", node->subtype, BSON_BIN_BINARY);
-			return 1;
+			return -1;
 		}
 
 		uint8_t dbuf[len];
 
 		if (bson_decoder_copy_data(decoder, dbuf)) {
 			PX4_ERR("FAIL: decoder: data1 copy failed");
-			return 1;
+			return -1;
 		}
 
 		if (bson_decoder_data_pending(decoder) != 0) {
 			PX4_ERR("FAIL: decoder: data1 copy did not exhaust all data");
-			return 1;
+			return -1;
 		}
 
 		if (memcmp(sample_data, dbuf, len) != 0) {
 			PX4_ERR("FAIL: decoder: data1 compare fail");
-			return 1;
+			return -1;
 		}
 
 		PX4_INFO("PASS: decoder: data1");
+		(*(unsigned *)private)++;
 		return 1;
 	}
 
 	if (node->type != BSON_EOO) {
 		PX4_ERR("FAIL: decoder: unexpected node name '%s'", node->name);
+		return -1;
 	}
 
 	return 1;
 }
 
-static void
-decode(bson_decoder_t decoder)
+static int
+decode(bson_decoder_t decoder, unsigned *nodes_decoded)
 {
 	int result;
 
+	*nodes_decoded = 0;
+
 	do {
 		result = bson_decoder_next(decoder);
 	} while (result > 0);
+
+	if (result != 0) {
+		PX4_ERR("FAIL: decoder: bson_decoder_next returned %d", result);
+		return 1;
+	}
+
+	if (*nodes_decoded != sample_node_count) {
+		PX4_ERR("FAIL: decoder: %u of %u nodes decoded", *nodes_decoded, sample_node_count);
+		return 1;
+	}
+
+	return 0;
+}
+
+/**
+ * Encode the sample document to a file, after offset bytes of padding.
+ */
+static int
+encode_file(unsigned offset, uint8_t *iobuf, unsigned iobuf_size)
+{
+	struct bson_encoder_s encoder;
+	int fd = open(sample_filename, O_CREAT | O_TRUNC | O_WRONLY, PX4_O_MODE_666);
+
+	if (fd < 0) {
+		PX4_ERR("FAIL: open %s for writing", sample_filename);
+		return 1;
+	}
+
+	if (offset > 0 && (lseek(fd, offset - 1, SEEK_SET) != (off_t)(offset - 1) || write(fd, "", 1) != 1)) {
+		PX4_ERR("FAIL: writing %u bytes of padding", offset);
+		close(fd);
+		return 1;
+	}
+
+	if (bson_encoder_init_file_buffered(&encoder, fd, iobuf, iobuf_size)) {
+		PX4_ERR("FAIL: bson_encoder_init_file_buffered");
+		close(fd);
+		return 1;
+	}
+
+	int ret = encode(&encoder);
+	close(fd);
+	return ret;
 }
 
 int
@@ -264,6 +319,7 @@ test_bson(int argc, char *argv[])
 {
 	struct bson_encoder_s encoder;
 	struct bson_decoder_s decoder;
+	unsigned nodes_decoded = 0;
 	void *buf;
 	int len;
 
@@ -273,7 +329,10 @@ test_bson(int argc, char *argv[])
 		return 1;
 	}
 
-	encode(&encoder);
+	if (encode(&encoder)) {
+		return 1;
+	}
+
 	len = bson_encoder_buf_size(&encoder);
 
 	if (len <= 0) {
@@ -289,13 +348,89 @@ test_bson(int argc, char *argv[])
 	}
 
 	/* now test-decode it */
-	if (bson_decoder_init_buf(&decoder, buf, len, decode_callback, NULL)) {
+	if (bson_decoder_init_buf(&decoder, buf, len, decode_callback, &nodes_decoded)) {
 		PX4_ERR("FAIL: bson_decoder_init_buf");
+		free(buf);
 		return 1;
 	}
 
-	decode(&decoder);
+	int ret = decode(&decoder, &nodes_decoded);
 	free(buf);
 
+	if (ret) {
+		return 1;
+	}
+
+	/* encode to a file through a block buffer smaller than the binary node */
+	uint8_t iobuf[64];
+
+	if (encode_file(0, iobuf, sizeof(iobuf))) {
+		return 1;
+	}
+
+	/* and decode it the same way */
+	int fd = open(sample_filename, O_RDONLY);
+
+	if (fd < 0) {
+		PX4_ERR("FAIL: open %s for reading", sample_filename);
+		return 1;
+	}
+
+	if (bson_decoder_init_file_buffered(&decoder, fd, iobuf, sizeof(iobuf), decode_callback, &nodes_decoded)) {
+		PX4_ERR("FAIL: bson_decoder_init_file_buffered");
+		close(fd);
+		return 1;
+	}
+
+	ret = decode(&decoder, &nodes_decoded);
+	bson_decoder_fini(&decoder);
+	close(fd);
+
+	if (ret) {
+		return 1;
+	}
+
+#if defined(__PX4_POSIX) && !defined(__PX4_QURT)
+
+	/* decode from a mapping, with the document at file offsets that are and are not page aligned */
+	const unsigned offsets[] = {0, 4096, 5000};
+
+	for (unsigned i = 0; i < sizeof(offsets) / sizeof(offsets[0]); i++) {
+		if (encode_file(offsets[i], iobuf, sizeof(iobuf))) {
+			return 1;
+		}
+
+		fd = open(sample_filename, O_RDONLY);
+
+		if (fd < 0 || lseek(fd, offsets[i], SEEK_SET) != (off_t)offsets[i]) {
+			PX4_ERR("FAIL: open %s for reading at offset %u", sample_filename, offsets[i]);
+
+			if (fd >= 0) {
+				close(fd);
+			}
+
+			return 1;
+		}
+
+		if (bson_decoder_init_file_mapped(&decoder, fd, decode_callback, &nodes_decoded)) {
+			PX4_ERR("FAIL: bson_decoder_init_file_mapped at offset %u", offsets[i]);
+			close(fd);
+			return 1;
+		}
+
+		ret = decode(&decoder, &nodes_decoded);
+		bson_decoder_fini(&decoder);
+		close(fd);
+
+		if (ret) {
+			PX4_ERR("FAIL: mapped decode at offset %u", offsets[i]);
+			return 1;
+		}
+	}
+
+#endif
+
+	unlink(sample_filename);
+
 	return PX4_OK;
 }
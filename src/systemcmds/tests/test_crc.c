@@ -0,0 +1,249 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2017 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/**
+ * @file test_crc.c
+ *
+ * Tests for the systemlib CRC engine: check values, consistency with a
+ * bitwise reference on unaligned buffers, and a throughput benchmark.
+ */
+
+#include <px4_config.h>
+#include <px4_defines.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <drivers/drv_hrt.h>
+#include <systemlib/crc.h>
+
+#include "tests_main.h"
+
+#define CRC_TEST_BUFSIZE	4096
+#define CRC_TEST_ROUNDS		200
+#define CRC_BENCH_BYTES		(1024 * 1024)
+
+static uint16_t
+ref_crc16_ccitt(uint16_t crc, size_t length, const uint8_t *bytes)
+{
+	for (size_t i = 0; i < length; i++) {
+		crc ^= (uint16_t)bytes[i] << 8;
+
+		for (int b = 0; b < 8; b++) {
+			crc = (crc & 0x8000) ? (crc << 1) ^ 0x1021 : (crc << 1);
+		}
+	}
+
+	return crc;
+}
+
+static uint16_t
+ref_crc16_arc(uint16_t crc, size_t length, const uint8_t *bytes)
+{
+	for (size_t i = 0; i < length; i++) {
+		crc ^= bytes[i];
+
+		for (int b = 0; b < 8; b++) {
+			crc = (crc & 1) ? (crc >> 1) ^ 0xA001 : (crc >> 1);
+		}
+	}
+
+	return crc;
+}
+
+static uint32_t
+ref_crc32(uint32_t crc, size_t length, const uint8_t *bytes)
+{
+	for (size_t i = 0; i < length; i++) {
+		crc ^= bytes[i];
+
+		for (int b = 0; b < 8; b++) {
+			crc = (crc & 1) ? (crc >> 1) ^ 0xEDB88320u : (crc >> 1);
+		}
+	}
+
+	return crc;
+}
+
+static int
+test_crc_check_values(void)
+{
+	const uint8_t check[] = "123456789";
+	int ret = OK;
+
+	/* CRC-16/CCITT-FALSE, CRC-16/ARC and CRC-32 check values */
+	if (crc16_signature(0xFFFF, 9, check) != 0x29B1) {
+		printf("crc16_signature check value failed: 0x%04x\n", crc16_signature(0xFFFF, 9, check));
+		ret = ERROR;
+	}
+
+	if (crc16_arc_signature(0, 9, check) != 0xBB3D) {
+		printf("crc16_arc_signature check value failed: 0x%04x\n", crc16_arc_signature(0, 9, check));
+		ret = ERROR;
+	}
+
+	if ((crc32_signature(0xFFFFFFFFu, 9, check) ^ 0xFFFFFFFFu) != 0xCBF43926u) {
+		printf("crc32_signature check value failed: 0x%08x\n",
+		       (unsigned)(crc32_signature(0xFFFFFFFFu, 9, check) ^ 0xFFFFFFFFu));
+		ret = ERROR;
+	}
+
+	/* byte-wise crc16_add must agree with the block variant */
+	uint16_t crc = 0xFFFF;
+
+	for (unsigned i = 0; i < 9; i++) {
+		crc = crc16_add(crc, check[i]);
+	}
+
+	if (crc != 0x29B1) {
+		printf("crc16_add check value failed: 0x%04x\n", crc);
+		ret = ERROR;
+	}
+
+	return ret;
+}
+
+static int
+test_crc_consistency(uint8_t *buf)
+{
+	for (unsigned i = 0; i < CRC_TEST_BUFSIZE; i++) {
+		buf[i] = rand() & 0xff;
+	}
+
+	for (unsigned round = 0; round < CRC_TEST_ROUNDS; round++) {
+		/* random offset and length exercise the unaligned head and tail paths */
+		size_t offset = rand() % 16;
+		size_t length = rand() % (CRC_TEST_BUFSIZE - offset);
+		const uint8_t *p = buf + offset;
+		uint32_t seed = ((uint32_t)rand() << 16) ^ (uint32_t)rand();
+
+		if (crc16_signature(seed, length, p) != ref_crc16_ccitt(seed, length, p)) {
+			printf("crc16_signature mismatch: offset %u length %u\n", (unsigned)offset, (unsigned)length);
+			return ERROR;
+		}
+
+		if (crc16_arc_signature(seed, length, p) != ref_crc16_arc(seed, length, p)) {
+			printf("crc16_arc_signature mismatch: offset %u length %u\n", (unsigned)offset, (unsigned)length);
+			return ERROR;
+		}
+
+		if (crc32_signature(seed, length, p) != ref_crc32(seed, length, p)) {
+			printf("crc32_signature mismatch: offset %u length %u\n", (unsigned)offset, (unsigned)length);
+			return ERROR;
+		}
+
+		/* splitting a buffer must give the same result as one call */
+		size_t split = length ? rand() % length : 0;
+
+		if (crc32_signature(crc32_signature(seed, split, p), length - split, p + split) !=
+		    crc32_signature(seed, length, p)) {
+			printf("crc32_signature split mismatch: length %u split %u\n", (unsigned)length, (unsigned)split);
+			return ERROR;
+		}
+	}
+
+	return OK;
+}
+
+static void
+test_crc_benchmark(uint8_t *buf)
+{
+	const unsigned iterations = CRC_BENCH_BYTES / CRC_TEST_BUFSIZE;
+	volatile uint32_t sink = 0;
+	hrt_abstime start;
+	hrt_abstime elapsed;
+
+	start = hrt_absolute_time();
+
+	for (unsigned i = 0; i < iterations; i++) {
+		sink += ref_crc32(0, CRC_TEST_BUFSIZE, buf);
+	}
+
+	elapsed = hrt_elapsed_time(&start);
+	printf("crc32 bitwise:        %8u us/MB\n", (unsigned)elapsed);
+
+	start = hrt_absolute_time();
+
+	for (unsigned i = 0; i < iterations; i++) {
+		sink += crc32_signature(0, CRC_TEST_BUFSIZE, buf);
+	}
+
+	elapsed = hrt_elapsed_time(&start);
+	printf("crc32_signature:      %8u us/MB\n", (unsigned)elapsed);
+
+	start = hrt_absolute_time();
+
+	for (unsigned i = 0; i < iterations; i++) {
+		sink += crc16_signature(0, CRC_TEST_BUFSIZE, buf);
+	}
+
+	elapsed = hrt_elapsed_time(&start);
+	printf("crc16_signature:      %8u us/MB\n", (unsigned)elapsed);
+
+	start = hrt_absolute_time();
+
+	for (unsigned i = 0; i < iterations; i++) {
+		sink += crc16_arc_signature(0, CRC_TEST_BUFSIZE, buf);
+	}
+
+	elapsed = hrt_elapsed_time(&start);
+	printf("crc16_arc_signature:  %8u us/MB\n", (unsigned)elapsed);
+
+	(void)sink;
+}
+
+int
+test_crc(int argc, char *argv[])
+{
+	uint8_t *buf = (uint8_t *)malloc(CRC_TEST_BUFSIZE);
+
+	if (buf == NULL) {
+		printf("crc: buffer alloc failed\n");
+		return ERROR;
+	}
+
+	int ret = test_crc_check_values();
+
+	if (ret == OK) {
+		ret = test_crc_consistency(buf);
+	}
+
+	if (ret == OK) {
+		test_crc_benchmark(buf);
+		printf("crc: PASS\n");
+	}
+
+	free(buf);
+	return ret;
+}
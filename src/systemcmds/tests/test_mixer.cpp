@@ -116,6 +116,7 @@ private:
 	bool loadQuadTest();
 	bool loadComplexTest();
 	bool loadAllTest();
+	bool multirotorBenchmarkTest();
 	bool load_mixer(const char *filename, unsigned expected_count, bool verbose = false);
 	bool load_mixer(const char *filename, const char *buf, unsigned loaded, unsigned expected_count,
 			const unsigned chunk_size, bool verbose);
@@ -137,6 +138,7 @@ bool MixerTest::run_tests()
 	ut_run_test(loadComplexTest);
 	ut_run_test(loadAllTest);
 	ut_run_test(mixerTest);
+	ut_run_test(multirotorBenchmarkTest);
 
 	return (_tests_failed == 0);
 }
@@ -235,6 +237,83 @@ bool MixerTest::loadAllTest()
 	return true;
 }
 
+bool MixerTest::multirotorBenchmarkTest()
+{
+	/* 4, 6 and 8 rotors (including the 6 rotor dodeca "6m") use the fixed rotor count kernels,
+	 * tri and twin engine the generic one */
+	const char *geometries[] = {"4x", "4+", "6x", "6c", "6m", "8x", "8c", "3y", "2-"};
+	const unsigned iterations = 10000;
+	const unsigned rotors_max = 12;
+	/* idle speed of 0.1 (1000 / 10000), shifted to the output range like the mixer does */
+	const float idle_speed = -1.0f + 0.1f * 2.0f;
+	const float eps = 1e-5f;
+	float outputs[rotors_max];
+
+	should_prearm = false;
+
+	for (unsigned g = 0; g < sizeof(geometries) / sizeof(geometries[0]); g++) {
+		char buf[32];
+		snprintf(buf, sizeof(buf), "R: %s 10000 10000 10000 1000\n", geometries[g]);
+		unsigned buflen = strlen(buf);
+
+		MultirotorMixer *mixer = MultirotorMixer::from_text(mixer_callback, 0, buf, buflen);
+
+		if (mixer == nullptr) {
+			PX4_ERR("failed to load multirotor mixer %s", geometries[g]);
+			return false;
+		}
+
+		/* hover: every rotor gets the same output, half way between idle and full */
+		actuator_controls[0] = 0.0f;
+		actuator_controls[1] = 0.0f;
+		actuator_controls[2] = 0.0f;
+		actuator_controls[3] = 0.5f;
+
+		unsigned mixed = mixer->mix(&outputs[0], rotors_max);
+		const float hover = idle_speed + 0.5f * (1.0f - idle_speed);
+
+		for (unsigned i = 0; i < mixed; i++) {
+			if (fabsf(outputs[i] - hover) > eps) {
+				PX4_ERR("multirotor mixer %s: hover output %u is %.6f, expected %.6f", geometries[g], i,
+					(double)outputs[i], (double)hover);
+				delete mixer;
+				return false;
+			}
+		}
+
+		bool in_range = true;
+		hrt_abstime starttime = hrt_absolute_time();
+
+		for (unsigned n = 0; n < iterations; n++) {
+			/* sweep through saturating and non-saturating demands */
+			actuator_controls[0] = -1.0f + 2.0f * (n % 16) / 15.0f;
+			actuator_controls[1] = 0.5f - (n % 7) / 6.0f;
+			actuator_controls[2] = 0.3f;
+			actuator_controls[3] = (n % 11) / 10.0f;
+
+			mixed = mixer->mix(&outputs[0], rotors_max);
+
+			for (unsigned i = 0; i < mixed; i++) {
+				in_range = in_range && outputs[i] >= idle_speed - eps && outputs[i] <= 1.0f + eps;
+			}
+		}
+
+		hrt_abstime elapsed = hrt_elapsed_time(&starttime);
+
+		delete mixer;
+
+		if (mixed == 0 || mixed > rotors_max || !in_range) {
+			PX4_ERR("multirotor mixer %s: %u outputs, in [idle, 1]: %d", geometries[g], mixed, in_range);
+			return false;
+		}
+
+		PX4_INFO("multirotor mixer %s: %u rotors, %.3f us per mix", geometries[g], mixed,
+			 (double)elapsed / iterations);
+	}
+
+	return true;
+}
+
 bool MixerTest::load_mixer(const char *filename, unsigned expected_count, bool verbose)
 {
 	char buf[2048];
@@ -0,0 +1,332 @@
+/****************************************************************************
+ *
+ *   Copyright (C) 2017 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/**
+ * @file test_namespace.cpp
+ * Tests that two namespaces (vehicles in the same process) do not see each
+ * other's topics, parameters and module instances.
+ */
+
+#include <unit_test.h>
+
+#include <px4_module.h>
+#include <px4_tasks.h>
+#include <px4_workqueue.h>
+#include <drivers/drv_hrt.h>
+#include <systemlib/param/param.h>
+#include <uORB/uORB.h>
+#include <pthread.h>
+#include <unistd.h>
+
+extern "C" int uorb_main(int argc, char *argv[]);
+
+struct namespace_test_s {
+	int val;
+};
+
+ORB_DECLARE(namespace_test);
+ORB_DEFINE(namespace_test, struct namespace_test_s, sizeof(namespace_test_s), "NAMESPACE_TEST:int val;");
+
+/** Switches the namespace of the calling thread and restores it when going out of scope */
+class NamespaceGuard
+{
+public:
+	NamespaceGuard(int ns) : _previous(px4_get_namespace()) { px4_set_namespace(ns); }
+	~NamespaceGuard() { px4_set_namespace(_previous); }
+
+	void set(int ns) { px4_set_namespace(ns); }
+
+private:
+	const int _previous;
+};
+
+/** Minimal module, to check that every namespace has its own instance */
+class NamespaceTestModule : public ModuleBase<NamespaceTestModule>
+{
+public:
+	NamespaceTestModule() : _namespace(px4_get_namespace()) {}
+
+	static int task_spawn(int argc, char *argv[])
+	{
+		_task_id = px4_task_spawn_cmd("ns_test_module",
+					      SCHED_DEFAULT,
+					      SCHED_PRIORITY_DEFAULT,
+					      1200,
+					      (px4_main_t)&run_trampoline,
+					      (char *const *)argv);
+
+		if (_task_id < 0) {
+			_task_id = -1;
+			return -errno;
+		}
+
+		return wait_until_running();
+	}
+
+	static NamespaceTestModule *instantiate(int argc, char *argv[]) { return new NamespaceTestModule(); }
+
+	static int custom_command(int argc, char *argv[]) { return print_usage("unknown command"); }
+
+	static int print_usage(const char *reason = nullptr) { return 0; }
+
+	void run() override
+	{
+		while (!should_exit()) {
+			usleep(10000);
+		}
+	}
+
+	/** namespace in which the running instance was created, -1 if not running */
+	static int instance_namespace()
+	{
+		NamespaceTestModule *object = get_instance();
+		return object ? object->_namespace : -1;
+	}
+
+private:
+	const int _namespace;
+};
+
+class NamespaceTest : public UnitTest
+{
+public:
+	virtual bool run_tests();
+
+private:
+	bool _threads_inherit_namespace();
+	bool _topics_isolated();
+	bool _params_isolated();
+	bool _module_instances_isolated();
+
+	static void *namespace_thread(void *arg);
+	static int namespace_task(int argc, char *argv[]);
+	static void namespace_work(void *arg);
+
+	static volatile int _task_namespace;
+
+	// use the last namespaces, to stay clear of the vehicles that are running
+	static constexpr int NS_A = PX4_MAX_NAMESPACES - 2;
+	static constexpr int NS_B = PX4_MAX_NAMESPACES - 1;
+};
+
+volatile int NamespaceTest::_task_namespace = -1;
+
+bool NamespaceTest::run_tests()
+{
+	const int namespaces[] = {NS_A, NS_B};
+
+	for (int ns : namespaces) {
+		NamespaceGuard guard(ns);
+		char *argv[] = {(char *)"uorb", (char *)"start", nullptr};
+		uorb_main(2, argv);
+	}
+
+	ut_run_test(_threads_inherit_namespace);
+	ut_run_test(_topics_isolated);
+	ut_run_test(_params_isolated);
+	ut_run_test(_module_instances_isolated);
+
+	return (_tests_failed == 0);
+}
+
+void *NamespaceTest::namespace_thread(void *arg)
+{
+	*(int *)arg = px4_get_namespace();
+	return nullptr;
+}
+
+int NamespaceTest::namespace_task(int argc, char *argv[])
+{
+	_task_namespace = px4_get_namespace();
+	return 0;
+}
+
+void NamespaceTest::namespace_work(void *arg)
+{
+	*(volatile int *)arg = px4_get_namespace();
+}
+
+bool NamespaceTest::_threads_inherit_namespace()
+{
+	NamespaceGuard guard(NS_B);
+
+	// helper thread
+	int thread_namespace = -1;
+	pthread_t thread;
+	ut_compare("px4_pthread_create", px4_pthread_create(&thread, nullptr, namespace_thread, &thread_namespace), 0);
+	pthread_join(thread, nullptr);
+	ut_compare("thread namespace", thread_namespace, NS_B);
+
+	// task
+	_task_namespace = -1;
+	ut_assert("task spawn", px4_task_spawn_cmd("ns_test_task", SCHED_DEFAULT, SCHED_PRIORITY_DEFAULT, 1200,
+			namespace_task, nullptr) >= 0);
+
+	for (int i = 0; i < 100 && _task_namespace == -1; i++) {
+		usleep(10000);
+	}
+
+	ut_compare("task namespace", _task_namespace, NS_B);
+
+	// work item (static, in case it runs late)
+	static volatile int work_namespace;
+	static struct work_s work;
+	work_namespace = -1;
+	ut_compare("work_queue", work_queue(LPWORK, &work, namespace_work, (void *)&work_namespace, 0), 0);
+
+	for (int i = 0; i < 100 && work_namespace == -1; i++) {
+		usleep(10000);
+	}
+
+	ut_compare("work namespace", work_namespace, NS_B);
+
+	return true;
+}
+
+bool NamespaceTest::_topics_isolated()
+{
+	// different values in every run, so that a previous run cannot make the test pass
+	const int val_a = (int)(hrt_absolute_time() & 0x3fffffff);
+	const int val_b = val_a + 1;
+
+	NamespaceGuard guard(NS_A);
+	namespace_test_s sample = {val_a};
+	orb_advert_t pub_a = orb_advertise(ORB_ID(namespace_test), &sample);
+	ut_assert("advertise in A", pub_a != nullptr);
+	int sub_a = orb_subscribe(ORB_ID(namespace_test));
+	ut_assert("subscribe in A", sub_a >= 0);
+
+	guard.set(NS_B);
+	sample.val = val_b;
+	orb_advert_t pub_b = orb_advertise(ORB_ID(namespace_test), &sample);
+	ut_assert("advertise in B", pub_b != nullptr);
+	int sub_b = orb_subscribe(ORB_ID(namespace_test));
+	ut_assert("subscribe in B", sub_b >= 0);
+
+	// every namespace reads its own publication
+	ut_compare("copy in B", orb_copy(ORB_ID(namespace_test), sub_b, &sample), PX4_OK);
+	ut_compare("value in B", sample.val, val_b);
+
+	guard.set(NS_A);
+	ut_compare("copy in A", orb_copy(ORB_ID(namespace_test), sub_a, &sample), PX4_OK);
+	ut_compare("value in A", sample.val, val_a);
+
+	// a publication in A does not update B
+	sample.val = val_a + 2;
+	ut_compare("publish in A", orb_publish(ORB_ID(namespace_test), pub_a, &sample), PX4_OK);
+
+	guard.set(NS_B);
+	bool updated = true;
+	ut_compare("check in B", orb_check(sub_b, &updated), PX4_OK);
+	ut_assert_false(updated);
+
+	orb_unsubscribe(sub_b);
+	orb_unadvertise(pub_b);
+
+	guard.set(NS_A);
+	ut_compare("check in A", orb_check(sub_a, &updated), PX4_OK);
+	ut_assert_true(updated);
+
+	orb_unsubscribe(sub_a);
+	orb_unadvertise(pub_a);
+
+	return true;
+}
+
+bool NamespaceTest::_params_isolated()
+{
+	param_t param = param_find("TEST_1");
+	ut_assert("TEST_1 not found", param != PARAM_INVALID);
+
+	int32_t value_caller;
+	ut_compare("get in caller namespace", param_get(param, &value_caller), PX4_OK);
+
+	int32_t value;
+
+	{
+		NamespaceGuard guard(NS_A);
+		value = 100;
+		ut_compare("set in A", param_set(param, &value), PX4_OK);
+
+		guard.set(NS_B);
+		value = 200;
+		ut_compare("set in B", param_set(param, &value), PX4_OK);
+
+		guard.set(NS_A);
+		ut_compare("get in A", param_get(param, &value), PX4_OK);
+		ut_compare("value in A", value, 100);
+		param_reset(param);
+
+		guard.set(NS_B);
+		ut_compare("get in B", param_get(param, &value), PX4_OK);
+		ut_compare("value in B", value, 200);
+		param_reset(param);
+	}
+
+	// the namespace that runs the test is not affected
+	ut_compare("get in caller namespace", param_get(param, &value), PX4_OK);
+	ut_compare("value in caller namespace", value, value_caller);
+
+	return true;
+}
+
+bool NamespaceTest::_module_instances_isolated()
+{
+	char *start_argv[] = {(char *)"ns_test_module", (char *)"start", nullptr};
+	char *stop_argv[] = {(char *)"ns_test_module", (char *)"stop", nullptr};
+
+	NamespaceGuard guard(NS_A);
+	ut_compare("start in A", NamespaceTestModule::main(2, start_argv), 0);
+	ut_assert_true(NamespaceTestModule::is_running());
+	ut_compare("instance of A", NamespaceTestModule::instance_namespace(), NS_A);
+
+	// not running in B until started there, and then with its own instance
+	guard.set(NS_B);
+	ut_assert_false(NamespaceTestModule::is_running());
+	ut_compare("start in B", NamespaceTestModule::main(2, start_argv), 0);
+	ut_compare("instance of B", NamespaceTestModule::instance_namespace(), NS_B);
+
+	ut_compare("stop in B", NamespaceTestModule::main(2, stop_argv), 0);
+	ut_assert_false(NamespaceTestModule::is_running());
+
+	// stopping B leaves A running
+	guard.set(NS_A);
+	ut_assert_true(NamespaceTestModule::is_running());
+	ut_compare("instance of A", NamespaceTestModule::instance_namespace(), NS_A);
+	ut_compare("stop in A", NamespaceTestModule::main(2, stop_argv), 0);
+	ut_assert_false(NamespaceTestModule::is_running());
+
+	return true;
+}
+
+ut_declare_test_c(test_namespace, NamespaceTest)
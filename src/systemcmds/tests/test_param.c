@@ -38,7 +38,10 @@
  */
 
 #include <px4_defines.h>
+#include <fcntl.h>
 #include <stdio.h>
+#include <unistd.h>
+#include <drivers/drv_hrt.h>
 #include "systemlib/err.h"
 #include "systemlib/param/param.h"
 #include "tests_main.h"
@@ -46,6 +49,63 @@
 #define PARAM_MAGIC1 12345678
 #define PARAM_MAGIC2 0xa5a5a5a5
 
+#define PARAM_BENCH_FILE PX4_ROOTFSDIR "/fs/microsd/param_bench.bson"
+#define PARAM_BENCH_RUNS 10
+
+/**
+ * Time the export and import of all parameters through a file.
+ */
+static int
+param_benchmark(void)
+{
+	hrt_abstime export_time = 0;
+	hrt_abstime import_time = 0;
+
+	for (int i = 0; i < PARAM_BENCH_RUNS; i++) {
+		int fd = open(PARAM_BENCH_FILE, O_CREAT | O_TRUNC | O_WRONLY, PX4_O_MODE_666);
+
+		if (fd < 0) {
+			warnx("failed to open %s", PARAM_BENCH_FILE);
+			return 1;
+		}
+
+		hrt_abstime start = hrt_absolute_time();
+		int ret = param_export(fd, false);
+		export_time += hrt_elapsed_time(&start);
+		close(fd);
+
+		if (ret != OK) {
+			warnx("param_export failed (%i)", ret);
+			return 1;
+		}
+
+		fd = open(PARAM_BENCH_FILE, O_RDONLY);
+
+		if (fd < 0) {
+			warnx("failed to open %s", PARAM_BENCH_FILE);
+			return 1;
+		}
+
+		start = hrt_absolute_time();
+		ret = param_import(fd);
+		import_time += hrt_elapsed_time(&start);
+		close(fd);
+
+		if (ret != OK) {
+			warnx("param_import failed (%i)", ret);
+			return 1;
+		}
+	}
+
+	unlink(PARAM_BENCH_FILE);
+
+	warnx("%u params: export %llu us, import %llu us (mean of %d runs)", param_count_used(),
+	      (unsigned long long)(export_time / PARAM_BENCH_RUNS),
+	      (unsigned long long)(import_time / PARAM_BENCH_RUNS), PARAM_BENCH_RUNS);
+
+	return 0;
+}
+
 int
 test_param(int argc, char *argv[])
 {
@@ -99,6 +159,10 @@ test_param(int argc, char *argv[])
 		return 1;
 	}
 
+	if (param_benchmark() != 0) {
+		return 1;
+	}
+
 	warnx("parameter test PASS");
 
 	return 0;
@@ -0,0 +1,220 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2017 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/**
+ * @file test_sensor_kernels.cpp
+ * Tests the structure-of-arrays sensor correction kernels of the sensors module
+ * against the per-instance math they replace, and compares their run time.
+ */
+
+#include <unit_test.h>
+
+#include <drivers/drv_hrt.h>
+#include <mathlib/mathlib.h>
+#include <modules/sensors/sensor_kernels.h>
+
+using namespace sensors;
+
+class SensorKernelsTest : public UnitTest
+{
+public:
+	SensorKernelsTest();
+
+	virtual bool run_tests();
+
+private:
+	bool correctAndRotateTest();
+	bool rotateEachTest();
+	bool benchmarkTest();
+
+	/** previous implementation: one instance at a time through math::Vector<3> */
+	void reference_correct_and_rotate(unsigned instance, math::Vector<3> &out);
+
+	static constexpr unsigned instances = 3; ///< a typical triple IMU setup
+
+	float _raw[SENSOR_COUNT_MAX][3];
+	float _dt_inv[SENSOR_COUNT_MAX];
+	float _offsets[SENSOR_COUNT_MAX][3];
+	float _scales[SENSOR_COUNT_MAX][3];
+	math::Matrix<3, 3> _rotation;
+	math::Matrix<3, 3> _rotations[SENSOR_COUNT_MAX];
+};
+
+SensorKernelsTest::SensorKernelsTest()
+{
+	for (unsigned i = 0; i < SENSOR_COUNT_MAX; i++) {
+		for (unsigned axis = 0; axis < 3; axis++) {
+			_raw[i][axis] = 0.01f * (i + 1) * (axis + 1) - 0.02f;
+			_offsets[i][axis] = 0.3f * axis - 0.1f * i;
+			_scales[i][axis] = 1.0f + 0.01f * (axis + i);
+		}
+
+		_dt_inv[i] = 1.e6f / (4000 + 100 * i);
+		_rotations[i].from_euler(0.1f * i, -0.2f, 0.5f * i);
+	}
+
+	_rotation.from_euler(M_PI_F, 0.f, M_PI_2_F);
+}
+
+void SensorKernelsTest::reference_correct_and_rotate(unsigned instance, math::Vector<3> &out)
+{
+	float dt_inv = _dt_inv[instance];
+	out = math::Vector<3>(_raw[instance][0] * dt_inv, _raw[instance][1] * dt_inv, _raw[instance][2] * dt_inv);
+
+	for (unsigned axis = 0; axis < 3; axis++) {
+		out(axis) = (out(axis) - _offsets[instance][axis]) * _scales[instance][axis];
+	}
+
+	out = _rotation * out;
+}
+
+bool SensorKernelsTest::correctAndRotateTest()
+{
+	SensorSamples3D data = {};
+	SensorCorrections3D corrections = {};
+	float dt_inv[SENSOR_COUNT_MAX] = {};
+
+	for (unsigned i = 0; i < instances; i++) {
+		data.set(i, _raw[i][0], _raw[i][1], _raw[i][2]);
+		corrections.offset.set(i, _offsets[i][0], _offsets[i][1], _offsets[i][2]);
+		corrections.scale.set(i, _scales[i][0], _scales[i][1], _scales[i][2]);
+		dt_inv[i] = _dt_inv[i];
+	}
+
+	correct_and_rotate(data, dt_inv, corrections, _rotation);
+
+	for (unsigned i = 0; i < instances; i++) {
+		math::Vector<3> expected;
+		reference_correct_and_rotate(i, expected);
+
+		float result[3];
+		data.get(i, result);
+
+		for (unsigned axis = 0; axis < 3; axis++) {
+			ut_compare_float("corrected sample", result[axis], expected(axis), 4);
+		}
+	}
+
+	// an identity correction with unit gain only rotates
+	corrections.set_identity(0);
+	dt_inv[0] = 1.f;
+	data.set(0, 1.f, 2.f, 3.f);
+	correct_and_rotate(data, dt_inv, corrections, _rotation);
+
+	math::Vector<3> expected = _rotation * math::Vector<3>(1.f, 2.f, 3.f);
+	ut_compare_float("identity x", data.x[0], expected(0), 4);
+	ut_compare_float("identity y", data.y[0], expected(1), 4);
+	ut_compare_float("identity z", data.z[0], expected(2), 4);
+
+	return true;
+}
+
+bool SensorKernelsTest::rotateEachTest()
+{
+	SensorSamples3D data = {};
+
+	for (unsigned i = 0; i < SENSOR_COUNT_MAX; i++) {
+		data.set(i, _raw[i][0], _raw[i][1], _raw[i][2]);
+	}
+
+	rotate_each(data, _rotations);
+
+	for (unsigned i = 0; i < SENSOR_COUNT_MAX; i++) {
+		math::Vector<3> expected = _rotations[i] * math::Vector<3>(_raw[i][0], _raw[i][1], _raw[i][2]);
+		ut_compare_float("rotated x", data.x[i], expected(0), 5);
+		ut_compare_float("rotated y", data.y[i], expected(1), 5);
+		ut_compare_float("rotated z", data.z[i], expected(2), 5);
+	}
+
+	return true;
+}
+
+bool SensorKernelsTest::benchmarkTest()
+{
+	const unsigned iterations = 100000;
+	volatile float sink = 0.f;
+
+	// previous implementation
+	hrt_abstime t0 = hrt_absolute_time();
+
+	for (unsigned n = 0; n < iterations; n++) {
+		for (unsigned i = 0; i < instances; i++) {
+			math::Vector<3> out;
+			reference_correct_and_rotate(i, out);
+			sink = sink + out(0);
+		}
+
+		_raw[n % instances][0] += 1e-9f;
+	}
+
+	hrt_abstime reference_us = hrt_elapsed_time(&t0);
+
+	// structure of arrays, including the conversion from & to the per-instance layout
+	t0 = hrt_absolute_time();
+
+	for (unsigned n = 0; n < iterations; n++) {
+		SensorSamples3D data = {};
+		SensorCorrections3D corrections = {};
+		float dt_inv[SENSOR_COUNT_MAX] = {};
+
+		for (unsigned i = 0; i < instances; i++) {
+			data.set(i, _raw[i][0], _raw[i][1], _raw[i][2]);
+			corrections.offset.set(i, _offsets[i][0], _offsets[i][1], _offsets[i][2]);
+			corrections.scale.set(i, _scales[i][0], _scales[i][1], _scales[i][2]);
+			dt_inv[i] = _dt_inv[i];
+		}
+
+		correct_and_rotate(data, dt_inv, corrections, _rotation);
+		sink = sink + data.x[0] + data.x[1] + data.x[2];
+
+		_raw[n % instances][0] += 1e-9f;
+	}
+
+	hrt_abstime kernel_us = hrt_elapsed_time(&t0);
+
+	PX4_INFO("%u IMUs, per update: math::Vector %.3f us, structure of arrays %.3f us", instances,
+		 (double)reference_us / iterations, (double)kernel_us / iterations);
+
+	return true;
+}
+
+bool SensorKernelsTest::run_tests()
+{
+	ut_run_test(correctAndRotateTest);
+	ut_run_test(rotateEachTest);
+	ut_run_test(benchmarkTest);
+
+	return (_tests_failed == 0);
+}
+
+ut_declare_test_c(test_sensor_kernels, SensorKernelsTest)
@@ -57,6 +57,7 @@ extern int	test_autodeclination(int argc, char *argv[]);
 extern int	test_hysteresis(int argc, char *argv[]);
 extern int	test_bson(int argc, char *argv[]);
 extern int	test_conv(int argc, char *argv[]);
+extern int	test_crc(int argc, char *argv[]);
 extern int	test_dataman(int argc, char *argv[]);
 extern int	test_file(int argc, char *argv[]);
 extern int	test_file2(int argc, char *argv[]);
@@ -71,11 +72,13 @@ extern int	test_mathlib(int argc, char *argv[]);
 extern int	test_matrix(int argc, char *argv[]);
 extern int	test_mixer(int argc, char *argv[]);
 extern int	test_mount(int argc, char *argv[]);
+extern int	test_namespace(int argc, char *argv[]);
 extern int	test_param(int argc, char *argv[]);
 extern int	test_perf(int argc, char *argv[]);
 extern int	test_ppm(int argc, char *argv[]);
 extern int	test_ppm_loopback(int argc, char *argv[]);
 extern int	test_rc(int argc, char *argv[]);
+extern int	test_sensor_kernels(int argc, char *argv[]);
 extern int	test_sensors(int argc, char *argv[]);
 extern int	test_servo(int argc, char *argv[]);
 extern int	test_sleep(int argc, char *argv[]);